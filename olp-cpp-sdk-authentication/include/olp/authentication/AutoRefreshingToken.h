@@ -137,6 +137,26 @@ class AUTHENTICATION_API OLP_SDK_DEPRECATED("Will be removed by 10.2020.")
    */
   AutoRefreshingToken(TokenEndpoint token_endpoint, TokenRequest token_request);
 
+  /**
+   * @brief Creates the `AutoRefreshingToken` instance that refreshes the token
+   * in the background.
+   *
+   * When a token is requested within `refresh_lead_time` before it reaches
+   * the minimum validity, the still valid token is returned immediately and
+   * a new token is requested asynchronously. A random jitter of up to
+   * a quarter of the lead time is applied to spread the refreshes of
+   * different instances.
+   *
+   * @param token_endpoint The token endpoint against which the token is
+   * refreshed.
+   * @param token_request The token request that is sent to the token endpoint.
+   * @param refresh_lead_time The time before the minimum validity of the token
+   * is reached when the background refresh starts. Zero disables the
+   * background refresh.
+   */
+  AutoRefreshingToken(TokenEndpoint token_endpoint, TokenRequest token_request,
+                      std::chrono::seconds refresh_lead_time);
+
   PORTING_POP_WARNINGS()
 
  private:
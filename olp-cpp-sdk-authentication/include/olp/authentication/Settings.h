@@ -20,6 +20,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -105,6 +106,18 @@ struct AUTHENTICATION_API Settings {
    * treated.
    */
   client::RetrySettings retry_settings;
+
+  /**
+   * @brief The time before the token reaches its minimum validity when it is
+   * refreshed in the background.
+   *
+   * Within this time, the still valid token is returned to the callers
+   * without blocking, while a new token is requested asynchronously.
+   *
+   * Default is zero, which means the token is only refreshed when it is
+   * requested after reaching its minimum validity.
+   */
+  std::chrono::seconds token_refresh_lead_time{0};
 };
 
 }  // namespace authentication
@@ -140,12 +140,9 @@ class TokenProvider {
     }
 
     /// Get the token response from AutoRefreshingToken or request a new token
-    /// if expired or not present.
+    /// if expired or not present. AutoRefreshingToken prevents multiple
+    /// authorization requests, so the valid token is returned without locking.
     TokenResponse GetResponse() const {
-      /// Mutex is needed to prevent multiple authorization requests, that could
-      /// happen when the token is not yet available, and multiple consumers
-      /// requested it.
-      std::lock_guard<std::mutex> lock(request_mutex_);
       return token_.GetToken(minimum_validity_);
     }
 
@@ -160,7 +157,6 @@ class TokenProvider {
    private:
     std::chrono::seconds minimum_validity_{kDefaultMinimumValidity};
     AutoRefreshingToken token_;
-    mutable std::mutex request_mutex_;
   };
 
   std::shared_ptr<TokenProviderImpl> impl_;
@@ -223,7 +223,7 @@ template <>
 boost::optional<SignInResult> AuthenticationClientImpl::FindInCache(
     const std::string& key) {
   return client_token_cache_->locked(
-      [&](utils::LruCache<std::string, SignInResult>& cache) {
+      [&](utils::HashLruCache<std::string, SignInResult>& cache) {
         auto it = cache.Find(key);
         return it != cache.end() ? boost::make_optional(it->value())
                                  : boost::none;
@@ -234,7 +234,7 @@ template <>
 boost::optional<SignInUserResult> AuthenticationClientImpl::FindInCache(
     const std::string& key) {
   return user_token_cache_->locked(
-      [&](utils::LruCache<std::string, SignInUserResult>& cache) {
+      [&](utils::HashLruCache<std::string, SignInUserResult>& cache) {
         auto it = cache.Find(key);
         return it != cache.end() ? boost::make_optional(it->value())
                                  : boost::none;
@@ -246,7 +246,7 @@ void AuthenticationClientImpl::StoreInCache(const std::string& key,
                                             SignInResult response) {
   // Cache the response
   client_token_cache_->locked(
-      [&](utils::LruCache<std::string, SignInResult>& cache) {
+      [&](utils::HashLruCache<std::string, SignInResult>& cache) {
         return cache.InsertOrAssign(key, response);
       });
 }
@@ -256,7 +256,7 @@ void AuthenticationClientImpl::StoreInCache(const std::string& key,
                                             SignInUserResult response) {
   // Cache the response
   user_token_cache_->locked(
-      [&](utils::LruCache<std::string, SignInUserResult>& cache) {
+      [&](utils::HashLruCache<std::string, SignInUserResult>& cache) {
         return cache.InsertOrAssign(key, response);
       });
 }
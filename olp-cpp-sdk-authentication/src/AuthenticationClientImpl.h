@@ -36,7 +36,7 @@
 #include "olp/core/http/NetworkRequest.h"
 #include "olp/core/porting/make_unique.h"
 #include "olp/core/thread/Atomic.h"
-#include "olp/core/utils/LruCache.h"
+#include "olp/core/utils/HashLruCache.h"
 
 namespace olp {
 namespace authentication {
@@ -63,11 +63,11 @@ class AuthenticationClientImpl {
  public:
   /// The sign in cache alias type
   using SignInCacheType =
-      thread::Atomic<utils::LruCache<std::string, SignInResult>>;
+      thread::Atomic<utils::HashLruCache<std::string, SignInResult>>;
 
   /// The sign in user cache alias type
   using SignInUserCacheType =
-      thread::Atomic<utils::LruCache<std::string, SignInUserResult>>;
+      thread::Atomic<utils::HashLruCache<std::string, SignInUserResult>>;
 
   explicit AuthenticationClientImpl(AuthenticationSettings settings);
   virtual ~AuthenticationClientImpl();
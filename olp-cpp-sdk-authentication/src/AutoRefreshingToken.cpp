@@ -19,8 +19,15 @@
 
 #include "olp/authentication/AutoRefreshingToken.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <iostream>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
 
 #include "olp/authentication/TokenEndpoint.h"
 #include "olp/core/client/CancellationToken.h"
@@ -30,13 +37,23 @@
 namespace {
 constexpr auto kLogTag = "authentication::AutoRefreshingToken";
 
-std::chrono::steady_clock::time_point ComputeRefreshTime(
-    std::chrono::seconds expires_in,
-    const std::chrono::seconds& minimum_validity) {
-  auto now = std::chrono::steady_clock::now();
-  auto expiry_time_chrono = now + expires_in;
-  return (expiry_time_chrono <= now) ? now
-                                     : (expiry_time_chrono - minimum_validity);
+/// The background refresh starts at a random point of the first quarter of
+/// the lead time to avoid many clients refreshing at the same moment.
+constexpr auto kJitterDivider = 4;
+
+/// The delay before the failed background refresh is retried.
+constexpr auto kRefreshRetryDelay = std::chrono::seconds(10);
+
+std::chrono::seconds ComputeJitter(std::chrono::seconds refresh_lead_time) {
+  const auto max_jitter = refresh_lead_time.count() / kJitterDivider;
+  if (max_jitter <= 0) {
+    return std::chrono::seconds(0);
+  }
+
+  static thread_local std::mt19937 generator{std::random_device{}()};
+  std::uniform_int_distribution<std::chrono::seconds::rep> distribution(
+      0, max_jitter);
+  return std::chrono::seconds(distribution(generator));
 }
 }  // namespace
 
@@ -45,123 +62,269 @@ namespace authentication {
 PORTING_PUSH_WARNINGS()
 PORTING_CLANG_GCC_DISABLE_WARNING("-Wdeprecated-declarations")
 
-struct AutoRefreshingToken::Impl {
-  Impl(TokenEndpoint token_endpoint, TokenRequest token_request)
+struct AutoRefreshingToken::Impl
+    : public std::enable_shared_from_this<AutoRefreshingToken::Impl> {
+  /// The token together with the times it must be refreshed. The state is
+  /// immutable, and it is replaced atomically, so readers do not need a lock.
+  struct TokenState {
+    TokenEndpoint::TokenResponse response;
+    std::chrono::steady_clock::time_point expiry_time;
+    std::chrono::seconds jitter;
+  };
+
+  using TokenStatePtr = std::shared_ptr<const TokenState>;
+
+  Impl(TokenEndpoint token_endpoint, TokenRequest token_request,
+       std::chrono::seconds refresh_lead_time)
       : token_endpoint_(std::move(token_endpoint)),
         token_request_(std::move(token_request)),
-        current_token_(),
-        token_refresh_time_() {}
+        refresh_lead_time_(refresh_lead_time) {}
 
   TokenEndpoint::TokenResponse GetToken(
       client::CancellationToken& cancellation_token,
       std::chrono::seconds minimum_validity) {
-    if (ForceRefresh(minimum_validity) || ShouldRefreshNow()) {
-      OLP_SDK_LOG_INFO_F(kLogTag, "Time to refresh token");
-      TryRefreshCurrentToken(cancellation_token, minimum_validity);
+    auto state = GetValidState(minimum_validity);
+    if (state) {
+      return state->response;
     }
 
-    // Return existing still valid token
-    return current_token_;
+    std::lock_guard<std::mutex> guard(token_mutex_);
+
+    // Other thread might have refreshed the token while we were waiting.
+    state = GetValidState(minimum_validity);
+    if (state) {
+      return state->response;
+    }
+
+    OLP_SDK_LOG_INFO_F(kLogTag, "Time to refresh token");
+    auto response =
+        token_endpoint_.RequestToken(cancellation_token, token_request_).get();
+    StoreState(response);
+    return response;
   }
 
   client::CancellationToken GetToken(const GetTokenCallback& callback,
                                      std::chrono::seconds minimum_validity) {
-    if (ForceRefresh(minimum_validity) || ShouldRefreshNow()) {
-      OLP_SDK_LOG_INFO_F(kLogTag, "Time to refresh token");
-      return TryRefreshCurrentToken(callback, minimum_validity);
+    auto state = GetValidState(minimum_validity);
+    if (state) {
+      callback(state->response);
+      return {};
     }
 
-    // Return existing still valid token
-    callback(current_token_);
-    return {};
+    // The callers that come while the token is requested wait for the same
+    // request.
+    const auto request = async_request_;
+    std::unique_lock<std::mutex> lock(request->mutex);
+    const auto waiter_id = ++request->next_id;
+    request->waiters.emplace_back(waiter_id, callback);
+    client::CancellationToken waiter_token(
+        [request, waiter_id]() { Cancel(request, waiter_id); });
+
+    if (request->in_flight) {
+      OLP_SDK_LOG_DEBUG_F(kLogTag, "Joining token request in flight");
+      return waiter_token;
+    }
+
+    request->in_flight = true;
+    const auto generation = ++request->generation;
+    lock.unlock();
+
+    OLP_SDK_LOG_INFO_F(kLogTag, "Time to refresh token");
+    std::weak_ptr<Impl> weak_self = shared_from_this();
+    auto token = token_endpoint_.RequestToken(
+        token_request_, [weak_self, request, generation](
+                            TokenEndpoint::TokenResponse response) {
+          std::vector<Waiter> waiters;
+          {
+            std::lock_guard<std::mutex> guard(request->mutex);
+            if (!request->in_flight || request->generation != generation) {
+              return;
+            }
+            request->in_flight = false;
+            request->token = client::CancellationToken();
+            waiters.swap(request->waiters);
+          }
+
+          auto self = weak_self.lock();
+          if (self) {
+            self->StoreState(response);
+          }
+          for (const auto& waiter : waiters) {
+            waiter.second(response);
+          }
+        });
+
+    // The request might be completed or abandoned by all callers already.
+    lock.lock();
+    if (request->in_flight && request->generation == generation) {
+      request->token = std::move(token);
+    }
+    return waiter_token;
   }
 
  private:
-  bool ShouldRefreshNow() const {
-    return std::chrono::steady_clock::now() >= token_refresh_time_;
+  using Waiter = std::pair<std::uint64_t, GetTokenCallback>;
+
+  /// The asynchronous token request shared by the concurrent callers.
+  struct AsyncRequest {
+    std::mutex mutex;
+    std::vector<Waiter> waiters;
+    client::CancellationToken token;
+    std::uint64_t next_id{0u};
+    std::uint64_t generation{0u};
+    bool in_flight{false};
+  };
+
+  /// Cancels the caller, and the request when no other caller waits for it.
+  static void Cancel(const std::shared_ptr<AsyncRequest>& request,
+                     std::uint64_t waiter_id) {
+    GetTokenCallback callback;
+    client::CancellationToken token;
+    {
+      std::lock_guard<std::mutex> guard(request->mutex);
+      auto& waiters = request->waiters;
+      auto it = std::find_if(
+          waiters.begin(), waiters.end(),
+          [&](const Waiter& waiter) { return waiter.first == waiter_id; });
+      if (it == waiters.end()) {
+        return;
+      }
+
+      callback = std::move(it->second);
+      waiters.erase(it);
+      if (waiters.empty() && request->in_flight) {
+        request->in_flight = false;
+        token = std::move(request->token);
+      }
+    }
+
+    token.Cancel();
+    callback(client::ApiError::Cancelled());
   }
 
-  bool ForceRefresh(const std::chrono::seconds& minimum_validity) const {
+  static bool ForceRefresh(const std::chrono::seconds& minimum_validity) {
     return minimum_validity <= std::chrono::seconds(0);
   }
 
-  void TryRefreshCurrentToken(client::CancellationToken& cancellation_token,
-                              const std::chrono::seconds& minimum_validity) {
-    std::lock_guard<std::mutex> guard(token_mutex_);
-    current_token_ =
-        token_endpoint_.RequestToken(cancellation_token, token_request_).get();
+  static bool IsTokenValid(const TokenEndpoint::TokenResponse& response) {
+    return response.IsSuccessful() &&
+           response.GetResult().GetErrorResponse().code == 0;
+  }
 
-    if (!current_token_.IsSuccessful()) {
-      OLP_SDK_LOG_INFO_F(
-          kLogTag, "Token NOK, code=%d, error=%s",
-          static_cast<int>(current_token_.GetError().GetErrorCode()),
-          current_token_.GetError().GetMessage().c_str());
-    } else if (current_token_.GetResult().GetErrorResponse().code != 0) {
-      const auto& result = current_token_.GetResult();
+  /// Returns the current state if the token satisfies the minimum validity,
+  /// and schedules the background refresh if the token expires soon.
+  TokenStatePtr GetValidState(std::chrono::seconds minimum_validity) {
+    if (ForceRefresh(minimum_validity)) {
+      return nullptr;
+    }
+
+    auto state = std::atomic_load(&state_);
+    if (!state) {
+      return nullptr;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto refresh_time = state->expiry_time - minimum_validity;
+    if (now >= refresh_time) {
+      return nullptr;
+    }
+
+    if (refresh_lead_time_.count() > 0 && IsTokenValid(state->response) &&
+        now >= refresh_time - refresh_lead_time_ + state->jitter) {
+      RefreshInBackground();
+    }
+
+    return state;
+  }
+
+  void RefreshInBackground() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    if (now.count() < refresh_retry_at_.load()) {
+      return;
+    }
+
+    bool expected = false;
+    if (!background_refresh_.compare_exchange_strong(expected, true)) {
+      return;
+    }
+
+    OLP_SDK_LOG_DEBUG_F(kLogTag, "Refreshing token in background");
+    std::weak_ptr<Impl> weak_self = shared_from_this();
+    token_endpoint_.RequestToken(
+        token_request_, [weak_self](TokenEndpoint::TokenResponse response) {
+          auto self = weak_self.lock();
+          if (!self) {
+            return;
+          }
+
+          // Keep the still valid token if the refresh failed, the next
+          // caller within the lead time retries after a delay.
+          if (IsTokenValid(response)) {
+            self->StoreState(response);
+          } else {
+            LogResponse(response);
+            const auto retry_at =
+                std::chrono::steady_clock::now() + kRefreshRetryDelay;
+            self->refresh_retry_at_ = retry_at.time_since_epoch().count();
+          }
+          self->background_refresh_ = false;
+        });
+  }
+
+  static void LogResponse(const TokenEndpoint::TokenResponse& response) {
+    if (!response.IsSuccessful()) {
+      OLP_SDK_LOG_INFO_F(kLogTag, "Token NOK, code=%d, error=%s",
+                         static_cast<int>(response.GetError().GetErrorCode()),
+                         response.GetError().GetMessage().c_str());
+    } else if (response.GetResult().GetErrorResponse().code != 0) {
+      const auto& result = response.GetResult();
       OLP_SDK_LOG_INFO_F(kLogTag, "Token NOK, status=%d, code=%d, error=%s",
                          static_cast<int>(result.GetHttpStatus()),
                          static_cast<int>(result.GetErrorResponse().code),
                          result.GetErrorResponse().message.c_str());
     } else {
-      auto expiry_time = current_token_.GetResult().GetExpiryTime();
+      auto expiry_time = response.GetResult().GetExpiryTime();
       OLP_SDK_LOG_INFO_F(kLogTag, "Token OK, expires=%s",
                          std::asctime(std::gmtime(&expiry_time)));
     }
-
-    token_refresh_time_ = ComputeRefreshTime(
-        current_token_.GetResult().GetExpiresIn(), minimum_validity);
   }
 
-  client::CancellationToken TryRefreshCurrentToken(
-      const GetTokenCallback& callback,
-      const std::chrono::seconds& minimum_validity) {
-    std::lock_guard<std::mutex> guard(token_mutex_);
+  void StoreState(const TokenEndpoint::TokenResponse& response) {
+    LogResponse(response);
 
-    // Avoid capturing this, but very risky as updating without lock
-    auto& current_token = current_token_;
-    auto& token_refresh_time = token_refresh_time_;
-
-    return token_endpoint_.RequestToken(
-        token_request_,
-        [&, callback, minimum_validity](TokenEndpoint::TokenResponse response) {
-          current_token = response;
-
-          if (!current_token.IsSuccessful()) {
-            OLP_SDK_LOG_INFO_F(
-                kLogTag, "Token NOK, code=%d, error=%s",
-                static_cast<int>(current_token.GetError().GetErrorCode()),
-                current_token.GetError().GetMessage().c_str());
-          } else if (current_token.GetResult().GetErrorResponse().code != 0) {
-            const auto& result = current_token.GetResult();
-            OLP_SDK_LOG_INFO_F(kLogTag,
-                               "Token NOK, status=%d code=%d, error=%s",
-                               static_cast<int>(result.GetHttpStatus()),
-                               static_cast<int>(result.GetErrorResponse().code),
-                               result.GetErrorResponse().message.c_str());
-          } else {
-            auto expiry_time = current_token.GetResult().GetExpiryTime();
-            OLP_SDK_LOG_INFO_F(kLogTag, "Token OK, expires=%s",
-                               std::asctime(std::gmtime(&expiry_time)));
-          }
+    auto state = std::make_shared<TokenState>();
+    state->response = response;
+    state->expiry_time = std::chrono::steady_clock::now();
+    if (response.IsSuccessful()) {
+      state->expiry_time += response.GetResult().GetExpiresIn();
+    }
+    state->jitter = ComputeJitter(refresh_lead_time_);
 
-          token_refresh_time = ComputeRefreshTime(
-              current_token.GetResult().GetExpiresIn(), minimum_validity);
-          callback(response);
-        });
+    std::atomic_store(&state_, TokenStatePtr(std::move(state)));
   }
 
- private:
   TokenEndpoint token_endpoint_;
   TokenRequest token_request_;
-  TokenEndpoint::TokenResponse current_token_;
-  std::chrono::steady_clock::time_point token_refresh_time_;
+  const std::chrono::seconds refresh_lead_time_;
+  TokenStatePtr state_;
+  std::atomic<bool> background_refresh_{false};
+  std::atomic<std::chrono::steady_clock::rep> refresh_retry_at_{0};
   std::mutex token_mutex_;
+  const std::shared_ptr<AsyncRequest> async_request_ =
+      std::make_shared<AsyncRequest>();
 };
 
 AutoRefreshingToken::AutoRefreshingToken(TokenEndpoint token_endpoint,
                                          TokenRequest token_request)
+    : AutoRefreshingToken(std::move(token_endpoint), std::move(token_request),
+                          std::chrono::seconds(0)) {}
+
+AutoRefreshingToken::AutoRefreshingToken(
+    TokenEndpoint token_endpoint, TokenRequest token_request,
+    std::chrono::seconds refresh_lead_time)
     : impl_(std::make_shared<AutoRefreshingToken::Impl>(
-          std::move(token_endpoint), std::move(token_request))) {}
+          std::move(token_endpoint), std::move(token_request),
+          refresh_lead_time)) {}
 
 TokenEndpoint::TokenResponse AutoRefreshingToken::GetToken(
     client::CancellationToken& cancellation_token,
@@ -61,14 +61,20 @@ class TokenEndpoint::Impl {
       client::CancellationToken& cancel_token,
       const TokenRequest& token_request);
 
+  std::chrono::seconds GetTokenRefreshLeadTime() const {
+    return token_refresh_lead_time_;
+  }
+
  private:
   AuthenticationClient auth_client_;
   AuthenticationCredentials auth_credentials_;
+  std::chrono::seconds token_refresh_lead_time_;
 };
 
 TokenEndpoint::Impl::Impl(Settings settings)
     : auth_client_(ConvertSettings(settings)),
-      auth_credentials_(std::move(settings.credentials)) {}
+      auth_credentials_(std::move(settings.credentials)),
+      token_refresh_lead_time_(settings.token_refresh_lead_time) {}
 
 client::CancellationToken TokenEndpoint::Impl::RequestToken(
     const TokenRequest& token_request, const RequestTokenCallback& callback) {
@@ -138,7 +144,8 @@ std::future<TokenEndpoint::TokenResponse> TokenEndpoint::RequestToken(
 
 AutoRefreshingToken TokenEndpoint::RequestAutoRefreshingToken(
     const TokenRequest& token_request) {
-  return AutoRefreshingToken(*this, token_request);
+  return AutoRefreshingToken(*this, token_request,
+                             impl_->GetTokenRefreshLeadTime());
 }
 
 PORTING_POP_WARNINGS()
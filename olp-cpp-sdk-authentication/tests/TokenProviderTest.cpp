@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include <gmock/gmock.h>
+#include <mocks/NetworkMock.h>
+#include <olp/authentication/AutoRefreshingToken.h>
+#include <olp/authentication/TokenProvider.h>
+#include <olp/core/http/HttpStatusCode.h>
+
+namespace {
+namespace auth = olp::authentication;
+using testing::_;
+
+constexpr auto kFirstToken =
+    R"({"accessToken":"token_1","tokenType":"bearer","expiresIn":3600})";
+constexpr auto kSecondToken =
+    R"({"accessToken":"token_2","tokenType":"bearer","expiresIn":3600})";
+
+PORTING_PUSH_WARNINGS()
+PORTING_CLANG_GCC_DISABLE_WARNING("-Wdeprecated-declarations")
+
+TEST(TokenProviderTest, RefreshTokenInBackground) {
+  auto network = std::make_shared<NetworkMock>();
+
+  auth::Settings settings({"key", "secret"});
+  settings.network_request_handler = network;
+  // The lead time is longer than the token lifetime, so every request within
+  // the token validity triggers the background refresh.
+  settings.token_refresh_lead_time = std::chrono::hours(24);
+
+  EXPECT_CALL(*network, Send(_, _, _, _, _))
+      .WillOnce(ReturnHttpResponse(GetResponse(olp::http::HttpStatusCode::OK),
+                                   kFirstToken))
+      .WillRepeatedly(ReturnHttpResponse(
+          GetResponse(olp::http::HttpStatusCode::OK), kSecondToken));
+
+  auth::TokenProviderDefault provider(settings);
+
+  // No token yet, the first request blocks until the token is received.
+  EXPECT_EQ(provider(), "token_1");
+
+  // The valid token is returned right away while the new one is requested.
+  EXPECT_EQ(provider(), "token_1");
+
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  auto token = provider();
+  while (token != "token_2" && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    token = provider();
+  }
+
+  EXPECT_EQ(token, "token_2");
+  testing::Mock::VerifyAndClearExpectations(network.get());
+}
+
+TEST(TokenProviderTest, NoBackgroundRefreshByDefault) {
+  auto network = std::make_shared<NetworkMock>();
+
+  auth::Settings settings({"key", "secret"});
+  settings.network_request_handler = network;
+
+  EXPECT_CALL(*network, Send(_, _, _, _, _))
+      .WillOnce(ReturnHttpResponse(GetResponse(olp::http::HttpStatusCode::OK),
+                                   kFirstToken));
+
+  auth::TokenProviderDefault provider(settings);
+
+  EXPECT_EQ(provider(), "token_1");
+  EXPECT_EQ(provider(), "token_1");
+  EXPECT_TRUE(provider);
+}
+
+TEST(TokenProviderTest, RetryFailedBackgroundRefreshAfterDelay) {
+  auto network = std::make_shared<NetworkMock>();
+
+  auth::Settings settings({"key", "secret"});
+  settings.network_request_handler = network;
+  settings.token_refresh_lead_time = std::chrono::hours(24);
+
+  EXPECT_CALL(*network, Send(_, _, _, _, _))
+      .WillOnce(ReturnHttpResponse(GetResponse(olp::http::HttpStatusCode::OK),
+                                   kFirstToken))
+      .WillOnce(ReturnHttpResponse(
+          GetResponse(olp::http::HttpStatusCode::UNAUTHORIZED),
+          R"({"errorCode":401300,"message":"Signature mismatch"})"));
+
+  auth::TokenProviderDefault provider(settings);
+
+  EXPECT_EQ(provider(), "token_1");
+
+  // The failed refresh is not retried by every caller.
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+  while (std::chrono::steady_clock::now() < deadline) {
+    EXPECT_EQ(provider(), "token_1");
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  testing::Mock::VerifyAndClearExpectations(network.get());
+}
+
+TEST(TokenProviderTest, CoalesceAsyncTokenRequests) {
+  auto network = std::make_shared<NetworkMock>();
+
+  auth::Settings settings({"key", "secret"});
+  settings.network_request_handler = network;
+
+  EXPECT_CALL(*network, Send(_, _, _, _, _))
+      .WillOnce(ReturnHttpResponse(GetResponse(olp::http::HttpStatusCode::OK),
+                                   kFirstToken));
+
+  auth::AutoRefreshingToken token(auth::TokenEndpoint(settings),
+                                  auth::TokenRequest{});
+
+  std::promise<std::string> first_promise;
+  std::promise<std::string> second_promise;
+  auto get_token = [&](std::promise<std::string>& promise,
+                       std::chrono::seconds minimum_validity) {
+    return token.GetToken(
+        [&promise](const auth::TokenEndpoint::TokenResponse& response) {
+          promise.set_value(response.IsSuccessful()
+                                ? response.GetResult().GetAccessToken()
+                                : response.GetError().GetMessage());
+        },
+        minimum_validity);
+  };
+
+  get_token(first_promise, auth::kDefaultMinimumValiditySeconds);
+  get_token(second_promise, auth::kDefaultMinimumValiditySeconds);
+
+  auto first_future = first_promise.get_future();
+  auto second_future = second_promise.get_future();
+  ASSERT_EQ(first_future.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  ASSERT_EQ(second_future.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  EXPECT_EQ(first_future.get(), "token_1");
+  EXPECT_EQ(second_future.get(), "token_1");
+
+  {
+    SCOPED_TRACE("Cancel one of the callers of the forced refresh");
+
+    EXPECT_CALL(*network, Send(_, _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            GetResponse(olp::http::HttpStatusCode::OK), kSecondToken));
+
+    std::promise<std::string> waiting_promise;
+    std::promise<std::string> cancelled_promise;
+    get_token(waiting_promise, auth::kForceRefresh);
+    get_token(cancelled_promise, auth::kForceRefresh).Cancel();
+
+    auto cancelled_future = cancelled_promise.get_future();
+    auto waiting_future = waiting_promise.get_future();
+    ASSERT_EQ(cancelled_future.wait_for(std::chrono::seconds(5)),
+              std::future_status::ready);
+    ASSERT_EQ(waiting_future.wait_for(std::chrono::seconds(5)),
+              std::future_status::ready);
+    EXPECT_EQ(cancelled_future.get(), "Cancelled");
+    EXPECT_EQ(waiting_future.get(), "token_2");
+  }
+
+  testing::Mock::VerifyAndClearExpectations(network.get());
+}
+
+PORTING_POP_WARNINGS()
+}  // namespace
@@ -21,6 +21,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <olp/core/CoreApi.h>
 #include <olp/core/client/ApiError.h>
@@ -37,12 +39,19 @@ class ApiLookupClientImpl;
 
 /**
  * @brief Client to API lookup requests
+ *
+ * The lookup results are shared in memory by all clients that use the same
+ * network and cache instances, and identical lookups that are in flight at
+ * the same time are sent only once.
  */
 class CORE_API ApiLookupClient final {
  public:
   /// Alias for the parameters and responses.
   using LookupApiResponse = ApiResponse<OlpClient, ApiError>;
   using LookupApiCallback = std::function<void(LookupApiResponse)>;
+  /// The catalogs that failed to warm up, and their errors.
+  using WarmUpErrors = std::vector<std::pair<HRN, ApiError>>;
+  using WarmUpCallback = std::function<void(WarmUpErrors)>;
 
   explicit ApiLookupClient(const HRN& catalog,
                            const OlpClientSettings& settings);
@@ -91,6 +100,25 @@ class CORE_API ApiLookupClient final {
                               const std::string& service_version,
                               FetchOptions options, LookupApiCallback callback);
 
+  /**
+   * @brief Looks up the APIs of the catalogs in advance.
+   *
+   * Use it at startup, before creating the layer clients of the catalogs,
+   * so that the clients do not wait for the lookup requests. The results
+   * are shared with all clients that use the same network and cache
+   * instances, and are stored in the cache.
+   *
+   * @param catalogs The HRNs of the catalogs.
+   * @param settings The settings used for the lookup requests.
+   * @param callback The function callback called once all lookups are done
+   * with the catalogs that failed.
+   *
+   * @return The token used to cancel the lookups.
+   */
+  static CancellationToken WarmUp(const std::vector<HRN>& catalogs,
+                                  const OlpClientSettings& settings,
+                                  WarmUpCallback callback);
+
  private:
   std::shared_ptr<ApiLookupClientImpl> impl_;
 };
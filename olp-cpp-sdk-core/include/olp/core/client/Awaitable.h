@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+/// Defined if the compiler supports C++20 coroutines and `Awaitable` is
+/// available.
+#define OLP_SDK_HAS_COROUTINES 1
+
+#include <atomic>
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <boost/optional.hpp>
+
+#include <olp/core/client/ApiError.h>
+#include <olp/core/client/CancellationContext.h>
+#include <olp/core/client/CancellationToken.h>
+#include <olp/core/thread/TaskScheduler.h>
+
+namespace olp {
+namespace client {
+
+/**
+ * @brief Awaits the result of an asynchronous API in a C++20 coroutine.
+ *
+ * Adapts any API that takes a callback and returns `CancellationToken`, so
+ * the coroutine does not hold a thread while the request is pending.
+ * The request starts when the coroutine suspends and is registered in
+ * the `CancellationContext`: cancelling the context cancels the request,
+ * and the coroutine resumes with the `Cancelled` error. A coroutine can use
+ * one context for a sequence of requests.
+ *
+ * The coroutine resumes on the task scheduler if it is provided, otherwise on
+ * the thread that delivers the result. If the result is delivered before
+ * the coroutine suspends, it continues without suspension.
+ *
+ * @tparam Response The response type of the API. It must be constructible
+ * from `ApiError`.
+ */
+template <typename Response>
+class Awaitable final {
+ public:
+  /// The callback that receives the response.
+  using Callback = std::function<void(Response)>;
+  /// Starts the request with the callback.
+  using StartFunc = std::function<CancellationToken(Callback)>;
+
+  /**
+   * @brief Creates the `Awaitable` instance.
+   *
+   * @param start The function that starts the request.
+   * @param context The `CancellationContext` instance that is used to cancel
+   * the request.
+   * @param scheduler The `TaskScheduler` instance used to resume the coroutine,
+   * or nullptr to resume it on the thread that delivers the result.
+   */
+  Awaitable(StartFunc start, CancellationContext context,
+            std::shared_ptr<thread::TaskScheduler> scheduler)
+      : start_(std::move(start)),
+        context_(std::move(context)),
+        state_(std::make_shared<State>(std::move(scheduler))) {}
+
+  /// The request is started in `await_suspend`.
+  bool await_ready() const noexcept { return false; }
+
+  /**
+   * @brief Starts the request.
+   *
+   * @param handle The handle of the suspended coroutine.
+   *
+   * @return False if the result is already available and the coroutine
+   * continues; true otherwise.
+   */
+  bool await_suspend(std::coroutine_handle<> handle) {
+    auto state = state_;
+    state->handle = handle;
+
+    Callback callback = [state](Response response) {
+      state->Complete(std::move(response));
+    };
+
+    context_.ExecuteOrCancelled([&]() { return start_(callback); },
+                                [&]() { callback(ApiError::Cancelled()); });
+
+    auto expected = Status::kPending;
+    return state->status.compare_exchange_strong(expected, Status::kSuspended,
+                                                 std::memory_order_acq_rel);
+  }
+
+  /// Returns the response.
+  Response await_resume() { return std::move(*state_->response); }
+
+ private:
+  enum class Status { kPending, kSuspended, kCompleted };
+
+  // Shared with the callback, which can outlive the awaitable.
+  struct State {
+    explicit State(std::shared_ptr<thread::TaskScheduler> task_scheduler)
+        : scheduler(std::move(task_scheduler)) {}
+
+    void Complete(Response result) {
+      response = std::move(result);
+      if (status.exchange(Status::kCompleted, std::memory_order_acq_rel) !=
+          Status::kSuspended) {
+        // The coroutine has not suspended yet, `await_suspend` continues it.
+        return;
+      }
+
+      auto coroutine = handle;
+      if (scheduler) {
+        scheduler->ScheduleTask([coroutine]() { coroutine.resume(); });
+      } else {
+        coroutine.resume();
+      }
+    }
+
+    const std::shared_ptr<thread::TaskScheduler> scheduler;
+    std::coroutine_handle<> handle;
+    std::atomic<Status> status{Status::kPending};
+    boost::optional<Response> response;
+  };
+
+  StartFunc start_;
+  CancellationContext context_;
+  std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief Creates the `Awaitable` instance for an asynchronous API.
+ *
+ * Example:
+ * @code
+ * auto response = co_await olp::client::MakeAwaitable<DataResponse>(
+ *     [&](auto callback) { return client.GetData(request, callback); },
+ *     context, scheduler);
+ * @endcode
+ *
+ * @param start The function that starts the request with the callback and
+ * returns `CancellationToken`.
+ * @param context The `CancellationContext` instance that is used to cancel
+ * the request.
+ * @param scheduler The `TaskScheduler` instance used to resume the coroutine,
+ * or nullptr to resume it on the thread that delivers the result.
+ *
+ * @return The `Awaitable` instance.
+ */
+template <typename Response, typename StartFunc>
+Awaitable<Response> MakeAwaitable(
+    StartFunc&& start, CancellationContext context = CancellationContext(),
+    std::shared_ptr<thread::TaskScheduler> scheduler = nullptr) {
+  return Awaitable<Response>(std::forward<StartFunc>(start), std::move(context),
+                             std::move(scheduler));
+}
+
+}  // namespace client
+}  // namespace olp
+
+#endif  // __cpp_impl_coroutine
@@ -19,9 +19,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <olp/core/CoreApi.h>
 #include <olp/core/client/CancellationToken.h>
@@ -76,13 +78,28 @@ class CORE_API CancellationContext {
   /**
    * @brief Checks whether this context is cancelled.
    *
+   * The check does not lock, so it can be polled in loops.
+   *
    * @return True if the context is cancelled; false otherwise.
    */
   bool IsCancelled() const;
 
+  /**
+   * @brief Creates a child context.
+   *
+   * Cancelling this context cancels all its children, and their children,
+   * in one call. Cancelling a child does not affect this context. The child
+   * of a cancelled context is created cancelled.
+   *
+   * @return The child `CancellationContext` instance.
+   */
+  CancellationContext CreateChild() const;
+
  private:
   /// A helper for unordered containers.
   friend struct CancellationContextHash;
+  /// Inspects the internal state in the tests.
+  friend struct CancellationContextInspector;
 
   /**
    * @brief An implementation used to shared the `CancellationContext` instance.
@@ -103,9 +120,22 @@ class CORE_API CancellationContext {
     /**
      * @brief The flag that is set to `true` for `CancelOperation()`.
      */
-    bool is_cancelled_{false};
+    std::atomic<bool> is_cancelled_{false};
+    /**
+     * @brief The child contexts that are cancelled with this context.
+     */
+    std::vector<std::weak_ptr<CancellationContextImpl>> children_;
+    /**
+     * @brief The number of children at which the expired ones are removed.
+     */
+    size_t children_prune_size_{16u};
   };
 
+  /**
+   * @brief Cancels the context and its children.
+   */
+  static void Cancel(const std::shared_ptr<CancellationContextImpl>& impl);
+
   /**
    * @brief The shared implementation.
    */
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 namespace olp {
 namespace client {
 
@@ -32,9 +34,18 @@ inline bool CancellationContext::ExecuteOrCancelled(
     return true;
   }
 
+  // The flag is never reset, so the cancelled context is handled without
+  // the lock.
+  if (impl_->is_cancelled_.load(std::memory_order_acquire)) {
+    if (cancel_fn) {
+      cancel_fn();
+    }
+    return false;
+  }
+
   std::lock_guard<std::recursive_mutex> lock(impl_->mutex_);
 
-  if (impl_->is_cancelled_) {
+  if (impl_->is_cancelled_.load(std::memory_order_relaxed)) {
     if (cancel_fn) {
       cancel_fn();
     }
@@ -49,18 +60,37 @@ inline bool CancellationContext::ExecuteOrCancelled(
 }
 
 inline void CancellationContext::CancelOperation() {
-  if (!impl_) {
-    return;
+  if (impl_) {
+    Cancel(impl_);
   }
+}
 
-  std::lock_guard<std::recursive_mutex> lock(impl_->mutex_);
-  if (impl_->is_cancelled_) {
+inline void CancellationContext::Cancel(
+    const std::shared_ptr<CancellationContextImpl>& impl) {
+  if (impl->is_cancelled_.load(std::memory_order_acquire)) {
     return;
   }
 
-  impl_->sub_operation_cancel_token_.Cancel();
-  impl_->sub_operation_cancel_token_ = CancellationToken();
-  impl_->is_cancelled_ = true;
+  std::vector<std::weak_ptr<CancellationContextImpl>> children;
+  {
+    std::lock_guard<std::recursive_mutex> lock(impl->mutex_);
+    if (impl->is_cancelled_.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    impl->is_cancelled_.store(true, std::memory_order_release);
+    impl->sub_operation_cancel_token_.Cancel();
+    impl->sub_operation_cancel_token_ = CancellationToken();
+    children.swap(impl->children_);
+  }
+
+  // The children are cancelled without the lock of the parent, as their
+  // operations may use the parent. No child is added after the flag is set.
+  for (const auto& weak_child : children) {
+    if (auto child = weak_child.lock()) {
+      Cancel(child);
+    }
+  }
 }
 
 inline bool CancellationContext::IsCancelled() const {
@@ -68,8 +98,36 @@ inline bool CancellationContext::IsCancelled() const {
     return false;
   }
 
+  return impl_->is_cancelled_.load(std::memory_order_acquire);
+}
+
+inline CancellationContext CancellationContext::CreateChild() const {
+  CancellationContext child;
+  if (!impl_) {
+    return child;
+  }
+
   std::lock_guard<std::recursive_mutex> lock(impl_->mutex_);
-  return impl_->is_cancelled_;
+  if (impl_->is_cancelled_.load(std::memory_order_relaxed)) {
+    child.impl_->is_cancelled_.store(true, std::memory_order_relaxed);
+    return child;
+  }
+
+  auto& children = impl_->children_;
+  if (children.size() >= impl_->children_prune_size_) {
+    children.erase(
+        std::remove_if(children.begin(), children.end(),
+                       [](const std::weak_ptr<CancellationContextImpl>& item) {
+                         return item.expired();
+                       }),
+        children.end());
+    // Keeps the pruning amortized constant per child.
+    impl_->children_prune_size_ =
+        std::max<size_t>(16u, children.size() * 2u);
+  }
+
+  children.push_back(child.impl_);
+  return child;
 }
 
 inline size_t CancellationContextHash::operator()(
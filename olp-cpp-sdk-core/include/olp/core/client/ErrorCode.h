@@ -90,7 +90,12 @@ enum class ErrorCode {
   /**
    * A failed cache IO operation.
    */
-  CacheIO
+  CacheIO,
+
+  /**
+   * The downloaded data does not match its checksum.
+   */
+  ChecksumMismatch
 };
 
 }  // namespace client
@@ -44,7 +44,15 @@ enum FetchOptions {
    * in the background.
    * @note Do not use for versioned layer client requests.
    */
-  CacheWithUpdate
+  CacheWithUpdate,
+
+  /**
+   * Returns the requested cached resource if it is found, also if it expired
+   * less than `OlpClientSettings::max_staleness` ago. The expired resource is
+   * refreshed in the background, only once at a time. Queries the network if
+   * the resource is not found in the cache.
+   */
+  StaleWhileRevalidate
 };
 
 }  // namespace client
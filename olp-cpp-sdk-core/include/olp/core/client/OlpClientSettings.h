@@ -262,6 +262,19 @@ struct CORE_API OlpClientSettings {
    * volatile or versioned, and which is stored in cache.
    */
   std::chrono::seconds default_cache_expiration = std::chrono::seconds::max();
+
+  /**
+   * @brief How long an expired cache entry can still be returned to
+   * the requests made with the `StaleWhileRevalidate` fetch option.
+   *
+   * The expired entries are kept in the cache for this duration. They are not
+   * returned to the requests made with the other fetch options. By default,
+   * the expired entries are not kept.
+   *
+   * @note Applies to the entries that expire, see `default_cache_expiration`.
+   * Use the same value for all clients that share the cache.
+   */
+  std::chrono::seconds max_staleness = std::chrono::seconds::zero();
 };
 
 }  // namespace client
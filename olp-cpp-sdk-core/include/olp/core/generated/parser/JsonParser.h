@@ -19,16 +19,75 @@
 
 #pragma once
 
+#include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 
+#include <rapidjson/allocators.h>
 #include <rapidjson/document.h>
-#include <rapidjson/istreamwrapper.h>
 
 #include "ParserWrapper.h"
 
 namespace olp {
 namespace parser {
+namespace detail {
+
+/*
+ * The memory of the parsed documents. Each thread keeps one instance, so
+ * the documents that fit into the buffer are parsed without allocations.
+ */
+class ParserAllocator {
+ public:
+  static constexpr size_t kBufferSize = 64u * 1024u;
+  static constexpr size_t kStackCapacity = 1024u;
+
+  ParserAllocator()
+      : buffer_(new char[kBufferSize]),
+        allocator_(buffer_.get(), kBufferSize) {}
+
+  rapidjson::MemoryPoolAllocator<>* GetAllocator() { return &allocator_; }
+
+  rapidjson::CrtAllocator* GetStackAllocator() { return &stack_allocator_; }
+
+  bool TryAcquire() {
+    if (in_use_) {
+      return false;
+    }
+    in_use_ = true;
+    return true;
+  }
+
+  // Releases all memory of the parsed document except the buffer.
+  void Release() {
+    allocator_.Clear();
+    in_use_ = false;
+  }
+
+ private:
+  std::unique_ptr<char[]> buffer_;
+  rapidjson::MemoryPoolAllocator<> allocator_;
+  rapidjson::CrtAllocator stack_allocator_;
+  bool in_use_{false};
+};
+
+inline ParserAllocator& GetThreadParserAllocator() {
+  static thread_local ParserAllocator allocator;
+  return allocator;
+}
+
+template <typename T>
+inline bool ParseDocument(rapidjson::Document& doc, char* json, T& result) {
+  doc.ParseInsitu(json);
+  if (doc.IsObject() || doc.IsArray()) {
+    from_json(doc, result);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace detail
+
 template <typename T>
 inline T parse(const std::string& json) {
   rapidjson::Document doc;
@@ -40,20 +99,49 @@ inline T parse(const std::string& json) {
   return result;
 }
 
+/**
+ * @brief Parses the JSON in-situ, the buffer is modified by the parser.
+ *
+ * The parsed document uses the memory pool of the calling thread, which is
+ * reused between the calls.
+ */
 template <typename T>
-inline T parse(std::stringstream& json_stream, bool& res) {
-  res = false;
-  rapidjson::Document doc;
-  rapidjson::IStreamWrapper stream(json_stream);
-  doc.ParseStream(stream);
+inline T parse(std::string&& json, bool& res) {
   T result{};
-  if (doc.IsObject() || doc.IsArray()) {
-    from_json(doc, result);
-    res = true;
+  auto& allocator = detail::GetThreadParserAllocator();
+
+  // The pool is busy if `from_json` parses a nested document.
+  if (!allocator.TryAcquire()) {
+    rapidjson::Document doc;
+    res = detail::ParseDocument(doc, &json[0], result);
+    return result;
   }
+
+  struct ReleaseGuard {
+    ~ReleaseGuard() { allocator.Release(); }
+    detail::ParserAllocator& allocator;
+  } guard{allocator};
+
+  rapidjson::Document doc(allocator.GetAllocator(),
+                          detail::ParserAllocator::kStackCapacity,
+                          allocator.GetStackAllocator());
+  res = detail::ParseDocument(doc, &json[0], result);
   return result;
 }
 
+template <typename T>
+inline T parse(std::string&& json) {
+  bool res = true;
+  return parse<T>(std::move(json), res);
+}
+
+template <typename T>
+inline T parse(std::stringstream& json_stream, bool& res) {
+  // Copying the buffer at once is faster than reading the stream per
+  // character, and allows the in-situ parsing.
+  return parse<T>(json_stream.str(), res);
+}
+
 template <typename T>
 inline T parse(std::stringstream& json_stream) {
   bool res = true;
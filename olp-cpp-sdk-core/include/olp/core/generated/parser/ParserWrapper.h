@@ -22,6 +22,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/optional.hpp>
@@ -31,7 +32,7 @@ namespace olp {
 namespace parser {
 
 inline void from_json(const rapidjson::Value& value, std::string& x) {
-  x = value.GetString();
+  x.assign(value.GetString(), value.GetStringLength());
 }
 
 inline void from_json(const rapidjson::Value& value, int32_t& x) {
@@ -52,15 +53,16 @@ inline void from_json(const rapidjson::Value& value, bool& x) {
 
 inline void from_json(const rapidjson::Value& value,
                       std::shared_ptr<std::vector<unsigned char>>& x) {
-  std::string s = value.GetString();
-  x = std::make_shared<std::vector<unsigned char>>(s.begin(), s.end());
+  const auto* begin = value.GetString();
+  x = std::make_shared<std::vector<unsigned char>>(
+      begin, begin + value.GetStringLength());
 }
 
 template <typename T>
 inline void from_json(const rapidjson::Value& value, boost::optional<T>& x) {
   T result = T();
   from_json(value, result);
-  x = result;
+  x = std::move(result);
 }
 
 template <typename T>
@@ -68,31 +70,36 @@ inline void from_json(const rapidjson::Value& value,
                       std::map<std::string, T>& results) {
   for (rapidjson::Value::ConstMemberIterator itr = value.MemberBegin();
        itr != value.MemberEnd(); ++itr) {
-    std::string key;
-    from_json(itr->name, key);
-    from_json(itr->value, results[key]);
+    std::string key(itr->name.GetString(), itr->name.GetStringLength());
+    from_json(itr->value, results[std::move(key)]);
   }
 }
 
 template <typename T>
 inline void from_json(const rapidjson::Value& value, std::vector<T>& results) {
+  results.reserve(results.size() + value.Size());
   for (rapidjson::Value::ConstValueIterator itr = value.Begin();
        itr != value.End(); ++itr) {
     T result;
     from_json(*itr, result);
-    results.push_back(result);
+    results.push_back(std::move(result));
   }
 }
 
 template <typename T>
-inline T parse(const rapidjson::Value& value, const std::string& name) {
+inline T parse(const rapidjson::Value& value, const char* name) {
   T result = T();
-  rapidjson::Value::ConstMemberIterator itr = value.FindMember(name.c_str());
+  rapidjson::Value::ConstMemberIterator itr = value.FindMember(name);
   if (itr != value.MemberEnd()) {
     from_json(itr->value, result);
   }
   return result;
 }
 
+template <typename T>
+inline T parse(const rapidjson::Value& value, const std::string& name) {
+  return parse<T>(value, name.c_str());
+}
+
 }  // namespace parser
 }  // namespace olp
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <olp/core/geo/Types.h>
 
 namespace olp {
@@ -73,6 +75,49 @@ class CORE_API IProjection {
    */
   virtual bool Unproject(const WorldCoordinates& world_point,
                          GeoCoordinates3d& geo_point) const = 0;
+
+  /**
+   * @brief Projects a batch of points from geographic to world coordinates.
+   *
+   * The points are passed as separate arrays of coordinates (structure of
+   * arrays), so the projection can convert them with vector instructions.
+   * The input and output arrays must not overlap. The default implementation
+   * calls `Project` for each point.
+   *
+   * @param latitudes The latitudes in radians.
+   * @param longitudes The longitudes in radians.
+   * @param altitudes The altitudes in meters.
+   * @param count The number of points.
+   * @param x The output world X coordinates.
+   * @param y The output world Y coordinates.
+   * @param z The output world Z coordinates.
+   *
+   * @return True if all points are projected; false otherwise.
+   */
+  virtual bool ProjectBatch(const double* latitudes, const double* longitudes,
+                            const double* altitudes, size_t count, double* x,
+                            double* y, double* z) const;
+
+  /**
+   * @brief Unprojects a batch of points from world to geographic coordinates.
+   *
+   * The input and output arrays must not overlap. The default implementation
+   * calls `Unproject` for each point.
+   *
+   * @param x The world X coordinates.
+   * @param y The world Y coordinates.
+   * @param z The world Z coordinates.
+   * @param count The number of points.
+   * @param latitudes The output latitudes in radians.
+   * @param longitudes The output longitudes in radians.
+   * @param altitudes The output altitudes in meters.
+   *
+   * @return True if all points are unprojected; false otherwise.
+   */
+  virtual bool UnprojectBatch(const double* x, const double* y,
+                              const double* z, size_t count,
+                              double* latitudes, double* longitudes,
+                              double* altitudes) const;
 };
 
 }  // namespace geo
@@ -47,6 +47,13 @@ class CORE_API WebMercatorProjection final : public IProjection {
                WorldCoordinates& world_point) const override;
   bool Unproject(const WorldCoordinates& world_point,
                  GeoCoordinates3d& geo_point) const override;
+
+  bool ProjectBatch(const double* latitudes, const double* longitudes,
+                    const double* altitudes, size_t count, double* x,
+                    double* y, double* z) const override;
+  bool UnprojectBatch(const double* x, const double* y, const double* z,
+                      size_t count, double* latitudes, double* longitudes,
+                      double* altitudes) const override;
 };
 
 }  // namespace geo
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include <olp/core/CoreApi.h>
+#include <olp/core/geo/Types.h>
+#include <olp/core/geo/coordinates/GeoCoordinates.h>
+#include <olp/core/geo/tiling/TileKey.h>
+
+namespace olp {
+namespace geo {
+
+/**
+ * @brief A lazy cover of a region by the tiles of one level.
+ *
+ * The tiles are visited in the Morton (quadkey) order by a depth-first
+ * traversal of the tile tree that skips the subtrees outside of the region,
+ * so the iteration does not allocate memory and takes time proportional to
+ * the number of visited tiles.
+ *
+ * The compact cover replaces the subtrees that are fully inside of the
+ * region by their roots, so the number of tiles grows with the perimeter of
+ * the region instead of its area. `PrefetchTilesRequest` expands such tiles
+ * down to its minimum level, so the compact cover can be prefetched with the
+ * minimum and maximum levels set to the level of the cover.
+ *
+ * The tiling scheme must outlive the cover and its iterators.
+ */
+class CORE_API TileCover {
+ public:
+  /// The relation of a tile to the covered region.
+  enum class Coverage {
+    kNone,     ///< The tile is outside of the region.
+    kPartial,  ///< The tile intersects the border of the region.
+    kFull      ///< The tile is inside of the region.
+  };
+
+  /**
+   * @brief Gets the relation of a tile to the covered region.
+   *
+   * The function can be conservative and return `kPartial` for the tiles
+   * that are inside or outside of the region.
+   */
+  using CoverageFunction = std::function<Coverage(const TileKey& tile_key)>;
+
+  /// The tile key iterator.
+  class CORE_API Iterator
+      : public std::iterator<std::forward_iterator_tag, TileKey> {
+    friend class TileCover;
+
+   public:
+    /// An alias for the tile key.
+    using ValueType = TileKey;
+
+    /// Creates the end iterator.
+    Iterator() = default;
+
+    /**
+     * @brief Gets the current tile key.
+     *
+     * @return The current tile key.
+     */
+    const ValueType& operator*() const { return tile_key_; }
+
+    /**
+     * @brief Gets a pointer to the current tile key.
+     *
+     * @return The pointer to the current tile key.
+     */
+    const ValueType* operator->() const { return &tile_key_; }
+
+    /**
+     * @brief Iterates to the next tile.
+     *
+     * @return A reference to this.
+     */
+    Iterator& operator++();
+
+    /**
+     * @brief Iterates to the next tile.
+     *
+     * @return The iterator before the increment.
+     */
+    Iterator operator++(int);
+
+    /**
+     * @brief Checks whether the iterators are equal.
+     *
+     * @param other The other iterator.
+     *
+     * @return True if the iterators are equal; false otherwise.
+     */
+    bool operator==(const Iterator& other) const;
+
+    /**
+     * @brief Checks whether the iterators are not equal.
+     *
+     * @param other The other iterator.
+     *
+     * @return True if the iterators are not equal; false otherwise.
+     */
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    struct Frame {
+      TileKey tile_key;
+      std::uint32_t next_child{0};
+      std::uint32_t child_count{0};
+      std::uint32_t columns{0};
+      bool is_full{false};
+    };
+
+    explicit Iterator(const TileCover& cover);
+
+    void Push(const TileKey& tile_key, bool is_full);
+    void Advance();
+
+    const TileCover* cover_{nullptr};
+    std::array<Frame, TileKey::LevelCount> stack_;
+    std::uint32_t depth_{0};
+    TileKey tile_key_;
+  };
+
+  /// An alias for the iterator.
+  using ConstIterator = Iterator;
+
+  /**
+   * @brief Creates a `TileCover` instance.
+   *
+   * @param tiling_scheme The tiling scheme.
+   * @param level The level of the tiles.
+   * @param coverage The relation of the tiles to the covered region.
+   */
+  TileCover(const ITilingScheme& tiling_scheme, std::uint32_t level,
+            CoverageFunction coverage);
+
+  /**
+   * @brief Creates a cover of a geographic rectangle.
+   *
+   * The cover contains the same tiles as
+   * `TileKeyUtils::GeoRectangleToTileKeys`.
+   *
+   * @param tiling_scheme The tiling scheme.
+   * @param geo_rectangle The rectangle.
+   * @param level The level of the tiles.
+   *
+   * @return The cover, which is empty if the rectangle cannot be projected.
+   */
+  static TileCover FromGeoRectangle(const ITilingScheme& tiling_scheme,
+                                    const GeoRectangle& geo_rectangle,
+                                    std::uint32_t level);
+
+  /**
+   * @brief Creates a cover of a polygon.
+   *
+   * The edges of the polygon are straight lines in geographic coordinates,
+   * and the polygon must not cross the antimeridian.
+   *
+   * @param tiling_scheme The tiling scheme.
+   * @param polygon The vertices of the polygon. The polygon is closed
+   * implicitly.
+   * @param level The level of the tiles.
+   *
+   * @return The cover, which is empty if the polygon has less than three
+   * vertices.
+   */
+  static TileCover FromPolygon(const ITilingScheme& tiling_scheme,
+                               std::vector<GeoCoordinates> polygon,
+                               std::uint32_t level);
+
+  /**
+   * @brief Creates a cover of a corridor along a path, for example, a route.
+   *
+   * The distances are approximated on a sphere with the equatorial radius of
+   * the Earth, and the path must not cross the antimeridian.
+   *
+   * @param tiling_scheme The tiling scheme.
+   * @param path The points of the path.
+   * @param radius The distance from the path in meters.
+   * @param level The level of the tiles.
+   *
+   * @return The cover, which is empty if the path has no points.
+   */
+  static TileCover FromCorridor(const ITilingScheme& tiling_scheme,
+                                std::vector<GeoCoordinates> path,
+                                double radius, std::uint32_t level);
+
+  /**
+   * @brief Gets the compact version of this cover.
+   *
+   * @return The cover that contains the roots of the fully covered subtrees
+   * instead of their tiles.
+   */
+  TileCover Compact() const;
+
+  /// Checks whether this cover is compact.
+  bool IsCompact() const { return compact_; }
+
+  /// Gets the level of the tiles.
+  std::uint32_t GetLevel() const { return level_; }
+
+  /// Returns an iterator to the beginning.
+  ConstIterator begin() const;
+  /// Returns an iterator to the end.
+  ConstIterator end() const;
+
+  /// Returns a constant iterator to the beginning.
+  ConstIterator cbegin() const { return begin(); }
+  /// Returns a constant iterator to the end.
+  ConstIterator cend() const { return end(); }
+
+  /**
+   * @brief Collects the tiles of the cover.
+   *
+   * @return The tile keys in the Morton order.
+   */
+  std::vector<TileKey> ToTileKeys() const;
+
+ private:
+  const ITilingScheme* tiling_scheme_;
+  std::uint32_t level_;
+  CoverageFunction coverage_;
+  bool compact_{false};
+};
+
+}  // namespace geo
+}  // namespace olp
@@ -20,6 +20,8 @@
 #pragma once
 
 #include <bitset>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include <boost/optional.hpp>
@@ -63,6 +65,8 @@ class CORE_API TileKey {
  public:
   enum { LevelCount = 32 };
   enum { MaxLevel = LevelCount - 1 };
+  /// The maximum length of a HERE tile code string.
+  enum { HereTileMaxLength = 20 };
 
   /**
    * @brief The main direction used to find a child node or 
@@ -150,6 +154,21 @@ class CORE_API TileKey {
    */
   std::string ToHereTile() const;
 
+  /**
+   * @brief Writes the HERE tile code string of the tile key to a buffer.
+   *
+   * Does not allocate memory and does not write the terminating null
+   * character, as `std::to_chars`.
+   *
+   * @param first The beginning of the buffer.
+   * @param last The end of the buffer. A buffer of `HereTileMaxLength`
+   * characters is always large enough.
+   *
+   * @return The pointer past the last written character, or `nullptr` if
+   * the buffer is too small.
+   */
+  char* ToHereTile(char* first, char* last) const;
+
   /**
    * @brief Creates a tile key from a HERE tile code string.
    *
@@ -157,6 +176,15 @@ class CORE_API TileKey {
    */
   static TileKey FromHereTile(const std::string& key);
 
+  /**
+   * @brief Creates a tile key from a HERE tile code string that is not
+   * null-terminated.
+   *
+   * @param first The beginning of the string.
+   * @param last The end of the string.
+   */
+  static TileKey FromHereTile(const char* first, const char* last);
+
   /**
    * @brief Creates a 64-bit Morton code from a tile key.
    *
@@ -171,6 +199,28 @@ class CORE_API TileKey {
    */
   static TileKey FromQuadKey64(std::uint64_t quad_key);
 
+  /**
+   * @brief Creates 64-bit Morton codes from tile keys.
+   *
+   * Converting tile keys in batches is faster than one by one.
+   *
+   * @param tile_keys The tile keys.
+   * @param count The number of tile keys.
+   * @param quad_keys The output array of `count` Morton codes.
+   */
+  static void ToQuadKeys64(const TileKey* tile_keys, size_t count,
+                           std::uint64_t* quad_keys);
+
+  /**
+   * @brief Creates tile keys from 64-bit Morton codes.
+   *
+   * @param quad_keys The Morton codes.
+   * @param count The number of Morton codes.
+   * @param tile_keys The output array of `count` tile keys.
+   */
+  static void FromQuadKeys64(const std::uint64_t* quad_keys, size_t count,
+                             TileKey* tile_keys);
+
   /**
    * @brief Creates a tile key.
    *
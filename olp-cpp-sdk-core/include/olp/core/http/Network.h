@@ -25,6 +25,7 @@
 #include <string>
 
 #include <olp/core/CoreApi.h>
+#include <olp/core/http/NetworkMetrics.h>
 #include <olp/core/http/NetworkRequest.h>
 #include <olp/core/http/NetworkResponse.h>
 #include <olp/core/http/NetworkTypes.h>
@@ -145,6 +146,29 @@ class CORE_API Network {
    * @return The statistic for the requested bucket.
    */
   virtual Statistics GetStatistics(uint8_t bucket_id = 0);
+
+  /**
+   * @brief Enables or disables the per-host latency metrics.
+   *
+   * The metrics are disabled by default. While they are disabled, only
+   * the bucket statistics are collected.
+   *
+   * @param[in] enabled True to enable the metrics; false to disable them.
+   */
+  virtual void SetMetricsEnabled(bool enabled);
+
+  /**
+   * @brief Gets the per-host latency metrics for a bucket.
+   *
+   * The metrics include the requests that completed while the metrics
+   * were enabled. The latencies are available only if the network
+   * implementation reports the timings of the requests.
+   *
+   * @param[in] bucket_id The bucket ID.
+   *
+   * @return A snapshot of the metrics for each host and status class.
+   */
+  virtual NetworkMetrics GetMetrics(uint8_t bucket_id = 0);
 };
 
 /**
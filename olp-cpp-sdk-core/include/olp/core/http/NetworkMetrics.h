@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <olp/core/CoreApi.h>
+
+namespace olp {
+namespace http {
+
+/**
+ * @brief The durations of the phases of a network request.
+ *
+ * All durations are in microseconds and measured from the start of
+ * the request. A zero `total` means that the network implementation
+ * does not provide the timings.
+ */
+struct CORE_API NetworkTimings {
+  /// The time until the host name was resolved.
+  std::uint64_t name_lookup{0u};
+  /// The time until the TCP connection was established.
+  std::uint64_t connect{0u};
+  /// The time until the TLS handshake was completed.
+  std::uint64_t tls_handshake{0u};
+  /// The time until the first byte of the response was received.
+  std::uint64_t time_to_first_byte{0u};
+  /// The total time of the request.
+  std::uint64_t total{0u};
+  /// True if the request opened a new connection instead of reusing one.
+  bool new_connection{false};
+};
+
+/**
+ * @brief A snapshot of a latency distribution.
+ *
+ * Values are grouped in log-linear buckets as in HDR histograms: every
+ * power of two is split into `kSubBucketCount` linear buckets, so each
+ * bucket is at most 12.5% wide relative to its values. Values above
+ * `kMaxTrackableValue` are counted in the last bucket.
+ */
+class CORE_API LatencyHistogram final {
+ public:
+  /// The number of linear buckets in each power of two.
+  static constexpr std::size_t kSubBucketCount = 8u;
+  /// The number of buckets.
+  static constexpr std::size_t kBucketCount = 200u;
+  /// The largest value with an exact bucket, about 134 seconds.
+  static constexpr std::uint64_t kMaxTrackableValue = (1ull << 27) - 1u;
+
+  /// A bucket as its inclusive upper bound and the number of values.
+  using Bucket = std::pair<std::uint64_t, std::uint64_t>;
+
+  LatencyHistogram() = default;
+
+  /**
+   * @brief Creates the `LatencyHistogram` instance from bucket counts.
+   *
+   * @param counts The number of values in each bucket.
+   * @param sum The sum of all values.
+   * @param max The largest value.
+   */
+  LatencyHistogram(std::vector<std::uint64_t> counts, std::uint64_t sum,
+                   std::uint64_t max);
+
+  /**
+   * @brief Gets the index of the bucket that counts the value.
+   *
+   * @param value The value.
+   *
+   * @return The bucket index.
+   */
+  static std::size_t GetBucketIndex(std::uint64_t value);
+
+  /**
+   * @brief Gets the largest value that is counted in the bucket.
+   *
+   * @param index The bucket index.
+   *
+   * @return The inclusive upper bound of the bucket.
+   */
+  static std::uint64_t GetBucketUpperBound(std::size_t index);
+
+  /**
+   * @brief Adds a value to the histogram.
+   *
+   * @param value The value.
+   */
+  void Record(std::uint64_t value);
+
+  /// Gets the number of values.
+  std::uint64_t GetCount() const { return count_; }
+
+  /// Gets the sum of all values.
+  std::uint64_t GetSum() const { return sum_; }
+
+  /// Gets the largest value.
+  std::uint64_t GetMax() const { return max_; }
+
+  /// Gets the mean of all values, or zero if the histogram is empty.
+  double GetMean() const;
+
+  /**
+   * @brief Gets the value at the percentile.
+   *
+   * @param percentile The percentile from 0 to 100.
+   *
+   * @return The upper bound of the bucket that contains the percentile,
+   * limited by the largest value, or zero if the histogram is empty.
+   */
+  std::uint64_t GetPercentile(double percentile) const;
+
+  /**
+   * @brief Gets the non-empty buckets in ascending order.
+   *
+   * Exporters can use the buckets to build cumulative histograms.
+   *
+   * @return The upper bounds and counts of the non-empty buckets.
+   */
+  std::vector<Bucket> GetBuckets() const;
+
+  /**
+   * @brief Adds the values of another histogram to this histogram.
+   *
+   * @param other The other histogram.
+   *
+   * @return A reference to *this.
+   */
+  LatencyHistogram& operator+=(const LatencyHistogram& other);
+
+ private:
+  std::vector<std::uint64_t> counts_;
+  std::uint64_t count_{0u};
+  std::uint64_t sum_{0u};
+  std::uint64_t max_{0u};
+};
+
+/**
+ * @brief The metrics of the requests to a host that completed with
+ * the same status class.
+ */
+struct CORE_API HostMetrics {
+  /// The host name, including the port if it is specified in the URL.
+  std::string host;
+  /// The first digit of the HTTP status, or 0 if the request failed
+  /// without an HTTP status.
+  int status_class{0};
+  /// The number of requests.
+  std::uint64_t requests{0u};
+  /// The total bytes downloaded, including the size of headers and payload.
+  std::uint64_t bytes_downloaded{0u};
+  /// The total bytes uploaded, including the size of headers and payload.
+  std::uint64_t bytes_uploaded{0u};
+  /// The name lookup times of the requests that opened a connection.
+  LatencyHistogram name_lookup;
+  /// The connect times of the requests that opened a connection.
+  LatencyHistogram connect;
+  /// The TLS handshake times of the requests that opened a TLS connection.
+  LatencyHistogram tls_handshake;
+  /// The times to the first byte of the response.
+  LatencyHistogram time_to_first_byte;
+  /// The total times of the requests.
+  LatencyHistogram total;
+};
+
+/// The per-host metrics of a statistics bucket.
+using NetworkMetrics = std::vector<HostMetrics>;
+
+}  // namespace http
+}  // namespace olp
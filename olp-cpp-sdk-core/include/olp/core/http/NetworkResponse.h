@@ -22,6 +22,7 @@
 #include <string>
 
 #include <olp/core/CoreApi.h>
+#include <olp/core/http/NetworkMetrics.h>
 #include <olp/core/http/NetworkTypes.h>
 
 namespace olp {
@@ -126,6 +127,24 @@ class CORE_API NetworkResponse final {
    */
   NetworkResponse& WithBytesDownloaded(uint64_t bytes_downloaded);
 
+  /**
+   * @brief Gets the durations of the phases of the associated network
+   * request.
+   *
+   * @return The timings of the request.
+   */
+  const NetworkTimings& GetTimings() const;
+
+  /**
+   * @brief Sets the durations of the phases of the associated network
+   * request.
+   *
+   * @param[in] timings The timings of the request.
+   *
+   * @return A reference to *this.
+   */
+  NetworkResponse& WithTimings(const NetworkTimings& timings);
+
  private:
   /// The associated request ID.
   RequestId request_id_{0};
@@ -137,6 +156,8 @@ class CORE_API NetworkResponse final {
   uint64_t bytes_uploaded_;
   /// The number of bytes downloaded during the network request.
   uint64_t bytes_downloaded_;
+  /// The durations of the phases of the network request.
+  NetworkTimings timings_;
 };
 
 }  // namespace http
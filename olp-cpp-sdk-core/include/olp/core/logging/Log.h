@@ -528,6 +528,19 @@ class CORE_API Log {
    */
   static bool isEnabled(Level level, const std::string& tag);
 
+  /**
+   * @brief Checks whether a log tag is enabled for a level.
+   *
+   * Unlike the `std::string` overload, does not allocate memory when no
+   * tag-specific levels are set.
+   *
+   * @param tag The tag for the log component.
+   * @param level The log level.
+   *
+   * @return True if the log is enabled; false otherwise.
+   */
+  static bool isEnabled(Level level, const char* tag);
+
   /**
    * @brief Logs a message to the registered appenders.
    *
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+
+#include <olp/core/CoreApi.h>
+#include <olp/core/tracing/Tracer.h>
+
+namespace olp {
+namespace tracing {
+
+/**
+ * @brief A tracer that keeps the spans in memory and writes them in
+ * the Chrome trace event format.
+ *
+ * The output can be opened in `chrome://tracing` or Perfetto to profile
+ * a workload offline.
+ *
+ * @code
+ * auto recorder = std::make_shared<tracing::ChromeTraceRecorder>();
+ * tracing::SetTracer(recorder);
+ * // Run the workload.
+ * tracing::SetTracer(nullptr);
+ * std::ofstream file("trace.json");
+ * recorder->Write(file);
+ * @endcode
+ */
+class CORE_API ChromeTraceRecorder final : public Tracer {
+ public:
+  /// The default limit of the recorded spans.
+  static constexpr std::size_t kDefaultMaxEvents = 1000000u;
+
+  /**
+   * @brief Creates the `ChromeTraceRecorder` instance.
+   *
+   * @param max_events The maximum number of completed spans to keep. Later
+   * spans are dropped.
+   */
+  explicit ChromeTraceRecorder(std::size_t max_events = kDefaultMaxEvents);
+
+  ~ChromeTraceRecorder() override;
+
+  SpanId BeginSpan(const char* name, const SpanAttributes& attributes) override;
+
+  void EndSpan(SpanId id) override;
+
+  /**
+   * @brief Writes the completed spans as a JSON trace.
+   *
+   * The spans that are not ended yet are not written.
+   *
+   * @param stream The output stream.
+   */
+  void Write(std::ostream& stream) const;
+
+  /**
+   * @brief Gets the number of completed spans.
+   *
+   * @return The number of spans that can be written.
+   */
+  std::size_t GetEventCount() const;
+
+  /// Removes the completed spans.
+  void Clear();
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace tracing
+}  // namespace olp
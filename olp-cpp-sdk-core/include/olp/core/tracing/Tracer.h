@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <olp/core/CoreApi.h>
+
+namespace olp {
+/// Traces the operations of the SDK.
+namespace tracing {
+
+/**
+ * @brief The context of a traced operation.
+ */
+class CORE_API SpanAttributes final {
+ public:
+  /**
+   * @brief Gets the ID of the request that the operation belongs to.
+   *
+   * The SDK uses the key under which concurrent identical requests are
+   * merged, so the spans of one request can be correlated.
+   *
+   * @return The request ID.
+   */
+  const std::string& GetRequestId() const { return request_id_; }
+
+  /**
+   * @brief Sets the ID of the request that the operation belongs to.
+   *
+   * @param request_id The request ID.
+   *
+   * @return A reference to the updated `SpanAttributes` instance.
+   */
+  SpanAttributes& WithRequestId(std::string request_id) {
+    request_id_ = std::move(request_id);
+    return *this;
+  }
+
+  /**
+   * @brief Gets the HRN of the catalog.
+   *
+   * @return The catalog HRN string.
+   */
+  const std::string& GetCatalog() const { return catalog_; }
+
+  /**
+   * @brief Sets the HRN of the catalog.
+   *
+   * @param catalog The catalog HRN string.
+   *
+   * @return A reference to the updated `SpanAttributes` instance.
+   */
+  SpanAttributes& WithCatalog(std::string catalog) {
+    catalog_ = std::move(catalog);
+    return *this;
+  }
+
+  /**
+   * @brief Gets the layer ID.
+   *
+   * @return The layer ID.
+   */
+  const std::string& GetLayer() const { return layer_; }
+
+  /**
+   * @brief Sets the layer ID.
+   *
+   * @param layer The layer ID.
+   *
+   * @return A reference to the updated `SpanAttributes` instance.
+   */
+  SpanAttributes& WithLayer(std::string layer) {
+    layer_ = std::move(layer);
+    return *this;
+  }
+
+  /**
+   * @brief Gets the partition ID, tile key or data handle.
+   *
+   * @return The partition.
+   */
+  const std::string& GetPartition() const { return partition_; }
+
+  /**
+   * @brief Sets the partition ID, tile key or data handle.
+   *
+   * @param partition The partition.
+   *
+   * @return A reference to the updated `SpanAttributes` instance.
+   */
+  SpanAttributes& WithPartition(std::string partition) {
+    partition_ = std::move(partition);
+    return *this;
+  }
+
+  /**
+   * @brief Gets the operation specific details, for example, the URL path
+   * or the cache key.
+   *
+   * @return The details.
+   */
+  const std::string& GetDetails() const { return details_; }
+
+  /**
+   * @brief Sets the operation specific details.
+   *
+   * @param details The details.
+   *
+   * @return A reference to the updated `SpanAttributes` instance.
+   */
+  SpanAttributes& WithDetails(std::string details) {
+    details_ = std::move(details);
+    return *this;
+  }
+
+ private:
+  std::string request_id_;
+  std::string catalog_;
+  std::string layer_;
+  std::string partition_;
+  std::string details_;
+};
+
+/**
+ * @brief An interface for receiving the spans of the SDK operations.
+ *
+ * The methods are called from the threads that run the operations, so
+ * implementations must be thread-safe and fast.
+ */
+class CORE_API Tracer {
+ public:
+  /// The identifier of a span within the tracer.
+  using SpanId = std::uint64_t;
+
+  virtual ~Tracer() = default;
+
+  /**
+   * @brief Called when an operation starts.
+   *
+   * @param name The name of the operation.
+   * @param attributes The context of the operation.
+   *
+   * @return The ID that is passed to `EndSpan` when the operation ends.
+   */
+  virtual SpanId BeginSpan(const char* name,
+                           const SpanAttributes& attributes) = 0;
+
+  /**
+   * @brief Called when an operation ends.
+   *
+   * The call can happen on a thread different from the one that began the
+   * span.
+   *
+   * @param id The ID returned by `BeginSpan`.
+   */
+  virtual void EndSpan(SpanId id) = 0;
+};
+
+/**
+ * @brief Sets the tracer that receives the spans of all SDK operations.
+ *
+ * @param tracer The tracer, or nullptr to disable tracing.
+ */
+CORE_API void SetTracer(std::shared_ptr<Tracer> tracer);
+
+/**
+ * @brief Gets the current tracer.
+ *
+ * @return The tracer, or nullptr if tracing is disabled.
+ */
+CORE_API std::shared_ptr<Tracer> GetTracer();
+
+/**
+ * @brief Checks whether a tracer is set.
+ *
+ * @return True if tracing is enabled; false otherwise.
+ */
+CORE_API bool IsTracingEnabled();
+
+/**
+ * @brief Traces an operation from construction to destruction or `End`.
+ *
+ * The attributes are built only if tracing is enabled, so a disabled
+ * span costs one atomic load.
+ *
+ * @code
+ * tracing::Span span("Repository::Get", [&] {
+ *   return tracing::SpanAttributes().WithLayer(layer);
+ * });
+ * @endcode
+ */
+class CORE_API Span final {
+ public:
+  /// Creates an inactive span.
+  Span() = default;
+
+  /**
+   * @brief Begins the span if tracing is enabled.
+   *
+   * @param name The name of the operation. It must outlive the span.
+   * @param make_attributes The function that returns the `SpanAttributes`.
+   */
+  template <typename MakeAttributes>
+  Span(const char* name, MakeAttributes make_attributes) {
+    if (IsTracingEnabled()) {
+      Begin(name, make_attributes());
+    }
+  }
+
+  /**
+   * @brief Begins the span without attributes if tracing is enabled.
+   *
+   * @param name The name of the operation. It must outlive the span.
+   */
+  explicit Span(const char* name);
+
+  ~Span();
+
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+  Span(Span&& other) noexcept;
+  Span& operator=(Span&& other) noexcept;
+
+  /// Ends the span. Further calls have no effect.
+  void End();
+
+ private:
+  void Begin(const char* name, const SpanAttributes& attributes);
+
+  std::shared_ptr<Tracer> tracer_;
+  Tracer::SpanId id_{0u};
+};
+
+}  // namespace tracing
+}  // namespace olp
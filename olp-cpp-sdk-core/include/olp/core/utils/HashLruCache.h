@@ -0,0 +1,760 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <olp/core/utils/LruCache.h>
+
+namespace olp {
+namespace utils {
+/**
+ * @brief A key-value LRU cache indexed by an open-addressing hash table.
+ *
+ * It provides the same interface as `LruCache`, but finds the keys in
+ * constant time and allocates the items from a pool in chunks, so
+ * an item does not need a separate allocation. It suits large caches,
+ * for example, the index of all keys stored on disk.
+ *
+ * @note The iteration follows the LRU order, not the key order.
+ *
+ * @tparam Key The `HashLruCache` key type.
+ * @tparam Value The `HashLruCache` value type.
+ * @tparam CacheCostFunc The cache cost functor.
+ * The specializations should return a non-zero value for any given object.
+ * The default implementation returns "1" as the size for each object.
+ * @tparam Hash The hash function of the keys.
+ * @tparam KeyEqual The function that checks whether two keys are equal.
+ */
+template <typename Key, typename Value,
+          typename CacheCostFunc = CacheCost<Value>,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class HashLruCache {
+  using Index = std::uint32_t;
+  static constexpr Index kNone = 0xFFFFFFFFu;
+  // The number of items allocated at once.
+  static constexpr std::size_t kChunkSize = 1024u;
+
+  struct Entry {
+    template <typename _Key, typename _Value>
+    Entry(_Key&& key, _Value&& value)
+        : key_(std::forward<_Key>(key)), value_(std::forward<_Value>(value)) {}
+
+    Key key_;
+    Value value_;
+  };
+
+  // An item of the pool. The entry is constructed only while the item is
+  // used; a free item links the next free item.
+  struct Node {
+    typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type entry_;
+    Index previous_;
+    Index next_;
+    std::uint32_t hash_;
+
+    Entry& entry() { return *reinterpret_cast<Entry*>(&entry_); }
+    const Entry& entry() const {
+      return *reinterpret_cast<const Entry*>(&entry_);
+    }
+  };
+
+  // A slot of the hash table. The hash is kept to skip the key comparison
+  // and to move the slots without hashing the keys again.
+  struct Slot {
+    Index node_;
+    std::uint32_t hash_;
+  };
+
+ public:
+  /// An alias for the eviction function.
+  using EvictionFunction = std::function<void(const Key&, Value&&)>;
+
+  /**
+   * @brief A type of objects to be stored.
+   *
+   * Each object is defined by a key-value pair.
+   */
+  class ValueType {
+   public:
+    /**
+     * @brief Gets the key of the `ValueType` object.
+     *
+     * @return The key of the `ValueType` object.
+     */
+    const Key& key() const { return cache_->GetNode(index_).entry().key_; }
+
+    /**
+     * @brief Gets the value of the `ValueType` object.
+     *
+     * @return The value of the `ValueType` object.
+     */
+    const Value& value() const {
+      return cache_->GetNode(index_).entry().value_;
+    }
+
+   protected:
+    /// The cache that owns the item.
+    const HashLruCache* cache_{nullptr};
+    /// The index of the item in the pool.
+    Index index_{kNone};
+  };
+
+  /// A constant iterator of the `HashLruCache` object.
+  class const_iterator : public ValueType {
+   public:
+    /// A typedef for the iterator category.
+    typedef std::bidirectional_iterator_tag iterator_category;
+    /// A typedef for the difference type.
+    typedef std::ptrdiff_t difference_type;
+    /// A typedef for the `ValueType` type.
+    typedef ValueType value_type;
+    /// A typedef for the `ValueType` constant reference.
+    typedef const value_type& reference;
+    /// A typedef for the `ValueType` constant pointer.
+    typedef const value_type* pointer;
+
+    /// Creates a constant iterator object.
+    const_iterator() = default;
+
+    /**
+     * @brief Checks whether both iterators point to the same item.
+     *
+     * @param other The `const_iterator` instance.
+     *
+     * @return True if the iterators are the same; false otherwise.
+     */
+    bool operator==(const const_iterator& other) const {
+      return this->index_ == other.index_;
+    }
+
+    /**
+     * @brief Checks whether the iterators point to different items.
+     *
+     * @param other The `const_iterator` instance.
+     *
+     * @return True if the iterators are not the same; false otherwise.
+     */
+    bool operator!=(const const_iterator& other) const {
+      return !operator==(other);
+    }
+
+    /**
+     * @brief Iterates to the next, less recently used item.
+     *
+     * @return A reference to this.
+     */
+    const_iterator& operator++() {
+      this->index_ = this->cache_->GetNode(this->index_).next_;
+      return *this;
+    }
+
+    /**
+     * @brief Iterates to the next, less recently used item.
+     *
+     * @return The iterator before the increment.
+     */
+    const_iterator operator++(int) {
+      auto result = *this;
+      ++(*this);
+      return result;
+    }
+
+    /**
+     * @brief Iterates to the previous, more recently used item.
+     *
+     * @return A reference to this.
+     */
+    const_iterator& operator--() {
+      this->index_ = this->cache_->GetNode(this->index_).previous_;
+      return *this;
+    }
+
+    /**
+     * @brief Iterates to the previous, more recently used item.
+     *
+     * @return The iterator before the decrement.
+     */
+    const_iterator operator--(int) {
+      auto result = *this;
+      --(*this);
+      return result;
+    }
+
+    /**
+     * @brief Gets a reference to this object.
+     *
+     * @return The reference to this.
+     */
+    reference operator*() const { return *this; }
+
+    /**
+     * @brief Gets a pointer to this object.
+     *
+     * @return The pointer to this.
+     */
+    pointer operator->() const { return this; }
+
+   private:
+    friend class HashLruCache;
+
+    const_iterator(const HashLruCache* cache, Index index) {
+      this->cache_ = cache;
+      this->index_ = index;
+    }
+  };
+
+  /**
+   * @brief Creates a `HashLruCache` instance.
+   *
+   * Creates an invalid `HashLruCache` with the maximum size of `0`
+   * that caches nothing.
+   */
+  HashLruCache() = default;
+
+  /**
+   * @brief Creates a `HashLruCache` instance.
+   *
+   * @param maxSize The maximum size of values this cache can keep.
+   * @param cacheCostFunc The function this cache uses to compute the
+   *        caching cost of each cached value.
+   * @param hash The hash function of the keys.
+   * @param equal The function that checks whether two keys are equal.
+   */
+  explicit HashLruCache(std::size_t maxSize,
+                        CacheCostFunc cacheCostFunc = CacheCostFunc(),
+                        const Hash& hash = Hash(),
+                        const KeyEqual& equal = KeyEqual())
+      : cache_cost_func_(std::move(cacheCostFunc)),
+        hash_(hash),
+        equal_(equal),
+        max_size_(maxSize) {}
+
+  /// The deleted copy constructor.
+  HashLruCache(const HashLruCache&) = delete;
+
+  /// The move constructor.
+  HashLruCache(HashLruCache&& other) noexcept { Swap(other); }
+
+  /// The deleted assignment operator.
+  HashLruCache& operator=(const HashLruCache&) = delete;
+
+  /// The move assignment operator.
+  HashLruCache& operator=(HashLruCache&& other) noexcept {
+    Swap(other);
+    return *this;
+  }
+
+  ~HashLruCache() { DestroyEntries(); }
+
+  /**
+   * @brief Inserts a key-value pair in the cache.
+   *
+   * @note If the key already exists in the cache, it is promoted in the
+   * LRU, but its value and cost are not updated. To update or insert existing
+   * values, use `InsertOrAssign` instead.
+   *
+   * @param key The key to add.
+   * @param value The value to add.
+   *
+   * @return A pair of bool and an iterator, analogously to `LruCache::Insert`.
+   */
+  template <typename _Key, typename _Value>
+  std::pair<const_iterator, bool> Insert(_Key&& key, _Value&& value) {
+    const auto hash = GetHash(key);
+    const auto found = FindSlot(key, hash);
+    if (found != kNone) {
+      const auto index = slots_[found].node_;
+      Promote(index);
+      return std::make_pair(const_iterator{this, index}, false);
+    }
+
+    return Add(std::forward<_Key>(key), std::forward<_Value>(value), hash);
+  }
+
+  /**
+   * @brief Inserts a key-value pair in the cache or updates an existing
+   * key-value pair.
+   *
+   * @note If the key already exists in the cache, its value and cost are
+   * updated. Not to update the existing key-value pair, use `Insert` instead.
+   *
+   * @param key The key to add.
+   * @param value The value to add.
+   *
+   * @return A pair of bool and an iterator, analogously to
+   * `LruCache::InsertOrAssign`.
+   */
+  template <typename _Value>
+  std::pair<const_iterator, bool> InsertOrAssign(Key key, _Value&& value) {
+    const auto hash = GetHash(key);
+    const auto found = FindSlot(key, hash);
+    if (found == kNone) {
+      return Add(std::move(key), std::forward<_Value>(value), hash);
+    }
+
+    const auto index = slots_[found].node_;
+    auto& entry = GetNode(index).entry();
+    const auto old_cost = cache_cost_func_(entry.value_);
+    entry.value_ = std::forward<_Value>(value);
+    size_ += cache_cost_func_(entry.value_) - old_cost;
+    Promote(index);
+    Evict();
+    return std::make_pair(const_iterator{this, index}, false);
+  }
+
+  /**
+   * @brief Removes a key from the cache.
+   *
+   * @param key The key to remove.
+   *
+   * @return True if the key exists and is removed from the cache; false
+   * otherwise.
+   */
+  bool Erase(const Key& key) {
+    const auto slot = FindSlot(key, GetHash(key));
+    if (slot == kNone) {
+      return false;
+    }
+
+    EraseSlot(slot, false);
+    return true;
+  }
+
+  /**
+   * @brief Removes a key from the cache.
+   *
+   * @param it The iterator of the key that should be removed.
+   *
+   * @return A new iterator.
+   */
+  const_iterator Erase(const_iterator& it) {
+    auto prev = it++;
+
+    Erase(prev->key());
+
+    return it;
+  }
+
+  /**
+   * @brief Gets the current size of the cache.
+   *
+   * @return The current cache size.
+   */
+  std::size_t Size() const { return size_; }
+
+  /**
+   * @brief Gets the maximum size of the cache.
+   *
+   * @return The maximum cache size.
+   */
+  std::size_t GetMaxSize() const { return max_size_; }
+
+  /**
+   * @brief Sets the new maximum size of the cache.
+   *
+   * If the new maximum size is smaller than the current size, items are evicted
+   * until the cache shrinks to less than or equal to the new maximum size.
+   *
+   * @param maxSize The new maximum size of the cache.
+   */
+  void Resize(std::size_t maxSize) {
+    max_size_ = maxSize;
+    Evict();
+  }
+
+  /**
+   * @brief Prepares the cache for the number of items.
+   *
+   * Avoids rebuilding the hash table while the cache is populated.
+   *
+   * @param count The expected number of items.
+   */
+  void Reserve(std::size_t count) {
+    std::size_t capacity = kMinCapacity;
+    while (capacity - capacity / 4u < count) {
+      capacity *= 2u;
+    }
+    if (capacity > slots_.size()) {
+      Rehash(capacity);
+    }
+    chunks_.reserve((count + kChunkSize - 1u) / kChunkSize);
+  }
+
+  /**
+   * @brief Finds a value in the cache.
+   *
+   * @note This function promotes the item pointed to by a key if found.
+   *
+   * @param key The key to find.
+   *
+   * @return If found, the iterator to the value; the iterator pointing
+   * to `end()` otherwise.
+   */
+  const_iterator Find(const Key& key) {
+    const auto slot = FindSlot(key, GetHash(key));
+    if (slot == kNone) {
+      return end();
+    }
+
+    const auto index = slots_[slot].node_;
+    Promote(index);
+    return const_iterator{this, index};
+  }
+
+  /**
+   * @brief Finds a value in the cache.
+   *
+   * @note This function does NOT promote the item pointed to by a key if
+   * found.
+   *
+   * @param key The key to find.
+   *
+   * @return If found, the iterator to the value; the iterator pointing
+   * to `end()` otherwise.
+   */
+  const_iterator FindNoPromote(const Key& key) const {
+    const auto slot = FindSlot(key, GetHash(key));
+    return const_iterator{this, slot == kNone ? kNone : slots_[slot].node_};
+  }
+
+  /**
+   * @brief Finds a value in the cache.
+   *
+   * @note This function promotes the item pointed to by a key if found.
+   *
+   * @param key The key to find.
+   * @param nullValue The value to return if the key-value pair is not in the
+   * cache
+   * @return If found, a constant reference to the value; `nullValue` otherwise.
+   */
+  const Value& Find(const Key& key, const Value& nullValue) {
+    auto it = Find(key);
+    return it == end() ? nullValue : it.value();
+  }
+
+  /// Returns a constant iterator to the most recently used item.
+  const_iterator begin() const { return const_iterator{this, first_}; }
+
+  /// Returns a constant iterator to the end.
+  const_iterator end() const { return const_iterator{this, kNone}; }
+
+  /// Returns a constant iterator to the least recently used item.
+  const_iterator rbegin() const { return const_iterator{this, last_}; }
+
+  /// Returns a reverse constant iterator to the end.
+  const_iterator rend() const { return const_iterator{this, kNone}; }
+
+  /**
+   * @brief Removes all items from the cache.
+   *
+   * Removes all content and releases the memory, but does not reset
+   * the eviction callback or maximum size.
+   */
+  void Clear() {
+    DestroyEntries();
+    std::vector<std::unique_ptr<Node[]>>().swap(chunks_);
+    std::vector<Slot>().swap(slots_);
+    first_ = last_ = free_ = kNone;
+    used_nodes_ = 0u;
+    count_ = 0u;
+    size_ = 0u;
+  }
+
+  /**
+   * @brief Sets a function that is invoked when a value is
+   * evicted from the cache.
+   *
+   * @note The function must not modify the cache in the
+   * callback. The value can be safely moved. If not, it is destroyed when
+   * the function returns.
+   *
+   * To reset the eviction callback, pass `nullptr`.
+   *
+   * @param func The function to be called on eviction.
+   */
+  void SetEvictionCallback(EvictionFunction func) {
+    eviction_callback_ = std::move(func);
+  }
+
+ private:
+  static constexpr std::size_t kMinCapacity = 16u;
+
+  Node& GetNode(Index index) {
+    return chunks_[index / kChunkSize][index % kChunkSize];
+  }
+
+  const Node& GetNode(Index index) const {
+    return chunks_[index / kChunkSize][index % kChunkSize];
+  }
+
+  std::uint32_t GetHash(const Key& key) const {
+    // Mixes the bits, since the standard hashes of integers are identities.
+    const auto hash =
+        static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::uint32_t>(hash >> 32);
+  }
+
+  std::size_t GetMask() const { return slots_.size() - 1u; }
+
+  // Returns the position of the slot that holds the key, or kNone.
+  Index FindSlot(const Key& key, std::uint32_t hash) const {
+    if (slots_.empty()) {
+      return kNone;
+    }
+
+    const auto mask = GetMask();
+    for (auto pos = hash & mask;; pos = (pos + 1u) & mask) {
+      const auto& slot = slots_[pos];
+      if (slot.node_ == kNone) {
+        return kNone;
+      }
+      if (slot.hash_ == hash &&
+          equal_(GetNode(slot.node_).entry().key_, key)) {
+        return static_cast<Index>(pos);
+      }
+    }
+  }
+
+  void InsertSlot(Index index, std::uint32_t hash) {
+    const auto mask = GetMask();
+    auto pos = hash & mask;
+    while (slots_[pos].node_ != kNone) {
+      pos = (pos + 1u) & mask;
+    }
+    slots_[pos] = Slot{index, hash};
+  }
+
+  // Removes the slot and shifts the following slots of the probe sequence
+  // back, so the lookups do not need tombstones.
+  void RemoveSlot(std::size_t pos) {
+    const auto mask = GetMask();
+    auto next = pos;
+    while (true) {
+      next = (next + 1u) & mask;
+      const auto& slot = slots_[next];
+      if (slot.node_ == kNone) {
+        break;
+      }
+
+      // The slot stays if its home position is cyclically in (pos, next].
+      const auto home = slot.hash_ & mask;
+      const bool stays = pos <= next ? (pos < home && home <= next)
+                                     : (pos < home || home <= next);
+      if (!stays) {
+        slots_[pos] = slot;
+        pos = next;
+      }
+    }
+    slots_[pos] = Slot{kNone, 0u};
+  }
+
+  void Rehash(std::size_t capacity) {
+    std::vector<Slot> slots(capacity, Slot{kNone, 0u});
+    slots_.swap(slots);
+    for (const auto& slot : slots) {
+      if (slot.node_ != kNone) {
+        InsertSlot(slot.node_, slot.hash_);
+      }
+    }
+  }
+
+  Index AllocateNode() {
+    if (free_ != kNone) {
+      const auto index = free_;
+      free_ = GetNode(index).next_;
+      return index;
+    }
+
+    if (used_nodes_ == chunks_.size() * kChunkSize) {
+      chunks_.emplace_back(new Node[kChunkSize]);
+    }
+    return static_cast<Index>(used_nodes_++);
+  }
+
+  void FreeNode(Index index) {
+    GetNode(index).next_ = free_;
+    free_ = index;
+  }
+
+  template <typename _Key, typename _Value>
+  std::pair<const_iterator, bool> Add(_Key&& key, _Value&& value,
+                                      std::uint32_t hash) {
+    const auto index = AllocateNode();
+    auto& node = GetNode(index);
+    new (&node.entry_)
+        Entry(std::forward<_Key>(key), std::forward<_Value>(value));
+
+    // If the item is too large, do not insert it.
+    const auto cost = cache_cost_func_(node.entry().value_);
+    if (cost > max_size_) {
+      node.entry().~Entry();
+      FreeNode(index);
+      return std::make_pair(end(), false);
+    }
+
+    if (count_ + 1u > slots_.size() - slots_.size() / 4u) {
+      Rehash(slots_.empty() ? kMinCapacity : slots_.size() * 2u);
+    }
+
+    node.hash_ = hash;
+    InsertSlot(index, hash);
+    ++count_;
+    LinkFirst(index);
+    size_ += cost;
+    Evict();
+    return std::make_pair(const_iterator{this, index}, true);
+  }
+
+  void EraseSlot(std::size_t pos, bool doEvictionCallback) {
+    const auto index = slots_[pos].node_;
+    auto& entry = GetNode(index).entry();
+    const auto cost = cache_cost_func_(entry.value_);
+
+    Unlink(index);
+    RemoveSlot(pos);
+    --count_;
+
+    if (doEvictionCallback && eviction_callback_) {
+      eviction_callback_(entry.key_, std::move(entry.value_));
+    }
+
+    entry.~Entry();
+    FreeNode(index);
+    size_ -= cost;
+  }
+
+  // Finds the slot of the item by its position in the pool.
+  std::size_t GetSlotOf(Index index) const {
+    const auto mask = GetMask();
+    auto pos = GetNode(index).hash_ & mask;
+    while (slots_[pos].node_ != index) {
+      pos = (pos + 1u) & mask;
+    }
+    return pos;
+  }
+
+  void LinkFirst(Index index) {
+    auto& node = GetNode(index);
+    node.previous_ = kNone;
+    node.next_ = first_;
+    if (first_ != kNone) {
+      GetNode(first_).previous_ = index;
+    } else {
+      last_ = index;
+    }
+    first_ = index;
+  }
+
+  void Unlink(Index index) {
+    auto& node = GetNode(index);
+    if (node.previous_ != kNone) {
+      GetNode(node.previous_).next_ = node.next_;
+    } else {
+      first_ = node.next_;
+    }
+
+    if (node.next_ != kNone) {
+      GetNode(node.next_).previous_ = node.previous_;
+    } else {
+      last_ = node.previous_;
+    }
+  }
+
+  void Promote(Index index) {
+    if (index != first_) {
+      Unlink(index);
+      LinkFirst(index);
+    }
+  }
+
+  void Evict() {
+    while (size_ > max_size_ && last_ != kNone) {
+      EraseSlot(GetSlotOf(last_), true);
+    }
+  }
+
+  void DestroyEntries() {
+    for (auto index = first_; index != kNone;) {
+      auto& node = GetNode(index);
+      index = node.next_;
+      node.entry().~Entry();
+    }
+  }
+
+  void Swap(HashLruCache& other) {
+    using std::swap;
+    swap(eviction_callback_, other.eviction_callback_);
+    swap(cache_cost_func_, other.cache_cost_func_);
+    swap(hash_, other.hash_);
+    swap(equal_, other.equal_);
+    swap(chunks_, other.chunks_);
+    swap(slots_, other.slots_);
+    swap(first_, other.first_);
+    swap(last_, other.last_);
+    swap(free_, other.free_);
+    swap(used_nodes_, other.used_nodes_);
+    swap(count_, other.count_);
+    swap(max_size_, other.max_size_);
+    swap(size_, other.size_);
+  }
+
+  EvictionFunction eviction_callback_;
+  CacheCostFunc cache_cost_func_;
+  Hash hash_;
+  KeyEqual equal_;
+  std::vector<std::unique_ptr<Node[]>> chunks_;
+  std::vector<Slot> slots_;
+  Index first_{kNone};
+  Index last_{kNone};
+  Index free_{kNone};
+  std::size_t used_nodes_{0u};
+  std::size_t count_{0u};
+  std::size_t max_size_{0u};
+  std::size_t size_{0u};
+};
+
+template <typename Key, typename Value, typename CacheCostFunc,
+          typename Hash, typename KeyEqual>
+constexpr typename HashLruCache<Key, Value, CacheCostFunc, Hash,
+                                KeyEqual>::Index
+    HashLruCache<Key, Value, CacheCostFunc, Hash, KeyEqual>::kNone;
+
+template <typename Key, typename Value, typename CacheCostFunc,
+          typename Hash, typename KeyEqual>
+constexpr std::size_t
+    HashLruCache<Key, Value, CacheCostFunc, Hash, KeyEqual>::kChunkSize;
+
+template <typename Key, typename Value, typename CacheCostFunc,
+          typename Hash, typename KeyEqual>
+constexpr std::size_t
+    HashLruCache<Key, Value, CacheCostFunc, Hash, KeyEqual>::kMinCapacity;
+
+}  // namespace utils
+}  // namespace olp
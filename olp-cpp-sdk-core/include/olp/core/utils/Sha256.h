@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <olp/core/CoreApi.h>
+
+namespace olp {
+namespace utils {
+
+/**
+ * @brief Computes the SHA-256 hash incrementally.
+ *
+ * The data can be fed in chunks of any size, for example, as they arrive from
+ * the network. On x86 CPUs that support the SHA extensions, the hardware
+ * implementation is selected at runtime; otherwise, the portable
+ * implementation is used.
+ */
+class CORE_API Sha256 {
+ public:
+  /// The length of the SHA-256 digest in bytes.
+  static constexpr size_t kDigestLength = 32;
+
+  /// An alias for the SHA-256 digest.
+  using Digest = std::array<std::uint8_t, kDigestLength>;
+
+  Sha256();
+
+  /**
+   * @brief Appends the data to the hashed message.
+   *
+   * @param data The pointer to the data.
+   * @param size The size of the data in bytes.
+   *
+   * @return A reference to the updated `Sha256` instance.
+   */
+  Sha256& Update(const void* data, size_t size);
+
+  /**
+   * @brief Completes the hash computation.
+   *
+   * The instance is reset afterwards and can be used to hash a new message.
+   *
+   * @return The digest of all the data passed to `Update`.
+   */
+  Digest Finalize();
+
+  /**
+   * @brief Resets the instance to its initial state.
+   */
+  void Reset();
+
+  /**
+   * @brief Computes the SHA-256 hash of the buffer.
+   *
+   * @param data The pointer to the data.
+   * @param size The size of the data in bytes.
+   *
+   * @return The computed digest.
+   */
+  static Digest Compute(const void* data, size_t size);
+
+  /**
+   * @brief Converts the digest to a lowercase hexadecimal string.
+   *
+   * @param digest The digest to convert.
+   *
+   * @return The 64 characters long hexadecimal representation of the digest.
+   */
+  static std::string ToHexString(const Digest& digest);
+
+ private:
+  static constexpr size_t kBlockLength = 64;
+
+  std::array<std::uint32_t, 8> state_;
+  std::array<std::uint8_t, kBlockLength> buffer_;
+  size_t buffer_size_;
+  std::uint64_t total_size_;
+};
+
+}  // namespace utils
+}  // namespace olp
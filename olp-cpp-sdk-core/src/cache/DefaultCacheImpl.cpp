@@ -28,6 +28,7 @@
 
 #include "olp/core/logging/Log.h"
 #include "olp/core/porting/make_unique.h"
+#include "olp/core/tracing/Tracer.h"
 #include "olp/core/utils/Dir.h"
 
 namespace {
@@ -136,6 +137,11 @@ olp::cache::DefaultCache::StorageOpenResult ToStorageOpenResult(
 
   return {};
 }
+
+olp::tracing::Span CacheSpan(const char* name, const std::string& key) {
+  return olp::tracing::Span(
+      name, [&] { return olp::tracing::SpanAttributes().WithDetails(key); });
+}
 }  // namespace
 
 namespace olp {
@@ -258,6 +264,7 @@ void DefaultCacheImpl::Compact() {
 
 bool DefaultCacheImpl::Put(const std::string& key, const boost::any& value,
                            const Encoder& encoder, time_t expiry) {
+  auto span = CacheSpan("DefaultCache::Put", key);
   std::lock_guard<std::mutex> lock(cache_lock_);
   if (!is_open_) {
     return false;
@@ -281,6 +288,8 @@ bool DefaultCacheImpl::Put(const std::string& key, const boost::any& value,
 bool DefaultCacheImpl::Put(const std::string& key,
                            const KeyValueCache::ValueTypePtr value,
                            time_t expiry) {
+  auto span = CacheSpan("DefaultCache::Put", key);
+
   if (!value) {
     return false;
   }
@@ -308,6 +317,7 @@ bool DefaultCacheImpl::Put(const std::string& key,
 
 boost::any DefaultCacheImpl::Get(const std::string& key,
                                  const Decoder& decoder) {
+  auto span = CacheSpan("DefaultCache::Get", key);
   std::lock_guard<std::mutex> lock(cache_lock_);
   if (!is_open_) {
     return boost::any();
@@ -338,20 +348,18 @@ boost::any DefaultCacheImpl::Get(const std::string& key,
 }
 
 KeyValueCache::ValueTypePtr DefaultCacheImpl::Get(const std::string& key) {
+  auto span = CacheSpan("DefaultCache::Get", key);
   std::lock_guard<std::mutex> lock(cache_lock_);
   if (!is_open_) {
     return nullptr;
   }
 
-  if (memory_cache_) {
-    auto value = memory_cache_->Get(key);
-    if (!value.empty()) {
-      PromoteKeyLru(key);
-      return boost::any_cast<KeyValueCache::ValueTypePtr>(value);
-    }
+  KeyValueCache::ValueTypePtr value = nullptr;
+  if (memory_cache_ && memory_cache_->Get(key, value)) {
+    PromoteKeyLru(key);
+    return value;
   }
 
-  KeyValueCache::ValueTypePtr value = nullptr;
   time_t expiry = KeyValueCache::kDefaultExpiry;
 
   auto result = GetFromDiskCache(key, value, expiry);
@@ -367,6 +375,7 @@ KeyValueCache::ValueTypePtr DefaultCacheImpl::Get(const std::string& key) {
 }
 
 bool DefaultCacheImpl::Remove(const std::string& key) {
+  auto span = CacheSpan("DefaultCache::Remove", key);
   std::lock_guard<std::mutex> lock(cache_lock_);
 
   if (!is_open_) {
@@ -400,6 +409,7 @@ bool DefaultCacheImpl::Remove(const std::string& key) {
 }
 
 bool DefaultCacheImpl::RemoveKeysWithPrefix(const std::string& key) {
+  auto span = CacheSpan("DefaultCache::RemoveKeysWithPrefix", key);
   std::lock_guard<std::mutex> lock(cache_lock_);
 
   if (!is_open_) {
@@ -429,6 +439,7 @@ bool DefaultCacheImpl::RemoveKeysWithPrefix(const std::string& key) {
 }
 
 bool DefaultCacheImpl::Contains(const std::string& key) const {
+  auto span = CacheSpan("DefaultCache::Contains", key);
   std::lock_guard<std::mutex> lock(cache_lock_);
   if (!is_open_) {
     return false;
@@ -25,6 +25,7 @@
 #include <string>
 #include <utility>
 
+#include <olp/core/utils/HashLruCache.h>
 #include "DiskCache.h"
 #include "InMemoryCache.h"
 #include "ProtectedKeyList.h"
@@ -78,8 +79,8 @@ class DefaultCacheImpl {
   };
 
   /// The LRU cache definition using the leveldb keys as key and the value size
-  /// as value.
-  using DiskLruCache = utils::LruCache<std::string, ValueProperties>;
+  /// as value. It holds every key on disk, so it is indexed by hash.
+  using DiskLruCache = utils::HashLruCache<std::string, ValueProperties>;
 
   /// Returns LRU mutable cache, used for tests.
   const std::unique_ptr<DiskLruCache>& GetMutableCacheLru() const {
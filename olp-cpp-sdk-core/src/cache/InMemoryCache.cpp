@@ -19,6 +19,8 @@
 
 #include "InMemoryCache.h"
 
+#include <utility>
+
 namespace olp {
 namespace cache {
 namespace {
@@ -29,146 +31,262 @@ inline bool HasExpiry(time_t expiry_seconds) {
 
 InMemoryCache::InMemoryCache(size_t max_size, ModelCacheCostFunc cache_cost,
                              TimeProvider time_provider)
-    : item_tuples_(max_size, std::move(cache_cost)),
-      time_provider_(std::move(time_provider)) {
-  item_tuples_.SetEvictionCallback(
-      [this](const std::string& key, ItemTuple&& value) {
-        OnEviction(key, std::move(value));
-      });
-}
+    : max_size_(max_size),
+      cache_cost_(std::move(cache_cost)),
+      time_provider_(std::move(time_provider)) {}
 
 bool InMemoryCache::Put(const std::string& key, const boost::any& item,
                         time_t expire_seconds, size_t size) {
+  Value value;
+  if (const auto* data = boost::any_cast<KeyValueCache::ValueTypePtr>(&item)) {
+    value.data = *data;
+  } else {
+    value.object = item;
+  }
+
+  return PutValue(key, std::move(value), expire_seconds, size);
+}
+
+bool InMemoryCache::Put(const std::string& key,
+                        KeyValueCache::ValueTypePtr data,
+                        time_t expire_seconds, size_t size) {
+  Value value;
+  value.data = std::move(data);
+  return PutValue(key, std::move(value), expire_seconds, size);
+}
+
+bool InMemoryCache::PutValue(const std::string& key, Value value,
+                             time_t expire_seconds, size_t size) {
   std::lock_guard<std::mutex> lock{mutex_};
 
-  PurgeExpired();
+  const auto now = time_provider_();
+  PurgeExpired(now);
 
-  bool expires = HasExpiry(expire_seconds);
-  if (expires) {
+  if (HasExpiry(expire_seconds)) {
     // can't expire in the past.
     if (expire_seconds <= 0) {
       return false;
     }
-    expire_seconds += time_provider_();
+    expire_seconds += now;
   }
 
-  auto item_tuple = std::make_tuple(key, expire_seconds, item, size);
-  auto ret = item_tuples_.InsertOrAssign(key, item_tuple);
-  if (ret.second && expires) {
-    item_expiries_[expire_seconds].push_back(item_tuple);
+  const auto cost = cache_cost_(value, size);
+  auto it = items_.find(key);
+  if (cost > max_size_) {
+    // The previous value must not outlive the rejected one.
+    if (it != items_.end()) {
+      Erase(it);
+    }
+    return false;
   }
 
-  return ret.second;
+  if (it == items_.end()) {
+    it = items_.emplace(key, Item()).first;
+    it->second.key = &it->first;
+  } else {
+    UnlinkLru(it->second);
+    UnlinkExpiry(it->second);
+    size_ -= it->second.cost;
+  }
+
+  auto& item = it->second;
+  item.value = std::move(value);
+  item.expiry = expire_seconds;
+  item.cost = cost;
+  size_ += cost;
+
+  LinkLru(item);
+  LinkExpiry(item);
+  Evict();
+  return true;
+}
+
+InMemoryCache::Item* InMemoryCache::Find(const std::string& key) {
+  auto it = items_.find(key);
+  if (it == items_.end()) {
+    return nullptr;
+  }
+
+  auto& item = it->second;
+  if (HasExpiry(item.expiry)) {
+    const auto now = time_provider_();
+    if (item.expiry < now) {
+      PurgeExpired(now);
+      return nullptr;
+    }
+  }
+
+  if (lru_first_ != &item) {
+    UnlinkLru(item);
+    LinkLru(item);
+  }
+  return &item;
 }
 
 boost::any InMemoryCache::Get(const std::string& key) {
   std::lock_guard<std::mutex> lock{mutex_};
-  auto it = item_tuples_.Find(key);
-  if (it != item_tuples_.end()) {
-    auto expiry_time = std::get<1>(it.value());
-    if (expiry_time < time_provider_()) {
-      PurgeExpired(expiry_time);
-      return {};
-    }
+  const auto* item = Find(key);
+  if (!item) {
+    return {};
+  }
+
+  if (item->value.data) {
+    return item->value.data;
+  }
+  return item->value.object;
+}
 
-    return std::get<2>(it.value());
+bool InMemoryCache::Get(const std::string& key,
+                        KeyValueCache::ValueTypePtr& value) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  const auto* item = Find(key);
+  if (!item || !item->value.data) {
+    return false;
   }
 
-  return {};
+  value = item->value.data;
+  return true;
 }
 
 size_t InMemoryCache::Size() const {
   std::lock_guard<std::mutex> lock{mutex_};
-  return item_tuples_.Size();
+  return size_;
 }
 
 void InMemoryCache::Clear() {
   std::lock_guard<std::mutex> lock{mutex_};
-  item_expiries_.clear();
-  item_tuples_.Clear();
+  expiry_buckets_.clear();
+  items_.clear();
+  lru_first_ = lru_last_ = nullptr;
+  size_ = 0u;
 }
 
 bool InMemoryCache::Remove(const std::string& key) {
   std::lock_guard<std::mutex> lock{mutex_};
-  return item_tuples_.Erase(key);
+  auto it = items_.find(key);
+  if (it == items_.end()) {
+    return false;
+  }
+
+  Erase(it);
+  return true;
 }
 
 void InMemoryCache::RemoveKeysWithPrefix(const std::string& key_prefix,
                                          const RemoveFilterFunc& filter) {
   std::lock_guard<std::mutex> lock{mutex_};
 
-  for (auto it = item_tuples_.begin(); it != item_tuples_.end();) {
-    if (it->key().substr(0, key_prefix.length()) == key_prefix) {
-      // Check if this key is not protected, and if it is do not remove
-      if (filter && filter(it->key())) {
-        ++it;
-        continue;
-      }
-
-      // we allow concurrent modifications.
-      it = item_tuples_.Erase(it);
-    } else {
+  for (auto it = items_.begin(); it != items_.end();) {
+    const auto& key = it->first;
+    // Protected keys are not removed.
+    if (key.compare(0, key_prefix.length(), key_prefix) != 0 ||
+        (filter && filter(key))) {
       ++it;
+      continue;
     }
+
+    Erase(it++);
   }
 }
 
 bool InMemoryCache::Contains(const std::string& key) const {
   std::lock_guard<std::mutex> lock{mutex_};
-  auto it = item_tuples_.FindNoPromote(key);
-  if (it != item_tuples_.end()) {
-    auto expiry_time = std::get<1>(it.value());
-    return (expiry_time > time_provider_());
+  auto it = items_.find(key);
+  if (it != items_.end()) {
+    return (it->second.expiry > time_provider_());
   }
 
   return false;
 }
 
-bool InMemoryCache::PurgeExpired() {
-  bool ret = true;
-  std::vector<time_t> expired_keys;
-  const auto time_now = time_provider_();
+void InMemoryCache::LinkLru(Item& item) {
+  item.lru_prev = nullptr;
+  item.lru_next = lru_first_;
+  if (lru_first_) {
+    lru_first_->lru_prev = &item;
+  } else {
+    lru_last_ = &item;
+  }
+  lru_first_ = &item;
+}
 
-  for (const auto& item : item_expiries_) {
-    if (item.first < time_now) {
-      expired_keys.push_back(item.first);
-    } else {
-      // std::map is sorted, so any further expiry times will be larger.
-      break;
-    }
+void InMemoryCache::UnlinkLru(Item& item) {
+  if (item.lru_prev) {
+    item.lru_prev->lru_next = item.lru_next;
+  } else {
+    lru_first_ = item.lru_next;
   }
 
-  for (auto& key : expired_keys) {
-    ret &= PurgeExpired(key);
+  if (item.lru_next) {
+    item.lru_next->lru_prev = item.lru_prev;
+  } else {
+    lru_last_ = item.lru_prev;
   }
 
-  return ret;
+  item.lru_prev = item.lru_next = nullptr;
 }
 
-bool InMemoryCache::PurgeExpired(time_t expire_time) {
-  bool ret = true;
-  for (auto& item : item_expiries_[expire_time]) {
-    ret &= item_tuples_.Erase(std::get<0>(item));
+void InMemoryCache::LinkExpiry(Item& item) {
+  if (!HasExpiry(item.expiry)) {
+    return;
   }
 
-  item_expiries_.erase(expire_time);
-  return ret;
+  auto& first = expiry_buckets_[item.expiry];
+  item.expiry_prev = nullptr;
+  item.expiry_next = first;
+  if (first) {
+    first->expiry_prev = &item;
+  }
+  first = &item;
 }
 
-void InMemoryCache::OnEviction(const std::string& key, ItemTuple&& value) {
-  time_t expiry = std::get<1>(value);
-  if (HasExpiry(expiry)) {
-    auto item = item_expiries_[expiry];
-    for (auto it = item.begin(); it != item.end(); it++) {
-      if (std::get<0>(*it) == key) {
-        item.erase(it);
-        break;
-      }
+void InMemoryCache::UnlinkExpiry(Item& item) {
+  if (!HasExpiry(item.expiry)) {
+    return;
+  }
+
+  if (item.expiry_prev) {
+    item.expiry_prev->expiry_next = item.expiry_next;
+  } else {
+    // The first item of the bucket; an empty bucket is removed.
+    auto bucket = expiry_buckets_.find(item.expiry);
+    if (item.expiry_next) {
+      bucket->second = item.expiry_next;
+    } else {
+      expiry_buckets_.erase(bucket);
     }
+  }
+
+  if (item.expiry_next) {
+    item.expiry_next->expiry_prev = item.expiry_prev;
+  }
 
-    if (item_expiries_[expiry].size() == 0) {
-      item_expiries_.erase(expiry);
+  item.expiry_prev = item.expiry_next = nullptr;
+}
+
+void InMemoryCache::Erase(Items::iterator it) {
+  auto& item = it->second;
+  UnlinkLru(item);
+  UnlinkExpiry(item);
+  size_ -= item.cost;
+  items_.erase(it);
+}
+
+void InMemoryCache::PurgeExpired(time_t now) {
+  // The buckets are sorted, so the purge stops at the first valid bucket.
+  while (!expiry_buckets_.empty()) {
+    const auto bucket = expiry_buckets_.begin();
+    if (bucket->first >= now) {
+      break;
     }
+
+    Erase(items_.find(*bucket->second->key));
+  }
+}
+
+void InMemoryCache::Evict() {
+  while (size_ > max_size_ && lru_last_) {
+    Erase(items_.find(*lru_last_->key));
   }
 }
 
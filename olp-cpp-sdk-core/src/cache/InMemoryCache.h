@@ -21,13 +21,13 @@
 
 #include <chrono>
 #include <functional>
+#include <limits>
 #include <map>
 #include <mutex>
 #include <string>
-#include <tuple>
-#include <vector>
+#include <unordered_map>
 
-#include <olp/core/utils/LruCache.h>
+#include <olp/core/cache/KeyValueCache.h>
 #include <boost/any.hpp>
 
 namespace olp {
@@ -36,25 +36,39 @@ namespace cache {
 /**
  * @brief In-memory cache that implements a LRU and a time based eviction
  * policy.
+ *
+ * The items are indexed by a hash map and linked into an intrusive LRU list,
+ * so lookups, insertions, and evictions take constant time. The items that
+ * expire in the same second share a bucket of the expiry index.
  */
 class InMemoryCache {
  public:
   static constexpr size_t kSizeMax = std::numeric_limits<std::size_t>::max();
   static constexpr time_t kExpiryMax = std::numeric_limits<time_t>::max();
 
-  using ItemTuple = std::tuple<std::string, time_t, boost::any, size_t>;
-  using ItemTuples = std::vector<ItemTuple>;
+  /**
+   * @brief The value of an item.
+   *
+   * The binary data is stored as is, only the decoded objects are boxed into
+   * `boost::any`.
+   */
+  struct Value {
+    KeyValueCache::ValueTypePtr data;
+    boost::any object;
+  };
+
   using TimeProvider = std::function<time_t()>;
-  using ModelCacheCostFunc = std::function<std::size_t(const ItemTuple&)>;
+  /// Gets the cost of the value with the size passed to `Put`.
+  using ModelCacheCostFunc =
+      std::function<std::size_t(const Value& value, std::size_t size)>;
 
   /// Will be used to filter out keys to be removed in case they are protected.
   using RemoveFilterFunc = std::function<bool(const std::string&)>;
 
   /// Default cache cost based on size.
   struct DefaultCacheCost {
-    std::size_t operator()(const ItemTuple& value) const {
-      auto result = std::get<3>(value);
-      return (result == 0) ? 1u : result;
+    std::size_t operator()(const Value&, std::size_t size) const {
+      return (size == 0) ? 1u : size;
     }
   };
 
@@ -70,10 +84,24 @@ class InMemoryCache {
                 ModelCacheCostFunc cache_cost = DefaultCacheCost(),
                 TimeProvider time_provider = DefaultTimeProvider());
 
+  InMemoryCache(const InMemoryCache&) = delete;
+  InMemoryCache& operator=(const InMemoryCache&) = delete;
+
   bool Put(const std::string& key, const boost::any& item,
            time_t expire_seconds = kExpiryMax, size_t = 1u);
 
+  bool Put(const std::string& key, KeyValueCache::ValueTypePtr data,
+           time_t expire_seconds = kExpiryMax, size_t = 1u);
+
   boost::any Get(const std::string& key);
+
+  /**
+   * @brief Gets the binary data without boxing it into `boost::any`.
+   *
+   * @return False if the key is not found, expired, or stores other data.
+   */
+  bool Get(const std::string& key, KeyValueCache::ValueTypePtr& value);
+
   size_t Size() const;
   void Clear();
 
@@ -82,16 +110,46 @@ class InMemoryCache {
                             const RemoveFilterFunc& filter = nullptr);
   bool Contains(const std::string& key) const;
 
- protected:
-  bool PurgeExpired();
-  bool PurgeExpired(time_t expire_time);
-  void OnEviction(const std::string& key, ItemTuple&& value);
-
  private:
+  struct Item {
+    // Points to the key of the map, which is stable.
+    const std::string* key{nullptr};
+    Value value;
+    time_t expiry{kExpiryMax};
+    std::size_t cost{0u};
+    // The LRU list, from the most to the least recently used item.
+    Item* lru_prev{nullptr};
+    Item* lru_next{nullptr};
+    // The items that expire in the same second.
+    Item* expiry_prev{nullptr};
+    Item* expiry_next{nullptr};
+  };
+
+  using Items = std::unordered_map<std::string, Item>;
+
+  bool PutValue(const std::string& key, Value value, time_t expire_seconds,
+                size_t size);
+  Item* Find(const std::string& key);
+
+  void LinkLru(Item& item);
+  void UnlinkLru(Item& item);
+  void LinkExpiry(Item& item);
+  void UnlinkExpiry(Item& item);
+
+  void Erase(Items::iterator it);
+  void PurgeExpired(time_t now);
+  void Evict();
+
   mutable std::mutex mutex_;
-  utils::LruCache<std::string, ItemTuple, ModelCacheCostFunc> item_tuples_;
-  std::map<time_t, ItemTuples> item_expiries_;
+  const size_t max_size_;
+  ModelCacheCostFunc cache_cost_;
   TimeProvider time_provider_;
+  Items items_;
+  size_t size_{0u};
+  Item* lru_first_{nullptr};
+  Item* lru_last_{nullptr};
+  // The first item of each expiry bucket, ordered by the expiry time.
+  std::map<time_t, Item*> expiry_buckets_;
 };
 }  // namespace cache
 }  // namespace olp
@@ -45,5 +45,11 @@ CancellationToken ApiLookupClient::LookupApi(const std::string& service,
                           std::move(callback));
 }
 
+CancellationToken ApiLookupClient::WarmUp(const std::vector<HRN>& catalogs,
+                                          const OlpClientSettings& settings,
+                                          WarmUpCallback callback) {
+  return ApiLookupClientImpl::WarmUp(catalogs, settings, std::move(callback));
+}
+
 }  // namespace client
 }  // namespace olp
@@ -19,8 +19,18 @@
 
 #include "ApiLookupClientImpl.h"
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <olp/core/client/Condition.h>
 #include <olp/core/client/HRN.h>
 #include <olp/core/logging/Log.h>
+#include <olp/core/tracing/Tracer.h>
+#include "client/ApiLookupRegistry.h"
 #include "client/api/PlatformApi.h"
 #include "client/api/ResourcesApi.h"
 #include "repository/ApiCacheRepository.h"
@@ -68,6 +78,73 @@ olp::client::OlpClient GetStaticUrl(
   return {};
 }
 
+OlpClient CreateLookupClient(const HRN& catalog,
+                             const OlpClientSettings& settings) {
+  const auto& provider = settings.api_lookup_settings.lookup_endpoint_provider;
+  return CreateClient(provider(catalog.GetPartition()), settings);
+}
+
+bool IsCacheAllowed(FetchOptions options) {
+  return options != OnlineOnly && options != CacheWithUpdate;
+}
+
+bool IsPlatformService(const std::string& service) {
+  return service == "config";
+}
+
+// Identifies the credentials that the lookup request is sent with, in the
+// same order of precedence. Only a hash of the key or token is kept. The
+// providers are called, so the result is computed once per client.
+std::string CredentialsId(const OlpClientSettings& settings) {
+  const auto& authentication = settings.authentication_settings;
+  if (!authentication) {
+    return {};
+  }
+
+  std::hash<std::string> hash;
+  if (authentication->api_key_provider) {
+    return "key:" + std::to_string(hash(authentication->api_key_provider()));
+  }
+
+  if (authentication->provider) {
+    return "token:" + std::to_string(hash(authentication->provider()));
+  }
+
+  return {};
+}
+
+ApiLookupRegistry::Key RegistryKey(const OlpClientSettings& settings,
+                                   const std::string& credentials,
+                                   const OlpClient& lookup_client,
+                                   bool platform,
+                                   const std::string& catalog) {
+  return {settings.network_request_handler, settings.cache,
+          lookup_client.GetBaseUrl(), platform ? "platform" : catalog,
+          credentials};
+}
+
+ApiLookupRegistry::FetchFunc FetchApis(OlpClient lookup_client, bool platform,
+                                       std::string catalog) {
+  return [=](ApiLookupRegistry::ApisCallback callback) {
+    if (platform) {
+      return PlatformApi::GetApis(lookup_client, callback);
+    }
+    return ResourcesApi::GetApis(lookup_client, catalog, callback);
+  };
+}
+
+ApiLookupRegistry::StoreFunc StoreApis(
+    HRN catalog, std::shared_ptr<cache::KeyValueCache> cache) {
+  return [=](const ApiLookupRegistry::ApisResult& available_services) {
+    repository::ApiCacheRepository cache_repository(catalog, cache);
+    for (const auto& service_api : available_services.first) {
+      cache_repository.Put(service_api.GetApi(), service_api.GetVersion(),
+                           service_api.GetBaseUrl(),
+                           available_services.second);
+    }
+  };
+}
+
 ApiLookupClient::LookupApiResponse NotFoundInCacheError() {
   return ApiError(client::ErrorCode::NotFound,
                   "CacheOnly: resource not found in cache");
@@ -82,28 +159,36 @@ std::string ClientCacheKey(const std::string& service,
                            const std::string& service_version) {
   return service + service_version;
 }
+
+tracing::Span LookupApiSpan(const std::string& catalog,
+                            const std::string& service,
+                            const std::string& service_version) {
+  return tracing::Span("ApiLookupClient::LookupApi", [&] {
+    return tracing::SpanAttributes().WithCatalog(catalog).WithDetails(
+        service + "/" + service_version);
+  });
+}
 }  // namespace
 
 ApiLookupClientImpl::ApiLookupClientImpl(const HRN& catalog,
                                          const OlpClientSettings& settings)
     : catalog_(catalog),
       catalog_string_(catalog_.ToString()),
-      settings_(settings) {
-  auto provider = settings_.api_lookup_settings.lookup_endpoint_provider;
-  const auto& base_url = provider(catalog_.GetPartition());
-  lookup_client_ = CreateClient(base_url, settings_);
-}
+      settings_(settings),
+      lookup_client_(CreateLookupClient(catalog_, settings_)) {}
 
 ApiLookupClient::LookupApiResponse ApiLookupClientImpl::LookupApi(
     const std::string& service, const std::string& service_version,
     FetchOptions options, CancellationContext context) {
+  auto span = LookupApiSpan(catalog_string_, service, service_version);
+
   auto result_client = GetStaticUrl(catalog_, settings_);
   if (!result_client.GetBaseUrl().empty()) {
     return result_client;
   }
 
-  if (options != OnlineOnly && options != CacheWithUpdate) {
-    auto client = GetCachedClient(service, service_version);
+  if (IsCacheAllowed(options)) {
+    auto client = GetCachedClient(service, service_version, options);
     if (client) {
       return *client;
     } else if (options == CacheOnly) {
@@ -111,58 +196,71 @@ ApiLookupClient::LookupApiResponse ApiLookupClientImpl::LookupApi(
     }
   }
 
-  PlatformApi::ApisResponse api_response;
-  if (service == "config") {
-    api_response = PlatformApi::GetApis(lookup_client_, context);
-  } else {
-    api_response =
-        ResourcesApi::GetApis(lookup_client_, catalog_string_, context);
-  }
-
-  if (!api_response.IsSuccessful()) {
-    OLP_SDK_LOG_WARNING_F(
-        kLogTag, "LookupApi(%s/%s) unsuccessful, hrn='%s', error='%s'",
-        service.c_str(), service_version.c_str(), catalog_string_.c_str(),
-        api_response.GetError().GetMessage().c_str());
-    return api_response.GetError();
-  }
+  struct LookupState {
+    Condition condition;
+    ApiLookupRegistry::ApisResponse response{ApiError::Cancelled()};
+  };
 
-  const auto& api_result = api_response.GetResult();
-  if (options != OnlineOnly && options != CacheWithUpdate) {
-    PutToDiskCache(api_result);
+  auto state = std::make_shared<LookupState>();
+
+  // The request might be shared with other callers, so wait for all of its
+  // attempts.
+  const auto& retry_settings = settings_.retry_settings;
+  const auto timeout = std::chrono::seconds(retry_settings.timeout) *
+                       (retry_settings.max_attempts + 1);
+
+  context.ExecuteOrCancelled(
+      [&]() {
+        const bool platform = IsPlatformService(service);
+        return ApiLookupRegistry::Instance().Fetch(
+            RegistryKey(settings_, GetCredentialsId(), lookup_client_,
+                        platform, catalog_string_),
+            FetchApis(lookup_client_, platform, catalog_string_),
+            IsCacheAllowed(options) ? StoreApis(catalog_, settings_.cache)
+                                    : nullptr,
+            [state](ApiLookupRegistry::ApisResponse response) {
+              state->response = std::move(response);
+              state->condition.Notify();
+            });
+      },
+      [&]() { state->condition.Notify(); });
+
+  if (!state->condition.Wait(timeout)) {
+    OLP_SDK_LOG_WARNING_F(kLogTag, "LookupApi(%s/%s) timed out, hrn='%s'",
+                          service.c_str(), service_version.c_str(),
+                          catalog_string_.c_str());
+    context.CancelOperation();
+    return ApiError(ErrorCode::RequestTimeout, "Network request timed out.");
   }
 
-  auto url = FindApi(api_result.first, service, service_version);
-  if (url.empty()) {
-    OLP_SDK_LOG_WARNING_F(
-        kLogTag, "LookupApi(%s/%s) service not found, hrn='%s'",
-        service.c_str(), service_version.c_str(), catalog_string_.c_str());
-
-    return ServiceNotAvailable();
+  if (context.IsCancelled()) {
+    return ApiError::Cancelled();
   }
 
-  OLP_SDK_LOG_DEBUG_F(kLogTag,
-                      "LookupApi(%s/%s) found, hrn='%s', service_url='%s'",
-                      service.c_str(), service_version.c_str(),
-                      catalog_string_.c_str(), url.c_str());
-
-  const auto expiration = api_result.second;
-
-  return CreateAndCacheClient(url, ClientCacheKey(service, service_version),
-                              expiration);
+  return ProcessApis(service, service_version, state->response);
 }
 
 CancellationToken ApiLookupClientImpl::LookupApi(
     const std::string& service, const std::string& service_version,
     FetchOptions options, ApiLookupClient::LookupApiCallback callback) {
+  if (tracing::IsTracingEnabled()) {
+    auto span = std::make_shared<tracing::Span>(
+        LookupApiSpan(catalog_string_, service, service_version));
+    callback = [span,
+                callback](ApiLookupClient::LookupApiResponse response) {
+      span->End();
+      callback(std::move(response));
+    };
+  }
+
   auto result_client = GetStaticUrl(catalog_, settings_);
   if (!result_client.GetBaseUrl().empty()) {
     callback(result_client);
     return CancellationToken();
   }
 
-  if (options != OnlineOnly && options != CacheWithUpdate) {
-    auto client = GetCachedClient(service, service_version);
+  if (IsCacheAllowed(options)) {
+    auto client = GetCachedClient(service, service_version, options);
     if (client) {
       callback(*client);
       return CancellationToken();
@@ -172,46 +270,111 @@ CancellationToken ApiLookupClientImpl::LookupApi(
     }
   }
 
-  PlatformApi::ApisCallback lookup_callback =
-      [=](PlatformApi::ApisResponse response) mutable -> void {
-    if (!response.IsSuccessful()) {
-      OLP_SDK_LOG_WARNING_F(
-          kLogTag, "LookupApi(%s/%s) unsuccessful, hrn='%s', error='%s'",
-          service.c_str(), service_version.c_str(), catalog_string_.c_str(),
-          response.GetError().GetMessage().c_str());
-      callback(response.GetError());
-      return;
+  const bool platform = IsPlatformService(service);
+  return ApiLookupRegistry::Instance().Fetch(
+      RegistryKey(settings_, GetCredentialsId(), lookup_client_, platform,
+                  catalog_string_),
+      FetchApis(lookup_client_, platform, catalog_string_),
+      IsCacheAllowed(options) ? StoreApis(catalog_, settings_.cache) : nullptr,
+      [=](ApiLookupRegistry::ApisResponse response) {
+        callback(ProcessApis(service, service_version, response));
+      });
+}
+
+CancellationToken ApiLookupClientImpl::WarmUp(
+    const std::vector<HRN>& catalogs, const OlpClientSettings& settings,
+    ApiLookupClient::WarmUpCallback callback) {
+  if (catalogs.empty()) {
+    callback({});
+    return CancellationToken();
+  }
+
+  struct WarmUpState {
+    std::mutex mutex;
+    size_t remaining{0u};
+    ApiLookupClient::WarmUpErrors errors;
+  };
+
+  auto state = std::make_shared<WarmUpState>();
+  state->remaining = catalogs.size();
+
+  auto& registry = ApiLookupRegistry::Instance();
+  const auto credentials = CredentialsId(settings);
+  std::vector<CancellationToken> tokens;
+
+  for (const auto& catalog : catalogs) {
+    auto on_done = [=](ApiLookupRegistry::ApisResponse response) {
+      ApiLookupClient::WarmUpErrors errors;
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!response.IsSuccessful()) {
+          state->errors.emplace_back(catalog, response.GetError());
+        }
+        if (--state->remaining > 0) {
+          return;
+        }
+        errors = std::move(state->errors);
+      }
+      callback(std::move(errors));
+    };
+
+    if (!GetStaticUrl(catalog, settings).GetBaseUrl().empty()) {
+      on_done(ApiLookupRegistry::ApisResult());
+      continue;
     }
 
-    const auto& api_result = response.GetResult();
-    if (options != OnlineOnly && options != CacheWithUpdate) {
-      PutToDiskCache(api_result);
+    const auto catalog_string = catalog.ToString();
+    const auto lookup_client = CreateLookupClient(catalog, settings);
+    const auto key = RegistryKey(settings, credentials, lookup_client, false,
+                                 catalog_string);
+    auto fetch = FetchApis(lookup_client, false, catalog_string);
+    auto store = StoreApis(catalog, settings.cache);
+
+    if (registry.Get(key, fetch, store)) {
+      on_done(ApiLookupRegistry::ApisResult());
+      continue;
     }
 
-    const auto url = FindApi(api_result.first, service, service_version);
-    if (url.empty()) {
-      OLP_SDK_LOG_WARNING_F(
-          kLogTag, "LookupApi(%s/%s) service not found, hrn='%s'",
-          service.c_str(), service_version.c_str(), catalog_string_.c_str());
+    OLP_SDK_LOG_DEBUG_F(kLogTag, "WarmUp, hrn='%s'", catalog_string.c_str());
+    tokens.push_back(registry.Fetch(key, std::move(fetch), std::move(store),
+                                    std::move(on_done)));
+  }
 
-      callback(ServiceNotAvailable());
-      return;
+  return CancellationToken([tokens]() {
+    for (const auto& token : tokens) {
+      token.Cancel();
     }
+  });
+}
 
-    OLP_SDK_LOG_DEBUG_F(kLogTag,
-                        "LookupApi(%s/%s) found, hrn='%s', service_url='%s'",
-                        service.c_str(), service_version.c_str(),
-                        catalog_string_.c_str(), url.c_str());
+ApiLookupClient::LookupApiResponse ApiLookupClientImpl::ProcessApis(
+    const std::string& service, const std::string& service_version,
+    const ApiLookupRegistry::ApisResponse& response) {
+  if (!response.IsSuccessful()) {
+    OLP_SDK_LOG_WARNING_F(
+        kLogTag, "LookupApi(%s/%s) unsuccessful, hrn='%s', error='%s'",
+        service.c_str(), service_version.c_str(), catalog_string_.c_str(),
+        response.GetError().GetMessage().c_str());
+    return response.GetError();
+  }
 
-    callback(CreateAndCacheClient(url, ClientCacheKey(service, service_version),
-                                  api_result.second));
-  };
+  const auto& api_result = response.GetResult();
+  auto url = FindApi(api_result.first, service, service_version);
+  if (url.empty()) {
+    OLP_SDK_LOG_WARNING_F(
+        kLogTag, "LookupApi(%s/%s) service not found, hrn='%s'",
+        service.c_str(), service_version.c_str(), catalog_string_.c_str());
 
-  if (service == "config") {
-    return PlatformApi::GetApis(lookup_client_, lookup_callback);
+    return ServiceNotAvailable();
   }
-  return ResourcesApi::GetApis(lookup_client_, catalog_string_,
-                               lookup_callback);
+
+  OLP_SDK_LOG_DEBUG_F(kLogTag,
+                      "LookupApi(%s/%s) found, hrn='%s', service_url='%s'",
+                      service.c_str(), service_version.c_str(),
+                      catalog_string_.c_str(), url.c_str());
+
+  return CreateAndCacheClient(url, ClientCacheKey(service, service_version),
+                              api_result.second);
 }
 
 OlpClient ApiLookupClientImpl::CreateAndCacheClient(
@@ -234,21 +397,72 @@ OlpClient ApiLookupClientImpl::CreateAndCacheClient(
   return client_with_expiration.client;
 }
 
+std::string ApiLookupClientImpl::GetCredentialsId() {
+  {
+    std::lock_guard<std::mutex> lock(cached_clients_mutex_);
+    if (credentials_id_) {
+      return *credentials_id_;
+    }
+  }
+
+  // The providers are called without the lock, they might block.
+  auto credentials = CredentialsId(settings_);
+
+  std::lock_guard<std::mutex> lock(cached_clients_mutex_);
+  if (!credentials_id_) {
+    credentials_id_ = std::move(credentials);
+  }
+  return *credentials_id_;
+}
+
 boost::optional<OlpClient> ApiLookupClientImpl::GetCachedClient(
-    const std::string& service, const std::string& service_version) {
+    const std::string& service, const std::string& service_version,
+    FetchOptions options) {
   const std::string key = ClientCacheKey(service, service_version);
+  const auto max_staleness = options == StaleWhileRevalidate
+                                 ? settings_.max_staleness
+                                 : std::chrono::seconds::zero();
+  boost::optional<OlpClient> stale_client;
 
   {
     std::lock_guard<std::mutex> lock(cached_clients_mutex_);
     const auto client_it = cached_clients_.find(key);
     if (client_it != cached_clients_.end()) {
       const ClientWithExpiration& client_with_expiration = client_it->second;
-      if (client_with_expiration.expire_at > std::chrono::steady_clock::now()) {
+      const auto now = std::chrono::steady_clock::now();
+      if (client_with_expiration.expire_at > now) {
         OLP_SDK_LOG_DEBUG_F(
             kLogTag, "LookupApi(%s/%s) found in client cache, hrn='%s'",
             service.c_str(), service_version.c_str(), catalog_string_.c_str());
         return client_with_expiration.client;
       }
+
+      if (std::chrono::duration_cast<std::chrono::seconds>(
+              now - client_with_expiration.expire_at) < max_staleness) {
+        stale_client = client_with_expiration.client;
+      }
+    }
+  }
+
+  // The lookups of the other clients are shared in memory with their exact
+  // expiration. The expired lookup is refreshed by the registry.
+  const bool platform = IsPlatformService(service);
+  const auto registry_key = RegistryKey(settings_, GetCredentialsId(),
+                                        lookup_client_, platform,
+                                        catalog_string_);
+  const auto entry = ApiLookupRegistry::Instance().Get(
+      registry_key, FetchApis(lookup_client_, platform, catalog_string_),
+      StoreApis(catalog_, settings_.cache), max_staleness);
+  if (entry) {
+    const auto url = FindApi(*entry->apis, service, service_version);
+    if (!url.empty()) {
+      OLP_SDK_LOG_DEBUG_F(
+          kLogTag, "LookupApi(%s/%s) found in shared registry, hrn='%s'",
+          service.c_str(), service_version.c_str(), catalog_string_.c_str());
+
+      const auto remaining = std::chrono::duration_cast<std::chrono::seconds>(
+          entry->expire_at - std::chrono::steady_clock::now());
+      return CreateAndCacheClient(url, key, remaining.count());
     }
   }
 
@@ -262,7 +476,16 @@ boost::optional<OlpClient> ApiLookupClientImpl::GetCachedClient(
     OLP_SDK_LOG_DEBUG_F(
         kLogTag, "LookupApi(%s/%s) cache miss in disk cache, hrn='%s'",
         service.c_str(), service_version.c_str(), catalog_string_.c_str());
-    return boost::none;
+
+    if (stale_client) {
+      OLP_SDK_LOG_DEBUG_F(
+          kLogTag, "LookupApi(%s/%s) stale in client cache, hrn='%s'",
+          service.c_str(), service_version.c_str(), catalog_string_.c_str());
+      ApiLookupRegistry::Instance().Refresh(
+          registry_key, FetchApis(lookup_client_, platform, catalog_string_),
+          StoreApis(catalog_, settings_.cache));
+    }
+    return stale_client;
   }
 
   // When the service url is retrieved from disk cache we assume it is valid for
@@ -272,13 +495,5 @@ boost::optional<OlpClient> ApiLookupClientImpl::GetCachedClient(
   return CreateAndCacheClient(*base_url, key, kLookupApiShortExpiryTime);
 }
 
-void ApiLookupClientImpl::PutToDiskCache(const ApisResult& available_services) {
-  repository::ApiCacheRepository cache_repository_(catalog_, settings_.cache);
-  for (const auto& service_api : available_services.first) {
-    cache_repository_.Put(service_api.GetApi(), service_api.GetVersion(),
-                          service_api.GetBaseUrl(), available_services.second);
-  }
-}
-
 }  // namespace client
 }  // namespace olp
@@ -21,6 +21,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <olp/core/client/ApiError.h>
 #include <olp/core/client/ApiLookupClient.h>
@@ -31,6 +32,8 @@
 #include <olp/core/client/OlpClient.h>
 #include <olp/core/client/OlpClientSettings.h>
 #include <olp/core/client/model/Api.h>
+#include <boost/optional.hpp>
+#include "client/ApiLookupRegistry.h"
 
 namespace olp {
 namespace client {
@@ -48,9 +51,11 @@ class ApiLookupClientImpl {
                               FetchOptions options,
                               ApiLookupClient::LookupApiCallback callback);
 
- protected:
-  using ApisResult = std::pair<Apis, boost::optional<time_t>>;
+  static CancellationToken WarmUp(const std::vector<HRN>& catalogs,
+                                  const OlpClientSettings& settings,
+                                  ApiLookupClient::WarmUpCallback callback);
 
+ protected:
   struct ClientWithExpiration {
     OlpClient client;
     std::chrono::steady_clock::time_point expire_at;
@@ -61,9 +66,15 @@ class ApiLookupClientImpl {
                                  boost::optional<time_t> expiration);
 
   boost::optional<OlpClient> GetCachedClient(
-      const std::string& service, const std::string& service_version);
+      const std::string& service, const std::string& service_version,
+      FetchOptions options = OnlineIfNotFound);
 
-  void PutToDiskCache(const ApisResult& available_services);
+  /// Identifies the credentials of the client in the shared registry.
+  std::string GetCredentialsId();
+
+  ApiLookupClient::LookupApiResponse ProcessApis(
+      const std::string& service, const std::string& service_version,
+      const ApiLookupRegistry::ApisResponse& response);
 
   const HRN& catalog_;
   const std::string catalog_string_;
@@ -72,6 +83,7 @@ class ApiLookupClientImpl {
 
   std::mutex cached_clients_mutex_;
   std::unordered_map<std::string, ClientWithExpiration> cached_clients_;
+  boost::optional<std::string> credentials_id_;
 };
 
 }  // namespace client
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "ApiLookupRegistry.h"
+
+#include <algorithm>
+
+#include <olp/core/logging/Log.h>
+
+namespace olp {
+namespace client {
+
+namespace {
+constexpr auto kLogTag = "ApiLookupRegistry";
+constexpr time_t kLookupApiDefaultExpiryTime = 3600;
+constexpr size_t kMaxEntries = 256u;
+
+// Compares the control blocks, so a new instance allocated at the address of
+// a destroyed one does not match.
+template <typename T>
+bool IsSameInstance(const std::weak_ptr<T>& stored,
+                    const std::shared_ptr<T>& current) {
+  return !stored.owner_before(current) && !current.owner_before(stored);
+}
+
+// The instance was set and is destroyed, unlike the one that was never set.
+template <typename T>
+bool IsReleased(const std::weak_ptr<T>& stored) {
+  return stored.expired() && !IsSameInstance(stored, std::shared_ptr<T>());
+}
+}  // namespace
+
+ApiLookupRegistry& ApiLookupRegistry::Instance() {
+  static ApiLookupRegistry instance;
+  return instance;
+}
+
+std::string ApiLookupRegistry::CreateId(const Key& key) {
+  return std::to_string(reinterpret_cast<std::uintptr_t>(key.network.get())) +
+         "::" +
+         std::to_string(reinterpret_cast<std::uintptr_t>(key.cache.get())) +
+         "::" + key.lookup_url + "::" + key.resource + "::" + key.credentials;
+}
+
+boost::optional<ApiLookupRegistry::Entry> ApiLookupRegistry::Get(
+    const Key& key, const FetchFunc& refresh, const StoreFunc& store,
+    std::chrono::seconds max_staleness) {
+  const auto id = CreateId(key);
+  const auto now = std::chrono::steady_clock::now();
+  Entry entry;
+  bool start_refresh = false;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+      return boost::none;
+    }
+
+    const auto& stored = it->second;
+    if (!IsSameInstance(stored.network, key.network) ||
+        !IsSameInstance(stored.cache, key.cache)) {
+      entries_.erase(it);
+      return boost::none;
+    }
+
+    // The expired result is kept, the other callers might accept it.
+    if (stored.entry.expire_at <= now &&
+        std::chrono::duration_cast<std::chrono::seconds>(
+            now - stored.entry.expire_at) >= max_staleness) {
+      return boost::none;
+    }
+
+    entry = stored.entry;
+    start_refresh = refresh && now >= stored.refresh_at &&
+                    pending_.find(id) == pending_.end();
+  }
+
+  if (start_refresh) {
+    OLP_SDK_LOG_DEBUG_F(kLogTag, "Get: refreshing, resource='%s'",
+                        key.resource.c_str());
+    Start(id, key, refresh, store, nullptr, true);
+  }
+
+  return entry;
+}
+
+void ApiLookupRegistry::Refresh(const Key& key, FetchFunc refresh,
+                                StoreFunc store) {
+  Start(CreateId(key), key, std::move(refresh), std::move(store), nullptr,
+        true);
+}
+
+CancellationToken ApiLookupRegistry::Fetch(const Key& key, FetchFunc fetch,
+                                           StoreFunc store,
+                                           ApisCallback callback) {
+  return Start(CreateId(key), key, std::move(fetch), std::move(store),
+               std::move(callback), false);
+}
+
+void ApiLookupRegistry::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
+
+CancellationToken ApiLookupRegistry::Start(const std::string& id,
+                                           const Key& key, FetchFunc fetch,
+                                           StoreFunc store,
+                                           ApisCallback callback,
+                                           bool background) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = pending_.find(id);
+  const bool is_leader = it == pending_.end();
+  if (is_leader) {
+    it = pending_.emplace(id, PendingRequest()).first;
+    it->second.generation = ++next_id_;
+  }
+
+  auto& request = it->second;
+  if (store && !request.store) {
+    request.store = std::move(store);
+  }
+  request.background = request.background || background;
+
+  const auto generation = request.generation;
+  CancellationToken waiter_token;
+  if (callback) {
+    const auto waiter_id = ++next_id_;
+    request.waiters.emplace_back(waiter_id, std::move(callback));
+    waiter_token = CancellationToken([this, id, generation, waiter_id]() {
+      Cancel(id, generation, waiter_id);
+    });
+  }
+
+  if (!is_leader) {
+    OLP_SDK_LOG_DEBUG_F(kLogTag, "Start: joined request, resource='%s'",
+                        key.resource.c_str());
+    return waiter_token;
+  }
+
+  lock.unlock();
+
+  // The callback might be called synchronously, so the request is started
+  // without the lock.
+  auto token = fetch([this, id, key, generation](ApisResponse response) {
+    Complete(id, key, generation, std::move(response));
+  });
+
+  lock.lock();
+  it = pending_.find(id);
+  if (it == pending_.end() || it->second.generation != generation) {
+    return waiter_token;
+  }
+
+  if (it->second.waiters.empty() && !it->second.background) {
+    // All callers left while the request was being started.
+    pending_.erase(it);
+    lock.unlock();
+    token.Cancel();
+    return waiter_token;
+  }
+
+  it->second.token = std::move(token);
+  it->second.started = true;
+  return waiter_token;
+}
+
+void ApiLookupRegistry::Complete(const std::string& id, const Key& key,
+                                 std::uint64_t generation,
+                                 ApisResponse response) {
+  std::vector<Waiter> waiters;
+  StoreFunc store;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find(id);
+    if (it == pending_.end() || it->second.generation != generation) {
+      return;
+    }
+
+    waiters = std::move(it->second.waiters);
+    store = std::move(it->second.store);
+    pending_.erase(it);
+
+    if (store && response.IsSuccessful()) {
+      const auto& result = response.GetResult();
+      const std::chrono::milliseconds lifetime = std::chrono::seconds(
+          result.second.value_or(kLookupApiDefaultExpiryTime));
+      const auto now = std::chrono::steady_clock::now();
+
+      StoredEntry stored;
+      stored.entry.apis = std::make_shared<const Apis>(result.first);
+      stored.entry.expire_at = now + lifetime;
+      stored.refresh_at = now + lifetime - lifetime / 10;
+      stored.network = key.network;
+      stored.cache = key.cache;
+      entries_[id] = std::move(stored);
+      Prune();
+    }
+  }
+
+  if (store && response.IsSuccessful()) {
+    store(response.GetResult());
+  }
+
+  for (auto& waiter : waiters) {
+    waiter.second(response);
+  }
+}
+
+void ApiLookupRegistry::Prune() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (IsReleased(it->second.network) || IsReleased(it->second.cache)) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // E.g. the results of the rotated credentials are not requested anymore.
+  while (entries_.size() > kMaxEntries) {
+    auto oldest = std::min_element(
+        entries_.begin(), entries_.end(),
+        [](const std::pair<const std::string, StoredEntry>& lhs,
+           const std::pair<const std::string, StoredEntry>& rhs) {
+          return lhs.second.entry.expire_at < rhs.second.entry.expire_at;
+        });
+    OLP_SDK_LOG_DEBUG_F(kLogTag, "Prune: evicting, id='%s'",
+                        oldest->first.c_str());
+    entries_.erase(oldest);
+  }
+}
+
+void ApiLookupRegistry::Cancel(const std::string& id, std::uint64_t generation,
+                               std::uint64_t waiter_id) {
+  ApisCallback callback;
+  CancellationToken token;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find(id);
+    if (it == pending_.end() || it->second.generation != generation) {
+      return;
+    }
+
+    auto& request = it->second;
+    auto waiter_it = std::find_if(
+        request.waiters.begin(), request.waiters.end(),
+        [&](const Waiter& waiter) { return waiter.first == waiter_id; });
+    if (waiter_it == request.waiters.end()) {
+      return;
+    }
+
+    callback = std::move(waiter_it->second);
+    request.waiters.erase(waiter_it);
+
+    // The request that is still being started is cancelled by `Start`.
+    if (request.waiters.empty() && !request.background && request.started) {
+      token = std::move(request.token);
+      pending_.erase(it);
+    }
+  }
+
+  token.Cancel();
+  callback(ApiError::Cancelled());
+}
+
+}  // namespace client
+}  // namespace olp
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <olp/core/cache/KeyValueCache.h>
+#include <olp/core/client/ApiError.h>
+#include <olp/core/client/ApiResponse.h>
+#include <olp/core/client/CancellationToken.h>
+#include <olp/core/client/model/Api.h>
+#include <olp/core/http/Network.h>
+#include <boost/optional.hpp>
+
+namespace olp {
+namespace client {
+
+/**
+ * @brief The process-wide registry of the API lookup results.
+ *
+ * All lookup clients that use the same network, cache and credentials share
+ * the results of the resource and platform lookups. Identical lookups that
+ * are in flight at the same time are sent once, and every caller receives
+ * the outcome. The results that are about to expire are refreshed in the
+ * background when they are requested. The results of the released network
+ * or cache instances are removed, and the number of results is limited.
+ */
+class ApiLookupRegistry final {
+ public:
+  using ApisResult = std::pair<Apis, boost::optional<time_t>>;
+  using ApisResponse = ApiResponse<ApisResult, ApiError>;
+  using ApisCallback = std::function<void(ApisResponse)>;
+
+  /// Starts the lookup request and calls the callback with its outcome.
+  using FetchFunc = std::function<CancellationToken(ApisCallback)>;
+  /// Persists the result of a lookup, e.g. to the disk cache.
+  using StoreFunc = std::function<void(const ApisResult&)>;
+
+  /// Identifies the lookup of a catalog, or of the platform, made with
+  /// the network and cache instances and the credentials.
+  struct Key {
+    std::shared_ptr<http::Network> network;
+    std::shared_ptr<cache::KeyValueCache> cache;
+    std::string lookup_url;
+    std::string resource;
+    /// Identifies the credentials, e.g. a hash of the token. The lookups
+    /// made with different credentials are not shared.
+    std::string credentials;
+  };
+
+  /// The shared result of a lookup.
+  struct Entry {
+    std::shared_ptr<const Apis> apis;
+    std::chrono::steady_clock::time_point expire_at;
+  };
+
+  /// Gets the registry of the process.
+  static ApiLookupRegistry& Instance();
+
+  /**
+   * @brief Gets the valid result of the lookup.
+   *
+   * Starts a background refresh when the result is close to its expiry or
+   * expired.
+   *
+   * @param key The lookup key.
+   * @param refresh The function used to refresh the result.
+   * @param store The function used to persist the refreshed result.
+   * @param max_staleness How long after its expiry the result is still
+   * returned.
+   *
+   * @return The result, or none if there is no valid result.
+   */
+  boost::optional<Entry> Get(
+      const Key& key, const FetchFunc& refresh, const StoreFunc& store,
+      std::chrono::seconds max_staleness = std::chrono::seconds::zero());
+
+  /**
+   * @brief Refreshes the lookup result in the background.
+   *
+   * Does nothing if the identical request is already in flight.
+   *
+   * @param key The lookup key.
+   * @param refresh The function used to refresh the result.
+   * @param store The function used to persist the refreshed result.
+   */
+  void Refresh(const Key& key, FetchFunc refresh, StoreFunc store);
+
+  /**
+   * @brief Fetches the lookup result or joins the identical request that is
+   * already in flight.
+   *
+   * The callback is called with the cancelled error when the returned token
+   * is cancelled. The request itself is cancelled when no caller waits for
+   * it anymore.
+   *
+   * @param key The lookup key.
+   * @param fetch The function that starts the request.
+   * @param store The function used to persist the result, or nullptr if
+   * the caller does not want the result to be cached.
+   * @param callback The callback that receives the outcome.
+   *
+   * @return The token that cancels this call.
+   */
+  CancellationToken Fetch(const Key& key, FetchFunc fetch, StoreFunc store,
+                          ApisCallback callback);
+
+  /// Removes all results. Requests in flight are not affected.
+  void Clear();
+
+ private:
+  using Waiter = std::pair<std::uint64_t, ApisCallback>;
+
+  struct StoredEntry {
+    Entry entry;
+    std::chrono::steady_clock::time_point refresh_at;
+    std::weak_ptr<http::Network> network;
+    std::weak_ptr<cache::KeyValueCache> cache;
+  };
+
+  struct PendingRequest {
+    std::uint64_t generation{0u};
+    std::vector<Waiter> waiters;
+    StoreFunc store;
+    CancellationToken token;
+    bool started{false};
+    bool background{false};
+  };
+
+  static std::string CreateId(const Key& key);
+
+  /// Removes the results of the released network or cache instances, and
+  /// the earliest expiring results above the limit. Requires the lock.
+  void Prune();
+
+  CancellationToken Start(const std::string& id, const Key& key,
+                          FetchFunc fetch, StoreFunc store,
+                          ApisCallback callback, bool background);
+
+  void Complete(const std::string& id, const Key& key,
+                std::uint64_t generation, ApisResponse response);
+
+  void Cancel(const std::string& id, std::uint64_t generation,
+              std::uint64_t waiter_id);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, StoredEntry> entries_;
+  std::unordered_map<std::string, PendingRequest> pending_;
+  std::uint64_t next_id_{0u};
+};
+
+}  // namespace client
+}  // namespace olp
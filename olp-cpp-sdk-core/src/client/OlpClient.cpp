@@ -33,6 +33,7 @@
 #include "olp/core/logging/Log.h"
 #include "olp/core/porting/shared_mutex.h"
 #include "olp/core/thread/Atomic.h"
+#include "olp/core/tracing/Tracer.h"
 #include "olp/core/utils/Url.h"
 
 namespace {
@@ -487,6 +488,17 @@ CancellationToken OlpClient::OlpClientImpl::CallApi(
     return CancellationToken();
   }
 
+  auto network_callback = callback;
+  if (tracing::IsTracingEnabled()) {
+    auto span = std::make_shared<tracing::Span>("OlpClient::CallApi", [&] {
+      return tracing::SpanAttributes().WithDetails(method + " " + path);
+    });
+    network_callback = [=](HttpResponse response) {
+      span->End();
+      callback(std::move(response));
+    };
+  }
+
   PendingUrlRequestPtr request_ptr = nullptr;
   auto& pending_requests = pending_requests_;
   const auto& url = network_request->GetUrl();
@@ -501,8 +513,8 @@ CancellationToken OlpClient::OlpClientImpl::CallApi(
 
   if (merge) {
     // Add callback and prepare CancellationToken
-    auto call_id =
-        pending_requests->Append(url, std::move(callback), request_ptr);
+    auto call_id = pending_requests->Append(url, std::move(network_callback),
+                                            request_ptr);
     cancellation_token =
         CancellationToken([=] { pending_requests->Cancel(url, call_id); });
 
@@ -518,7 +530,7 @@ CancellationToken OlpClient::OlpClientImpl::CallApi(
     request_ptr = std::make_shared<PendingUrlRequest>();
 
     // Add callback and prepare CancellationToken
-    auto call_id = request_ptr->Append(std::move(callback));
+    auto call_id = request_ptr->Append(std::move(network_callback));
     cancellation_token =
         CancellationToken([=] { request_ptr->Cancel(call_id); });
   }
@@ -550,6 +562,10 @@ HttpResponse OlpClient::OlpClientImpl::CallApi(
     OlpClient::ParametersType /*forms_params*/,
     OlpClient::RequestBodyType post_body, std::string content_type,
     CancellationContext context) const {
+  tracing::Span span("OlpClient::CallApi", [&] {
+    return tracing::SpanAttributes().WithDetails(method + " " + path);
+  });
+
   if (!settings_.network_request_handler) {
     return HttpResponse(static_cast<int>(olp::http::ErrorCode::OFFLINE_ERROR),
                         "Network request handler is empty.");
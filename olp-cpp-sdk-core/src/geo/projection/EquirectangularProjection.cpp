@@ -25,6 +25,7 @@
 #include "olp/core/geo/projection/EarthConstants.h"
 #include "olp/core/math/AlignedBox.h"
 #include "olp/core/math/Math.h"
+#include "ProjectionKernels.h"
 
 namespace olp {
 namespace geo {
@@ -66,5 +67,23 @@ bool EquirectangularProjection::Unproject(const WorldCoordinates& world_point,
   return true;
 }
 
+bool EquirectangularProjection::ProjectBatch(
+    const double* latitudes, const double* longitudes, const double* altitudes,
+    size_t count, double* x, double* y, double* z) const {
+  AddAndScale(longitudes, count, math::pi, kGeoToWorldScale, x);
+  AddAndScale(latitudes, count, math::half_pi, kGeoToWorldScale, y);
+  Copy(altitudes, count, z);
+  return true;
+}
+
+bool EquirectangularProjection::UnprojectBatch(
+    const double* x, const double* y, const double* z, size_t count,
+    double* latitudes, double* longitudes, double* altitudes) const {
+  ScaleAndAdd(y, count, kWorldToGeoScale, -math::half_pi, latitudes);
+  ScaleAndAdd(x, count, kWorldToGeoScale, -math::pi, longitudes);
+  Copy(z, count, altitudes);
+  return true;
+}
+
 }  // namespace geo
 }  // namespace olp
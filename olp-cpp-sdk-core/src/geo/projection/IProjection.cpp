@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "olp/core/geo/projection/IProjection.h"
+
+#include "olp/core/geo/coordinates/GeoCoordinates3d.h"
+
+namespace olp {
+namespace geo {
+
+bool IProjection::ProjectBatch(const double* latitudes,
+                               const double* longitudes,
+                               const double* altitudes, size_t count,
+                               double* x, double* y, double* z) const {
+  bool result = true;
+  WorldCoordinates world_point;
+  for (size_t i = 0; i < count; ++i) {
+    if (!Project({latitudes[i], longitudes[i], altitudes[i]}, world_point)) {
+      result = false;
+    }
+    x[i] = world_point.x;
+    y[i] = world_point.y;
+    z[i] = world_point.z;
+  }
+  return result;
+}
+
+bool IProjection::UnprojectBatch(const double* x, const double* y,
+                                 const double* z, size_t count,
+                                 double* latitudes, double* longitudes,
+                                 double* altitudes) const {
+  bool result = true;
+  GeoCoordinates3d geo_point;
+  for (size_t i = 0; i < count; ++i) {
+    if (!Unproject({x[i], y[i], z[i]}, geo_point)) {
+      result = false;
+    }
+    latitudes[i] = geo_point.GetLatitude();
+    longitudes[i] = geo_point.GetLongitude();
+    altitudes[i] = geo_point.GetAltitude();
+  }
+  return result;
+}
+
+}  // namespace geo
+}  // namespace olp
@@ -25,6 +25,7 @@
 #include "olp/core/geo/coordinates/GeoRectangle.h"
 #include "olp/core/math/AlignedBox.h"
 #include "olp/core/math/Math.h"
+#include "ProjectionKernels.h"
 
 namespace olp {
 namespace geo {
@@ -62,5 +63,25 @@ bool IdentityProjection::Unproject(const WorldCoordinates& world_point,
   return true;
 }
 
+bool IdentityProjection::ProjectBatch(const double* latitudes,
+                                      const double* longitudes,
+                                      const double* altitudes, size_t count,
+                                      double* x, double* y, double* z) const {
+  Copy(longitudes, count, x);
+  Copy(latitudes, count, y);
+  Copy(altitudes, count, z);
+  return true;
+}
+
+bool IdentityProjection::UnprojectBatch(const double* x, const double* y,
+                                        const double* z, size_t count,
+                                        double* latitudes, double* longitudes,
+                                        double* altitudes) const {
+  Copy(y, count, latitudes);
+  Copy(x, count, longitudes);
+  Copy(z, count, altitudes);
+  return true;
+}
+
 }  // namespace geo
 }  // namespace olp
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "ProjectionKernels.h"
+
+#include <cstring>
+
+#include "utils/CpuFeatures.h"
+
+#if defined(OLP_SDK_CPU_X86)
+#include <immintrin.h>
+#endif
+
+namespace olp {
+namespace geo {
+
+namespace {
+
+using LinearFunction = void (*)(const double* in, size_t count, double first,
+                                double second, double* out);
+
+void AddAndScaleScalar(const double* in, size_t count, double offset,
+                       double scale, double* out) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = (in[i] + offset) * scale;
+  }
+}
+
+void ScaleAndAddScalar(const double* in, size_t count, double scale,
+                       double offset, double* out) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = in[i] * scale + offset;
+  }
+}
+
+#if defined(OLP_SDK_CPU_X86)
+// The multiplication and the addition are not fused, so the results match
+// the scalar code exactly.
+
+OLP_SDK_CPU_TARGET("sse2")
+void AddAndScaleSse2(const double* in, size_t count, double offset,
+                     double scale, double* out) {
+  const __m128d offsets = _mm_set1_pd(offset);
+  const __m128d scales = _mm_set1_pd(scale);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const __m128d values = _mm_loadu_pd(in + i);
+    _mm_storeu_pd(out + i, _mm_mul_pd(_mm_add_pd(values, offsets), scales));
+  }
+  AddAndScaleScalar(in + i, count - i, offset, scale, out + i);
+}
+
+OLP_SDK_CPU_TARGET("sse2")
+void ScaleAndAddSse2(const double* in, size_t count, double scale,
+                     double offset, double* out) {
+  const __m128d scales = _mm_set1_pd(scale);
+  const __m128d offsets = _mm_set1_pd(offset);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const __m128d values = _mm_loadu_pd(in + i);
+    _mm_storeu_pd(out + i, _mm_add_pd(_mm_mul_pd(values, scales), offsets));
+  }
+  ScaleAndAddScalar(in + i, count - i, scale, offset, out + i);
+}
+
+OLP_SDK_CPU_TARGET("avx2")
+void AddAndScaleAvx2(const double* in, size_t count, double offset,
+                     double scale, double* out) {
+  const __m256d offsets = _mm256_set1_pd(offset);
+  const __m256d scales = _mm256_set1_pd(scale);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256d first = _mm256_loadu_pd(in + i);
+    const __m256d second = _mm256_loadu_pd(in + i + 4);
+    _mm256_storeu_pd(out + i,
+                     _mm256_mul_pd(_mm256_add_pd(first, offsets), scales));
+    _mm256_storeu_pd(out + i + 4,
+                     _mm256_mul_pd(_mm256_add_pd(second, offsets), scales));
+  }
+  AddAndScaleScalar(in + i, count - i, offset, scale, out + i);
+}
+
+OLP_SDK_CPU_TARGET("avx2")
+void ScaleAndAddAvx2(const double* in, size_t count, double scale,
+                     double offset, double* out) {
+  const __m256d scales = _mm256_set1_pd(scale);
+  const __m256d offsets = _mm256_set1_pd(offset);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256d first = _mm256_loadu_pd(in + i);
+    const __m256d second = _mm256_loadu_pd(in + i + 4);
+    _mm256_storeu_pd(out + i,
+                     _mm256_add_pd(_mm256_mul_pd(first, scales), offsets));
+    _mm256_storeu_pd(out + i + 4,
+                     _mm256_add_pd(_mm256_mul_pd(second, scales), offsets));
+  }
+  ScaleAndAddScalar(in + i, count - i, scale, offset, out + i);
+}
+#endif
+
+LinearFunction SelectAddAndScale() {
+#if defined(OLP_SDK_CPU_X86)
+  const auto& features = utils::cpu::GetFeatures();
+  if (features.avx2) {
+    return &AddAndScaleAvx2;
+  }
+  if (features.sse2) {
+    return &AddAndScaleSse2;
+  }
+#endif
+  return &AddAndScaleScalar;
+}
+
+LinearFunction SelectScaleAndAdd() {
+#if defined(OLP_SDK_CPU_X86)
+  const auto& features = utils::cpu::GetFeatures();
+  if (features.avx2) {
+    return &ScaleAndAddAvx2;
+  }
+  if (features.sse2) {
+    return &ScaleAndAddSse2;
+  }
+#endif
+  return &ScaleAndAddScalar;
+}
+
+}  // namespace
+
+void AddAndScale(const double* in, size_t count, double offset, double scale,
+                 double* out) {
+  static const LinearFunction function = SelectAddAndScale();
+  function(in, count, offset, scale, out);
+}
+
+void ScaleAndAdd(const double* in, size_t count, double scale, double offset,
+                 double* out) {
+  static const LinearFunction function = SelectScaleAndAdd();
+  function(in, count, scale, offset, out);
+}
+
+void Copy(const double* in, size_t count, double* out) {
+  if (count > 0) {
+    std::memcpy(out, in, count * sizeof(double));
+  }
+}
+
+}  // namespace geo
+}  // namespace olp
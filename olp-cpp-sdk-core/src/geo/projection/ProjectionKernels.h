@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace olp {
+namespace geo {
+
+/*
+ * The kernels of the batch projections. They use AVX2 or SSE2 when the CPU
+ * supports them, and give the same results as the scalar code.
+ */
+
+/// Computes `out[i] = (in[i] + offset) * scale`.
+void AddAndScale(const double* in, size_t count, double offset, double scale,
+                 double* out);
+
+/// Computes `out[i] = in[i] * scale + offset`.
+void ScaleAndAdd(const double* in, size_t count, double scale, double offset,
+                 double* out);
+
+/// Copies the values, the arrays must not overlap.
+void Copy(const double* in, size_t count, double* out);
+
+}  // namespace geo
+}  // namespace olp
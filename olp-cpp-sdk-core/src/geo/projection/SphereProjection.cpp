@@ -84,5 +84,34 @@ bool SphereProjection::Unproject(const WorldCoordinates& world_point,
   return true;
 }
 
+bool SphereProjection::ProjectBatch(const double* latitudes,
+                                    const double* longitudes,
+                                    const double* altitudes, size_t count,
+                                    double* x, double* y, double* z) const {
+  // The trigonometric functions are not vectorized, but the points are
+  // converted without the virtual calls.
+  for (size_t i = 0; i < count; ++i) {
+    const auto point =
+        ToWorldCoordinates({latitudes[i], longitudes[i], altitudes[i]});
+    x[i] = point.x;
+    y[i] = point.y;
+    z[i] = point.z;
+  }
+  return true;
+}
+
+bool SphereProjection::UnprojectBatch(const double* x, const double* y,
+                                      const double* z, size_t count,
+                                      double* latitudes, double* longitudes,
+                                      double* altitudes) const {
+  for (size_t i = 0; i < count; ++i) {
+    const auto geo_point = ToGeoCoordinates({x[i], y[i], z[i]});
+    latitudes[i] = geo_point.GetLatitude();
+    longitudes[i] = geo_point.GetLongitude();
+    altitudes[i] = geo_point.GetAltitude();
+  }
+  return true;
+}
+
 }  // namespace geo
 }  // namespace olp
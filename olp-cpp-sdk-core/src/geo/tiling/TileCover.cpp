@@ -0,0 +1,507 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+
+#include "olp/core/geo/tiling/TileCover.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "olp/core/geo/coordinates/GeoCoordinates3d.h"
+#include "olp/core/geo/coordinates/GeoRectangle.h"
+#include "olp/core/geo/projection/EarthConstants.h"
+#include "olp/core/geo/projection/IProjection.h"
+#include "olp/core/geo/tiling/ISubdivisionScheme.h"
+#include "olp/core/geo/tiling/ITilingScheme.h"
+#include "olp/core/geo/tiling/TileKeyUtils.h"
+#include "olp/core/math/AlignedBox.h"
+#include "olp/core/math/Math.h"
+
+namespace olp {
+namespace geo {
+
+namespace {
+
+using Coverage = TileCover::Coverage;
+
+// A point or an axis-aligned rectangle in the plane of the longitude (x)
+// and the latitude (y).
+struct Point {
+  double x;
+  double y;
+};
+
+struct Rect {
+  double min_x;
+  double min_y;
+  double max_x;
+  double max_y;
+
+  bool Contains(const Point& point) const {
+    return point.x >= min_x && point.x <= max_x && point.y >= min_y &&
+           point.y <= max_y;
+  }
+};
+
+struct Interval {
+  std::uint32_t min;
+  std::uint32_t max;
+};
+
+Point ToPoint(const GeoCoordinates& coordinates) {
+  return {coordinates.GetLongitude(), coordinates.GetLatitude()};
+}
+
+bool GetTileRect(const ITilingScheme& tiling_scheme, const TileKey& tile_key,
+                 Rect& rect) {
+  const auto box = CalculateTileBox(tiling_scheme, tile_key);
+  const auto& projection = tiling_scheme.GetProjection();
+
+  GeoCoordinates3d min;
+  GeoCoordinates3d max;
+  if (!projection.Unproject(box.Minimum(), min) ||
+      !projection.Unproject(box.Maximum(), max)) {
+    return false;
+  }
+
+  rect = {min.GetLongitude(), min.GetLatitude(), max.GetLongitude(),
+          max.GetLatitude()};
+  return true;
+}
+
+// Clips the segment by the rectangle as in the Liang-Barsky algorithm.
+bool SegmentIntersects(const Point& a, const Point& b, const Rect& rect) {
+  const double dx = b.x - a.x;
+  const double dy = b.y - a.y;
+  const double p[] = {-dx, dx, -dy, dy};
+  const double q[] = {a.x - rect.min_x, rect.max_x - a.x, a.y - rect.min_y,
+                      rect.max_y - a.y};
+
+  double t0 = 0.0;
+  double t1 = 1.0;
+  for (int i = 0; i < 4; ++i) {
+    if (p[i] == 0.0) {
+      if (q[i] < 0.0) {
+        return false;
+      }
+      continue;
+    }
+
+    const double t = q[i] / p[i];
+    if (p[i] < 0.0) {
+      t0 = std::max(t0, t);
+    } else {
+      t1 = std::min(t1, t);
+    }
+    if (t0 > t1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PolygonContains(const std::vector<Point>& polygon, const Point& point) {
+  bool inside = false;
+  for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+    const auto& a = polygon[i];
+    const auto& b = polygon[j];
+    if ((a.y > point.y) != (b.y > point.y) &&
+        point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+double SquaredDistance(const Point& point, const Point& a, const Point& b) {
+  const double dx = b.x - a.x;
+  const double dy = b.y - a.y;
+  const double length = dx * dx + dy * dy;
+  double t = 0.0;
+  if (length > 0.0) {
+    t = math::Clamp(((point.x - a.x) * dx + (point.y - a.y) * dy) / length,
+                    0.0, 1.0);
+  }
+
+  const double x = a.x + t * dx - point.x;
+  const double y = a.y + t * dy - point.y;
+  return x * x + y * y;
+}
+
+double SquaredDistance(const Point& point, const Rect& rect) {
+  const double x = std::max({rect.min_x - point.x, 0.0, point.x - rect.max_x});
+  const double y = std::max({rect.min_y - point.y, 0.0, point.y - rect.max_y});
+  return x * x + y * y;
+}
+
+class RectangleCoverage {
+ public:
+  RectangleCoverage(const ISubdivisionScheme& subdivision_scheme,
+                    std::uint32_t level, Interval rows,
+                    std::vector<Interval> columns)
+      : subdivision_scheme_(subdivision_scheme),
+        level_size_(subdivision_scheme.GetLevelSize(level)),
+        rows_(rows),
+        columns_(std::move(columns)) {}
+
+  Coverage operator()(const TileKey& tile_key) const {
+    const auto tile_level_size =
+        subdivision_scheme_.GetLevelSize(tile_key.Level());
+    const std::uint32_t height =
+        level_size_.Height() / tile_level_size.Height();
+    const std::uint32_t width = level_size_.Width() / tile_level_size.Width();
+
+    const Interval rows = {tile_key.Row() * height,
+                           tile_key.Row() * height + height - 1};
+    const Interval columns = {tile_key.Column() * width,
+                              tile_key.Column() * width + width - 1};
+
+    if (rows.max < rows_.min || rows.min > rows_.max) {
+      return Coverage::kNone;
+    }
+
+    const bool full_rows = rows.min >= rows_.min && rows.max <= rows_.max;
+    auto result = Coverage::kNone;
+    for (const auto& interval : columns_) {
+      if (columns.max < interval.min || columns.min > interval.max) {
+        continue;
+      }
+      if (full_rows && columns.min >= interval.min &&
+          columns.max <= interval.max) {
+        return Coverage::kFull;
+      }
+      result = Coverage::kPartial;
+    }
+    return result;
+  }
+
+ private:
+  const ISubdivisionScheme& subdivision_scheme_;
+  const math::Size2u level_size_;
+  const Interval rows_;
+  const std::vector<Interval> columns_;
+};
+
+class PolygonCoverage {
+ public:
+  PolygonCoverage(const ITilingScheme& tiling_scheme,
+                  std::vector<Point> polygon)
+      : tiling_scheme_(tiling_scheme),
+        polygon_(std::move(polygon)),
+        bounds_{std::numeric_limits<double>::max(),
+                std::numeric_limits<double>::max(),
+                std::numeric_limits<double>::lowest(),
+                std::numeric_limits<double>::lowest()} {
+    for (const auto& point : polygon_) {
+      bounds_.min_x = std::min(bounds_.min_x, point.x);
+      bounds_.min_y = std::min(bounds_.min_y, point.y);
+      bounds_.max_x = std::max(bounds_.max_x, point.x);
+      bounds_.max_y = std::max(bounds_.max_y, point.y);
+    }
+  }
+
+  Coverage operator()(const TileKey& tile_key) const {
+    Rect rect;
+    if (!GetTileRect(tiling_scheme_, tile_key, rect)) {
+      return Coverage::kPartial;
+    }
+
+    if (rect.max_x < bounds_.min_x || rect.min_x > bounds_.max_x ||
+        rect.max_y < bounds_.min_y || rect.min_y > bounds_.max_y) {
+      return Coverage::kNone;
+    }
+
+    for (size_t i = 0, j = polygon_.size() - 1; i < polygon_.size(); j = i++) {
+      if (SegmentIntersects(polygon_[j], polygon_[i], rect)) {
+        return Coverage::kPartial;
+      }
+    }
+
+    // No edge touches the tile, so the tile is either inside or outside.
+    const Point center = {(rect.min_x + rect.max_x) / 2,
+                          (rect.min_y + rect.max_y) / 2};
+    return PolygonContains(polygon_, center) ? Coverage::kFull
+                                             : Coverage::kNone;
+  }
+
+ private:
+  const ITilingScheme& tiling_scheme_;
+  const std::vector<Point> polygon_;
+  Rect bounds_;
+};
+
+class CorridorCoverage {
+ public:
+  CorridorCoverage(const ITilingScheme& tiling_scheme, std::vector<Point> path,
+                   double radius)
+      : tiling_scheme_(tiling_scheme),
+        path_(std::move(path)),
+        squared_radius_(radius * radius) {}
+
+  Coverage operator()(const TileKey& tile_key) const {
+    Rect rect;
+    if (!GetTileRect(tiling_scheme_, tile_key, rect)) {
+      return Coverage::kPartial;
+    }
+
+    auto result = Coverage::kNone;
+    for (size_t i = 0; i < path_.size(); ++i) {
+      const auto& a = path_[i];
+      const auto& b = path_[std::min(i + 1, path_.size() - 1)];
+
+      // Measures the longitude in the units of the latitude near the segment.
+      const double scale = std::cos((a.y + b.y) / 2);
+      const Point scaled_a = {a.x * scale, a.y};
+      const Point scaled_b = {b.x * scale, b.y};
+      const Rect scaled_rect = {rect.min_x * scale, rect.min_y,
+                                rect.max_x * scale, rect.max_y};
+      const Point corners[] = {{scaled_rect.min_x, scaled_rect.min_y},
+                               {scaled_rect.max_x, scaled_rect.min_y},
+                               {scaled_rect.min_x, scaled_rect.max_y},
+                               {scaled_rect.max_x, scaled_rect.max_y}};
+
+      // The buffer of the segment is convex, so it contains the tile if it
+      // contains all corners.
+      double min_distance = std::numeric_limits<double>::max();
+      bool contains_tile = true;
+      for (const auto& corner : corners) {
+        const double distance = SquaredDistance(corner, scaled_a, scaled_b);
+        min_distance = std::min(min_distance, distance);
+        contains_tile = contains_tile && distance <= squared_radius_;
+      }
+      if (contains_tile) {
+        return Coverage::kFull;
+      }
+
+      if (result == Coverage::kPartial) {
+        continue;
+      }
+
+      // The closest points of a segment and a rectangle that do not
+      // intersect include a vertex of one of them.
+      if (SegmentIntersects(scaled_a, scaled_b, scaled_rect) ||
+          min_distance <= squared_radius_ ||
+          SquaredDistance(scaled_a, scaled_rect) <= squared_radius_ ||
+          SquaredDistance(scaled_b, scaled_rect) <= squared_radius_) {
+        result = Coverage::kPartial;
+      }
+    }
+    return result;
+  }
+
+ private:
+  const ITilingScheme& tiling_scheme_;
+  const std::vector<Point> path_;
+  const double squared_radius_;
+};
+
+}  // namespace
+
+TileCover::TileCover(const ITilingScheme& tiling_scheme, std::uint32_t level,
+                     CoverageFunction coverage)
+    : tiling_scheme_(&tiling_scheme),
+      level_(level),
+      coverage_(std::move(coverage)) {}
+
+TileCover TileCover::FromGeoRectangle(const ITilingScheme& tiling_scheme,
+                                      const GeoRectangle& geo_rectangle,
+                                      std::uint32_t level) {
+  const auto empty = [](const TileKey&) { return Coverage::kNone; };
+  if (geo_rectangle.IsEmpty() || level > TileKey::MaxLevel) {
+    return TileCover(tiling_scheme, level, empty);
+  }
+
+  GeoCoordinates south_west = geo_rectangle.SouthWest();
+  GeoCoordinates north_east = geo_rectangle.NorthEast();
+
+  // Clamp at the poles and wrap around the international date line.
+  south_west.SetLongitude(
+      math::Wrap(south_west.GetLongitude(), -math::pi, math::pi));
+  south_west.SetLatitude(
+      math::Clamp(south_west.GetLatitude(), -math::half_pi, math::half_pi));
+
+  north_east.SetLongitude(
+      math::Wrap(north_east.GetLongitude(), -math::pi, math::pi));
+  north_east.SetLatitude(
+      math::Clamp(north_east.GetLatitude(), -math::half_pi, math::half_pi));
+
+  const TileKey min_tile_key =
+      TileKeyUtils::GeoCoordinatesToTileKey(tiling_scheme, south_west, level);
+  const TileKey max_tile_key =
+      TileKeyUtils::GeoCoordinatesToTileKey(tiling_scheme, north_east, level);
+  if (!min_tile_key.IsValid() || !max_tile_key.IsValid() ||
+      min_tile_key.Row() > max_tile_key.Row()) {
+    return TileCover(tiling_scheme, level, empty);
+  }
+
+  const auto& subdivision_scheme = tiling_scheme.GetSubdivisionScheme();
+  const std::uint32_t column_count =
+      subdivision_scheme.GetLevelSize(level).Width();
+
+  std::vector<Interval> columns;
+  if (south_west.GetLongitude() <= north_east.GetLongitude()) {
+    columns.push_back({min_tile_key.Column(), max_tile_key.Column()});
+  } else if (min_tile_key.Column() == max_tile_key.Column()) {
+    columns.push_back({0, column_count - 1});
+  } else {
+    columns.push_back({min_tile_key.Column(), column_count - 1});
+    columns.push_back({0, max_tile_key.Column()});
+  }
+
+  return TileCover(
+      tiling_scheme, level,
+      RectangleCoverage(subdivision_scheme, level,
+                        {min_tile_key.Row(), max_tile_key.Row()},
+                        std::move(columns)));
+}
+
+TileCover TileCover::FromPolygon(const ITilingScheme& tiling_scheme,
+                                 std::vector<GeoCoordinates> polygon,
+                                 std::uint32_t level) {
+  if (polygon.size() < 3) {
+    return TileCover(tiling_scheme, level,
+                     [](const TileKey&) { return Coverage::kNone; });
+  }
+
+  std::vector<Point> points;
+  points.reserve(polygon.size());
+  std::transform(polygon.begin(), polygon.end(), std::back_inserter(points),
+                 ToPoint);
+  return TileCover(tiling_scheme, level,
+                   PolygonCoverage(tiling_scheme, std::move(points)));
+}
+
+TileCover TileCover::FromCorridor(const ITilingScheme& tiling_scheme,
+                                  std::vector<GeoCoordinates> path,
+                                  double radius, std::uint32_t level) {
+  if (path.empty()) {
+    return TileCover(tiling_scheme, level,
+                     [](const TileKey&) { return Coverage::kNone; });
+  }
+
+  std::vector<Point> points;
+  points.reserve(path.size());
+  std::transform(path.begin(), path.end(), std::back_inserter(points),
+                 ToPoint);
+  return TileCover(
+      tiling_scheme, level,
+      CorridorCoverage(tiling_scheme, std::move(points),
+                       radius / EarthConstants::EquatorialRadius()));
+}
+
+TileCover TileCover::Compact() const {
+  TileCover cover = *this;
+  cover.compact_ = true;
+  return cover;
+}
+
+TileCover::ConstIterator TileCover::begin() const { return Iterator(*this); }
+
+TileCover::ConstIterator TileCover::end() const { return Iterator(); }
+
+std::vector<TileKey> TileCover::ToTileKeys() const {
+  return std::vector<TileKey>(begin(), end());
+}
+
+TileCover::Iterator::Iterator(const TileCover& cover) : cover_(&cover) {
+  const auto root = TileKey::FromRowColumnLevel(0, 0, 0);
+  const auto coverage = cover.level_ > TileKey::MaxLevel
+                            ? Coverage::kNone
+                            : cover.coverage_(root);
+  if (coverage == Coverage::kNone) {
+    cover_ = nullptr;
+  } else if (cover.level_ == 0 ||
+             (cover.compact_ && coverage == Coverage::kFull)) {
+    tile_key_ = root;
+  } else {
+    Push(root, coverage == Coverage::kFull);
+    Advance();
+  }
+}
+
+TileCover::Iterator& TileCover::Iterator::operator++() {
+  Advance();
+  return *this;
+}
+
+TileCover::Iterator TileCover::Iterator::operator++(int) {
+  Iterator result = *this;
+  Advance();
+  return result;
+}
+
+bool TileCover::Iterator::operator==(const Iterator& other) const {
+  return cover_ == other.cover_ &&
+         (cover_ == nullptr || tile_key_ == other.tile_key_);
+}
+
+void TileCover::Iterator::Push(const TileKey& tile_key, bool is_full) {
+  const auto subdivision =
+      cover_->tiling_scheme_->GetSubdivisionScheme().GetSubdivisionAt(
+          tile_key.Level());
+
+  auto& frame = stack_[depth_++];
+  frame.tile_key = tile_key;
+  frame.next_child = 0;
+  frame.child_count = subdivision.Width() * subdivision.Height();
+  frame.columns = subdivision.Width();
+  frame.is_full = is_full;
+}
+
+void TileCover::Iterator::Advance() {
+  while (depth_ > 0) {
+    auto& frame = stack_[depth_ - 1];
+    if (frame.next_child == frame.child_count) {
+      --depth_;
+      continue;
+    }
+
+    // The children are ordered by row and then by column, which for the quad
+    // tree is the order of the quadkeys.
+    const std::uint32_t index = frame.next_child++;
+    const std::uint32_t rows = frame.child_count / frame.columns;
+    const auto child = TileKey::FromRowColumnLevel(
+        frame.tile_key.Row() * rows + index / frame.columns,
+        frame.tile_key.Column() * frame.columns + index % frame.columns,
+        frame.tile_key.Level() + 1);
+
+    const auto coverage =
+        frame.is_full ? Coverage::kFull : cover_->coverage_(child);
+    if (coverage == Coverage::kNone) {
+      continue;
+    }
+
+    if (child.Level() == cover_->level_ ||
+        (cover_->compact_ && coverage == Coverage::kFull)) {
+      tile_key_ = child;
+      return;
+    }
+
+    Push(child, coverage == Coverage::kFull);
+  }
+
+  cover_ = nullptr;
+}
+
+}  // namespace geo
+}  // namespace olp
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <olp/core/geo/tiling/TileKey.h>
+#include "utils/CpuFeatures.h"
+
+// PDEP and PEXT take 64-bit operands only in the 64-bit mode.
+#if defined(OLP_SDK_CPU_X86) && (defined(__x86_64__) || defined(_M_X64))
+#define OLP_SDK_TILE_KEY_BMI2 1
+#endif
+
+namespace olp {
+namespace geo {
+
+/*
+ * The kernels of the batch quad key conversions. `TileKey` selects one of
+ * them on the first use, and all of them give the same results.
+ */
+
+/// Converts the tile keys to the 64-bit quad keys with a lookup table.
+void EncodeQuadKeysScalar(const TileKey* tile_keys, size_t count,
+                          std::uint64_t* quad_keys);
+
+/// Converts the 64-bit quad keys to the tile keys with the bit shifts.
+void DecodeQuadKeysScalar(const std::uint64_t* quad_keys, size_t count,
+                          TileKey* tile_keys);
+
+#if defined(OLP_SDK_TILE_KEY_BMI2)
+/// Same as `EncodeQuadKeysScalar`, but with PDEP. Needs BMI2.
+void EncodeQuadKeysBmi2(const TileKey* tile_keys, size_t count,
+                        std::uint64_t* quad_keys);
+
+/// Same as `DecodeQuadKeysScalar`, but with PEXT. Needs BMI2.
+void DecodeQuadKeysBmi2(const std::uint64_t* quad_keys, size_t count,
+                        TileKey* tile_keys);
+#endif
+
+}  // namespace geo
+}  // namespace olp
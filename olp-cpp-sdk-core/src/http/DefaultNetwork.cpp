@@ -20,16 +20,36 @@
 #include <algorithm>
 
 #include "DefaultNetwork.h"
-#include "olp/core/http/HttpStatusCode.h"
 #include "olp/core/http/NetworkConstants.h"
 #include "olp/core/http/NetworkUtils.h"
 
 namespace olp {
 namespace http {
+
+namespace {
+// Gets the host and port part of the URL.
+std::string GetHost(const std::string& url) {
+  auto begin = url.find("://");
+  begin = begin == std::string::npos ? 0u : begin + 3u;
+  auto end = url.find_first_of("/?#", begin);
+  end = end == std::string::npos ? url.size() : end;
+
+  const auto credentials_end = url.rfind('@', end);
+  if (credentials_end != std::string::npos && credentials_end >= begin) {
+    begin = credentials_end + 1u;
+  }
+  return url.substr(begin, end - begin);
+}
+}  // namespace
+
 DefaultNetwork::DefaultNetwork(std::shared_ptr<Network> network)
     : current_statistics_bucket_{0}, network_{std::move(network)} {}
 
-DefaultNetwork::~DefaultNetwork() = default;
+DefaultNetwork::~DefaultNetwork() {
+  for (auto& bucket : buckets_) {
+    delete bucket.load();
+  }
+}
 
 SendOutcome DefaultNetwork::Send(NetworkRequest request, Payload payload,
                                  Callback callback,
@@ -43,20 +63,13 @@ SendOutcome DefaultNetwork::Send(NetworkRequest request, Payload payload,
     AppendDefaultHeaders(request_headers);
   }
 
-  const auto bucket_id = current_statistics_bucket_.load();
+  auto& bucket = GetBucket(current_statistics_bucket_.load());
+  auto host = metrics_enabled_.load(std::memory_order_relaxed)
+                  ? GetHost(request.GetUrl())
+                  : std::string();
 
-  auto user_callback = [=](NetworkResponse response) {
-    LockStatistics(bucket_id, [&](Statistics& stats) {
-      const auto status = response.GetStatus();
-      if (status < HttpStatusCode::OK ||
-          status >= HttpStatusCode::BAD_REQUEST) {
-        stats.total_failed++;
-      }
-
-      stats.total_requests++;
-      stats.bytes_downloaded += response.GetBytesDownloaded();
-      stats.bytes_uploaded += response.GetBytesUploaded();
-    });
+  auto user_callback = [=, &bucket](NetworkResponse response) {
+    bucket.Record(response, host);
 
     if (callback) {
       callback(std::move(response));
@@ -81,10 +94,17 @@ void DefaultNetwork::SetCurrentBucket(uint8_t bucket_id) {
 }
 
 DefaultNetwork::Statistics DefaultNetwork::GetStatistics(uint8_t bucket_id) {
-  Statistics result;
-  LockStatistics(bucket_id,
-                 [&](Statistics& statistics) { result = statistics; });
-  return result;
+  const auto bucket = buckets_[bucket_id].load(std::memory_order_acquire);
+  return bucket ? bucket->GetStatistics() : Statistics{};
+}
+
+void DefaultNetwork::SetMetricsEnabled(bool enabled) {
+  metrics_enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+NetworkMetrics DefaultNetwork::GetMetrics(uint8_t bucket_id) {
+  const auto bucket = buckets_[bucket_id].load(std::memory_order_acquire);
+  return bucket ? bucket->GetMetrics() : NetworkMetrics{};
 }
 
 void DefaultNetwork::AppendUserAgent(Headers& request_headers) const {
@@ -110,10 +130,22 @@ void DefaultNetwork::AppendDefaultHeaders(Headers& request_headers) const {
                          default_headers_.end());
 }
 
-void DefaultNetwork::LockStatistics(uint8_t bucket_id,
-                                    std::function<void(Statistics&)> callback) {
-  buckets_.locked(
-      [&](BucketsContainer& container) { callback(container[bucket_id]); });
+NetworkMetricsRecorder& DefaultNetwork::GetBucket(uint8_t bucket_id) {
+  auto& slot = buckets_[bucket_id];
+  auto bucket = slot.load(std::memory_order_acquire);
+  if (bucket) {
+    return *bucket;
+  }
+
+  auto created = new NetworkMetricsRecorder();
+  if (slot.compare_exchange_strong(bucket, created,
+                                   std::memory_order_acq_rel)) {
+    return *created;
+  }
+
+  // Another request created the recorder first.
+  delete created;
+  return *bucket;
 }
 
 }  // namespace http
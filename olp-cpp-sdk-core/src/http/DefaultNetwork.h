@@ -19,13 +19,14 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <limits>
 #include <mutex>
-#include <unordered_map>
 
 #include <olp/core/CoreApi.h>
 #include <olp/core/http/Network.h>
-#include <olp/core/thread/Atomic.h>
+#include "NetworkMetricsRecorder.h"
 
 namespace olp {
 namespace http {
@@ -64,17 +65,27 @@ class DefaultNetwork final : public Network {
   /// Implements the `GetStatistics` method of the `Network` class.
   Statistics GetStatistics(uint8_t bucket_id) override;
 
+  /// Implements the `SetMetricsEnabled` method of the `Network` class.
+  void SetMetricsEnabled(bool enabled) override;
+
+  /// Implements the `GetMetrics` method of the `Network` class.
+  NetworkMetrics GetMetrics(uint8_t bucket_id) override;
+
  private:
   void AppendUserAgent(Headers& request_headers) const;
   void AppendDefaultHeaders(Headers& request_headers) const;
 
-  void LockStatistics(uint8_t bucket_id,
-                      std::function<void(Statistics&)> callback);
+  NetworkMetricsRecorder& GetBucket(uint8_t bucket_id);
 
   std::atomic<uint8_t> current_statistics_bucket_;
-
-  using BucketsContainer = std::unordered_map<uint8_t, Statistics>;
-  thread::Atomic<BucketsContainer> buckets_;
+  std::atomic<bool> metrics_enabled_{false};
+
+  // The recorders are created on the first request of a bucket and are never
+  // replaced, so the callbacks can update them without locking.
+  using BucketsContainer =
+      std::array<std::atomic<NetworkMetricsRecorder*>,
+                 std::numeric_limits<uint8_t>::max() + 1u>;
+  BucketsContainer buckets_{};
 
   std::mutex default_headers_mutex_;
   Headers default_headers_;
@@ -60,6 +60,10 @@ Network::Statistics Network::GetStatistics(uint8_t /*bucket_id*/) {
   return Network::Statistics{};
 }
 
+void Network::SetMetricsEnabled(bool /*enabled*/) {}
+
+NetworkMetrics Network::GetMetrics(uint8_t /*bucket_id*/) { return {}; }
+
 std::shared_ptr<Network> CreateDefaultNetwork(size_t max_requests_count) {
   auto network = CreateDefaultNetworkImpl(max_requests_count);
   if (network) {
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "olp/core/http/NetworkMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace olp {
+namespace http {
+
+namespace {
+// The values below `kSubBucketCount` have a bucket each, so the first
+// power of two that is split into sub-buckets is 2^kSubBucketBits.
+constexpr unsigned kSubBucketBits = 3u;
+
+unsigned HighestBit(std::uint64_t value) {
+  unsigned bit = 0u;
+  for (unsigned shift = 32u; shift > 0u; shift /= 2u) {
+    if (value >> shift) {
+      value >>= shift;
+      bit += shift;
+    }
+  }
+  return bit;
+}
+}  // namespace
+
+constexpr std::size_t LatencyHistogram::kSubBucketCount;
+constexpr std::size_t LatencyHistogram::kBucketCount;
+constexpr std::uint64_t LatencyHistogram::kMaxTrackableValue;
+
+LatencyHistogram::LatencyHistogram(std::vector<std::uint64_t> counts,
+                                   std::uint64_t sum, std::uint64_t max)
+    : counts_(std::move(counts)), sum_(sum), max_(max) {
+  counts_.resize(kBucketCount);
+  for (const auto count : counts_) {
+    count_ += count;
+  }
+}
+
+std::size_t LatencyHistogram::GetBucketIndex(std::uint64_t value) {
+  if (value < kSubBucketCount) {
+    return static_cast<std::size_t>(value);
+  }
+  if (value > kMaxTrackableValue) {
+    return kBucketCount - 1u;
+  }
+
+  const auto exponent = HighestBit(value);
+  const auto sub_bucket =
+      (value >> (exponent - kSubBucketBits)) - kSubBucketCount;
+  return (exponent - kSubBucketBits + 1u) * kSubBucketCount +
+         static_cast<std::size_t>(sub_bucket);
+}
+
+std::uint64_t LatencyHistogram::GetBucketUpperBound(std::size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+
+  const auto shift = index / kSubBucketCount - 1u;
+  const auto sub_bucket = index % kSubBucketCount;
+  return ((kSubBucketCount + sub_bucket + 1u) << shift) - 1u;
+}
+
+void LatencyHistogram::Record(std::uint64_t value) {
+  if (counts_.empty()) {
+    counts_.resize(kBucketCount);
+  }
+
+  ++counts_[GetBucketIndex(value)];
+  ++count_;
+  sum_ += value;
+  max_ = std::max(max_, value);
+}
+
+double LatencyHistogram::GetMean() const {
+  return count_ > 0u ? static_cast<double>(sum_) / count_ : 0.0;
+}
+
+std::uint64_t LatencyHistogram::GetPercentile(double percentile) const {
+  if (count_ == 0u) {
+    return 0u;
+  }
+
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  const auto rank = std::max<std::uint64_t>(
+      1u, static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * count_)));
+
+  std::uint64_t seen = 0u;
+  for (std::size_t index = 0; index < counts_.size(); ++index) {
+    seen += counts_[index];
+    if (seen >= rank) {
+      return std::min(GetBucketUpperBound(index), max_);
+    }
+  }
+  return max_;
+}
+
+std::vector<LatencyHistogram::Bucket> LatencyHistogram::GetBuckets() const {
+  std::vector<Bucket> buckets;
+  for (std::size_t index = 0; index < counts_.size(); ++index) {
+    if (counts_[index] > 0u) {
+      buckets.emplace_back(GetBucketUpperBound(index), counts_[index]);
+    }
+  }
+  return buckets;
+}
+
+LatencyHistogram& LatencyHistogram::operator+=(const LatencyHistogram& other) {
+  if (other.count_ == 0u) {
+    return *this;
+  }
+  if (counts_.empty()) {
+    counts_.resize(kBucketCount);
+  }
+
+  for (std::size_t index = 0; index < other.counts_.size(); ++index) {
+    counts_[index] += other.counts_[index];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  max_ = std::max(max_, other.max_);
+  return *this;
+}
+
+}  // namespace http
+}  // namespace olp
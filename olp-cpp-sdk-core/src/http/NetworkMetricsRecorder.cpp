@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "NetworkMetricsRecorder.h"
+
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "olp/core/http/HttpStatusCode.h"
+
+namespace olp {
+namespace http {
+
+namespace {
+int GetStatusClass(int status) {
+  return status >= 100 && status < 600 ? status / 100 : 0;
+}
+
+void AtomicMax(std::atomic<std::uint64_t>& target, std::uint64_t value) {
+  auto current = target.load(std::memory_order_relaxed);
+  while (current < value &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+}  // namespace
+
+constexpr std::size_t NetworkMetricsRecorder::kShardCount;
+constexpr std::size_t NetworkMetricsRecorder::kMaxSeriesCount;
+
+void NetworkMetricsRecorder::AtomicHistogram::Record(std::uint64_t value) {
+  counts[LatencyHistogram::GetBucketIndex(value)].fetch_add(
+      1u, std::memory_order_relaxed);
+  sum.fetch_add(value, std::memory_order_relaxed);
+  AtomicMax(max, value);
+}
+
+LatencyHistogram NetworkMetricsRecorder::AtomicHistogram::GetSnapshot()
+    const {
+  std::vector<std::uint64_t> snapshot(counts.size());
+  for (std::size_t index = 0; index < counts.size(); ++index) {
+    snapshot[index] = counts[index].load(std::memory_order_relaxed);
+  }
+  return LatencyHistogram(std::move(snapshot),
+                          sum.load(std::memory_order_relaxed),
+                          max.load(std::memory_order_relaxed));
+}
+
+NetworkMetricsRecorder::NetworkMetricsRecorder() = default;
+
+NetworkMetricsRecorder::~NetworkMetricsRecorder() {
+  for (auto& shard : shards_) {
+    for (auto& series : shard.series) {
+      delete series.load();
+    }
+  }
+}
+
+void NetworkMetricsRecorder::Record(const NetworkResponse& response,
+                                    const std::string& host) {
+  auto& shard = GetShard();
+  const auto status = response.GetStatus();
+  const auto bytes_downloaded = response.GetBytesDownloaded();
+  const auto bytes_uploaded = response.GetBytesUploaded();
+
+  if (status < HttpStatusCode::OK || status >= HttpStatusCode::BAD_REQUEST) {
+    shard.total_failed.fetch_add(1u, std::memory_order_relaxed);
+  }
+  shard.total_requests.fetch_add(1u, std::memory_order_relaxed);
+  shard.bytes_downloaded.fetch_add(bytes_downloaded,
+                                   std::memory_order_relaxed);
+  shard.bytes_uploaded.fetch_add(bytes_uploaded, std::memory_order_relaxed);
+
+  if (host.empty()) {
+    return;
+  }
+
+  auto series = FindOrCreateSeries(shard, host, GetStatusClass(status));
+  if (!series) {
+    return;
+  }
+
+  series->requests.fetch_add(1u, std::memory_order_relaxed);
+  series->bytes_downloaded.fetch_add(bytes_downloaded,
+                                     std::memory_order_relaxed);
+  series->bytes_uploaded.fetch_add(bytes_uploaded, std::memory_order_relaxed);
+
+  const auto& timings = response.GetTimings();
+  if (timings.total == 0u) {
+    return;
+  }
+
+  // Reused connections skip the name lookup, connect and TLS phases, their
+  // zero durations would hide the cost of the new connections.
+  if (timings.new_connection) {
+    series->name_lookup.Record(timings.name_lookup);
+    series->connect.Record(timings.connect);
+    if (timings.tls_handshake > 0u) {
+      series->tls_handshake.Record(timings.tls_handshake);
+    }
+  }
+  series->time_to_first_byte.Record(timings.time_to_first_byte);
+  series->total.Record(timings.total);
+}
+
+Network::Statistics NetworkMetricsRecorder::GetStatistics() const {
+  Network::Statistics statistics;
+  for (const auto& shard : shards_) {
+    statistics.bytes_downloaded +=
+        shard.bytes_downloaded.load(std::memory_order_relaxed);
+    statistics.bytes_uploaded +=
+        shard.bytes_uploaded.load(std::memory_order_relaxed);
+    statistics.total_requests +=
+        shard.total_requests.load(std::memory_order_relaxed);
+    statistics.total_failed +=
+        shard.total_failed.load(std::memory_order_relaxed);
+  }
+  return statistics;
+}
+
+NetworkMetrics NetworkMetricsRecorder::GetMetrics() const {
+  std::map<std::pair<std::string, int>, HostMetrics> merged;
+
+  for (const auto& shard : shards_) {
+    for (const auto& slot : shard.series) {
+      const auto series = slot.load(std::memory_order_acquire);
+      if (!series) {
+        continue;
+      }
+
+      auto& metrics = merged[std::make_pair(series->host,
+                                            series->status_class)];
+      metrics.host = series->host;
+      metrics.status_class = series->status_class;
+      metrics.requests += series->requests.load(std::memory_order_relaxed);
+      metrics.bytes_downloaded +=
+          series->bytes_downloaded.load(std::memory_order_relaxed);
+      metrics.bytes_uploaded +=
+          series->bytes_uploaded.load(std::memory_order_relaxed);
+      metrics.name_lookup += series->name_lookup.GetSnapshot();
+      metrics.connect += series->connect.GetSnapshot();
+      metrics.tls_handshake += series->tls_handshake.GetSnapshot();
+      metrics.time_to_first_byte += series->time_to_first_byte.GetSnapshot();
+      metrics.total += series->total.GetSnapshot();
+    }
+  }
+
+  NetworkMetrics result;
+  result.reserve(merged.size());
+  for (auto& metrics : merged) {
+    result.push_back(std::move(metrics.second));
+  }
+  return result;
+}
+
+NetworkMetricsRecorder::Shard& NetworkMetricsRecorder::GetShard() {
+  // Threads are assigned to the shards round-robin on their first request.
+  static std::atomic<std::size_t> next_shard{0u};
+  static thread_local const std::size_t shard =
+      next_shard.fetch_add(1u, std::memory_order_relaxed) % kShardCount;
+  return shards_[shard];
+}
+
+NetworkMetricsRecorder::Series* NetworkMetricsRecorder::FindOrCreateSeries(
+    Shard& shard, const std::string& host, int status_class) {
+  const auto hash = std::hash<std::string>()(host) ^
+                    static_cast<std::size_t>(status_class);
+  Series* created = nullptr;
+
+  // Open addressing with linear probing. Slots are never cleared, so a
+  // series found once stays valid until the recorder is destroyed.
+  for (std::size_t probe = 0; probe < kMaxSeriesCount; ++probe) {
+    auto& slot = shard.series[(hash + probe) % kMaxSeriesCount];
+    auto series = slot.load(std::memory_order_acquire);
+
+    if (!series) {
+      if (!created) {
+        created = new Series(host, status_class);
+      }
+      if (slot.compare_exchange_strong(series, created,
+                                       std::memory_order_acq_rel)) {
+        return created;
+      }
+      // Another thread took the slot, `series` now points to its series.
+    }
+
+    if (series->status_class == status_class && series->host == host) {
+      delete created;
+      return series;
+    }
+  }
+
+  delete created;
+  return nullptr;
+}
+
+}  // namespace http
+}  // namespace olp
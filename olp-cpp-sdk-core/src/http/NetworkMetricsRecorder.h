@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <olp/core/http/Network.h>
+#include <olp/core/http/NetworkMetrics.h>
+#include <olp/core/http/NetworkResponse.h>
+
+namespace olp {
+namespace http {
+
+/**
+ * @brief Collects the statistics and the per-host metrics of a bucket.
+ *
+ * Recording is lock-free. The counters are split into shards that are
+ * selected by the recording thread, so concurrent callbacks do not contend
+ * on the same cache lines. The snapshots sum up all shards.
+ */
+class NetworkMetricsRecorder final {
+ public:
+  NetworkMetricsRecorder();
+  ~NetworkMetricsRecorder();
+
+  NetworkMetricsRecorder(const NetworkMetricsRecorder&) = delete;
+  NetworkMetricsRecorder& operator=(const NetworkMetricsRecorder&) = delete;
+
+  /**
+   * @brief Adds a completed request.
+   *
+   * @param response The network response.
+   * @param host The host of the request, or an empty string to update only
+   * the bucket statistics.
+   */
+  void Record(const NetworkResponse& response, const std::string& host);
+
+  Network::Statistics GetStatistics() const;
+
+  NetworkMetrics GetMetrics() const;
+
+ private:
+  static constexpr std::size_t kShardCount = 8u;
+  // The number of host and status class pairs that each shard can track.
+  // Requests to further hosts are counted only in the bucket statistics.
+  static constexpr std::size_t kMaxSeriesCount = 64u;
+
+  struct AtomicHistogram {
+    void Record(std::uint64_t value);
+    LatencyHistogram GetSnapshot() const;
+
+    std::array<std::atomic<std::uint64_t>, LatencyHistogram::kBucketCount>
+        counts{};
+    std::atomic<std::uint64_t> sum{0u};
+    std::atomic<std::uint64_t> max{0u};
+  };
+
+  struct Series {
+    Series(std::string host, int status_class)
+        : host(std::move(host)), status_class(status_class) {}
+
+    const std::string host;
+    const int status_class;
+    std::atomic<std::uint64_t> requests{0u};
+    std::atomic<std::uint64_t> bytes_downloaded{0u};
+    std::atomic<std::uint64_t> bytes_uploaded{0u};
+    AtomicHistogram name_lookup;
+    AtomicHistogram connect;
+    AtomicHistogram tls_handshake;
+    AtomicHistogram time_to_first_byte;
+    AtomicHistogram total;
+  };
+
+  struct Shard {
+    std::atomic<std::uint64_t> bytes_downloaded{0u};
+    std::atomic<std::uint64_t> bytes_uploaded{0u};
+    std::atomic<std::uint32_t> total_requests{0u};
+    std::atomic<std::uint32_t> total_failed{0u};
+    std::array<std::atomic<Series*>, kMaxSeriesCount> series{};
+  };
+
+  Shard& GetShard();
+
+  static Series* FindOrCreateSeries(Shard& shard, const std::string& host,
+                                    int status_class);
+
+  std::array<Shard, kShardCount> shards_;
+};
+
+}  // namespace http
+}  // namespace olp
@@ -65,5 +65,12 @@ NetworkResponse& NetworkResponse::WithBytesDownloaded(
   return *this;
 }
 
+const NetworkTimings& NetworkResponse::GetTimings() const { return timings_; }
+
+NetworkResponse& NetworkResponse::WithTimings(const NetworkTimings& timings) {
+  timings_ = timings;
+  return *this;
+}
+
 }  // namespace http
 }  // namespace olp
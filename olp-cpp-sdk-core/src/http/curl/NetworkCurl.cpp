@@ -202,6 +202,36 @@ void GetTrafficData(CURL* handle, uint64_t& upload_bytes,
   }
 }
 
+/**
+ * @brief CURL get the durations of the request phases.
+ * @param[in] handle CURL easy handle.
+ * @return The timings in microseconds since the start of the request.
+ */
+NetworkTimings GetTimings(CURL* handle) {
+  auto get_time = [handle](CURLINFO info) -> uint64_t {
+    double seconds = 0.0;
+    if (curl_easy_getinfo(handle, info, &seconds) == CURLE_OK &&
+        seconds > 0.0) {
+      return static_cast<uint64_t>(seconds * 1000000.0);
+    }
+    return 0u;
+  };
+
+  NetworkTimings timings;
+  timings.name_lookup = get_time(CURLINFO_NAMELOOKUP_TIME);
+  timings.connect = get_time(CURLINFO_CONNECT_TIME);
+  timings.tls_handshake = get_time(CURLINFO_APPCONNECT_TIME);
+  timings.time_to_first_byte = get_time(CURLINFO_STARTTRANSFER_TIME);
+  timings.total = get_time(CURLINFO_TOTAL_TIME);
+
+  long connects = 0;
+  timings.new_connection =
+      curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects) ==
+          CURLE_OK &&
+      connects > 0;
+  return timings;
+}
+
 int64_t GetElapsedTime(std::chrono::steady_clock::time_point start) {
   return std::chrono::duration_cast<std::chrono::milliseconds>(
              std::chrono::steady_clock::now() - start)
@@ -866,7 +896,8 @@ void NetworkCurl::CompleteMessage(CURL* handle, CURLcode result) {
                           << ", time=" << GetElapsedTime(rhandle.send_time)
                           << "ms, bytes=" << download_bytes + upload_bytes);
 
-    response.WithStatus(status).WithError(error);
+    response.WithStatus(status).WithError(error).WithTimings(
+        GetTimings(rhandle.handle));
     ReleaseHandleUnlocked(&rhandle);
 
     lock.unlock();
@@ -61,6 +61,7 @@ class LogImpl {
 
   bool isEnabled(Level level) const;
   bool isEnabled(Level level, const std::string& tag) const;
+  bool isEnabled(Level level, const char* tag) const;
 
   void logMessage(Level level, const std::string& tag,
                   const std::string& message, const char* file,
@@ -155,6 +156,13 @@ bool LogImpl::isEnabled(Level level, const std::string& tag) const {
   return static_cast<int>(level) >= static_cast<int>(targetLevel);
 }
 
+bool LogImpl::isEnabled(Level level, const char* tag) const {
+  // Avoids the construction of the tag string for the lookup.
+  if (m_logLevels.empty()) return isEnabled(level);
+
+  return isEnabled(level, std::string(tag));
+}
+
 void LogImpl::logMessage(Level level, const std::string& tag,
                          const std::string& message, const char* file,
                          unsigned int line, const char* function,
@@ -274,6 +282,13 @@ bool Log::isEnabled(Level level, const std::string& tag) {
       [level, &tag](const LogImpl& log) { return log.isEnabled(level, tag); });
 }
 
+bool Log::isEnabled(Level level, const char* tag) {
+  if (!LogImpl::aliveStatus()) return false;
+
+  return LogImpl::getInstance().locked(
+      [level, tag](const LogImpl& log) { return log.isEnabled(level, tag); });
+}
+
 void Log::logMessage(Level level, const std::string& tag,
                      const std::string& message, const char* file,
                      unsigned int line, const char* function,
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "olp/core/tracing/ChromeTraceRecorder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace olp {
+namespace tracing {
+
+namespace {
+void WriteJsonString(std::ostream& stream, const std::string& value) {
+  stream << '"';
+  for (const auto c : value) {
+    switch (c) {
+      case '"':
+        stream << "\\\"";
+        break;
+      case '\\':
+        stream << "\\\\";
+        break;
+      case '\n':
+        stream << "\\n";
+        break;
+      case '\r':
+        stream << "\\r";
+        break;
+      case '\t':
+        stream << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x",
+                        static_cast<unsigned>(c));
+          stream << escaped;
+        } else {
+          stream << c;
+        }
+    }
+  }
+  stream << '"';
+}
+
+void WriteArgument(std::ostream& stream, const char* name,
+                   const std::string& value, bool& first) {
+  if (value.empty()) {
+    return;
+  }
+  if (!first) {
+    stream << ',';
+  }
+  first = false;
+  stream << '"' << name << "\":";
+  WriteJsonString(stream, value);
+}
+}  // namespace
+
+constexpr std::size_t ChromeTraceRecorder::kDefaultMaxEvents;
+
+class ChromeTraceRecorder::Impl {
+ public:
+  struct Event {
+    std::string name;
+    SpanAttributes attributes;
+    std::uint32_t thread_id;
+    std::int64_t begin;
+    std::int64_t duration;
+  };
+
+  explicit Impl(std::size_t max_events)
+      : max_events_(max_events), start_(std::chrono::steady_clock::now()) {}
+
+  SpanId Begin(const char* name, const SpanAttributes& attributes) {
+    Event event{name, attributes, 0u, Now(), 0};
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    event.thread_id = GetThreadId();
+    const auto id = next_id_++;
+    open_events_.emplace(id, std::move(event));
+    return id;
+  }
+
+  void End(SpanId id) {
+    const auto end = Now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = open_events_.find(id);
+    if (it == open_events_.end()) {
+      return;
+    }
+
+    if (events_.size() < max_events_) {
+      it->second.duration = end - it->second.begin;
+      events_.push_back(std::move(it->second));
+    }
+    open_events_.erase(it);
+  }
+
+  void Write(std::ostream& stream) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    stream << "{\"traceEvents\":[";
+    bool first_event = true;
+    for (const auto& event : events_) {
+      if (!first_event) {
+        stream << ",\n";
+      }
+      first_event = false;
+
+      stream << "{\"name\":";
+      WriteJsonString(stream, event.name);
+      stream << ",\"cat\":\"olp\",\"ph\":\"X\",\"ts\":" << event.begin
+             << ",\"dur\":" << event.duration
+             << ",\"pid\":1,\"tid\":" << event.thread_id << ",\"args\":{";
+
+      const auto& attributes = event.attributes;
+      bool first_argument = true;
+      WriteArgument(stream, "request_id", attributes.GetRequestId(),
+                    first_argument);
+      WriteArgument(stream, "catalog", attributes.GetCatalog(),
+                    first_argument);
+      WriteArgument(stream, "layer", attributes.GetLayer(), first_argument);
+      WriteArgument(stream, "partition", attributes.GetPartition(),
+                    first_argument);
+      WriteArgument(stream, "details", attributes.GetDetails(),
+                    first_argument);
+      stream << "}}";
+    }
+    stream << "],\"displayTimeUnit\":\"ms\"}";
+  }
+
+  std::size_t GetEventCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_.size();
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+  }
+
+ private:
+  std::int64_t Now() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start_)
+        .count();
+  }
+
+  // Maps the threads to small numbers, the viewers show one row per thread.
+  std::uint32_t GetThreadId() {
+    const auto result = thread_ids_.emplace(
+        std::this_thread::get_id(),
+        static_cast<std::uint32_t>(thread_ids_.size() + 1u));
+    return result.first->second;
+  }
+
+  const std::size_t max_events_;
+  const std::chrono::steady_clock::time_point start_;
+  mutable std::mutex mutex_;
+  SpanId next_id_{1u};
+  std::unordered_map<SpanId, Event> open_events_;
+  std::unordered_map<std::thread::id, std::uint32_t> thread_ids_;
+  std::vector<Event> events_;
+};
+
+ChromeTraceRecorder::ChromeTraceRecorder(std::size_t max_events)
+    : impl_(new Impl(max_events)) {}
+
+ChromeTraceRecorder::~ChromeTraceRecorder() = default;
+
+Tracer::SpanId ChromeTraceRecorder::BeginSpan(
+    const char* name, const SpanAttributes& attributes) {
+  return impl_->Begin(name, attributes);
+}
+
+void ChromeTraceRecorder::EndSpan(SpanId id) { impl_->End(id); }
+
+void ChromeTraceRecorder::Write(std::ostream& stream) const {
+  impl_->Write(stream);
+}
+
+std::size_t ChromeTraceRecorder::GetEventCount() const {
+  return impl_->GetEventCount();
+}
+
+void ChromeTraceRecorder::Clear() { impl_->Clear(); }
+
+}  // namespace tracing
+}  // namespace olp
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "olp/core/tracing/Tracer.h"
+
+#include <atomic>
+
+namespace olp {
+namespace tracing {
+
+namespace {
+// The flag keeps the disabled check to a single relaxed load, the tracer
+// itself is read only when the flag is set.
+std::atomic<bool> g_tracing_enabled{false};
+std::shared_ptr<Tracer> g_tracer;
+}  // namespace
+
+void SetTracer(std::shared_ptr<Tracer> tracer) {
+  const bool enabled = tracer != nullptr;
+  std::atomic_store(&g_tracer, std::move(tracer));
+  g_tracing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+std::shared_ptr<Tracer> GetTracer() {
+  if (!IsTracingEnabled()) {
+    return nullptr;
+  }
+  return std::atomic_load(&g_tracer);
+}
+
+bool IsTracingEnabled() {
+  return g_tracing_enabled.load(std::memory_order_relaxed);
+}
+
+Span::Span(const char* name) {
+  if (IsTracingEnabled()) {
+    Begin(name, SpanAttributes());
+  }
+}
+
+Span::~Span() { End(); }
+
+Span::Span(Span&& other) noexcept
+    : tracer_(std::move(other.tracer_)), id_(other.id_) {}
+
+Span& Span::operator=(Span&& other) noexcept {
+  if (this != &other) {
+    End();
+    tracer_ = std::move(other.tracer_);
+    id_ = other.id_;
+  }
+  return *this;
+}
+
+void Span::End() {
+  if (tracer_) {
+    tracer_->EndSpan(id_);
+    tracer_.reset();
+  }
+}
+
+void Span::Begin(const char* name, const SpanAttributes& attributes) {
+  tracer_ = GetTracer();
+  if (tracer_) {
+    id_ = tracer_->BeginSpan(name, attributes);
+  }
+}
+
+}  // namespace tracing
+}  // namespace olp
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "CpuFeatures.h"
+
+#include <cstdint>
+
+#if defined(OLP_SDK_CPU_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace olp {
+namespace utils {
+namespace cpu {
+
+namespace {
+
+#if defined(OLP_SDK_CPU_X86)
+void CpuId(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+  for (int i = 0; i < 4; ++i) {
+    regs[i] = static_cast<uint32_t>(info[i]);
+  }
+#else
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+bool OsSupportsAvx() {
+#if defined(_MSC_VER)
+  return (_xgetbv(0) & 0x6) == 0x6;
+#else
+  uint32_t eax = 0, edx = 0;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (eax & 0x6) == 0x6;
+#endif
+}
+#endif
+
+Features Detect() {
+  Features features;
+#if defined(OLP_SDK_CPU_X86)
+  uint32_t regs[4] = {0, 0, 0, 0};
+  CpuId(0, 0, regs);
+  const auto max_leaf = regs[0];
+  // The vendor string "AuthenticAMD" is stored in EBX, EDX and ECX.
+  const bool amd = regs[1] == 0x68747541u && regs[3] == 0x69746e65u &&
+                   regs[2] == 0x444d4163u;
+  if (max_leaf < 1) {
+    return features;
+  }
+
+  CpuId(1, 0, regs);
+  const auto base_family = (regs[0] >> 8) & 0xFu;
+  const auto family = base_family == 0xFu
+                           ? base_family + ((regs[0] >> 20) & 0xFFu)
+                           : base_family;
+  features.sse2 = (regs[3] & (1u << 26)) != 0;
+  features.ssse3 = (regs[2] & (1u << 9)) != 0;
+  features.sse41 = (regs[2] & (1u << 19)) != 0;
+  const bool osxsave = (regs[2] & (1u << 27)) != 0;
+  const bool avx = (regs[2] & (1u << 28)) != 0;
+
+  if (max_leaf >= 7) {
+    CpuId(7, 0, regs);
+    features.avx2 =
+        avx && osxsave && OsSupportsAvx() && (regs[1] & (1u << 5)) != 0;
+    features.bmi2 = (regs[1] & (1u << 8)) != 0;
+    features.fast_pdep = features.bmi2 && (!amd || family >= 0x19u);
+    features.sha = features.ssse3 && features.sse41 &&
+                   (regs[1] & (1u << 29)) != 0;
+  }
+#endif
+  return features;
+}
+
+}  // namespace
+
+const Features& GetFeatures() {
+  static const Features features = Detect();
+  return features;
+}
+
+}  // namespace cpu
+}  // namespace utils
+}  // namespace olp
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define OLP_SDK_CPU_X86 1
+/// Target attributes are used to compile the ISA specific kernels.
+#define OLP_SDK_CPU_TARGET(isa) __attribute__((target(isa)))
+#elif (defined(_M_X64) || defined(_M_IX86)) && defined(_MSC_VER)
+#define OLP_SDK_CPU_X86 1
+/// MSVC allows intrinsics without per-function target attributes.
+#define OLP_SDK_CPU_TARGET(isa)
+#endif
+
+namespace olp {
+namespace utils {
+namespace cpu {
+
+/**
+ * @brief The instruction set extensions available on the running CPU.
+ *
+ * The features are detected once on the first access and then cached, so it
+ * is cheap to query them on hot paths to select an implementation.
+ */
+struct Features {
+  bool sse2{false};
+  bool ssse3{false};
+  bool sse41{false};
+  bool avx2{false};
+  bool bmi2{false};
+  bool sha{false};
+  /// True if PDEP and PEXT of BMI2 are not microcoded, which makes them slower
+  /// than the portable code on AMD CPUs before Zen 3.
+  bool fast_pdep{false};
+};
+
+/**
+ * @brief Gets the features of the running CPU.
+ *
+ * All features are reported as unavailable on non-x86 platforms.
+ *
+ * @return The detected CPU features.
+ */
+const Features& GetFeatures();
+
+}  // namespace cpu
+}  // namespace utils
+}  // namespace olp
@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "olp/core/utils/Sha256.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "CpuFeatures.h"
+
+#if defined(OLP_SDK_CPU_X86)
+#include <immintrin.h>
+#endif
+
+namespace olp {
+namespace utils {
+
+namespace {
+
+// SHA-256 algorithm as defined in FIPS 180-4.
+// https://nvlpubs.nist.gov/nistpubs/FIPS/NIST.FIPS.180-4.pdf
+
+alignas(16) constexpr uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr uint32_t kInitialState[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                       0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                       0x1f83d9ab, 0x5be0cd19};
+
+using TransformFunction = void (*)(uint32_t* state, const uint8_t* data,
+                                   size_t blocks);
+
+inline uint32_t RotateRight(uint32_t x, uint32_t n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+inline uint32_t LoadBigEndian(const uint8_t* data) {
+  return (static_cast<uint32_t>(data[0]) << 24) |
+         (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
+
+void TransformScalar(uint32_t* state, const uint8_t* data, size_t blocks) {
+  uint32_t w[64];
+
+  for (; blocks > 0; --blocks, data += 64) {
+    for (int i = 0; i < 16; ++i) {
+      w[i] = LoadBigEndian(data + i * 4);
+    }
+    for (int i = 16; i < 64; ++i) {
+      const uint32_t s0 = RotateRight(w[i - 15], 7) ^
+                          RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      const uint32_t s1 = RotateRight(w[i - 2], 17) ^
+                          RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int i = 0; i < 64; ++i) {
+      const uint32_t sum1 =
+          RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+      const uint32_t ch = (e & f) ^ (~e & g);
+      const uint32_t t1 = h + sum1 + ch + kRoundConstants[i] + w[i];
+      const uint32_t sum0 =
+          RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+      const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+      const uint32_t t2 = sum0 + maj;
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+}
+
+#if defined(OLP_SDK_CPU_X86)
+// Uses the Intel SHA extensions. Each `sha256rnds2` performs two rounds, the
+// message schedule is computed with `sha256msg1` and `sha256msg2`.
+OLP_SDK_CPU_TARGET("sha,sse4.1,ssse3")
+void TransformShaNi(uint32_t* state, const uint8_t* data, size_t blocks) {
+  const __m128i kByteSwapMask =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+  // The hardware expects the state as ABEF and CDGH.
+  __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+  __m128i state1 =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+  tmp = _mm_shuffle_epi32(tmp, 0xB1);
+  state1 = _mm_shuffle_epi32(state1, 0x1B);
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+  state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+  for (; blocks > 0; --blocks, data += 64) {
+    const __m128i abef_save = state0;
+    const __m128i cdgh_save = state1;
+    __m128i msg[4];
+
+    for (int i = 0; i < 16; ++i) {
+      if (i < 4) {
+        msg[i] = _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)),
+            kByteSwapMask);
+      }
+
+      __m128i rounds = _mm_add_epi32(
+          msg[i & 3], _mm_load_si128(reinterpret_cast<const __m128i*>(
+                          &kRoundConstants[i * 4])));
+      state1 = _mm_sha256rnds2_epu32(state1, state0, rounds);
+
+      if (i >= 3 && i < 15) {
+        const __m128i next =
+            _mm_add_epi32(msg[(i + 1) & 3],
+                          _mm_alignr_epi8(msg[i & 3], msg[(i + 3) & 3], 4));
+        msg[(i + 1) & 3] = _mm_sha256msg2_epu32(next, msg[i & 3]);
+      }
+
+      rounds = _mm_shuffle_epi32(rounds, 0x0E);
+      state0 = _mm_sha256rnds2_epu32(state0, state1, rounds);
+
+      if (i >= 1 && i < 13) {
+        msg[(i + 3) & 3] = _mm_sha256msg1_epu32(msg[(i + 3) & 3], msg[i & 3]);
+      }
+    }
+
+    state0 = _mm_add_epi32(state0, abef_save);
+    state1 = _mm_add_epi32(state1, cdgh_save);
+  }
+
+  tmp = _mm_shuffle_epi32(state0, 0x1B);
+  state1 = _mm_shuffle_epi32(state1, 0xB1);
+  state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+  state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+#endif
+
+TransformFunction SelectTransform() {
+#if defined(OLP_SDK_CPU_X86)
+  if (cpu::GetFeatures().sha) {
+    return &TransformShaNi;
+  }
+#endif
+  return &TransformScalar;
+}
+
+void Transform(uint32_t* state, const uint8_t* data, size_t blocks) {
+  static const TransformFunction transform = SelectTransform();
+  transform(state, data, blocks);
+}
+
+}  // namespace
+
+constexpr size_t Sha256::kDigestLength;
+constexpr size_t Sha256::kBlockLength;
+
+Sha256::Sha256() { Reset(); }
+
+void Sha256::Reset() {
+  std::copy(std::begin(kInitialState), std::end(kInitialState),
+            state_.begin());
+  buffer_size_ = 0;
+  total_size_ = 0;
+}
+
+Sha256& Sha256::Update(const void* data, size_t size) {
+  if (size == 0) {
+    return *this;
+  }
+
+  auto bytes = static_cast<const uint8_t*>(data);
+  total_size_ += size;
+
+  if (buffer_size_ > 0) {
+    const auto to_copy = std::min(kBlockLength - buffer_size_, size);
+    std::memcpy(buffer_.data() + buffer_size_, bytes, to_copy);
+    buffer_size_ += to_copy;
+    bytes += to_copy;
+    size -= to_copy;
+
+    if (buffer_size_ < kBlockLength) {
+      return *this;
+    }
+
+    Transform(state_.data(), buffer_.data(), 1);
+    buffer_size_ = 0;
+  }
+
+  // Hash the full blocks directly from the input without copying.
+  const auto blocks = size / kBlockLength;
+  if (blocks > 0) {
+    Transform(state_.data(), bytes, blocks);
+    bytes += blocks * kBlockLength;
+    size -= blocks * kBlockLength;
+  }
+
+  if (size > 0) {
+    std::memcpy(buffer_.data(), bytes, size);
+    buffer_size_ = size;
+  }
+
+  return *this;
+}
+
+Sha256::Digest Sha256::Finalize() {
+  const uint64_t length_in_bits = total_size_ * 8;
+
+  buffer_[buffer_size_++] = 0x80;
+  if (buffer_size_ > kBlockLength - 8) {
+    std::fill(buffer_.begin() + buffer_size_, buffer_.end(), 0);
+    Transform(state_.data(), buffer_.data(), 1);
+    buffer_size_ = 0;
+  }
+  std::fill(buffer_.begin() + buffer_size_, buffer_.end() - 8, 0);
+  for (size_t i = 0; i < 8; ++i) {
+    buffer_[kBlockLength - 1 - i] =
+        static_cast<uint8_t>(length_in_bits >> (i * 8));
+  }
+  Transform(state_.data(), buffer_.data(), 1);
+
+  Digest digest;
+  for (size_t i = 0; i < state_.size(); ++i) {
+    digest[i * 4 + 0] = static_cast<uint8_t>(state_[i] >> 24);
+    digest[i * 4 + 1] = static_cast<uint8_t>(state_[i] >> 16);
+    digest[i * 4 + 2] = static_cast<uint8_t>(state_[i] >> 8);
+    digest[i * 4 + 3] = static_cast<uint8_t>(state_[i]);
+  }
+
+  Reset();
+  return digest;
+}
+
+Sha256::Digest Sha256::Compute(const void* data, size_t size) {
+  Sha256 sha;
+  sha.Update(data, size);
+  return sha.Finalize();
+}
+
+std::string Sha256::ToHexString(const Digest& digest) {
+  static const char kHexDigits[] = "0123456789abcdef";
+  std::string result(digest.size() * 2, '\0');
+  for (size_t i = 0; i < digest.size(); ++i) {
+    result[i * 2] = kHexDigits[digest[i] >> 4];
+    result[i * 2 + 1] = kHexDigits[digest[i] & 0x0f];
+  }
+  return result;
+}
+
+}  // namespace utils
+}  // namespace olp
@@ -35,8 +35,12 @@ void Populate(olp::cache::InMemoryCache& cache, int count, int first = 0) {
   }
 }
 
-using ItemTuple = olp::cache::InMemoryCache::ItemTuple;
-using EqualityCacheCost = olp::utils::CacheCost<ItemTuple>;
+using CacheValue = olp::cache::InMemoryCache::Value;
+
+struct EqualityCacheCost {
+  std::size_t operator()(const CacheValue&, std::size_t) const { return 1; }
+};
+
 using Data = std::shared_ptr<std::vector<unsigned char>>;
 
 Data CreateDataContainer(int length) {
@@ -335,10 +339,10 @@ TEST(InMemoryCacheTest, CustomCost) {
   auto oversized_model = "value: " + oversized;
 
   struct MyCacheCost {
-    std::size_t operator()(const ItemTuple&) const { return 2; }
+    std::size_t operator()(const CacheValue&, std::size_t) const { return 2; }
   };
 
-  auto cost_func = [](const ItemTuple&) { return 2; };
+  auto cost_func = [](const CacheValue&, std::size_t) { return 2; };
 
   olp::cache::InMemoryCache cache(1, MyCacheCost());
 
@@ -366,11 +370,10 @@ TEST(InMemoryCacheTest, StaticNoLimit) {
 }
 
 TEST(InMemoryCacheTest, ClassBasedCustomCost) {
-  auto class_model_cache_cost = [](const ItemTuple& tuple) {
-    auto model_item = std::get<2>(tuple);
+  auto class_model_cache_cost = [](const CacheValue& value, std::size_t) {
     std::size_t result(1u);
 
-    if (auto data_container = boost::any_cast<Data>(model_item)) {
+    if (auto data_container = value.data) {
       auto data_size = data_container->size();
       result = (data_size > 0) ? data_size : result;
     }
@@ -416,4 +419,48 @@ TEST(InMemoryCacheTest, ClassBasedCustomCost) {
     ASSERT_EQ(0u, cache.Size());
   }
 }
+
+TEST(InMemoryCacheTest, PutOverwritesExpiry) {
+  time_t now = std::time(nullptr);
+
+  olp::cache::InMemoryCache cache(10, EqualityCacheCost(), [&] { return now; });
+
+  std::string key("key");
+  ASSERT_TRUE(cache.Put(key, Value(1), 1));
+  ASSERT_TRUE(cache.Put(key, Value(2)));
+  ASSERT_TRUE(cache.Put("removed", Value(3), 1));
+  ASSERT_TRUE(cache.Remove("removed"));
+
+  // wait 2 seconds
+  now += 2;
+
+  auto value = cache.Get(key);
+  ASSERT_FALSE(value.empty());
+  ASSERT_EQ(Value(2), boost::any_cast<std::string>(value));
+  ASSERT_EQ(1u, cache.Size());
+}
+
+TEST(InMemoryCacheTest, BinaryData) {
+  olp::cache::InMemoryCache cache;
+
+  auto data = CreateDataContainer(5);
+  ASSERT_TRUE(cache.Put("data", data));
+  ASSERT_TRUE(cache.Put("boxed", boost::any(data)));
+  ASSERT_TRUE(cache.Put("object", Value(1)));
+
+  Data result;
+  ASSERT_TRUE(cache.Get("data", result));
+  ASSERT_EQ(data, result);
+
+  result.reset();
+  ASSERT_TRUE(cache.Get("boxed", result));
+  ASSERT_EQ(data, result);
+
+  ASSERT_FALSE(cache.Get("object", result));
+  ASSERT_FALSE(cache.Get("missing", result));
+
+  auto value = cache.Get("data");
+  ASSERT_FALSE(value.empty());
+  ASSERT_EQ(data, boost::any_cast<Data>(value));
+}
 }  // namespace
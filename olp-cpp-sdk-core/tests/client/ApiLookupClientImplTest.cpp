@@ -18,11 +18,17 @@
  */
 
 #include <gmock/gmock.h>
+
+#include <chrono>
+#include <future>
+#include <thread>
+
 #include <matchers/NetworkUrlMatchers.h>
 #include <mocks/CacheMock.h>
 #include <mocks/NetworkMock.h>
 #include <olp/core/client/OlpClientSettingsFactory.h>
 #include "client/ApiLookupClientImpl.h"
+#include "client/ApiLookupRegistry.h"
 
 namespace {
 namespace client = olp::client;
@@ -60,6 +66,8 @@ class ApiLookupClientImplTest : public ::testing::Test {
     settings_.retry_settings.timeout = 1;
   }
 
+  void TearDown() override { client::ApiLookupRegistry::Instance().Clear(); }
+
  protected:
   client::OlpClientSettings settings_;
   std::shared_ptr<testing::StrictMock<CacheMock>> cache_;
@@ -362,6 +370,9 @@ TEST_F(ApiLookupClientImplTest, LookupApi) {
 
   {
     SCOPED_TRACE("Client caching from online");
+    // The lookups of the previous sections are shared in memory.
+    client::ApiLookupRegistry::Instance().Clear();
+
     EXPECT_CALL(*network_, Send(IsGetRequest(lookup_url), _, _, _, _))
         .Times(1)
         .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
@@ -396,6 +407,9 @@ TEST_F(ApiLookupClientImplTest, LookupApi) {
 
   {
     SCOPED_TRACE("Client caching from cache");
+    // The lookups of the previous sections are shared in memory.
+    client::ApiLookupRegistry::Instance().Clear();
+
     EXPECT_CALL(*network_, Send(IsGetRequest(lookup_url), _, _, _, _)).Times(0);
 
     EXPECT_CALL(*cache_, Get(cache_key, _))
@@ -796,6 +810,9 @@ TEST_F(ApiLookupClientImplTest, LookupApiAsync) {
 
   {
     SCOPED_TRACE("Client caching from online");
+    // The lookups of the previous sections are shared in memory.
+    client::ApiLookupRegistry::Instance().Clear();
+
     EXPECT_CALL(*network_, Send(IsGetRequest(lookup_url), _, _, _, _))
         .Times(1)
         .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
@@ -836,6 +853,9 @@ TEST_F(ApiLookupClientImplTest, LookupApiAsync) {
 
   {
     SCOPED_TRACE("Client caching from cache");
+    // The lookups of the previous sections are shared in memory.
+    client::ApiLookupRegistry::Instance().Clear();
+
     EXPECT_CALL(*network_, Send(IsGetRequest(lookup_url), _, _, _, _)).Times(0);
 
     EXPECT_CALL(*cache_, Get(cache_key, _))
@@ -988,4 +1008,179 @@ TEST_F(ApiLookupClientImplTest, CustomCatalogProviderAsync) {
   }
 }
 
+TEST_F(ApiLookupClientImplTest, SharedLookup) {
+  const std::string catalog =
+      "hrn:here:data::olp-here-test:hereos-internal-test-v2";
+  const auto catalog_hrn = client::HRN::FromString(catalog);
+  const std::string lookup_url =
+      "https://api-lookup.data.api.platform.here.com/lookup/v1/resources/" +
+      catalog + "/apis";
+
+  EXPECT_CALL(*network_, Send(IsGetRequest(lookup_url), _, _, _, _))
+      .Times(1)
+      .WillOnce(ReturnHttpResponse(
+          olp::http::NetworkResponse().WithStatus(
+              olp::http::HttpStatusCode::OK),
+          kResponseLookupResource, {}, std::chrono::milliseconds(100)));
+  EXPECT_CALL(*cache_, Get(_, _)).Times(2).WillRepeatedly(Return(boost::any()));
+  EXPECT_CALL(*cache_, Put(_, _, _, _)).Times(3);
+
+  using LookupApiResponse = client::ApiLookupClient::LookupApiResponse;
+  std::promise<LookupApiResponse> first_promise;
+  std::promise<LookupApiResponse> second_promise;
+
+  // Both clients wait for the same request.
+  client::ApiLookupClientImpl first_client(catalog_hrn, settings_);
+  first_client.LookupApi("random_service", "v8",
+                         client::FetchOptions::OnlineIfNotFound,
+                         [&](LookupApiResponse response) {
+                           first_promise.set_value(std::move(response));
+                         });
+
+  client::ApiLookupClientImpl second_client(catalog_hrn, settings_);
+  second_client.LookupApi("pipelines", "v2",
+                          client::FetchOptions::OnlineIfNotFound,
+                          [&](LookupApiResponse response) {
+                            second_promise.set_value(std::move(response));
+                          });
+
+  auto first_response = first_promise.get_future().get();
+  ASSERT_TRUE(first_response.IsSuccessful());
+  EXPECT_EQ(first_response.GetResult().GetBaseUrl(), kConfigBaseUrl);
+
+  auto second_response = second_promise.get_future().get();
+  ASSERT_TRUE(second_response.IsSuccessful());
+  EXPECT_EQ(second_response.GetResult().GetBaseUrl(),
+            "https://pipelines.api.platform.sit.here.com/pipeline-service");
+
+  {
+    SCOPED_TRACE("Result is shared with a new client");
+
+    client::ApiLookupClientImpl client(catalog_hrn, settings_);
+    auto response =
+        client.LookupApi("pipelines", "v1", client::FetchOptions::CacheOnly,
+                         client::CancellationContext());
+    ASSERT_TRUE(response.IsSuccessful());
+    EXPECT_EQ(response.GetResult().GetBaseUrl(),
+              "https://pipelines.api.platform.sit.here.com/pipeline-service");
+  }
+
+  testing::Mock::VerifyAndClearExpectations(network_.get());
+  testing::Mock::VerifyAndClearExpectations(cache_.get());
+}
+
+TEST_F(ApiLookupClientImplTest, WarmUp) {
+  const auto catalog =
+      client::HRN::FromString("hrn:here:data::olp-here-test:catalog-1");
+  const auto failing_catalog =
+      client::HRN::FromString("hrn:here:data::olp-here-test:catalog-2");
+  const std::string lookup_url =
+      "https://api-lookup.data.api.platform.here.com/lookup/v1/resources/";
+
+  EXPECT_CALL(*network_, Send(IsGetRequest(lookup_url + catalog.ToString() +
+                                           "/apis"),
+                              _, _, _, _))
+      .Times(1)
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   kResponseLookupResource));
+  EXPECT_CALL(*network_, Send(IsGetRequest(lookup_url +
+                                           failing_catalog.ToString() +
+                                           "/apis"),
+                              _, _, _, _))
+      .Times(1)
+      .WillOnce(
+          ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                 olp::http::HttpStatusCode::UNAUTHORIZED),
+                             "Inappropriate"));
+  EXPECT_CALL(*cache_, Put(_, _, _, _)).Times(3);
+
+  std::promise<client::ApiLookupClient::WarmUpErrors> promise;
+  client::ApiLookupClient::WarmUp(
+      {catalog, failing_catalog}, settings_,
+      [&](client::ApiLookupClient::WarmUpErrors errors) {
+        promise.set_value(std::move(errors));
+      });
+
+  const auto errors = promise.get_future().get();
+  ASSERT_EQ(errors.size(), 1u);
+  EXPECT_TRUE(errors[0].first == failing_catalog);
+  EXPECT_EQ(errors[0].second.GetErrorCode(), client::ErrorCode::AccessDenied);
+
+  {
+    SCOPED_TRACE("Lookup of the warmed up catalog is not sent");
+
+    client::ApiLookupClientImpl client(catalog, settings_);
+    auto response = client.LookupApi("random_service", "v8",
+                                     client::FetchOptions::OnlineIfNotFound,
+                                     client::CancellationContext());
+    ASSERT_TRUE(response.IsSuccessful());
+    EXPECT_EQ(response.GetResult().GetBaseUrl(), kConfigBaseUrl);
+  }
+
+  testing::Mock::VerifyAndClearExpectations(network_.get());
+  testing::Mock::VerifyAndClearExpectations(cache_.get());
+}
+
+TEST_F(ApiLookupClientImplTest, StaleWhileRevalidate) {
+  const std::string catalog =
+      "hrn:here:data::olp-here-test:hereos-internal-test-v2";
+  const auto catalog_hrn = client::HRN::FromString(catalog);
+  const std::string lookup_url =
+      "https://api-lookup.data.api.platform.here.com/lookup/v1/resources/" +
+      catalog + "/apis";
+  const std::string service_name = "random_service";
+  const std::string service_version = "v8";
+
+  settings_.max_staleness = std::chrono::seconds(60);
+  ApiLookupClientImplTestable client(catalog_hrn, settings_);
+  // The client expires right away.
+  client.CreateAndCacheClient(kConfigBaseUrl, service_name + service_version,
+                              0);
+
+  {
+    SCOPED_TRACE("Expired client is not used by other fetch options");
+
+    EXPECT_CALL(*cache_, Get(_, _)).Times(1).WillOnce(Return(boost::any()));
+
+    EXPECT_FALSE(client.GetCachedClient(service_name, service_version,
+                                        client::FetchOptions::CacheOnly));
+    testing::Mock::VerifyAndClearExpectations(cache_.get());
+  }
+
+  {
+    SCOPED_TRACE("Expired client is used and refreshed once");
+
+    EXPECT_CALL(*network_, Send(IsGetRequest(lookup_url), _, _, _, _))
+        .Times(1)
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::OK),
+            kResponseLookupResource, {}, std::chrono::milliseconds(100)));
+    EXPECT_CALL(*cache_, Get(_, _))
+        .Times(2)
+        .WillRepeatedly(Return(boost::any()));
+    EXPECT_CALL(*cache_, Put(_, _, _, _)).Times(3);
+
+    for (int i = 0; i < 2; ++i) {
+      auto cached_client =
+          client.GetCachedClient(service_name, service_version,
+                                 client::FetchOptions::StaleWhileRevalidate);
+      ASSERT_TRUE(cached_client);
+      EXPECT_EQ(cached_client->GetBaseUrl(), kConfigBaseUrl);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    // The refreshed lookup is shared in memory.
+    auto cached_client = client.GetCachedClient(
+        service_name, service_version, client::FetchOptions::CacheOnly);
+    ASSERT_TRUE(cached_client);
+    EXPECT_EQ(cached_client->GetBaseUrl(), kConfigBaseUrl);
+
+    testing::Mock::VerifyAndClearExpectations(network_.get());
+    testing::Mock::VerifyAndClearExpectations(cache_.get());
+  }
+}
+
 }  // namespace
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <mocks/NetworkMock.h>
+#include "client/ApiLookupRegistry.h"
+
+namespace {
+namespace client = olp::client;
+using client::ApiLookupRegistry;
+
+constexpr auto kLookupUrl = "https://lookup.example.com";
+constexpr auto kCatalog = "hrn:here:data::olp-here-test:catalog";
+
+class ApiLookupRegistryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    network_ = std::make_shared<NetworkMock>();
+    key_ = {network_, nullptr, kLookupUrl, kCatalog};
+  }
+
+  void TearDown() override { ApiLookupRegistry::Instance().Clear(); }
+
+  // Records the callbacks, so the test completes the requests.
+  ApiLookupRegistry::FetchFunc RecordingFetch() {
+    return [this](ApiLookupRegistry::ApisCallback callback) {
+      callbacks_.push_back(std::move(callback));
+      return client::CancellationToken([this]() { ++cancelled_; });
+    };
+  }
+
+  static ApiLookupRegistry::ApisResult Result(time_t expiry) {
+    client::Apis apis(1);
+    apis[0].SetApi("config");
+    apis[0].SetVersion("v1");
+    apis[0].SetBaseUrl("https://config.example.com");
+    return {apis, expiry};
+  }
+
+  std::shared_ptr<NetworkMock> network_;
+  ApiLookupRegistry::Key key_;
+  std::vector<ApiLookupRegistry::ApisCallback> callbacks_;
+  int cancelled_{0};
+};
+
+TEST_F(ApiLookupRegistryTest, CoalescesRequests) {
+  auto& registry = ApiLookupRegistry::Instance();
+  int stored = 0;
+  auto store = [&](const ApiLookupRegistry::ApisResult&) { ++stored; };
+
+  std::vector<ApiLookupRegistry::ApisResponse> responses;
+  auto callback = [&](ApiLookupRegistry::ApisResponse response) {
+    responses.push_back(std::move(response));
+  };
+
+  registry.Fetch(key_, RecordingFetch(), nullptr, callback);
+  registry.Fetch(key_, RecordingFetch(), store, callback);
+  ASSERT_EQ(callbacks_.size(), 1u);
+  EXPECT_FALSE(registry.Get(key_, nullptr, nullptr));
+
+  callbacks_[0](Result(3600));
+
+  ASSERT_EQ(responses.size(), 2u);
+  EXPECT_TRUE(responses[0].IsSuccessful());
+  EXPECT_TRUE(responses[1].IsSuccessful());
+  EXPECT_EQ(stored, 1);
+
+  const auto entry = registry.Get(key_, nullptr, nullptr);
+  ASSERT_TRUE(entry);
+  ASSERT_EQ(entry->apis->size(), 1u);
+  EXPECT_EQ(entry->apis->front().GetBaseUrl(), "https://config.example.com");
+
+  {
+    SCOPED_TRACE("Other network instance");
+
+    ApiLookupRegistry::Key other = key_;
+    other.network = std::make_shared<NetworkMock>();
+    EXPECT_FALSE(registry.Get(other, nullptr, nullptr));
+  }
+  {
+    SCOPED_TRACE("Other credentials");
+
+    ApiLookupRegistry::Key other = key_;
+    other.credentials = "token:1";
+    EXPECT_FALSE(registry.Get(other, nullptr, nullptr));
+
+    registry.Fetch(other, RecordingFetch(), nullptr, callback);
+    ASSERT_EQ(callbacks_.size(), 2u);
+    callbacks_[1](Result(3600));
+    EXPECT_EQ(responses.size(), 3u);
+  }
+}
+
+TEST_F(ApiLookupRegistryTest, ErrorsAreNotStored) {
+  auto& registry = ApiLookupRegistry::Instance();
+  int stored = 0;
+  auto store = [&](const ApiLookupRegistry::ApisResult&) { ++stored; };
+
+  std::vector<ApiLookupRegistry::ApisResponse> responses;
+  auto callback = [&](ApiLookupRegistry::ApisResponse response) {
+    responses.push_back(std::move(response));
+  };
+
+  registry.Fetch(key_, RecordingFetch(), store, callback);
+  registry.Fetch(key_, RecordingFetch(), store, callback);
+  ASSERT_EQ(callbacks_.size(), 1u);
+  callbacks_[0](client::ApiError::NetworkConnection());
+
+  ASSERT_EQ(responses.size(), 2u);
+  EXPECT_EQ(responses[1].GetError().GetErrorCode(),
+            client::ErrorCode::NetworkConnection);
+  EXPECT_EQ(stored, 0);
+  EXPECT_FALSE(registry.Get(key_, nullptr, nullptr));
+
+  {
+    SCOPED_TRACE("Next fetch sends a new request");
+
+    registry.Fetch(key_, RecordingFetch(), store, callback);
+    ASSERT_EQ(callbacks_.size(), 2u);
+
+    // The request in flight is shared by the tests, so it is completed.
+    callbacks_[1](Result(3600));
+    EXPECT_EQ(responses.size(), 3u);
+  }
+}
+
+TEST_F(ApiLookupRegistryTest, CancelsRequestWithoutWaiters) {
+  auto& registry = ApiLookupRegistry::Instance();
+  std::vector<ApiLookupRegistry::ApisResponse> responses;
+  auto callback = [&](ApiLookupRegistry::ApisResponse response) {
+    responses.push_back(std::move(response));
+  };
+
+  auto first = registry.Fetch(key_, RecordingFetch(), nullptr, callback);
+  auto second = registry.Fetch(key_, RecordingFetch(), nullptr, callback);
+
+  first.Cancel();
+  ASSERT_EQ(responses.size(), 1u);
+  EXPECT_EQ(responses[0].GetError().GetErrorCode(),
+            client::ErrorCode::Cancelled);
+  EXPECT_EQ(cancelled_, 0);
+
+  second.Cancel();
+  EXPECT_EQ(responses.size(), 2u);
+  EXPECT_EQ(cancelled_, 1);
+
+  {
+    SCOPED_TRACE("Late response is ignored");
+
+    callbacks_[0](Result(3600));
+    EXPECT_EQ(responses.size(), 2u);
+  }
+}
+
+TEST_F(ApiLookupRegistryTest, SynchronousResponse) {
+  auto& registry = ApiLookupRegistry::Instance();
+  int responses = 0;
+
+  registry.Fetch(
+      key_,
+      [](ApiLookupRegistry::ApisCallback callback) {
+        callback(Result(3600));
+        return client::CancellationToken();
+      },
+      [](const ApiLookupRegistry::ApisResult&) {},
+      [&](ApiLookupRegistry::ApisResponse response) {
+        EXPECT_TRUE(response.IsSuccessful());
+        ++responses;
+      });
+
+  EXPECT_EQ(responses, 1);
+  EXPECT_TRUE(registry.Get(key_, nullptr, nullptr));
+}
+
+TEST_F(ApiLookupRegistryTest, RefreshesBeforeExpiry) {
+  auto& registry = ApiLookupRegistry::Instance();
+  auto store = [](const ApiLookupRegistry::ApisResult&) {};
+
+  registry.Fetch(key_, RecordingFetch(), store,
+                 [](ApiLookupRegistry::ApisResponse) {});
+  callbacks_[0](Result(1));
+
+  EXPECT_TRUE(registry.Get(key_, RecordingFetch(), store));
+  EXPECT_EQ(callbacks_.size(), 1u);
+
+  // The result is refreshed during the last tenth of its lifetime.
+  std::this_thread::sleep_for(std::chrono::milliseconds(920));
+
+  EXPECT_TRUE(registry.Get(key_, RecordingFetch(), store));
+  ASSERT_EQ(callbacks_.size(), 2u);
+  EXPECT_TRUE(registry.Get(key_, RecordingFetch(), store));
+  EXPECT_EQ(callbacks_.size(), 2u);
+
+  callbacks_[1](Result(3600));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  EXPECT_TRUE(registry.Get(key_, RecordingFetch(), store));
+  EXPECT_EQ(callbacks_.size(), 2u);
+}
+
+TEST_F(ApiLookupRegistryTest, ReturnsStaleResult) {
+  auto& registry = ApiLookupRegistry::Instance();
+  auto store = [](const ApiLookupRegistry::ApisResult&) {};
+  const auto max_staleness = std::chrono::seconds(60);
+
+  registry.Fetch(key_, RecordingFetch(), store,
+                 [](ApiLookupRegistry::ApisResponse) {});
+  callbacks_[0](Result(1));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+  EXPECT_FALSE(registry.Get(key_, nullptr, nullptr));
+
+  // The expired result is returned and refreshed once.
+  EXPECT_TRUE(registry.Get(key_, RecordingFetch(), store, max_staleness));
+  ASSERT_EQ(callbacks_.size(), 2u);
+  EXPECT_TRUE(registry.Get(key_, RecordingFetch(), store, max_staleness));
+  registry.Refresh(key_, RecordingFetch(), store);
+  EXPECT_EQ(callbacks_.size(), 2u);
+
+  callbacks_[1](Result(3600));
+
+  EXPECT_TRUE(registry.Get(key_, nullptr, nullptr));
+}
+
+TEST_F(ApiLookupRegistryTest, LimitsStoredResults) {
+  auto& registry = ApiLookupRegistry::Instance();
+  auto store = [](const ApiLookupRegistry::ApisResult&) {};
+
+  // E.g. the lookups made with the rotated credentials.
+  std::vector<ApiLookupRegistry::Key> keys;
+  for (int i = 0; i <= 256; ++i) {
+    ApiLookupRegistry::Key key = key_;
+    key.credentials = "token:" + std::to_string(i);
+    keys.push_back(key);
+
+    registry.Fetch(
+        key,
+        [i](ApiLookupRegistry::ApisCallback callback) {
+          callback(Result(3600 + i));
+          return client::CancellationToken();
+        },
+        store, [](ApiLookupRegistry::ApisResponse) {});
+  }
+
+  // The earliest expiring result is removed.
+  EXPECT_FALSE(registry.Get(keys.front(), nullptr, nullptr));
+  EXPECT_TRUE(registry.Get(keys[1], nullptr, nullptr));
+  EXPECT_TRUE(registry.Get(keys.back(), nullptr, nullptr));
+}
+
+}  // namespace
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <olp/core/client/Awaitable.h>
+
+// The awaitables are only available when compiled as C++20.
+#if !defined(OLP_SDK_HAS_COROUTINES) && defined(OLP_SDK_REQUIRE_COROUTINES)
+#error "The compiler does not support C++20 coroutines"
+#endif
+
+#ifdef OLP_SDK_HAS_COROUTINES
+
+#include <exception>
+#include <future>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <olp/core/client/ApiResponse.h>
+
+namespace {
+
+namespace client = olp::client;
+using client::CancellationContext;
+using client::CancellationToken;
+using client::ErrorCode;
+
+using Response = client::ApiResponse<std::string, client::ApiError>;
+using Callback = std::function<void(Response)>;
+
+// A coroutine that starts immediately and is not awaited.
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+// Runs the tasks synchronously and counts them.
+class CountingScheduler : public olp::thread::TaskScheduler {
+ public:
+  size_t GetCount() const { return count_; }
+
+ protected:
+  void EnqueueTask(TaskScheduler::CallFuncType&& func) override {
+    ++count_;
+    func();
+  }
+
+ private:
+  std::atomic<size_t> count_{0u};
+};
+
+DetachedTask Await(client::Awaitable<Response> awaitable,
+                   std::promise<Response>& promise) {
+  promise.set_value(co_await awaitable);
+}
+
+TEST(AwaitableTest, ResumesOnScheduler) {
+  auto scheduler = std::make_shared<CountingScheduler>();
+  std::promise<Response> promise;
+  std::promise<void> suspended;
+  auto suspended_future = suspended.get_future().share();
+  std::thread network;
+
+  Await(client::MakeAwaitable<Response>(
+            [&](Callback callback) {
+              network = std::thread([=]() {
+                // The response arrives after the coroutine is suspended,
+                // otherwise it would be resumed without the scheduler.
+                suspended_future.wait();
+                callback(std::string("data"));
+              });
+              return CancellationToken();
+            },
+            CancellationContext(), scheduler),
+        promise);
+
+  // The coroutine returns control here when it is suspended.
+  suspended.set_value();
+
+  auto response = promise.get_future().get();
+  network.join();
+
+  ASSERT_TRUE(response.IsSuccessful());
+  EXPECT_EQ(response.GetResult(), "data");
+  EXPECT_EQ(scheduler->GetCount(), 1u);
+}
+
+TEST(AwaitableTest, SynchronousResultDoesNotSuspend) {
+  auto scheduler = std::make_shared<CountingScheduler>();
+  std::promise<Response> promise;
+
+  Await(client::MakeAwaitable<Response>(
+            [](Callback callback) {
+              callback(std::string("cached"));
+              return CancellationToken();
+            },
+            CancellationContext(), scheduler),
+        promise);
+
+  auto future = promise.get_future();
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(0)),
+            std::future_status::ready);
+  EXPECT_EQ(future.get().GetResult(), "cached");
+  EXPECT_EQ(scheduler->GetCount(), 0u);
+}
+
+TEST(AwaitableTest, CancelsRequest) {
+  CancellationContext context;
+  std::promise<Response> promise;
+
+  Await(client::MakeAwaitable<Response>(
+            [](Callback callback) {
+              return CancellationToken([=]() {
+                callback(client::ApiError::Cancelled());
+              });
+            },
+            context),
+        promise);
+
+  auto future = promise.get_future();
+  EXPECT_EQ(future.wait_for(std::chrono::seconds(0)),
+            std::future_status::timeout);
+
+  context.CancelOperation();
+
+  auto response = future.get();
+  ASSERT_FALSE(response.IsSuccessful());
+  EXPECT_EQ(response.GetError().GetErrorCode(), ErrorCode::Cancelled);
+}
+
+TEST(AwaitableTest, CancelledContextDoesNotStartRequest) {
+  CancellationContext context;
+  context.CancelOperation();
+  std::promise<Response> promise;
+  bool started = false;
+
+  Await(client::MakeAwaitable<Response>(
+            [&](Callback) {
+              started = true;
+              return CancellationToken();
+            },
+            context),
+        promise);
+
+  auto response = promise.get_future().get();
+  EXPECT_FALSE(started);
+  ASSERT_FALSE(response.IsSuccessful());
+  EXPECT_EQ(response.GetError().GetErrorCode(), ErrorCode::Cancelled);
+}
+
+}  // namespace
+
+#endif  // OLP_SDK_HAS_COROUTINES
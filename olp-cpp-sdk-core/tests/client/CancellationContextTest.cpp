@@ -21,7 +21,19 @@
 
 #include <olp/core/client/CancellationContext.h>
 
+namespace olp {
+namespace client {
+struct CancellationContextInspector {
+  static size_t ChildrenCount(const CancellationContext& context) {
+    std::lock_guard<std::recursive_mutex> lock(context.impl_->mutex_);
+    return context.impl_->children_.size();
+  }
+};
+}  // namespace client
+}  // namespace olp
+
 using olp::client::CancellationContext;
+using olp::client::CancellationContextInspector;
 
 TEST(CancellationContextTest, CancelOperation) {
   CancellationContext context;
@@ -52,3 +64,56 @@ TEST(CancellationContextTest, MoveAndCancelOperation) {
   EXPECT_FALSE(context.IsCancelled());
   EXPECT_TRUE(context_move.IsCancelled());
 }
+
+TEST(CancellationContextTest, CancelParentCancelsChildren) {
+  CancellationContext parent;
+  auto child = parent.CreateChild();
+  auto grandchild = child.CreateChild();
+
+  int cancelled_operations = 0;
+  auto token = [&]() {
+    return olp::client::CancellationToken([&]() { ++cancelled_operations; });
+  };
+  EXPECT_TRUE(child.ExecuteOrCancelled(token));
+  EXPECT_TRUE(grandchild.ExecuteOrCancelled(token));
+
+  parent.CancelOperation();
+  EXPECT_TRUE(child.IsCancelled());
+  EXPECT_TRUE(grandchild.IsCancelled());
+  EXPECT_EQ(cancelled_operations, 2);
+
+  {
+    SCOPED_TRACE("The child of a cancelled context is cancelled");
+
+    auto late_child = parent.CreateChild();
+    EXPECT_TRUE(late_child.IsCancelled());
+
+    bool cancel_called = false;
+    EXPECT_FALSE(late_child.ExecuteOrCancelled(
+        token, [&]() { cancel_called = true; }));
+    EXPECT_TRUE(cancel_called);
+  }
+}
+
+TEST(CancellationContextTest, CancelChildDoesNotCancelParent) {
+  CancellationContext parent;
+  auto child = parent.CreateChild();
+  auto sibling = parent.CreateChild();
+
+  child.CancelOperation();
+  EXPECT_TRUE(child.IsCancelled());
+  EXPECT_FALSE(parent.IsCancelled());
+  EXPECT_FALSE(sibling.IsCancelled());
+
+  {
+    SCOPED_TRACE("Expired children are released");
+
+    for (int i = 0; i < 1000; ++i) {
+      parent.CreateChild();
+      EXPECT_LE(CancellationContextInspector::ChildrenCount(parent), 16u);
+    }
+    EXPECT_GE(CancellationContextInspector::ChildrenCount(parent), 2u);
+    parent.CancelOperation();
+    EXPECT_TRUE(sibling.IsCancelled());
+  }
+}
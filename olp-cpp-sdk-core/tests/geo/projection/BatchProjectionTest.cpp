@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/geo/coordinates/GeoCoordinates3d.h>
+#include <olp/core/geo/coordinates/GeoRectangle.h>
+#include <olp/core/geo/projection/EquirectangularProjection.h>
+#include <olp/core/geo/projection/IdentityProjection.h>
+#include <olp/core/geo/projection/SphereProjection.h>
+#include <olp/core/geo/projection/WebMercatorProjection.h>
+#include <olp/core/math/AlignedBox.h>
+#include <olp/core/math/Math.h>
+
+namespace {
+namespace geo = olp::geo;
+namespace math = olp::math;
+
+// Not a multiple of the vector width to cover the remainder loops.
+constexpr size_t kPointCount = 1003u;
+
+// Uses the default batch implementation of `IProjection`.
+class ScalarProjection : public geo::IProjection {
+ public:
+  geo::GeoRectangle GetGeoBounds() const override {
+    return projection_.GetGeoBounds();
+  }
+
+  geo::WorldAlignedBox WorldExtent(double minimum_altitude,
+                                   double maximum_altitude) const override {
+    return projection_.WorldExtent(minimum_altitude, maximum_altitude);
+  }
+
+  bool Project(const geo::GeoCoordinates3d& geo_point,
+               geo::WorldCoordinates& world_point) const override {
+    return projection_.Project(geo_point, world_point);
+  }
+
+  bool Unproject(const geo::WorldCoordinates& world_point,
+                 geo::GeoCoordinates3d& geo_point) const override {
+    return projection_.Unproject(world_point, geo_point);
+  }
+
+ private:
+  geo::EquirectangularProjection projection_;
+};
+
+struct Points {
+  explicit Points(size_t count)
+      : first(count), second(count), third(count) {}
+
+  std::vector<double> first;
+  std::vector<double> second;
+  std::vector<double> third;
+};
+
+class BatchProjectionTest
+    : public ::testing::TestWithParam<std::shared_ptr<geo::IProjection>> {
+ protected:
+  void SetUp() override {
+    std::mt19937 generator(42u);
+    std::uniform_real_distribution<double> latitude(-math::half_pi,
+                                                    math::half_pi);
+    std::uniform_real_distribution<double> longitude(-math::pi, math::pi);
+    std::uniform_real_distribution<double> altitude(-100.0, 1000.0);
+
+    for (size_t i = 0; i < kPointCount; ++i) {
+      geo_.first[i] = latitude(generator);
+      geo_.second[i] = longitude(generator);
+      geo_.third[i] = altitude(generator);
+    }
+  }
+
+  Points geo_{kPointCount};
+};
+
+TEST_P(BatchProjectionTest, MatchesSinglePoints) {
+  const auto& projection = *GetParam();
+
+  Points world(kPointCount);
+  ASSERT_TRUE(projection.ProjectBatch(
+      geo_.first.data(), geo_.second.data(), geo_.third.data(), kPointCount,
+      world.first.data(), world.second.data(), world.third.data()));
+
+  Points unprojected(kPointCount);
+  ASSERT_TRUE(projection.UnprojectBatch(
+      world.first.data(), world.second.data(), world.third.data(),
+      kPointCount, unprojected.first.data(), unprojected.second.data(),
+      unprojected.third.data()));
+
+  for (size_t i = 0; i < kPointCount; ++i) {
+    SCOPED_TRACE(i);
+
+    geo::WorldCoordinates world_point;
+    ASSERT_TRUE(projection.Project(
+        {geo_.first[i], geo_.second[i], geo_.third[i]}, world_point));
+    EXPECT_DOUBLE_EQ(world_point.x, world.first[i]);
+    EXPECT_DOUBLE_EQ(world_point.y, world.second[i]);
+    EXPECT_DOUBLE_EQ(world_point.z, world.third[i]);
+
+    geo::GeoCoordinates3d geo_point;
+    ASSERT_TRUE(projection.Unproject(world_point, geo_point));
+    EXPECT_DOUBLE_EQ(geo_point.GetLatitude(), unprojected.first[i]);
+    EXPECT_DOUBLE_EQ(geo_point.GetLongitude(), unprojected.second[i]);
+    EXPECT_DOUBLE_EQ(geo_point.GetAltitude(), unprojected.third[i]);
+  }
+}
+
+TEST_P(BatchProjectionTest, EmptyBatch) {
+  const auto& projection = *GetParam();
+  EXPECT_TRUE(projection.ProjectBatch(nullptr, nullptr, nullptr, 0u, nullptr,
+                                      nullptr, nullptr));
+  EXPECT_TRUE(projection.UnprojectBatch(nullptr, nullptr, nullptr, 0u,
+                                        nullptr, nullptr, nullptr));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    , BatchProjectionTest,
+    ::testing::Values(std::make_shared<geo::EquirectangularProjection>(),
+                      std::make_shared<geo::IdentityProjection>(),
+                      std::make_shared<geo::SphereProjection>(),
+                      std::make_shared<geo::WebMercatorProjection>(),
+                      std::make_shared<ScalarProjection>()));
+
+}  // namespace
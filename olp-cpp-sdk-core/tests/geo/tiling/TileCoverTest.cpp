@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/geo/coordinates/GeoCoordinates.h>
+#include <olp/core/geo/coordinates/GeoRectangle.h>
+#include <olp/core/geo/tiling/TileCover.h>
+#include <olp/core/geo/tiling/TileKeyUtils.h>
+#include <olp/core/geo/tiling/TilingSchemeRegistry.h>
+
+namespace {
+using olp::geo::GeoCoordinates;
+using olp::geo::GeoRectangle;
+using olp::geo::TileCover;
+using olp::geo::TileKey;
+using olp::geo::TileKeyUtils;
+
+GeoRectangle FromDegrees(double south, double west, double north,
+                         double east) {
+  return GeoRectangle(GeoCoordinates::FromDegrees(south, west),
+                      GeoCoordinates::FromDegrees(north, east));
+}
+
+void ExpectMortonOrder(const std::vector<TileKey>& tile_keys) {
+  for (size_t i = 1; i < tile_keys.size(); ++i) {
+    const auto& previous = tile_keys[i - 1];
+    const auto& current = tile_keys[i];
+    const auto level = std::min(previous.Level(), current.Level());
+    EXPECT_LT(previous.ChangedLevelTo(level).ToQuadKey64(),
+              current.ChangedLevelTo(level).ToQuadKey64() +
+                  (previous.Level() < current.Level() ? 0u : 1u))
+        << previous << " " << current;
+  }
+}
+
+// Expands the compact cover to the tiles of the cover level.
+std::set<TileKey> Expand(const olp::geo::ITilingScheme& tiling_scheme,
+                         const TileCover& cover) {
+  const auto& subdivision_scheme = tiling_scheme.GetSubdivisionScheme();
+  const auto level_size = subdivision_scheme.GetLevelSize(cover.GetLevel());
+
+  std::set<TileKey> result;
+  for (const auto& tile_key : cover.Compact()) {
+    const auto size = subdivision_scheme.GetLevelSize(tile_key.Level());
+    const auto rows = level_size.Height() / size.Height();
+    const auto columns = level_size.Width() / size.Width();
+    for (auto row = 0u; row < rows; ++row) {
+      for (auto column = 0u; column < columns; ++column) {
+        result.insert(TileKey::FromRowColumnLevel(
+            tile_key.Row() * rows + row, tile_key.Column() * columns + column,
+            cover.GetLevel()));
+      }
+    }
+  }
+  return result;
+}
+
+TEST(TileCoverTest, GeoRectangle) {
+  const olp::geo::HalfQuadTreeEquirectangularTilingScheme tiling_scheme;
+  const std::vector<GeoRectangle> rectangles = {
+      FromDegrees(52.4, 13.2, 52.6, 13.6),
+      FromDegrees(-10.0, -20.0, 30.0, 40.0),
+      FromDegrees(-30.0, 170.0, 10.0, -170.0),
+      FromDegrees(0.0, 10.0, 5.0, 9.0),
+      FromDegrees(-90.0, -180.0, 90.0, 180.0)};
+
+  for (const auto& rectangle : rectangles) {
+    for (auto level = 0u; level <= 12; ++level) {
+      SCOPED_TRACE(testing::Message() << "level=" << level);
+
+      auto expected =
+          TileKeyUtils::GeoRectangleToTileKeys(tiling_scheme, rectangle, level);
+      std::sort(expected.begin(), expected.end());
+
+      const auto cover =
+          TileCover::FromGeoRectangle(tiling_scheme, rectangle, level);
+      const auto tile_keys = cover.ToTileKeys();
+      ExpectMortonOrder(tile_keys);
+
+      auto sorted = tile_keys;
+      std::sort(sorted.begin(), sorted.end());
+      EXPECT_EQ(sorted, expected);
+
+      const auto compact = cover.Compact().ToTileKeys();
+      EXPECT_LE(compact.size(), tile_keys.size());
+      ExpectMortonOrder(compact);
+      EXPECT_EQ(Expand(tiling_scheme, cover),
+                std::set<TileKey>(tile_keys.begin(), tile_keys.end()));
+    }
+  }
+
+  {
+    SCOPED_TRACE("Compact cover of a large area");
+
+    const auto rectangle = FromDegrees(-10.0, -20.0, 30.0, 40.0);
+    const auto south_west = TileKeyUtils::GeoCoordinatesToTileKey(
+        tiling_scheme, rectangle.SouthWest(), 14);
+    const auto north_east = TileKeyUtils::GeoCoordinatesToTileKey(
+        tiling_scheme, rectangle.NorthEast(), 14);
+    const auto count = (north_east.Row() - south_west.Row() + 1) *
+                       (north_east.Column() - south_west.Column() + 1);
+
+    const auto cover =
+        TileCover::FromGeoRectangle(tiling_scheme, rectangle, 14);
+    EXPECT_EQ(std::distance(cover.begin(), cover.end()), count);
+    EXPECT_LT(cover.Compact().ToTileKeys().size(), 64000u);
+  }
+  {
+    SCOPED_TRACE("Empty rectangle");
+
+    const auto cover =
+        TileCover::FromGeoRectangle(tiling_scheme, GeoRectangle(), 10);
+    EXPECT_TRUE(cover.begin() == cover.end());
+  }
+}
+
+TEST(TileCoverTest, Polygon) {
+  const olp::geo::HalfQuadTreeEquirectangularTilingScheme tiling_scheme;
+  const std::vector<GeoCoordinates> polygon = {
+      GeoCoordinates::FromDegrees(52.0, 13.0),
+      GeoCoordinates::FromDegrees(52.0, 14.0),
+      GeoCoordinates::FromDegrees(52.5, 14.0),
+      GeoCoordinates::FromDegrees(52.5, 13.5),
+      GeoCoordinates::FromDegrees(53.0, 13.5),
+      GeoCoordinates::FromDegrees(53.0, 13.0)};
+  const auto level = 13u;
+
+  const auto cover = TileCover::FromPolygon(tiling_scheme, polygon, level);
+  const auto tile_keys = cover.ToTileKeys();
+  ExpectMortonOrder(tile_keys);
+  EXPECT_EQ(Expand(tiling_scheme, cover),
+            std::set<TileKey>(tile_keys.begin(), tile_keys.end()));
+
+  const auto contains = [&](const GeoCoordinates& point) {
+    const auto tile_key =
+        TileKeyUtils::GeoCoordinatesToTileKey(tiling_scheme, point, level);
+    return std::binary_search(tile_keys.begin(), tile_keys.end(), tile_key,
+                              [](const TileKey& lhs, const TileKey& rhs) {
+                                return lhs.ToQuadKey64() < rhs.ToQuadKey64();
+                              });
+  };
+
+  // The L-shaped polygon does not cover its bounding rectangle.
+  const auto bounding_tiles = TileKeyUtils::GeoRectangleToTileKeys(
+      tiling_scheme, FromDegrees(52.0, 13.0, 53.0, 14.0), level);
+  EXPECT_LT(tile_keys.size(), bounding_tiles.size());
+
+  EXPECT_TRUE(contains(GeoCoordinates::FromDegrees(52.1, 13.9)));
+  EXPECT_TRUE(contains(GeoCoordinates::FromDegrees(52.9, 13.1)));
+  EXPECT_TRUE(contains(GeoCoordinates::FromDegrees(52.0, 13.0)));
+  EXPECT_FALSE(contains(GeoCoordinates::FromDegrees(52.9, 13.9)));
+  EXPECT_FALSE(contains(GeoCoordinates::FromDegrees(51.9, 13.5)));
+
+  {
+    SCOPED_TRACE("Polygon inside of a tile");
+
+    const auto tile_key = TileKeyUtils::GeoCoordinatesToTileKey(
+        tiling_scheme, polygon.front(), 5);
+    const auto small = TileCover::FromPolygon(tiling_scheme, polygon, 5);
+    EXPECT_EQ(small.ToTileKeys(), std::vector<TileKey>{tile_key});
+  }
+  {
+    SCOPED_TRACE("Degenerate polygon");
+
+    const auto empty = TileCover::FromPolygon(
+        tiling_scheme, {polygon[0], polygon[1]}, level);
+    EXPECT_TRUE(empty.begin() == empty.end());
+  }
+}
+
+TEST(TileCoverTest, Corridor) {
+  const olp::geo::HalfQuadTreeEquirectangularTilingScheme tiling_scheme;
+  const std::vector<GeoCoordinates> path = {
+      GeoCoordinates::FromDegrees(52.0, 13.0),
+      GeoCoordinates::FromDegrees(52.0, 13.5),
+      GeoCoordinates::FromDegrees(52.5, 14.0)};
+  const auto level = 14u;
+  const double radius = 1000.0;
+
+  const auto cover =
+      TileCover::FromCorridor(tiling_scheme, path, radius, level);
+  const auto tile_keys = cover.ToTileKeys();
+  ExpectMortonOrder(tile_keys);
+  EXPECT_EQ(Expand(tiling_scheme, cover),
+            std::set<TileKey>(tile_keys.begin(), tile_keys.end()));
+
+  const std::set<TileKey> tiles(tile_keys.begin(), tile_keys.end());
+  const auto contains = [&](const GeoCoordinates& point) {
+    return tiles.count(TileKeyUtils::GeoCoordinatesToTileKey(
+               tiling_scheme, point, level)) > 0;
+  };
+
+  // 0.01 degrees of latitude is about 1.1 km.
+  for (const auto& point : path) {
+    EXPECT_TRUE(contains(point));
+  }
+  EXPECT_TRUE(contains(GeoCoordinates::FromDegrees(52.005, 13.25)));
+  EXPECT_TRUE(contains(GeoCoordinates::FromDegrees(51.995, 13.25)));
+  EXPECT_TRUE(contains(GeoCoordinates::FromDegrees(52.25, 13.75)));
+  EXPECT_FALSE(contains(GeoCoordinates::FromDegrees(52.03, 13.25)));
+  EXPECT_FALSE(contains(GeoCoordinates::FromDegrees(51.97, 13.25)));
+  EXPECT_FALSE(contains(GeoCoordinates::FromDegrees(52.3, 13.5)));
+
+  {
+    SCOPED_TRACE("Single point");
+
+    const auto point = TileCover::FromCorridor(tiling_scheme, {path[0]},
+                                               radius, level);
+    EXPECT_TRUE(point.begin() != point.end());
+    for (const auto& tile_key : point) {
+      EXPECT_TRUE(tiles.count(tile_key));
+    }
+  }
+}
+
+}  // namespace
@@ -21,8 +21,11 @@
 
 #include <cmath>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <olp/core/geo/tiling/TileKey.h>
+#include "geo/tiling/TileKeyKernels.h"
 
 using namespace olp::geo;
 
@@ -135,6 +138,127 @@ TEST(TileKeyTest, HereTiles) {
   ASSERT_FALSE(invalid.IsValid());
 }
 
+TEST(TileKeyTest, HereTilesBuffer) {
+  const auto quad = TileKey::FromRowColumnLevel(3, 5, 3);
+  char buffer[TileKey::HereTileMaxLength];
+
+  char* end = quad.ToHereTile(buffer, buffer + sizeof(buffer));
+  ASSERT_NE(nullptr, end);
+  EXPECT_EQ("91", std::string(buffer, end));
+  EXPECT_EQ(quad, TileKey::FromHereTile(buffer, end));
+
+  EXPECT_EQ(nullptr, quad.ToHereTile(buffer, buffer + 1));
+  EXPECT_EQ(buffer + 2, quad.ToHereTile(buffer, buffer + 2));
+
+  const auto deepest = TileKey::FromRowColumnLevel(
+      (1u << TileKey::MaxLevel) - 1, (1u << TileKey::MaxLevel) - 1,
+      TileKey::MaxLevel);
+  end = deepest.ToHereTile(buffer, buffer + sizeof(buffer));
+  ASSERT_NE(nullptr, end);
+  EXPECT_EQ(std::to_string(deepest.ToQuadKey64()), std::string(buffer, end));
+  EXPECT_EQ(deepest, TileKey::FromHereTile(buffer, end));
+
+  const std::string key = "23618402:suffix";
+  EXPECT_EQ(TileKey::FromHereTile("23618402"),
+            TileKey::FromHereTile(key.data(), key.data() + key.size()));
+}
+
+TEST(TileKeyTest, QuadKeys64Batch) {
+  // Interleaves the bits one by one.
+  const auto encode = [](const TileKey& tile_key) {
+    std::uint64_t result = 1ull << (2 * tile_key.Level());
+    for (std::uint32_t bit = 0; bit < tile_key.Level(); ++bit) {
+      result |= static_cast<std::uint64_t>((tile_key.Column() >> bit) & 1u)
+                << (2 * bit);
+      result |= static_cast<std::uint64_t>((tile_key.Row() >> bit) & 1u)
+                << (2 * bit + 1);
+    }
+    return result;
+  };
+
+  std::vector<TileKey> tile_keys;
+  std::uint32_t seed = 42u;
+  for (std::uint32_t level = 0; level <= TileKey::MaxLevel; ++level) {
+    for (int i = 0; i < 16; ++i) {
+      seed = seed * 1664525u + 1013904223u;
+      const auto row = level == 0 ? 0u : seed >> (32 - level);
+      seed = seed * 1664525u + 1013904223u;
+      const auto column = level == 0 ? 0u : seed >> (32 - level);
+      tile_keys.push_back(TileKey::FromRowColumnLevel(row, column, level));
+    }
+  }
+
+  std::vector<std::uint64_t> quad_keys(tile_keys.size());
+  TileKey::ToQuadKeys64(tile_keys.data(), tile_keys.size(), quad_keys.data());
+
+  std::vector<TileKey> decoded(tile_keys.size());
+  TileKey::FromQuadKeys64(quad_keys.data(), quad_keys.size(), decoded.data());
+
+  for (size_t i = 0; i < tile_keys.size(); ++i) {
+    SCOPED_TRACE(tile_keys[i]);
+    EXPECT_EQ(encode(tile_keys[i]), quad_keys[i]);
+    EXPECT_EQ(quad_keys[i], tile_keys[i].ToQuadKey64());
+    EXPECT_EQ(tile_keys[i], decoded[i]);
+    EXPECT_EQ(tile_keys[i], TileKey::FromQuadKey64(quad_keys[i]));
+  }
+
+  EXPECT_EQ(TileKey::FromRowColumnLevel(0, 0, 0), TileKey::FromQuadKey64(0));
+}
+
+TEST(TileKeyTest, QuadKeys64Kernels) {
+  std::vector<TileKey> tile_keys;
+  std::uint32_t seed = 7u;
+  for (std::uint32_t level = 0; level <= TileKey::MaxLevel; ++level) {
+    const auto max = level == 0 ? 0u : ~0u >> (32 - level);
+    tile_keys.push_back(TileKey::FromRowColumnLevel(0, 0, level));
+    tile_keys.push_back(TileKey::FromRowColumnLevel(max, max, level));
+    tile_keys.push_back(TileKey::FromRowColumnLevel(0, max, level));
+    tile_keys.push_back(TileKey::FromRowColumnLevel(max, 0, level));
+    for (int i = 0; i < 64; ++i) {
+      seed = seed * 1664525u + 1013904223u;
+      const auto row = seed & max;
+      seed = seed * 1664525u + 1013904223u;
+      const auto column = seed & max;
+      tile_keys.push_back(TileKey::FromRowColumnLevel(row, column, level));
+    }
+  }
+
+  const auto count = tile_keys.size();
+  std::vector<std::uint64_t> quad_keys(count);
+  std::vector<TileKey> decoded(count);
+
+  {
+    SCOPED_TRACE("The scalar kernels match the public API");
+    EncodeQuadKeysScalar(tile_keys.data(), count, quad_keys.data());
+    DecodeQuadKeysScalar(quad_keys.data(), count, decoded.data());
+
+    for (size_t i = 0; i < count; ++i) {
+      SCOPED_TRACE(tile_keys[i]);
+      EXPECT_EQ(tile_keys[i].ToQuadKey64(), quad_keys[i]);
+      EXPECT_EQ(tile_keys[i], decoded[i]);
+    }
+  }
+
+#if defined(OLP_SDK_TILE_KEY_BMI2)
+  // The public API may already use the BMI2 kernels, so compare them with
+  // the scalar ones directly.
+  if (olp::utils::cpu::GetFeatures().bmi2) {
+    SCOPED_TRACE("The BMI2 kernels match the scalar ones");
+    std::vector<std::uint64_t> bmi2_quad_keys(count);
+    EncodeQuadKeysBmi2(tile_keys.data(), count, bmi2_quad_keys.data());
+
+    std::vector<TileKey> bmi2_decoded(count);
+    DecodeQuadKeysBmi2(quad_keys.data(), count, bmi2_decoded.data());
+
+    for (size_t i = 0; i < count; ++i) {
+      SCOPED_TRACE(tile_keys[i]);
+      EXPECT_EQ(quad_keys[i], bmi2_quad_keys[i]);
+      EXPECT_EQ(decoded[i], bmi2_decoded[i]);
+    }
+  }
+#endif
+}
+
 TEST(TileKeyTest, MoveToLevel) {
   TileKey quad = TileKey::FromRowColumnLevel(0, 0, 5);
   ASSERT_EQ(quad.ChangedLevelBy(-2), quad.ChangedLevelTo(3));
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <gmock/gmock.h>
+
+#include <limits>
+
+#include <mocks/NetworkMock.h>
+#include <olp/core/http/NetworkMetrics.h>
+#include "http/DefaultNetwork.h"
+
+namespace {
+using olp::http::LatencyHistogram;
+using olp::http::NetworkRequest;
+using olp::http::NetworkResponse;
+using olp::http::NetworkTimings;
+using testing::_;
+
+TEST(NetworkMetricsTest, LatencyHistogramBuckets) {
+  {
+    SCOPED_TRACE("Bucket bounds");
+
+    for (uint64_t value = 0u; value < 8u; ++value) {
+      EXPECT_EQ(LatencyHistogram::GetBucketIndex(value), value);
+      EXPECT_EQ(LatencyHistogram::GetBucketUpperBound(value), value);
+    }
+
+    // Values from 1024 to 2047 are split into buckets of 128.
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(1024u),
+              LatencyHistogram::GetBucketIndex(1151u));
+    EXPECT_NE(LatencyHistogram::GetBucketIndex(1151u),
+              LatencyHistogram::GetBucketIndex(1152u));
+    EXPECT_EQ(LatencyHistogram::GetBucketUpperBound(
+                  LatencyHistogram::GetBucketIndex(1100u)),
+              1151u);
+
+    for (uint64_t value = 1u; value < LatencyHistogram::kMaxTrackableValue;
+         value = value * 3u + 1u) {
+      const auto index = LatencyHistogram::GetBucketIndex(value);
+      ASSERT_LT(index, LatencyHistogram::kBucketCount);
+      EXPECT_GE(LatencyHistogram::GetBucketUpperBound(index), value);
+      EXPECT_LT(LatencyHistogram::GetBucketUpperBound(index - 1u), value);
+    }
+
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(
+                  LatencyHistogram::kMaxTrackableValue),
+              LatencyHistogram::kBucketCount - 1u);
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(
+                  std::numeric_limits<uint64_t>::max()),
+              LatencyHistogram::kBucketCount - 1u);
+  }
+  {
+    SCOPED_TRACE("Percentiles");
+
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.GetPercentile(50.0), 0u);
+
+    for (uint64_t value = 1u; value <= 100u; ++value) {
+      histogram.Record(value * 1000u);
+    }
+
+    EXPECT_EQ(histogram.GetCount(), 100u);
+    EXPECT_EQ(histogram.GetMax(), 100000u);
+    EXPECT_DOUBLE_EQ(histogram.GetMean(), 50500.0);
+    EXPECT_NEAR(histogram.GetPercentile(50.0), 50000u, 50000u / 8u);
+    EXPECT_NEAR(histogram.GetPercentile(99.0), 99000u, 99000u / 8u);
+    EXPECT_EQ(histogram.GetPercentile(100.0), 100000u);
+
+    auto merged = histogram;
+    merged += histogram;
+    EXPECT_EQ(merged.GetCount(), 200u);
+    EXPECT_EQ(merged.GetPercentile(50.0), histogram.GetPercentile(50.0));
+
+    uint64_t count = 0u;
+    for (const auto& bucket : merged.GetBuckets()) {
+      count += bucket.second;
+    }
+    EXPECT_EQ(count, 200u);
+  }
+}
+
+TEST(NetworkMetricsTest, DefaultNetworkCollectsHostMetrics) {
+  auto mock = std::make_shared<NetworkMock>();
+  olp::http::DefaultNetwork network(mock);
+
+  NetworkTimings timings;
+  timings.name_lookup = 1000u;
+  timings.connect = 2000u;
+  timings.tls_handshake = 5000u;
+  timings.time_to_first_byte = 20000u;
+  timings.total = 30000u;
+  timings.new_connection = true;
+
+  int status = 200;
+  EXPECT_CALL(*mock, Send(_, _, _, _, _))
+      .WillRepeatedly([&](NetworkRequest, olp::http::Network::Payload,
+                          olp::http::Network::Callback callback,
+                          olp::http::Network::HeaderCallback,
+                          olp::http::Network::DataCallback) {
+        callback(NetworkResponse()
+                     .WithStatus(status)
+                     .WithBytesDownloaded(100u)
+                     .WithBytesUploaded(10u)
+                     .WithTimings(timings));
+        return olp::http::SendOutcome(1u);
+      });
+
+  auto send = [&](const std::string& url) {
+    network.Send(NetworkRequest(url), nullptr, nullptr);
+  };
+
+  {
+    SCOPED_TRACE("Disabled metrics");
+
+    send("https://a.example.com/path");
+    EXPECT_TRUE(network.GetMetrics(0).empty());
+    EXPECT_EQ(network.GetStatistics(0).total_requests, 1u);
+  }
+  {
+    SCOPED_TRACE("Enabled metrics");
+
+    network.SetMetricsEnabled(true);
+    send("https://a.example.com/path?query=1");
+    send("https://user@a.example.com");
+    send("http://b.example.com:8080/path");
+    timings.new_connection = false;
+    status = 404;
+    send("https://a.example.com/path");
+
+    const auto metrics = network.GetMetrics(0);
+    ASSERT_EQ(metrics.size(), 3u);
+
+    EXPECT_EQ(metrics[0].host, "a.example.com");
+    EXPECT_EQ(metrics[0].status_class, 2);
+    EXPECT_EQ(metrics[0].requests, 2u);
+    EXPECT_EQ(metrics[0].bytes_downloaded, 200u);
+    EXPECT_EQ(metrics[0].bytes_uploaded, 20u);
+    EXPECT_EQ(metrics[0].name_lookup.GetCount(), 2u);
+    EXPECT_EQ(metrics[0].tls_handshake.GetMax(), 5000u);
+    EXPECT_EQ(metrics[0].total.GetPercentile(50.0), 30000u);
+
+    EXPECT_EQ(metrics[1].host, "a.example.com");
+    EXPECT_EQ(metrics[1].status_class, 4);
+    EXPECT_EQ(metrics[1].requests, 1u);
+    EXPECT_EQ(metrics[1].name_lookup.GetCount(), 0u);
+    EXPECT_EQ(metrics[1].time_to_first_byte.GetCount(), 1u);
+
+    EXPECT_EQ(metrics[2].host, "b.example.com:8080");
+    EXPECT_EQ(metrics[2].requests, 1u);
+
+    const auto statistics = network.GetStatistics(0);
+    EXPECT_EQ(statistics.total_requests, 5u);
+    EXPECT_EQ(statistics.total_failed, 1u);
+    EXPECT_EQ(statistics.bytes_downloaded, 500u);
+  }
+  {
+    SCOPED_TRACE("Other bucket");
+
+    network.SetCurrentBucket(1);
+    send("https://a.example.com/path");
+    EXPECT_EQ(network.GetMetrics(1).size(), 1u);
+    EXPECT_EQ(network.GetStatistics(1).total_requests, 1u);
+    EXPECT_EQ(network.GetStatistics(0).total_requests, 5u);
+    EXPECT_TRUE(network.GetMetrics(2).empty());
+  }
+}
+
+}  // namespace
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+#include <olp/core/tracing/ChromeTraceRecorder.h>
+#include <olp/core/tracing/Tracer.h>
+
+namespace {
+namespace tracing = olp::tracing;
+
+class TracerTest : public ::testing::Test {
+ protected:
+  void TearDown() override { tracing::SetTracer(nullptr); }
+};
+
+TEST_F(TracerTest, DisabledSpanSkipsAttributes) {
+  ASSERT_FALSE(tracing::IsTracingEnabled());
+  EXPECT_EQ(tracing::GetTracer(), nullptr);
+
+  bool called = false;
+  tracing::Span span("Operation", [&] {
+    called = true;
+    return tracing::SpanAttributes();
+  });
+  span.End();
+
+  EXPECT_FALSE(called);
+}
+
+TEST_F(TracerTest, ChromeTraceRecorder) {
+  auto recorder = std::make_shared<tracing::ChromeTraceRecorder>(3u);
+  tracing::SetTracer(recorder);
+  ASSERT_TRUE(tracing::IsTracingEnabled());
+
+  {
+    tracing::Span outer("Outer", [] {
+      return tracing::SpanAttributes()
+          .WithRequestId("request")
+          .WithCatalog("hrn:here:data::olp-here-test:catalog")
+          .WithLayer("layer")
+          .WithPartition("23618364")
+          .WithDetails("a \"quoted\"\nvalue");
+    });
+    tracing::Span inner("Inner");
+
+    // The span can end on another thread.
+    auto moved = std::move(inner);
+    std::thread([&] { moved.End(); }).join();
+    EXPECT_EQ(recorder->GetEventCount(), 1u);
+  }
+  EXPECT_EQ(recorder->GetEventCount(), 2u);
+
+  {
+    SCOPED_TRACE("Open spans are not written");
+
+    tracing::Span open("Open");
+    std::stringstream stream;
+    recorder->Write(stream);
+
+    const auto json = stream.str();
+    EXPECT_EQ(json.find("{\"traceEvents\":[{\"name\":\"Inner\""), 0u);
+    EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"request_id\":\"request\""), std::string::npos);
+    EXPECT_NE(json.find("\"partition\":\"23618364\""), std::string::npos);
+    EXPECT_NE(json.find("\"details\":\"a \\\"quoted\\\"\\nvalue\""),
+              std::string::npos);
+    EXPECT_EQ(json.find("Open"), std::string::npos);
+  }
+  {
+    SCOPED_TRACE("Spans above the limit are dropped");
+
+    tracing::Span("First");
+    tracing::Span("Second");
+    EXPECT_EQ(recorder->GetEventCount(), 3u);
+  }
+
+  recorder->Clear();
+  EXPECT_EQ(recorder->GetEventCount(), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/utils/HashLruCache.h>
+
+namespace {
+
+using Cache = olp::utils::HashLruCache<std::string, int>;
+
+std::string Key(int index) { return "key" + std::to_string(index); }
+
+std::vector<std::string> GetKeys(const Cache& cache) {
+  std::vector<std::string> keys;
+  for (const auto& item : cache) {
+    keys.push_back(item.key());
+  }
+  return keys;
+}
+
+struct ValueCost {
+  std::size_t operator()(const int& value) const {
+    return static_cast<std::size_t>(value);
+  }
+};
+
+TEST(HashLruCacheTest, InsertAndFind) {
+  Cache cache(10);
+  EXPECT_TRUE(cache.Insert(Key(1), 1).second);
+  EXPECT_TRUE(cache.Insert(Key(2), 2).second);
+
+  {
+    SCOPED_TRACE("Insert does not update the value");
+
+    const auto result = cache.Insert(Key(1), 10);
+    EXPECT_FALSE(result.second);
+    ASSERT_NE(result.first, cache.end());
+    EXPECT_EQ(result.first->value(), 1);
+  }
+  {
+    SCOPED_TRACE("InsertOrAssign updates the value");
+
+    const auto result = cache.InsertOrAssign(Key(2), 20);
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ(result.first->value(), 20);
+  }
+
+  EXPECT_EQ(cache.Size(), 2u);
+  EXPECT_EQ(cache.Find(Key(1), -1), 1);
+  EXPECT_EQ(cache.Find(Key(3), -1), -1);
+  EXPECT_EQ(cache.FindNoPromote(Key(3)), cache.end());
+}
+
+TEST(HashLruCacheTest, LruOrder) {
+  Cache cache(3);
+  std::vector<std::pair<std::string, int>> evicted;
+  cache.SetEvictionCallback([&](const std::string& key, int&& value) {
+    evicted.emplace_back(key, value);
+  });
+
+  cache.Insert(Key(1), 1);
+  cache.Insert(Key(2), 2);
+  cache.Insert(Key(3), 3);
+  EXPECT_EQ(GetKeys(cache),
+            (std::vector<std::string>{Key(3), Key(2), Key(1)}));
+
+  {
+    SCOPED_TRACE("FindNoPromote keeps the order");
+
+    cache.FindNoPromote(Key(1));
+    EXPECT_EQ(cache.rbegin()->key(), Key(1));
+  }
+  {
+    SCOPED_TRACE("Find promotes");
+
+    cache.Find(Key(1));
+    EXPECT_EQ(GetKeys(cache),
+              (std::vector<std::string>{Key(1), Key(3), Key(2)}));
+  }
+  {
+    SCOPED_TRACE("The least recently used item is evicted");
+
+    cache.Insert(Key(4), 4);
+    EXPECT_EQ(GetKeys(cache),
+              (std::vector<std::string>{Key(4), Key(1), Key(3)}));
+    ASSERT_EQ(evicted.size(), 1u);
+    EXPECT_EQ(evicted[0], std::make_pair(Key(2), 2));
+  }
+  {
+    SCOPED_TRACE("Erase does not call the eviction callback");
+
+    EXPECT_TRUE(cache.Erase(Key(1)));
+    EXPECT_FALSE(cache.Erase(Key(1)));
+    EXPECT_EQ(evicted.size(), 1u);
+    EXPECT_EQ(GetKeys(cache), (std::vector<std::string>{Key(4), Key(3)}));
+  }
+  {
+    SCOPED_TRACE("Resize evicts");
+
+    cache.Resize(1u);
+    EXPECT_EQ(GetKeys(cache), (std::vector<std::string>{Key(4)}));
+    EXPECT_EQ(evicted.size(), 2u);
+  }
+}
+
+TEST(HashLruCacheTest, Cost) {
+  olp::utils::HashLruCache<std::string, int, ValueCost> cache(10);
+
+  EXPECT_FALSE(cache.Insert(Key(1), 11).second);
+  EXPECT_EQ(cache.Size(), 0u);
+
+  EXPECT_TRUE(cache.Insert(Key(1), 4).second);
+  EXPECT_TRUE(cache.Insert(Key(2), 4).second);
+  EXPECT_EQ(cache.Size(), 8u);
+
+  cache.InsertOrAssign(Key(2), 6);
+  EXPECT_EQ(cache.Size(), 10u);
+
+  cache.InsertOrAssign(Key(3), 3);
+  EXPECT_EQ(cache.Size(), 9u);
+  EXPECT_EQ(cache.FindNoPromote(Key(1)), cache.end());
+}
+
+TEST(HashLruCacheTest, EraseWhileIterating) {
+  Cache cache(100);
+  for (int i = 0; i < 10; ++i) {
+    cache.Insert(Key(i), i);
+  }
+
+  for (auto it = cache.begin(); it != cache.end();) {
+    if (it->value() % 2 == 0) {
+      it = cache.Erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  EXPECT_EQ(cache.Size(), 5u);
+  EXPECT_EQ(GetKeys(cache), (std::vector<std::string>{Key(9), Key(7), Key(5),
+                                                      Key(3), Key(1)}));
+
+  cache.Clear();
+  EXPECT_EQ(cache.Size(), 0u);
+  EXPECT_EQ(cache.begin(), cache.end());
+  EXPECT_TRUE(cache.Insert(Key(1), 1).second);
+}
+
+TEST(HashLruCacheTest, MatchesReferenceModel) {
+  // Random operations on many keys exercise the rehashing and the backward
+  // shift deletion of the hash table.
+  Cache cache(500);
+  cache.Reserve(100u);
+  std::map<std::string, int> expected;
+  std::mt19937 random(42);
+
+  for (int i = 0; i < 20000; ++i) {
+    const auto key = Key(static_cast<int>(random() % 1000u));
+    switch (random() % 3u) {
+      case 0:
+        cache.InsertOrAssign(key, i);
+        expected[key] = i;
+        break;
+      case 1:
+        EXPECT_EQ(cache.Erase(key), expected.erase(key) == 1u);
+        break;
+      default:
+        if (cache.Insert(key, i).second) {
+          expected[key] = i;
+        }
+        break;
+    }
+
+    // Keep the model in sync with the evictions.
+    if (expected.size() > cache.Size()) {
+      for (auto it = expected.begin(); it != expected.end();) {
+        if (cache.FindNoPromote(it->first) == cache.end()) {
+          it = expected.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+  }
+
+  ASSERT_EQ(cache.Size(), expected.size());
+  for (const auto& item : expected) {
+    auto it = cache.FindNoPromote(item.first);
+    ASSERT_NE(it, cache.end());
+    EXPECT_EQ(it->value(), item.second);
+  }
+
+  Cache moved(std::move(cache));
+  EXPECT_EQ(moved.Size(), expected.size());
+  EXPECT_EQ(GetKeys(moved).size(), expected.size());
+}
+
+}  // namespace
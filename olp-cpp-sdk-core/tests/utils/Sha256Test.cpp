@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/utils/Sha256.h>
+
+namespace {
+
+using olp::utils::Sha256;
+
+std::string HashString(const std::string& content) {
+  return Sha256::ToHexString(Sha256::Compute(content.data(), content.size()));
+}
+
+TEST(Sha256Test, KnownVectors) {
+  {
+    SCOPED_TRACE("Empty input");
+    EXPECT_EQ(
+        HashString(""),
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  }
+  {
+    SCOPED_TRACE("Single block");
+    EXPECT_EQ(
+        HashString("abc"),
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  }
+  {
+    SCOPED_TRACE("Padding spills into a second block");
+    EXPECT_EQ(
+        HashString("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  }
+  {
+    SCOPED_TRACE("Multiple blocks");
+    EXPECT_EQ(
+        HashString(std::string(1000000, 'a')),
+        "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+  }
+}
+
+TEST(Sha256Test, IncrementalUpdate) {
+  std::string content;
+  for (int i = 0; i < 1000; ++i) {
+    content.push_back(static_cast<char>(i * 31));
+  }
+  const auto expected = Sha256::Compute(content.data(), content.size());
+
+  for (size_t chunk_size : {1u, 7u, 63u, 64u, 65u, 300u}) {
+    SCOPED_TRACE("Chunk size " + std::to_string(chunk_size));
+    Sha256 sha;
+    for (size_t offset = 0; offset < content.size(); offset += chunk_size) {
+      sha.Update(content.data() + offset,
+                 std::min(chunk_size, content.size() - offset));
+    }
+    EXPECT_EQ(sha.Finalize(), expected);
+  }
+}
+
+TEST(Sha256Test, FinalizeResetsState) {
+  Sha256 sha;
+  sha.Update("abc", 3);
+  const auto first = sha.Finalize();
+  sha.Update("abc", 3);
+  EXPECT_EQ(sha.Finalize(), first);
+}
+
+}  // namespace
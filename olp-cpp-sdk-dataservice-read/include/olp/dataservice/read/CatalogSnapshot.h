@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <olp/core/client/HRN.h>
+#include <olp/core/client/OlpClientSettings.h>
+#include <olp/dataservice/read/DataServiceReadApi.h>
+#include <boost/optional.hpp>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+class CatalogSnapshotImpl;
+class VersionedLayerClient;
+
+/**
+ * @brief A version of a catalog shared by the clients of its layers.
+ *
+ * Create one snapshot per catalog and pass it to the `VersionedLayerClient`
+ * instances of the catalog layers, so that all of them read the same catalog
+ * version. If the catalog version is not specified, the latest version is
+ * requested once, with the first request of any of the clients. When
+ * the clients upgrade to a newer catalog version, the versions of all layers
+ * in it are requested once and shared by the clients.
+ *
+ * Copies of the snapshot share the same state.
+ *
+ * @code{.cpp}
+ * olp::dataservice::read::CatalogSnapshot snapshot(catalog, boost::none,
+ *                                                  settings);
+ * olp::dataservice::read::VersionedLayerClient roads(snapshot, "roads",
+ *                                                    settings);
+ * olp::dataservice::read::VersionedLayerClient places(snapshot, "places",
+ *                                                     settings);
+ * @endcode
+ */
+class DATASERVICE_READ_API CatalogSnapshot final {
+ public:
+  /**
+   * @brief Creates the `CatalogSnapshot` instance.
+   *
+   * @param catalog The HERE Resource Name (HRN) of the catalog.
+   * @param catalog_version The catalog version. If no version is specified,
+   * the latest version is used.
+   * @param settings The `OlpClientSettings` instance used to request
+   * the versions.
+   */
+  CatalogSnapshot(client::HRN catalog, boost::optional<int64_t> catalog_version,
+                  client::OlpClientSettings settings);
+
+  ~CatalogSnapshot();
+
+  /**
+   * @brief Gets the HRN of the catalog.
+   *
+   * @return The catalog HRN.
+   */
+  const client::HRN& GetCatalog() const;
+
+  /**
+   * @brief Gets the catalog version.
+   *
+   * @return The catalog version, or `boost::none` if the latest version has
+   * not been requested yet.
+   */
+  boost::optional<int64_t> GetVersion() const;
+
+  /**
+   * @brief Gets the version of a layer in the catalog version.
+   *
+   * The version of a layer is the catalog version in which the layer was last
+   * updated.
+   *
+   * @param layer_id The layer ID.
+   *
+   * @return The layer version, or `boost::none` if no client has upgraded to
+   * the catalog version yet or the layer is not in the catalog version.
+   */
+  boost::optional<int64_t> GetLayerVersion(const std::string& layer_id) const;
+
+ private:
+  friend class VersionedLayerClient;
+
+  std::shared_ptr<CatalogSnapshotImpl> impl_;
+};
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
@@ -220,6 +220,39 @@ class DATASERVICE_READ_API DataRequest final {
     return *this;
   }
 
+  /**
+   * @brief Checks whether the downloaded data is verified against the
+   * partition checksum.
+   *
+   * The default value is false.
+   *
+   * @return True if the checksum verification is enabled; false otherwise.
+   */
+  inline bool GetChecksumVerificationEnabled() const {
+    return verify_checksum_;
+  }
+
+  /**
+   * @brief Enables the verification of the downloaded data against the
+   * SHA-256 checksum of the partition.
+   *
+   * The checksum is only available when the data is requested using a
+   * partition ID. It is requested from the service together with the partition
+   * metadata. If the checksum of the downloaded data does not match, the
+   * data is not stored in the cache, and the request fails with the
+   * `ErrorCode::ChecksumMismatch` error. The cached partition metadata
+   * without the checksum is requested again. Partitions without a SHA-256
+   * checksum are not verified.
+   *
+   * @param enabled True to enable the checksum verification; false otherwise.
+   *
+   * @return A reference to the updated `DataRequest` instance.
+   */
+  inline DataRequest& WithChecksumVerificationEnabled(bool enabled) {
+    verify_checksum_ = enabled;
+    return *this;
+  }
+
   /**
    * @brief Creates a readable format for the request.
    *
@@ -254,6 +287,7 @@ class DATASERVICE_READ_API DataRequest final {
   boost::optional<std::string> billing_tag_;
   FetchOptions fetch_option_{OnlineIfNotFound};
   uint32_t priority_{thread::NORMAL};
+  bool verify_checksum_{false};
 };
 
 }  // namespace read
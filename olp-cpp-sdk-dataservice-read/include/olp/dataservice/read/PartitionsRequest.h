@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -179,6 +180,33 @@ class DATASERVICE_READ_API PartitionsRequest final {
     return *this;
   }
 
+  /**
+   * @brief Gets the number of parallel requests that download the metadata
+   * of all layer partitions.
+   *
+   * The default value is 1, the metadata is downloaded with one request.
+   *
+   * @return The number of shards.
+   */
+  inline std::uint32_t GetShardCount() const { return shard_count_; }
+
+  /**
+   * @brief Sets the number of parallel requests that download the metadata
+   * of all layer partitions.
+   *
+   * The metadata of a versioned layer is split into byte ranges that are
+   * downloaded and parsed concurrently. Small responses are not split. Has
+   * no effect if the partition IDs are set.
+   *
+   * @param shard_count The number of shards. Zero is treated as 1.
+   *
+   * @return A reference to the updated `PartitionsRequest` instance.
+   */
+  inline PartitionsRequest& WithShardCount(std::uint32_t shard_count) {
+    shard_count_ = shard_count > 0u ? shard_count : 1u;
+    return *this;
+  }
+
   /**
    * @brief Creates a readable format for the request.
    *
@@ -205,6 +233,7 @@ class DATASERVICE_READ_API PartitionsRequest final {
   AdditionalFields additional_fields_;
   boost::optional<std::string> billing_tag_;
   FetchOptions fetch_option_{OnlineIfNotFound};
+  std::uint32_t shard_count_{1u};
 };
 
 }  // namespace read
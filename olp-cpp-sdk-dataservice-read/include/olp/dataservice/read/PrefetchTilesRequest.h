@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include <olp/core/geo/tiling/TileCover.h>
 #include <olp/core/geo/tiling/TileKey.h>
 #include <olp/core/porting/deprecated.h>
 #include <olp/core/thread/TaskScheduler.h>
@@ -68,6 +69,25 @@ class DATASERVICE_READ_API PrefetchTilesRequest final {
     return *this;
   }
 
+  /**
+   * @brief Sets the tiles of a cover as the root tile keys for the request.
+   *
+   * Uses the compact version of the cover, so the fully covered areas are
+   * requested by their common ancestors, and sets the minimum and maximum
+   * tile levels to the level of the cover.
+   *
+   * @param tile_cover The cover of the area to prefetch.
+   *
+   * @return A reference to the updated `PrefetchTilesRequest` instance.
+   */
+  inline PrefetchTilesRequest& WithTileCover(const geo::TileCover& tile_cover) {
+    const auto compact = tile_cover.Compact();
+    tile_keys_.assign(compact.begin(), compact.end());
+    min_level_ = tile_cover.GetLevel();
+    max_level_ = tile_cover.GetLevel();
+    return *this;
+  }
+
   /**
    * @brief Gets the minimum tiles level to prefetch.
    *
@@ -180,6 +200,42 @@ class DATASERVICE_READ_API PrefetchTilesRequest final {
     return data_aggregation_enabled_;
   }
 
+  /**
+   * @brief Enables the prefetch manifest.
+   *
+   * The manifest records which tiles of every quad tree are already
+   * downloaded and stored in the cache. When it is enabled, a repeated or
+   * resumed prefetch of the same catalog version skips such tiles in bulk
+   * without checking the cache for each of them.
+   *
+   * @note The manifest is not updated when the cache evicts the data. Do not
+   * enable it if the cache is not large enough to hold all the prefetched
+   * data.
+   *
+   * @param prefetch_manifest_enabled The boolean parameter that enables or
+   * disables the manifest.
+   *
+   * @note Experimental. API may change.
+   *
+   * @return A reference to the updated `PrefetchTilesRequest` instance.
+   */
+  inline PrefetchTilesRequest& WithPrefetchManifestEnabled(
+      bool prefetch_manifest_enabled) {
+    prefetch_manifest_enabled_ = prefetch_manifest_enabled;
+    return *this;
+  }
+
+  /**
+   * @brief Gets the prefetch manifest flag.
+   *
+   * @note Experimental. API may change.
+   *
+   * @return The prefetch manifest flag as a boolean value.
+   */
+  inline bool GetPrefetchManifestEnabled() const {
+    return prefetch_manifest_enabled_;
+  }
+
   /**
    * @brief Gets the request priority.
    *
@@ -225,6 +281,7 @@ class DATASERVICE_READ_API PrefetchTilesRequest final {
   unsigned int max_level_{geo::TileKey::LevelCount};
   boost::optional<std::string> billing_tag_;
   bool data_aggregation_enabled_{false};
+  bool prefetch_manifest_enabled_{false};
   uint32_t priority_{thread::LOW};
 };
 
@@ -30,6 +30,7 @@
 #include <olp/dataservice/read/AggregatedDataResult.h>
 #include <olp/dataservice/read/PrefetchPartitionsResult.h>
 #include <olp/dataservice/read/PrefetchStatus.h>
+#include <olp/dataservice/read/UpgradeToVersionResult.h>
 #include <olp/dataservice/read/model/Catalog.h>
 #include <olp/dataservice/read/model/Data.h>
 #include <olp/dataservice/read/model/Messages.h>
@@ -71,6 +72,10 @@ using PartitionsResult = model::Partitions;
 using PartitionsResponse = Response<PartitionsResult>;
 /// The callback type of the partition metadata response.
 using PartitionsResponseCallback = Callback<PartitionsResult>;
+/// The callback type that receives the partition metadata one by one.
+using PartitionsStreamCallback = std::function<void(model::Partition)>;
+/// The callback type of the operations that do not have a result.
+using CallbackNoResult = Callback<client::ApiNoResult>;
 
 /// The `Data` alias type.
 using DataResult = model::Data;
@@ -137,6 +142,11 @@ using VersionsResponse = Response<VersionsResult>;
 /// The versions list of metadata callback type for the versioned client.
 using VersionsResponseCallback = Callback<VersionsResult>;
 
+/// The response type of the upgrade to a newer catalog version.
+using UpgradeToVersionResponse = Response<UpgradeToVersionResult>;
+/// The callback type of the upgrade to a newer catalog version.
+using UpgradeToVersionResponseCallback = Callback<UpgradeToVersionResult>;
+
 /// The list of tile keys.
 using TileKeys = std::vector<geo::TileKey>;
 }  // namespace read
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <olp/dataservice/read/DataServiceReadApi.h>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+
+/**
+ * @brief Represents the result of moving the cached layer metadata to
+ * a newer catalog version.
+ */
+class DATASERVICE_READ_API UpgradeToVersionResult {
+ public:
+  UpgradeToVersionResult() = default;
+
+  /**
+   * @brief Creates the `UpgradeToVersionResult` instance.
+   *
+   * @param from_version The catalog version used before the upgrade.
+   * @param to_version The catalog version used after the upgrade.
+   */
+  UpgradeToVersionResult(std::int64_t from_version, std::int64_t to_version)
+      : from_version_(from_version), to_version_(to_version) {}
+
+  /**
+   * @brief Gets the catalog version used before the upgrade.
+   *
+   * @return The catalog version.
+   */
+  std::int64_t GetFromVersion() const { return from_version_; }
+
+  /**
+   * @brief Gets the catalog version used after the upgrade.
+   *
+   * @return The catalog version.
+   */
+  std::int64_t GetToVersion() const { return to_version_; }
+
+  /**
+   * @brief Checks whether the layer changed between the versions.
+   *
+   * @return True if the layer has partitions that changed between
+   * the versions; false otherwise.
+   */
+  bool IsLayerChanged() const { return layer_changed_; }
+
+  /**
+   * @brief Sets whether the layer changed between the versions.
+   *
+   * @param layer_changed True if the layer changed; false otherwise.
+   */
+  void SetLayerChanged(bool layer_changed) { layer_changed_ = layer_changed; }
+
+  /**
+   * @brief Adds the ID of the partition that was added or changed.
+   *
+   * @param partition The partition ID.
+   */
+  void AddChangedPartition(std::string partition) {
+    changed_partitions_.emplace_back(std::move(partition));
+  }
+
+  /**
+   * @brief Gets the partitions that were added or changed.
+   *
+   * @return The list of partition IDs.
+   */
+  const std::vector<std::string>& GetChangedPartitions() const {
+    return changed_partitions_;
+  }
+
+  /**
+   * @brief Adds the ID of the partition that was removed.
+   *
+   * @param partition The partition ID.
+   */
+  void AddRemovedPartition(std::string partition) {
+    removed_partitions_.emplace_back(std::move(partition));
+  }
+
+  /**
+   * @brief Gets the partitions that were removed.
+   *
+   * The removed partitions are only known if the partition list of
+   * the previous version was cached.
+   *
+   * @return The list of partition IDs.
+   */
+  const std::vector<std::string>& GetRemovedPartitions() const {
+    return removed_partitions_;
+  }
+
+ private:
+  std::int64_t from_version_{-1};
+  std::int64_t to_version_{-1};
+  bool layer_changed_{false};
+  std::vector<std::string> changed_partitions_;
+  std::vector<std::string> removed_partitions_;
+};
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
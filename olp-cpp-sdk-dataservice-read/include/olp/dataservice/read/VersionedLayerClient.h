@@ -28,6 +28,7 @@
 #include <olp/core/client/CancellationToken.h>
 #include <olp/core/client/HRN.h>
 #include <olp/core/client/OlpClientSettings.h>
+#include <olp/dataservice/read/CatalogSnapshot.h>
 #include <olp/dataservice/read/DataRequest.h>
 #include <olp/dataservice/read/DataServiceReadApi.h>
 #include <olp/dataservice/read/PartitionsRequest.h>
@@ -126,6 +127,26 @@ class DATASERVICE_READ_API VersionedLayerClient final {
                        boost::optional<int64_t> catalog_version,
                        client::OlpClientSettings settings);
 
+  /**
+   * @brief Creates the `VersionedLayerClient` instance that uses the catalog
+   * version of the snapshot.
+   *
+   * All clients created with the same snapshot use the same catalog version,
+   * which is resolved only once. Keep in mind that catalog version provided
+   * with requests will be ignored.
+   *
+   * @param snapshot The `CatalogSnapshot` instance of the catalog that
+   * contains the versioned layer.
+   * @param layer_id The layer ID of the versioned layer from which you want to
+   * get data.
+   * @param settings The `OlpClientSettings` instance.
+   *
+   * @return The `VersionedLayerClient` instance that uses the catalog version
+   * of the snapshot.
+   */
+  VersionedLayerClient(const CatalogSnapshot& snapshot, std::string layer_id,
+                       client::OlpClientSettings settings);
+
   /// Movable, non-copyable
   VersionedLayerClient(const VersionedLayerClient& other) = delete;
   VersionedLayerClient(VersionedLayerClient&& other) noexcept;
@@ -295,6 +316,31 @@ class DATASERVICE_READ_API VersionedLayerClient final {
   client::CancellableFuture<PartitionsResponse> GetPartitions(
       PartitionsRequest partitions_request);
 
+  /**
+   * @brief Streams the partitions of the given generic layer asynchronously.
+   *
+   * The partitions are passed to the stream callback while the response is
+   * parsed, so the memory usage does not depend on the number of partitions
+   * in the layer. Use it instead of `GetPartitions` for large layers.
+   *
+   * @note The stream callback can receive partitions before an error is
+   * encountered.
+   *
+   * @param partitions_request The `PartitionsRequest` instance that contains
+   * a complete set of request parameters.
+   * @note CacheWithUpdate fetch option is not supported.
+   * @param partition_stream_callback The `PartitionsStreamCallback` object
+   * that is invoked for each partition.
+   * @param callback The `CallbackNoResult` object that is invoked when all
+   * partitions are streamed or an error is encountered.
+   *
+   * @return A token that can be used to cancel this request.
+   */
+  client::CancellationToken StreamLayerPartitions(
+      PartitionsRequest partitions_request,
+      PartitionsStreamCallback partition_stream_callback,
+      CallbackNoResult callback);
+
   /**
    * @brief Prefetches a set of tiles asynchronously.
    *
@@ -352,6 +398,50 @@ class DATASERVICE_READ_API VersionedLayerClient final {
       PrefetchTilesRequest request,
       PrefetchStatusCallback status_callback = nullptr);
 
+  /**
+   * @brief Prefetches the tiles of a moving viewport asynchronously.
+   *
+   * Unlike `PrefetchTiles`, this method keeps the state between the calls.
+   * Each call replaces the viewport of the previous one: the tiles that are
+   * no longer requested are dropped from the queue and their downloads are
+   * cancelled, while the tiles that are still requested keep downloading.
+   * The queued tiles are downloaded in the order of their distance to the
+   * `focus` tile, and the quad trees that were already queried for the
+   * previous viewports are not queried again.
+   *
+   * @note The callback of the previous viewport is invoked with
+   * the `Cancelled` error if its tiles are not prefetched yet.
+   *
+   * @param request The `PrefetchTilesRequest` instance that contains
+   * the tiles and levels of the viewport.
+   * @param focus The tile that the user looks at, for example, the center of
+   * the viewport or the next position on the route.
+   * @param callback The `PrefetchTilesResponseCallback` object that is invoked
+   * when all tiles of the viewport are prefetched or an error is encountered.
+   *
+   * @return A token that can be used to cancel the viewport.
+   */
+  client::CancellationToken PrefetchViewport(
+      PrefetchTilesRequest request, geo::TileKey focus,
+      PrefetchTilesResponseCallback callback);
+
+  /**
+   * @brief Prefetches the tiles of a moving viewport asynchronously.
+   *
+   * See the callback overload for the details.
+   *
+   * @param request The `PrefetchTilesRequest` instance that contains
+   * the tiles and levels of the viewport.
+   * @param focus The tile that the user looks at, for example, the center of
+   * the viewport or the next position on the route.
+   *
+   * @return `CancellableFuture` that contains the `PrefetchTilesResponse`
+   * instance with data or an error. You can also use `CancellableFuture` to
+   * cancel the viewport.
+   */
+  client::CancellableFuture<PrefetchTilesResponse> PrefetchViewport(
+      PrefetchTilesRequest request, geo::TileKey focus);
+
   /**
    * @brief Prefetches a set of partitions asynchronously.
    *
@@ -544,6 +634,45 @@ class DATASERVICE_READ_API VersionedLayerClient final {
    */
   bool Release(const std::string& partition_id);
 
+  /**
+   * @brief Moves the client to a newer catalog version and carries over
+   * the cached metadata of the layer.
+   *
+   * If the layer did not change between the versions, nothing is downloaded,
+   * and the cached partition metadata and quadtrees are reused by the new
+   * version. Otherwise, only the partition metadata of the new version is
+   * downloaded: the cached quadtrees without changed tiles are reused, and
+   * the data of the unchanged partitions stays in the cache, as it is stored
+   * by data handle.
+   *
+   * When the upgrade succeeds, the client uses the new version for all
+   * subsequent requests. The other clients that share the `CatalogSnapshot`
+   * with this client are moved as well.
+   *
+   * @param version The catalog version. It cannot be older than the current
+   * version of the client.
+   * @param callback The `UpgradeToVersionResponseCallback` object that
+   * receives the partitions that changed between the versions or an error.
+   *
+   * @return A token that can be used to cancel this request.
+   */
+  client::CancellationToken UpgradeToVersion(
+      int64_t version, UpgradeToVersionResponseCallback callback);
+
+  /**
+   * @brief Moves the client to a newer catalog version and carries over
+   * the cached metadata of the layer.
+   *
+   * @param version The catalog version. It cannot be older than the current
+   * version of the client.
+   *
+   * @return `CancellableFuture` that contains the `UpgradeToVersionResponse`
+   * instance or an error. You can also use `CancellableFuture` to cancel this
+   * request.
+   */
+  client::CancellableFuture<UpgradeToVersionResponse> UpgradeToVersion(
+      int64_t version);
+
  private:
   std::unique_ptr<VersionedLayerClientImpl> impl_;
 };
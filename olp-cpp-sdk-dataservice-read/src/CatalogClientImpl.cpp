@@ -61,10 +61,11 @@ client::CancellationToken CatalogClientImpl::GetCatalog(
     auto catalog = catalog_;
     auto settings = settings_;
     auto lookup_client = lookup_client_;
+    auto task_sink = &task_sink_;
 
     auto get_catalog_task = [=](client::CancellationContext context) {
       repository::CatalogRepository repository(catalog, settings,
-                                               lookup_client);
+                                               lookup_client, task_sink);
       return repository.GetCatalog(request, std::move(context));
     };
 
@@ -95,10 +96,11 @@ client::CancellationToken CatalogClientImpl::GetLatestVersion(
     auto catalog = catalog_;
     auto settings = settings_;
     auto lookup_client = lookup_client_;
+    auto task_sink = &task_sink_;
 
     auto get_latest_version_task = [=](client::CancellationContext context) {
       repository::CatalogRepository repository(catalog, settings,
-                                               lookup_client);
+                                               lookup_client, task_sink);
       return repository.GetLatestVersion(request, std::move(context));
     };
 
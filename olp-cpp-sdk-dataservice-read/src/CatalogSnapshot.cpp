@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "olp/dataservice/read/CatalogSnapshot.h"
+
+#include "CatalogSnapshotImpl.h"
+
+namespace olp {
+namespace dataservice {
+namespace read {
+
+CatalogSnapshot::CatalogSnapshot(client::HRN catalog,
+                                 boost::optional<int64_t> catalog_version,
+                                 client::OlpClientSettings settings)
+    : impl_(std::make_shared<CatalogSnapshotImpl>(
+          std::move(catalog), std::move(catalog_version),
+          std::move(settings))) {}
+
+CatalogSnapshot::~CatalogSnapshot() = default;
+
+const client::HRN& CatalogSnapshot::GetCatalog() const {
+  return impl_->GetCatalog();
+}
+
+boost::optional<int64_t> CatalogSnapshot::GetVersion() const {
+  const auto version = impl_->GetResolvedVersion();
+  if (version == CatalogSnapshotImpl::kInvalidVersion) {
+    return boost::none;
+  }
+  return version;
+}
+
+boost::optional<int64_t> CatalogSnapshot::GetLayerVersion(
+    const std::string& layer_id) const {
+  return impl_->GetLayerVersion(layer_id);
+}
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "CatalogSnapshotImpl.h"
+
+#include <utility>
+
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/client/OlpClientSettingsFactory.h>
+#include <olp/core/logging/Log.h>
+#include <olp/dataservice/read/CatalogVersionRequest.h>
+#include "repositories/CatalogRepository.h"
+
+namespace olp {
+namespace dataservice {
+namespace read {
+
+namespace {
+constexpr auto kLogTag = "CatalogSnapshotImpl";
+
+CatalogVersionResponse VersionResponse(int64_t version) {
+  model::VersionResponse response;
+  response.SetVersion(version);
+  return response;
+}
+}  // namespace
+
+constexpr int64_t CatalogSnapshotImpl::kInvalidVersion;
+
+CatalogSnapshotImpl::CatalogSnapshotImpl(
+    client::HRN catalog, boost::optional<int64_t> catalog_version,
+    client::OlpClientSettings settings)
+    : catalog_(std::move(catalog)),
+      settings_(std::move(settings)),
+      lookup_client_(catalog_, settings_),
+      version_(catalog_version.value_or(kInvalidVersion)),
+      initial_version_(catalog_version.value_or(kInvalidVersion)) {
+  if (!settings_.cache) {
+    settings_.cache = client::OlpClientSettingsFactory::CreateDefaultCache({});
+  }
+}
+
+CatalogVersionResponse CatalogSnapshotImpl::GetVersion(
+    boost::optional<std::string> billing_tag, FetchOptions fetch_options,
+    client::CancellationContext context, TaskSink* task_sink) {
+  auto version = version_.load();
+  if (version != kInvalidVersion) {
+    return VersionResponse(version);
+  }
+
+  repository::NamedMutex mutex(mutex_storage_, catalog_.ToString());
+  std::unique_lock<repository::NamedMutex> lock(mutex, std::defer_lock);
+
+  // The cache lookup is fast enough to not wait for the other threads.
+  if (fetch_options != CacheOnly) {
+    lock.lock();
+  }
+
+  version = version_.load();
+  if (version == kInvalidVersion) {
+    // Check if other threads have faced an error.
+    const auto optional_error = mutex.GetError();
+    if (optional_error) {
+      return *optional_error;
+    }
+
+    CatalogVersionRequest request;
+    request.WithBillingTag(billing_tag);
+    request.WithFetchOption(fetch_options);
+
+    repository::CatalogRepository repository(catalog_, settings_,
+                                             lookup_client_, task_sink);
+    auto response = repository.GetLatestVersion(request, context);
+    if (!response.IsSuccessful()) {
+      if (response.GetError().GetErrorCode() != client::ErrorCode::Cancelled) {
+        // Store an error to share it with other threads.
+        mutex.SetError(response.GetError());
+      }
+      return response;
+    }
+
+    // Another thread might have resolved the version from cache.
+    const auto resolved_version = response.GetResult().GetVersion();
+    if (version_.compare_exchange_strong(version, resolved_version)) {
+      version = resolved_version;
+      initial_version_.store(resolved_version);
+      OLP_SDK_LOG_DEBUG_F(kLogTag,
+                          "Resolved version, hrn='%s', version=%" PRId64,
+                          catalog_.ToCatalogHRNString().c_str(), version);
+    }
+  }
+
+  return VersionResponse(version);
+}
+
+void CatalogSnapshotImpl::SetVersion(int64_t version) {
+  version_.store(version);
+}
+
+CatalogSnapshotImpl::LayerVersionsResponse
+CatalogSnapshotImpl::GetLayerVersions(
+    int64_t version, const boost::optional<std::string>& billing_tag,
+    client::CancellationContext context, TaskSink* task_sink) {
+  auto layer_versions = FindLayerVersions(version);
+  if (layer_versions) {
+    return std::move(*layer_versions);
+  }
+
+  // The clients of all layers upgrade to the same version at once.
+  repository::NamedMutex mutex(
+      mutex_storage_,
+      catalog_.ToString() + "::" + std::to_string(version) + "::layerVersions");
+  std::lock_guard<repository::NamedMutex> lock(mutex);
+
+  layer_versions = FindLayerVersions(version);
+  if (layer_versions) {
+    return std::move(*layer_versions);
+  }
+
+  repository::CatalogRepository repository(catalog_, settings_,
+                                           lookup_client_, task_sink);
+  auto response = repository.GetLayerVersions(version, billing_tag,
+                                              OnlineIfNotFound, context);
+  if (!response.IsSuccessful()) {
+    OLP_SDK_LOG_WARNING_F(
+        kLogTag, "Failed to load layer versions, hrn='%s', error='%s'",
+        catalog_.ToCatalogHRNString().c_str(),
+        response.GetError().GetMessage().c_str());
+    return response;
+  }
+
+  // The stored versions are found by the requested version.
+  auto result = response.MoveResult();
+  result.SetVersion(version);
+
+  std::lock_guard<std::mutex> layer_versions_lock(layer_versions_mutex_);
+  layer_versions_ = result;
+  return result;
+}
+
+boost::optional<int64_t> CatalogSnapshotImpl::GetLayerVersion(
+    const std::string& layer_id) const {
+  const auto layer_versions = FindLayerVersions(version_.load());
+  if (!layer_versions) {
+    return boost::none;
+  }
+
+  for (const auto& layer_version : layer_versions->GetLayerVersions()) {
+    if (layer_version.GetLayer() == layer_id) {
+      return layer_version.GetVersion();
+    }
+  }
+  return boost::none;
+}
+
+int64_t CatalogSnapshotImpl::GetLayerUpgradeVersion(
+    const std::string& layer_id) const {
+  std::lock_guard<std::mutex> lock(layer_versions_mutex_);
+  const auto it = layer_upgrade_versions_.find(layer_id);
+  if (it == layer_upgrade_versions_.end()) {
+    return initial_version_.load();
+  }
+  return it->second;
+}
+
+void CatalogSnapshotImpl::SetLayerUpgradeVersion(const std::string& layer_id,
+                                                 int64_t version) {
+  {
+    std::lock_guard<std::mutex> lock(layer_versions_mutex_);
+    layer_upgrade_versions_[layer_id] = version;
+  }
+  SetVersion(version);
+}
+
+boost::optional<model::LayerVersions> CatalogSnapshotImpl::FindLayerVersions(
+    int64_t version) const {
+  std::lock_guard<std::mutex> lock(layer_versions_mutex_);
+  if (!layer_versions_ || layer_versions_->GetVersion() != version) {
+    return boost::none;
+  }
+  return layer_versions_;
+}
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <olp/core/client/ApiLookupClient.h>
+#include <olp/core/client/ApiResponse.h>
+#include <olp/core/client/CancellationContext.h>
+#include <olp/core/client/HRN.h>
+#include <olp/core/client/OlpClientSettings.h>
+#include <olp/dataservice/read/FetchOptions.h>
+#include <olp/dataservice/read/Types.h>
+#include <boost/optional.hpp>
+#include "generated/model/LayerVersions.h"
+#include "repositories/NamedMutex.h"
+
+namespace olp {
+namespace dataservice {
+namespace read {
+
+class TaskSink;
+
+/*
+ * @brief The catalog version used by one or more layer clients.
+ *
+ * The latest version is resolved once, concurrent requests wait for it.
+ * The layer versions are loaded once per catalog version, when the clients
+ * upgrade to it.
+ */
+class CatalogSnapshotImpl {
+ public:
+  using LayerVersionsResponse =
+      client::ApiResponse<model::LayerVersions, client::ApiError>;
+
+  /// The version that has not been resolved yet.
+  static constexpr int64_t kInvalidVersion = -1;
+
+  CatalogSnapshotImpl(client::HRN catalog,
+                      boost::optional<int64_t> catalog_version,
+                      client::OlpClientSettings settings);
+
+  const client::HRN& GetCatalog() const { return catalog_; }
+
+  const client::OlpClientSettings& GetSettings() const { return settings_; }
+
+  /// Gets the version, resolves it on the first call if it is not set.
+  /// Stale cache entries are refreshed with the tasks of the calling client.
+  CatalogVersionResponse GetVersion(boost::optional<std::string> billing_tag,
+                                    FetchOptions fetch_options,
+                                    client::CancellationContext context,
+                                    TaskSink* task_sink = nullptr);
+
+  /// Gets the version, or `kInvalidVersion` if it is not resolved yet.
+  int64_t GetResolvedVersion() const { return version_.load(); }
+
+  /// Moves the snapshot to another version.
+  void SetVersion(int64_t version);
+
+  /// Gets the versions of all layers in the catalog version. The clients of
+  /// the other layers upgrading to the same version reuse them.
+  LayerVersionsResponse GetLayerVersions(
+      int64_t version, const boost::optional<std::string>& billing_tag,
+      client::CancellationContext context, TaskSink* task_sink = nullptr);
+
+  /// Gets the layer version in the snapshot version, if the layer versions
+  /// of it are loaded.
+  boost::optional<int64_t> GetLayerVersion(const std::string& layer_id) const;
+
+  /// Gets the version that the cached metadata of the layer belongs to: the
+  /// version of the last layer upgrade, or the version that the snapshot was
+  /// created or resolved with. Other layers might have moved the snapshot
+  /// since, so the snapshot version is not the base of the layer upgrade.
+  int64_t GetLayerUpgradeVersion(const std::string& layer_id) const;
+
+  /// Records the upgrade of the layer and moves the snapshot to the version.
+  void SetLayerUpgradeVersion(const std::string& layer_id, int64_t version);
+
+ private:
+  boost::optional<model::LayerVersions> FindLayerVersions(
+      int64_t version) const;
+
+  const client::HRN catalog_;
+  client::OlpClientSettings settings_;
+  client::ApiLookupClient lookup_client_;
+  std::atomic<int64_t> version_;
+  std::atomic<int64_t> initial_version_;
+  repository::NamedMutexStorage mutex_storage_;
+  mutable std::mutex layer_versions_mutex_;
+  boost::optional<model::LayerVersions> layer_versions_;
+  std::unordered_map<std::string, int64_t> layer_upgrade_versions_;
+};
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
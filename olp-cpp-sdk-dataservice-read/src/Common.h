@@ -19,10 +19,19 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <olp/core/client/ApiLookupClient.h>
+#include <olp/core/client/CancellationContext.h>
 #include <olp/core/client/CancellationToken.h>
 #include <olp/core/client/PendingRequests.h>
 #include <olp/core/thread/TaskScheduler.h>
 #include <olp/dataservice/read/FetchOptions.h>
+#include <boost/optional.hpp>
 
 namespace olp {
 namespace dataservice {
@@ -61,6 +70,99 @@ inline client::CancellationToken ScheduleFetch(TaskScheduler&& schedule_task,
                        std::forward<Callback>(callback));
 }
 
+/*
+ * @brief Starts an asynchronous call and registers its cancellation token in
+ * the context.
+ *
+ * The callback receives the response, or the cancelled error if the context
+ * is cancelled before the call. The response that arrives before the token
+ * is registered, e.g. an immediate error, is passed to the callback after
+ * the registration, so the callback can start the next call with the same
+ * context.
+ *
+ * @param context The context of the operation.
+ * @param call Starts the call, consumes its callback.
+ * @param callback The callback that receives the response.
+ */
+template <typename Response>
+inline void ExecuteAsync(
+    client::CancellationContext context,
+    std::function<client::CancellationToken(std::function<void(Response)>)>
+        call,
+    std::function<void(Response)> callback) {
+  struct State {
+    std::mutex mutex;
+    bool started{false};
+    boost::optional<Response> response;
+  };
+  auto state = std::make_shared<State>();
+
+  auto on_response = [=](Response response) {
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (!state->started) {
+        state->response = std::move(response);
+        return;
+      }
+    }
+    callback(std::move(response));
+  };
+
+  const bool started = context.ExecuteOrCancelled(
+      [&]() { return call(on_response); },
+      [&]() { callback(client::ApiError::Cancelled()); });
+
+  boost::optional<Response> response;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->started = true;
+    response = std::move(state->response);
+  }
+
+  if (started && response) {
+    callback(std::move(*response));
+  }
+}
+
+/*
+ * @brief Looks up the service API without blocking the thread on the
+ * network.
+ *
+ * The cached lookup result is used if the fetch option allows it, otherwise
+ * the lookup continues online.
+ *
+ * @param lookup_client The lookup client of the catalog.
+ * @param service The name of the service.
+ * @param fetch_option The fetch option of the request.
+ * @param context The context of the operation.
+ * @param callback The callback that receives the lookup response.
+ */
+inline void LookupApiAsync(
+    client::ApiLookupClient& lookup_client, const std::string& service,
+    FetchOptions fetch_option, client::CancellationContext context,
+    client::ApiLookupClient::LookupApiCallback callback) {
+  auto lookup_option = static_cast<client::FetchOptions>(fetch_option);
+  if (lookup_option != client::OnlineOnly &&
+      lookup_option != client::CacheWithUpdate) {
+    // The cached lookup does not block, only the online lookup is async.
+    auto cached_lookup =
+        lookup_client.LookupApi(service, "v1", client::CacheOnly, context);
+    if (cached_lookup.IsSuccessful() || lookup_option == client::CacheOnly) {
+      callback(std::move(cached_lookup));
+      return;
+    }
+    lookup_option = client::OnlineOnly;
+  }
+
+  ExecuteAsync<client::ApiLookupClient::LookupApiResponse>(
+      std::move(context),
+      [&](client::ApiLookupClient::LookupApiCallback on_lookup) {
+        return lookup_client.LookupApi(service, "v1", lookup_option,
+                                       std::move(on_lookup));
+      },
+      std::move(callback));
+}
+
 }  // namespace read
 }  // namespace dataservice
 }  // namespace olp
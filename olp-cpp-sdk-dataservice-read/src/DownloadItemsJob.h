@@ -37,6 +37,13 @@ using ExtendedDataResponse = ExtendedApiResponse<model::Data, client::ApiError,
 using DownloadFunc = std::function<ExtendedDataResponse(
     std::string, client::CancellationContext)>;
 
+using DownloadCallback = std::function<void(ExtendedDataResponse)>;
+
+// Prototype of function used to download data without blocking the thread,
+// the callback receives the response.
+using AsyncDownloadFunc = std::function<void(
+    std::string, client::CancellationContext, DownloadCallback)>;
+
 template <typename ItemType, typename PrefetchResult>
 using AppendResultFunc =
     std::function<void(ExtendedDataResponse response, ItemType item,
@@ -59,6 +66,16 @@ class DownloadItemsJob {
         user_callback_(std::move(user_callback)),
         status_callback_(std::move(status_callback)) {}
 
+  DownloadItemsJob(
+      AsyncDownloadFunc download,
+      AppendResultFunc<ItemType, PrefetchResult> append_result,
+      Callback<PrefetchResult> user_callback,
+      PrefetchStatusCallbackType<PrefetchStatusType> status_callback)
+      : async_download_(std::move(download)),
+        append_result_(std::move(append_result)),
+        user_callback_(std::move(user_callback)),
+        status_callback_(std::move(status_callback)) {}
+
   void Initialize(size_t items_count, client::NetworkStatistics statistics) {
     download_task_count_ = total_download_task_count_ = items_count;
     accumulated_statistics_ = statistics;
@@ -68,6 +85,15 @@ class DownloadItemsJob {
                                 client::CancellationContext context) {
     return download_(data_handle, context);
   }
+
+  bool IsAsync() const { return static_cast<bool>(async_download_); }
+
+  void DownloadAsync(const std::string& data_handle,
+                     client::CancellationContext context,
+                     DownloadCallback callback) {
+    async_download_(data_handle, std::move(context), std::move(callback));
+  }
+
   size_t GetAccumulatedBytes(const olp::client::NetworkStatistics& statistics) {
     // This narrow cast is necessary to avoid narrowing compiler errors like
     // -Wc++11-narrowing when building for 32bit targets.
@@ -111,6 +137,7 @@ class DownloadItemsJob {
 
  private:
   DownloadFunc download_;
+  AsyncDownloadFunc async_download_;
   AppendResultFunc<ItemType, PrefetchResult> append_result_;
   Callback<PrefetchResult> user_callback_;
   PrefetchStatusCallbackType<PrefetchStatusType> status_callback_;
@@ -30,6 +30,7 @@
 #include <olp/core/logging/Log.h>
 #include <olp/dataservice/read/Types.h>
 #include "Common.h"
+#include "DownloadItemsJob.h"
 #include "ExtendedApiResponse.h"
 #include "TaskSink.h"
 
@@ -59,8 +60,15 @@ static olp::client::CancellationToken CreateToken(VectorOfTokens tokens) {
 
 template <typename ItemType, typename QueryType, typename PrefetchResult,
           typename QueryResponseType, typename PrefetchStatusType>
-class QueryMetadataJob {
+class QueryMetadataJob
+    : public std::enable_shared_from_this<
+          QueryMetadataJob<ItemType, QueryType, PrefetchResult,
+                           QueryResponseType, PrefetchStatusType>> {
  public:
+  /// The default maximum number of download tasks added to the `TaskSink` at
+  /// once.
+  static constexpr size_t kDefaultMaxDownloadsInFlight = 256u;
+
   QueryMetadataJob(
       QueryItemsFunc<ItemType, QueryType, QueryResponseType> query,
       FilterItemsFunc<typename QueryResponseType::ResultType> filter,
@@ -68,13 +76,16 @@ class QueryMetadataJob {
           DownloadItemsJob<ItemType, PrefetchResult, PrefetchStatusType>>
           download_job,
       TaskSink& task_sink, client::CancellationContext execution_context,
-      uint32_t priority)
+      uint32_t priority,
+      size_t max_downloads_in_flight = kDefaultMaxDownloadsInFlight)
       : query_(std::move(query)),
         filter_(std::move(filter)),
         download_job_(std::move(download_job)),
         task_sink_(task_sink),
         execution_context_(execution_context),
-        priority_(priority) {}
+        priority_(priority),
+        max_downloads_in_flight_(
+            std::max<size_t>(max_downloads_in_flight, 1u)) {}
 
   virtual ~QueryMetadataJob() = default;
 
@@ -94,25 +105,29 @@ class QueryMetadataJob {
   }
 
   void CompleteQuery(QueryResponseType response) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    accumulated_statistics_ += GetNetworkStatistics(response);
-
-    if (response.IsSuccessful()) {
-      auto items = response.MoveResult();
-      std::move(items.begin(), items.end(),
-                std::inserter(query_result_, query_result_.begin()));
-    } else {
-      const auto& error = response.GetError();
-      if (error.GetErrorCode() == client::ErrorCode::Cancelled) {
-        canceled_ = true;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      accumulated_statistics_ += GetNetworkStatistics(response);
+
+      if (response.IsSuccessful()) {
+        auto items = response.MoveResult();
+        std::move(items.begin(), items.end(),
+                  std::inserter(query_result_, query_result_.begin()));
       } else {
-        // Collect all errors.
-        query_errors_.push_back(error);
+        const auto& error = response.GetError();
+        if (error.GetErrorCode() == client::ErrorCode::Cancelled) {
+          canceled_ = true;
+        } else {
+          // Collect all errors.
+          query_errors_.push_back(error);
+        }
+      }
+
+      if (--query_count_) {
+        return;
       }
-    }
 
-    if (!--query_count_) {
       if (CheckIfFail()) {
         download_job_->OnPrefetchCompleted(query_errors_.front());
         return;
@@ -133,65 +148,133 @@ class QueryMetadataJob {
         return;
       }
 
-      OLP_SDK_LOG_DEBUG_F("QueryMetadataJob", "Starting download, requests=%zu",
-                          query_result_.size());
+      OLP_SDK_LOG_DEBUG_F("QueryMetadataJob",
+                          "Starting download, requests=%zu, window=%zu",
+                          query_result_.size(), max_downloads_in_flight_);
 
       download_job_->Initialize(query_result_.size(), accumulated_statistics_);
+      next_download_ = query_result_.begin();
+    }
 
-      auto download_job = download_job_;
-
-      bool all_download_tasks_triggered = true;
-
-      execution_context_.ExecuteOrCancelled(
-          [&]() {
-            VectorOfTokens tokens;
-            std::transform(
-                std::begin(query_result_), std::end(query_result_),
-                std::back_inserter(tokens),
-                [&](const typename QueryResponseType::ResultType::value_type&
-                        item) {
-                  const std::string& data_handle = item.second;
-                  const auto& item_key = item.first;
-
-                  auto result = task_sink_.AddTaskChecked(
-                      [=](client::CancellationContext context) {
-                        return download_job->Download(data_handle, context);
-                      },
-                      [=](ExtendedDataResponse response) {
-                        download_job->CompleteItem(item_key,
-                                                   std::move(response));
-                      },
-                      priority_);
-
-                  if (result) {
-                    return *result;
-                  }
-
-                  all_download_tasks_triggered = false;
-                  return client::CancellationToken();
-                });
-            return CreateToken(std::move(tokens));
-          },
-          [&]() {
-            download_job->OnPrefetchCompleted(
-                {{client::ErrorCode::Cancelled, "Cancelled"}});
-          });
-
-      if (!all_download_tasks_triggered) {
-        execution_context_.CancelOperation();
-        download_job_->OnPrefetchCompleted(
-            {{client::ErrorCode::Cancelled, "Cancelled"}});
-      }
+    // The downloads run in the child contexts of the execution context, so
+    // its cancellation cancels all of them at once.
+    if (execution_context_.IsCancelled()) {
+      download_job_->OnPrefetchCompleted(
+          {{client::ErrorCode::Cancelled, "Cancelled"}});
+      return;
     }
+
+    ScheduleDownloads();
   }
 
  protected:
+  using DownloadItem = typename QueryResponseType::ResultType::value_type;
+
+  // Adds the download tasks to the sink until the in-flight window is full.
+  // The completed downloads call it again, so the items are expanded into the
+  // tasks lazily, and the number of pending tasks never exceeds the window.
+  void ScheduleDownloads() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (scheduling_) {
+        // The thread which is already scheduling picks up the free slots.
+        return;
+      }
+      scheduling_ = true;
+    }
+
+    auto self = this->shared_from_this();
+
+    while (true) {
+      ItemType item_key;
+      std::string data_handle;
+
+      // The check does not lock the context, so it is done for every item.
+      const bool cancelled = execution_context_.IsCancelled();
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cancelled && next_download_ != query_result_.end()) {
+          downloads_aborted_ = true;
+        }
+
+        if (downloads_aborted_ || next_download_ == query_result_.end() ||
+            downloads_in_flight_ >= max_downloads_in_flight_) {
+          scheduling_ = false;
+          ReportAbortedIfDrained();
+          return;
+        }
+
+        item_key = next_download_->first;
+        data_handle = std::move(next_download_->second);
+        ++next_download_;
+        ++downloads_in_flight_;
+      }
+
+      auto complete = [=](ExtendedDataResponse response) {
+        self->download_job_->CompleteItem(item_key, std::move(response));
+        self->CompleteDownload();
+      };
+
+      // The asynchronous downloads do not hold the worker threads while
+      // waiting for the network, so the window is the only limit.
+      auto context = execution_context_.CreateChild();
+      const bool added =
+          download_job_->IsAsync()
+              ? static_cast<bool>(
+                    task_sink_.AddAsyncTaskChecked<ExtendedDataResponse>(
+                        [=](client::CancellationContext inner_context,
+                            DownloadCallback callback) {
+                          self->download_job_->DownloadAsync(
+                              data_handle, inner_context, std::move(callback));
+                        },
+                        complete, priority_, context))
+              : static_cast<bool>(task_sink_.AddTaskChecked(
+                    [=](client::CancellationContext inner_context) {
+                      return self->download_job_->Download(data_handle,
+                                                           inner_context);
+                    },
+                    complete, priority_, context));
+
+      if (!added) {
+        // The sink is closed, the remaining items are not downloaded.
+        std::lock_guard<std::mutex> lock(mutex_);
+        downloads_aborted_ = true;
+        --downloads_in_flight_;
+      }
+    }
+  }
+
+  void CompleteDownload() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --downloads_in_flight_;
+    }
+
+    ScheduleDownloads();
+  }
+
+  // When some items were never scheduled, the download job cannot complete on
+  // its own, so the prefetch is completed with cancellation once all
+  // in-flight downloads finish. Must be called under the lock.
+  void ReportAbortedIfDrained() {
+    if (!downloads_aborted_ || aborted_reported_ || scheduling_ ||
+        downloads_in_flight_ != 0u) {
+      return;
+    }
+
+    aborted_reported_ = true;
+    download_job_->OnPrefetchCompleted(
+        {{client::ErrorCode::Cancelled, "Cancelled"}});
+  }
+
   QueryItemsFunc<ItemType, QueryType, QueryResponseType> query_;
   FilterItemsFunc<typename QueryResponseType::ResultType> filter_;
   size_t query_count_{0};
   size_t query_size_{0};
   bool canceled_{false};
   typename QueryResponseType::ResultType query_result_;
+  typename QueryResponseType::ResultType::iterator next_download_;
   client::NetworkStatistics accumulated_statistics_;
   std::vector<client::ApiError> query_errors_;
   std::shared_ptr<
@@ -200,9 +283,20 @@ class QueryMetadataJob {
   TaskSink& task_sink_;
   client::CancellationContext execution_context_;
   uint32_t priority_;
+  const size_t max_downloads_in_flight_;
+  size_t downloads_in_flight_{0};
+  bool scheduling_{false};
+  bool downloads_aborted_{false};
+  bool aborted_reported_{false};
   std::mutex mutex_;
 };
 
+template <typename ItemType, typename QueryType, typename PrefetchResult,
+          typename QueryResponseType, typename PrefetchStatusType>
+constexpr size_t
+    QueryMetadataJob<ItemType, QueryType, PrefetchResult, QueryResponseType,
+                     PrefetchStatusType>::kDefaultMaxDownloadsInFlight;
+
 }  // namespace read
 }  // namespace dataservice
 }  // namespace olp
@@ -93,6 +93,50 @@ bool TaskSink::ScheduleTask(client::TaskContext task, uint32_t priority) {
   return true;
 }
 
+bool TaskSink::AddAsyncTaskImpl(client::TaskContext task,
+                                std::function<void()> start,
+                                uint32_t priority) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_) {
+      OLP_SDK_LOG_WARNING(
+          kLogTag, "Attempt to add a task when the sink is already closed");
+      return false;
+    }
+
+    // The task is removed from the pending requests when its result is
+    // delivered, not when `start` returns.
+    pending_requests_->Insert(task);
+  }
+
+  if (task_scheduler_) {
+    task_scheduler_->ScheduleTask(std::move(start), priority);
+  } else {
+    start();
+  }
+
+  return true;
+}
+
+void TaskSink::CompleteAsyncTask(
+    client::TaskContext task,
+    const std::shared_ptr<thread::TaskScheduler>& task_scheduler,
+    const std::shared_ptr<client::PendingRequests>& pending_requests,
+    uint32_t priority) {
+  auto execute = [=] {
+    task.Execute();
+    pending_requests->Remove(task);
+  };
+
+  // The result arrives on the network thread, the callback is moved to
+  // a worker thread to keep the network thread free.
+  if (task_scheduler) {
+    task_scheduler->ScheduleTask(std::move(execute), priority);
+  } else {
+    execute();
+  }
+}
+
 void TaskSink::ExecuteTask(client::TaskContext task) { task.Execute(); }
 
 }  // namespace read
@@ -19,6 +19,9 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+
 #include <boost/optional.hpp>
 
 #include <olp/core/client/CancellationToken.h>
@@ -67,7 +70,57 @@ class TaskSink {
     return context.CancelToken();
   }
 
+  /**
+   * Adds an operation that waits for the network without holding a worker
+   * thread. The worker only runs `start`, which must invoke its callback
+   * exactly once and register the pending request in the context. The
+   * result is delivered to `callback` on a worker thread, and the sink waits
+   * for the pending operations on destruction like for the other tasks.
+   */
+  template <typename Response>
+  boost::optional<client::CancellationToken> AddAsyncTaskChecked(
+      std::function<void(client::CancellationContext,
+                         std::function<void(Response)>)>
+          start,
+      std::function<void(Response)> callback, uint32_t priority,
+      client::CancellationContext context = client::CancellationContext()) {
+    auto result = std::make_shared<Response>(
+        client::ApiError(client::ErrorCode::Cancelled, "Cancelled"));
+    auto task = client::TaskContext::Create(
+        [result](client::CancellationContext) { return std::move(*result); },
+        std::move(callback), context);
+
+    auto scheduler = task_scheduler_;
+    auto pending_requests = pending_requests_;
+    std::function<void(Response)> complete = [=](Response response) {
+      *result = std::move(response);
+      CompleteAsyncTask(task, scheduler, pending_requests, priority);
+    };
+
+    auto start_task = [=]() {
+      if (context.IsCancelled()) {
+        complete(client::ApiError(client::ErrorCode::Cancelled, "Cancelled"));
+      } else {
+        start(context, complete);
+      }
+    };
+
+    if (!AddAsyncTaskImpl(task, std::move(start_task), priority)) {
+      return boost::none;
+    }
+    return task.CancelToken();
+  }
+
  protected:
+  bool AddAsyncTaskImpl(client::TaskContext task, std::function<void()> start,
+                        uint32_t priority);
+
+  static void CompleteAsyncTask(
+      client::TaskContext task,
+      const std::shared_ptr<thread::TaskScheduler>& task_scheduler,
+      const std::shared_ptr<client::PendingRequests>& pending_requests,
+      uint32_t priority);
+
   bool AddTaskImpl(client::TaskContext task, uint32_t priority);
 
   bool ScheduleTask(client::TaskContext task, uint32_t priority);
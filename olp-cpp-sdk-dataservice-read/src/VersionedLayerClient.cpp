@@ -34,6 +34,12 @@ VersionedLayerClient::VersionedLayerClient(
           std::move(catalog), std::move(layer_id), std::move(catalog_version),
           std::move(settings))) {}
 
+VersionedLayerClient::VersionedLayerClient(const CatalogSnapshot& snapshot,
+                                           std::string layer_id,
+                                           client::OlpClientSettings settings)
+    : impl_(std::make_unique<VersionedLayerClientImpl>(
+          snapshot.impl_, std::move(layer_id), std::move(settings))) {}
+
 VersionedLayerClient::VersionedLayerClient(
     VersionedLayerClient&& other) noexcept = default;
 
@@ -67,6 +73,15 @@ VersionedLayerClient::GetPartitions(PartitionsRequest partitions_request) {
   return impl_->GetPartitions(std::move(partitions_request));
 }
 
+client::CancellationToken VersionedLayerClient::StreamLayerPartitions(
+    PartitionsRequest partitions_request,
+    PartitionsStreamCallback partition_stream_callback,
+    CallbackNoResult callback) {
+  return impl_->StreamLayerPartitions(std::move(partitions_request),
+                                      std::move(partition_stream_callback),
+                                      std::move(callback));
+}
+
 client::CancellationToken VersionedLayerClient::PrefetchTiles(
     PrefetchTilesRequest request, PrefetchTilesResponseCallback callback,
     PrefetchStatusCallback status_callback) {
@@ -80,6 +95,19 @@ VersionedLayerClient::PrefetchTiles(PrefetchTilesRequest request,
   return impl_->PrefetchTiles(std::move(request), std::move(status_callback));
 }
 
+client::CancellationToken VersionedLayerClient::PrefetchViewport(
+    PrefetchTilesRequest request, geo::TileKey focus,
+    PrefetchTilesResponseCallback callback) {
+  return impl_->PrefetchViewport(std::move(request), focus,
+                                 std::move(callback));
+}
+
+client::CancellableFuture<PrefetchTilesResponse>
+VersionedLayerClient::PrefetchViewport(PrefetchTilesRequest request,
+                                       geo::TileKey focus) {
+  return impl_->PrefetchViewport(std::move(request), focus);
+}
+
 client::CancellationToken VersionedLayerClient::PrefetchPartitions(
     PrefetchPartitionsRequest request,
     PrefetchPartitionsResponseCallback callback,
@@ -149,6 +177,16 @@ bool VersionedLayerClient::Release(const std::string& partition_id) {
   return impl_->Release(partition_id);
 }
 
+client::CancellationToken VersionedLayerClient::UpgradeToVersion(
+    int64_t version, UpgradeToVersionResponseCallback callback) {
+  return impl_->UpgradeToVersion(version, std::move(callback));
+}
+
+client::CancellableFuture<UpgradeToVersionResponse>
+VersionedLayerClient::UpgradeToVersion(int64_t version) {
+  return impl_->UpgradeToVersion(version);
+}
+
 }  // namespace read
 }  // namespace dataservice
 }  // namespace olp
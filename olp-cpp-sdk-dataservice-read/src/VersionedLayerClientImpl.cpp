@@ -41,11 +41,13 @@
 #include "PrefetchTilesHelper.h"
 #include "ProtectDependencyResolver.h"
 #include "ReleaseDependencyResolver.h"
+#include "ViewportPrefetcher.h"
 #include "generated/api/QueryApi.h"
 #include "repositories/CatalogRepository.h"
 #include "repositories/DataCacheRepository.h"
 #include "repositories/DataRepository.h"
 #include "repositories/PartitionsRepository.h"
+#include "repositories/PrefetchManifest.h"
 #include "repositories/PrefetchTilesRepository.h"
 
 namespace olp {
@@ -54,10 +56,19 @@ namespace read {
 
 namespace {
 constexpr auto kLogTag = "VersionedLayerClientImpl";
-constexpr int64_t kInvalidVersion = -1;
+constexpr int64_t kInvalidVersion = CatalogSnapshotImpl::kInvalidVersion;
 constexpr auto kQuadTreeDepth = 4;
 }  // namespace
 
+struct VersionedLayerClientImpl::TilesPrefetch {
+  unsigned int min_level{0};
+  unsigned int max_level{0};
+  std::vector<geo::TileKey> roots;
+  PrefetchTilesHelper::QueryFunc query;
+  FilterItemsFunc<repository::SubQuadsResult> filter;
+  AsyncDownloadFunc download;
+};
+
 VersionedLayerClientImpl::VersionedLayerClientImpl(
     client::HRN catalog, std::string layer_id,
     boost::optional<int64_t> catalog_version,
@@ -65,18 +76,37 @@ VersionedLayerClientImpl::VersionedLayerClientImpl(
     : catalog_(std::move(catalog)),
       layer_id_(std::move(layer_id)),
       settings_(std::move(settings)),
-      catalog_version_(catalog_version ? catalog_version.get()
-                                       : kInvalidVersion),
       lookup_client_(catalog_, settings_),
-      task_sink_(settings_.task_scheduler) {
+      task_sink_(settings_.task_scheduler),
+      viewport_prefetcher_(std::make_shared<ViewportPrefetcher>(task_sink_)) {
   if (!settings_.cache) {
     settings_.cache = client::OlpClientSettingsFactory::CreateDefaultCache({});
   }
+
+  // The version is resolved by this client only.
+  snapshot_ = std::make_shared<CatalogSnapshotImpl>(
+      catalog_, std::move(catalog_version), settings_);
+}
+
+VersionedLayerClientImpl::VersionedLayerClientImpl(
+    std::shared_ptr<CatalogSnapshotImpl> snapshot, std::string layer_id,
+    client::OlpClientSettings settings)
+    : catalog_(snapshot->GetCatalog()),
+      layer_id_(std::move(layer_id)),
+      settings_(std::move(settings)),
+      snapshot_(std::move(snapshot)),
+      lookup_client_(catalog_, settings_),
+      task_sink_(settings_.task_scheduler),
+      viewport_prefetcher_(std::make_shared<ViewportPrefetcher>(task_sink_)) {
+  if (!settings_.cache) {
+    settings_.cache = snapshot_->GetSettings().cache;
+  }
 }
 
 bool VersionedLayerClientImpl::CancelPendingRequests() {
   OLP_SDK_LOG_TRACE(kLogTag, "CancelPendingRequests");
   task_sink_.CancelTasks();
+  viewport_prefetcher_->Cancel();
   return true;
 }
 
@@ -101,7 +131,8 @@ client::CancellationToken VersionedLayerClientImpl::GetPartitions(
     const auto version = version_response.GetResult().GetVersion();
 
     repository::PartitionsRepository repository(catalog_, layer_id_, settings_,
-                                                lookup_client_, mutex_storage_);
+                                                lookup_client_, mutex_storage_,
+                                                &task_sink_);
     return repository.GetVersionedPartitionsExtendedResponse(
         std::move(partitions_request), version, context);
   };
@@ -122,14 +153,58 @@ VersionedLayerClientImpl::GetPartitions(PartitionsRequest partitions_request) {
                                                        std::move(promise));
 }
 
+client::CancellationToken VersionedLayerClientImpl::StreamLayerPartitions(
+    PartitionsRequest partitions_request,
+    PartitionsStreamCallback partition_stream_callback,
+    CallbackNoResult callback) {
+  auto stream_task =
+      [this](PartitionsRequest request,
+             PartitionsStreamCallback stream_callback,
+             client::CancellationContext context) -> client::ApiNoResponse {
+    const auto fetch_option = request.GetFetchOption();
+    if (fetch_option == CacheWithUpdate) {
+      return client::ApiError(
+          client::ErrorCode::InvalidArgument,
+          "CacheWithUpdate option can not be used for versioned layer");
+    }
+
+    if (!stream_callback) {
+      return client::ApiError(client::ErrorCode::InvalidArgument,
+                              "Partitions stream callback is not set");
+    }
+
+    auto version_response =
+        GetVersion(request.GetBillingTag(), fetch_option, context);
+    if (!version_response.IsSuccessful()) {
+      return version_response.GetError();
+    }
+
+    const auto version = version_response.GetResult().GetVersion();
+
+    repository::PartitionsRepository repository(catalog_, layer_id_, settings_,
+                                                lookup_client_, mutex_storage_,
+                                                &task_sink_);
+    return repository.StreamVersionedPartitions(request, version,
+                                                stream_callback, context);
+  };
+
+  return task_sink_.AddTask(
+      std::bind(stream_task, std::move(partitions_request),
+                std::move(partition_stream_callback), std::placeholders::_1),
+      std::move(callback), thread::NORMAL);
+}
+
 client::CancellationToken VersionedLayerClientImpl::GetData(
     DataRequest request, DataResponseCallback callback) {
-  auto data_task =
-      [=](client::CancellationContext context) mutable -> DataResponse {
+  // The worker only resolves the version, the partition and the blob are
+  // requested without holding it.
+  auto data_task = [=](client::CancellationContext context,
+                       DataResponseCallback data_callback) mutable {
     if (request.GetFetchOption() == CacheWithUpdate) {
-      return {{client::ErrorCode::InvalidArgument,
-               "CacheWithUpdate option can not be used for versioned "
-               "layer"}};
+      data_callback({{client::ErrorCode::InvalidArgument,
+                      "CacheWithUpdate option can not be used for versioned "
+                      "layer"}});
+      return;
     }
 
     int64_t version = -1;
@@ -137,18 +212,26 @@ client::CancellationToken VersionedLayerClientImpl::GetData(
       auto version_response = GetVersion(request.GetBillingTag(),
                                          request.GetFetchOption(), context);
       if (!version_response.IsSuccessful()) {
-        return version_response.GetError();
+        data_callback(version_response.GetError());
+        return;
       }
       version = version_response.GetResult().GetVersion();
     }
 
     repository::DataRepository repository(catalog_, settings_, lookup_client_,
-                                          mutex_storage_);
-    return repository.GetVersionedData(layer_id_, request, version, context);
+                                          mutex_storage_, &task_sink_);
+    repository.GetVersionedDataAsync(
+        layer_id_, request, version, std::move(context),
+        [data_callback](BlobApi::DataResponse response) {
+          data_callback(std::move(response));
+        });
   };
 
-  return task_sink_.AddTask(std::move(data_task), std::move(callback),
-                            request.GetPriority());
+  return task_sink_
+      .AddAsyncTaskChecked<DataResponse>(std::move(data_task),
+                                         std::move(callback),
+                                         request.GetPriority())
+      .value_or(client::CancellationToken());
 }
 
 client::CancellableFuture<DataResponse> VersionedLayerClientImpl::GetData(
@@ -217,7 +300,8 @@ client::CancellationToken VersionedLayerClientImpl::PrefetchPartitions(
                        catalog_.ToCatalogHRNString().c_str(), key.c_str());
 
     repository::PartitionsRepository repository(catalog_, layer_id_, settings_,
-                                                lookup_client_, mutex_storage_);
+                                                lookup_client_, mutex_storage_,
+                                                &task_sink_);
 
     auto query = [=](std::vector<std::string> partitions,
                      client::CancellationContext inner_context) mutable
@@ -262,7 +346,7 @@ client::CancellationToken VersionedLayerClientImpl::PrefetchPartitions(
       }
 
       repository::DataRepository repository(catalog_, settings_, lookup_client_,
-                                            mutex_storage_);
+                                            mutex_storage_, &task_sink_);
       // Fetch from online
       return repository.GetVersionedData(
           layer_id_,
@@ -367,106 +451,75 @@ client::CancellationToken VersionedLayerClientImpl::PrefetchTiles(
         OLP_SDK_LOG_DEBUG_F(kLogTag, "PrefetchTiles: using key=%s",
                             key.c_str());
 
-        // Calculate the minimal set of Tile keys and depth to
-        // cover tree.
-        bool request_only_input_tiles =
-            !(request.GetMinLevel() <= request.GetMaxLevel() &&
-              request.GetMaxLevel() < geo::TileKey::LevelCount &&
-              request.GetMinLevel() < geo::TileKey::LevelCount);
-        unsigned int min_level =
-            (request_only_input_tiles
-                 ? static_cast<unsigned int>(geo::TileKey::LevelCount)
-                 : request.GetMinLevel());
-        unsigned int max_level =
-            (request_only_input_tiles
-                 ? static_cast<unsigned int>(geo::TileKey::LevelCount)
-                 : request.GetMaxLevel());
-
-        repository::PrefetchTilesRepository repository(
-            catalog_, layer_id_, settings_, lookup_client_,
-            request.GetBillingTag(), mutex_storage_);
-
-        auto sliced_tiles = repository.GetSlicedTiles(request.GetTileKeys(),
-                                                      min_level, max_level);
-
-        if (sliced_tiles.empty()) {
+        auto prefetch_response = CreateTilesPrefetch(request, version);
+        if (!prefetch_response.IsSuccessful()) {
           OLP_SDK_LOG_WARNING_F(kLogTag,
                                 "PrefetchTiles: tile/level mismatch, key=%s",
                                 key.c_str());
-          callback(
-              ApiError(ErrorCode::InvalidArgument, "TileKeys/levels mismatch"));
+          callback(prefetch_response.GetError());
           return;
         }
 
-        OLP_SDK_LOG_DEBUG_F(kLogTag, "PrefetchTiles, subquads=%zu, key=%s",
-                            sliced_tiles.size(), key.c_str());
-
-        const bool aggregation_enabled = request.GetDataAggregationEnabled();
+        auto prefetch = prefetch_response.MoveResult();
+
+        // The manifest lets a repeated or resumed prefetch skip the tiles
+        // that are already downloaded without checking the cache. They are
+        // removed before the download tasks are created, and reported as
+        // prefetched.
+        std::shared_ptr<repository::PrefetchManifestTracker> manifest;
+        auto skipped_tiles = std::make_shared<std::vector<geo::TileKey>>();
+        if (request.GetPrefetchManifestEnabled()) {
+          manifest = std::make_shared<repository::PrefetchManifestTracker>(
+              repository::PartitionsCacheRepository(
+                  catalog_, layer_id_, settings_.cache,
+                  settings_.default_cache_expiration),
+              version);
+
+          auto user_callback = std::move(callback);
+          callback = [=](PrefetchTilesResponse response) {
+            manifest->Store();
+            if (response.IsSuccessful() && !skipped_tiles->empty()) {
+              auto result = response.MoveResult();
+              for (const auto& tile : *skipped_tiles) {
+                result.push_back(std::make_shared<PrefetchTileResult>(
+                    tile, PrefetchTileNoError()));
+              }
+              response = PrefetchTilesResponse(std::move(result));
+            }
+            user_callback(std::move(response));
+          };
+        }
 
-        auto filter = [=](repository::SubQuadsResult tiles) mutable
+        auto filter = std::move(prefetch.filter);
+        auto filter_downloads = [=](repository::SubQuadsResult tiles)
             -> repository::SubQuadsResult {
-          if (request_only_input_tiles) {
-            return repository.FilterTilesByList(request, std::move(tiles));
-          } else {
-            return repository.FilterTilesByLevel(request, std::move(tiles));
+          tiles = filter(std::move(tiles));
+          if (manifest) {
+            *skipped_tiles = manifest->RemoveDownloaded(tiles);
           }
+          return tiles;
         };
 
-        auto query = [=](geo::TileKey root,
-                         client::CancellationContext inner_context) mutable {
-          auto response = repository.GetVersionedSubQuads(
-              root, kQuadTreeDepth, version, inner_context);
-
-          if (response.IsSuccessful() && aggregation_enabled) {
-            auto subquads = filter(response.GetResult());
-            auto network_stats = repository.LoadAggregatedSubQuads(
-                root, std::move(subquads), version, inner_context);
-
-            // append network statistics
-            network_stats += GetNetworkStatistics(response);
-            response = {response.GetResult(), network_stats};
-          }
-
-          return response;
-        };
-
-        auto& billing_tag = request.GetBillingTag();
-        auto download = [=](std::string data_handle,
-                            client::CancellationContext inner_context) mutable {
-          if (data_handle.empty()) {
-            return BlobApi::DataResponse(
-                ApiError(ErrorCode::NotFound, "Not found"));
-          }
-          repository::DataCacheRepository data_cache_repository(
-              catalog_, settings_.cache);
-          if (data_cache_repository.IsCached(layer_id_, data_handle)) {
-            return BlobApi::DataResponse(nullptr);
-          }
-
-          repository::DataRepository repository(catalog_, settings_,
-                                                lookup_client_, mutex_storage_);
-          // Fetch from online
-          return repository.GetVersionedData(
-              layer_id_,
-              DataRequest()
-                  .WithDataHandle(std::move(data_handle))
-                  .WithBillingTag(billing_tag),
-              version, std::move(inner_context), true);
-        };
-
-        std::vector<geo::TileKey> roots;
-        roots.reserve(sliced_tiles.size());
-
-        std::transform(
-            sliced_tiles.begin(), sliced_tiles.end(), std::back_inserter(roots),
-            [](const repository::RootTilesForRequest::value_type& root) {
-              return root.first;
-            });
+        auto query = std::move(prefetch.query);
+        if (manifest) {
+          auto query_tree = std::move(query);
+          query = [=](geo::TileKey root,
+                      client::CancellationContext inner_context) {
+            auto response = query_tree(root, std::move(inner_context));
+            if (response.IsSuccessful()) {
+              manifest->Load(root, response.GetResult());
+            }
+            return response;
+          };
+        }
 
-        auto append_result = [](ExtendedDataResponse response,
-                                geo::TileKey item,
-                                PrefetchTilesResult& prefetch_result) {
+        auto append_result = [=](ExtendedDataResponse response,
+                                 geo::TileKey item,
+                                 PrefetchTilesResult& prefetch_result) {
           if (response.IsSuccessful()) {
+            if (manifest) {
+              manifest->MarkDownloaded(item);
+            }
             prefetch_result.push_back(std::make_shared<PrefetchTileResult>(
                 item, PrefetchTileNoError()));
           } else {
@@ -476,12 +529,12 @@ client::CancellationToken VersionedLayerClientImpl::PrefetchTiles(
         };
 
         auto download_job = std::make_shared<PrefetchTilesHelper::DownloadJob>(
-            std::move(download), std::move(append_result), std::move(callback),
-            std::move(status_callback));
+            std::move(prefetch.download), std::move(append_result),
+            std::move(callback), std::move(status_callback));
 
         return PrefetchTilesHelper::Prefetch(
-            std::move(download_job), std::move(roots), std::move(query),
-            std::move(filter), task_sink_, request.GetPriority(),
+            std::move(download_job), prefetch.roots, std::move(query),
+            std::move(filter_downloads), task_sink_, request.GetPriority(),
             std::move(context));
       },
       request.GetPriority(), execution_context);
@@ -500,64 +553,245 @@ VersionedLayerClientImpl::PrefetchTiles(
                                                           promise);
 }
 
-CatalogVersionResponse VersionedLayerClientImpl::GetVersion(
-    boost::optional<std::string> billing_tag, const FetchOptions& fetch_options,
-    const client::CancellationContext& context) {
-  auto version = catalog_version_.load();
-  if (version != kInvalidVersion) {
-    model::VersionResponse response;
-    response.SetVersion(version);
-    return response;
+client::CancellationToken VersionedLayerClientImpl::PrefetchViewport(
+    PrefetchTilesRequest request, geo::TileKey focus,
+    PrefetchTilesResponseCallback callback) {
+  using client::ApiError;
+  using client::ErrorCode;
+
+  client::CancellationContext execution_context;
+
+  // The viewport of a later call replaces this one, even if its task runs
+  // first.
+  const auto sequence = viewport_prefetcher_->NextSequence();
+
+  return task_sink_.AddTask(
+      [=](client::CancellationContext context) mutable -> void {
+        if (context.IsCancelled()) {
+          callback(ApiError::Cancelled());
+          return;
+        }
+
+        const auto key = request.CreateKey(layer_id_);
+
+        if (request.GetTileKeys().empty() || !focus.IsValid()) {
+          OLP_SDK_LOG_WARNING_F(
+              kLogTag, "PrefetchViewport: invalid request, catalog=%s, key=%s",
+              catalog_.ToCatalogHRNString().c_str(), key.c_str());
+          callback(ApiError(ErrorCode::InvalidArgument,
+                            "Empty tile key list or invalid focus"));
+          return;
+        }
+
+        auto response =
+            GetVersion(request.GetBillingTag(), OnlineIfNotFound, context);
+
+        if (!response.IsSuccessful()) {
+          OLP_SDK_LOG_WARNING_F(
+              kLogTag,
+              "PrefetchViewport: getting catalog version failed, key=%s",
+              key.c_str());
+          callback(response.GetError());
+          return;
+        }
+
+        auto version = response.GetResult().GetVersion();
+
+        auto prefetch_response = CreateTilesPrefetch(request, version);
+        if (!prefetch_response.IsSuccessful()) {
+          OLP_SDK_LOG_WARNING_F(kLogTag,
+                                "PrefetchViewport: tile/level mismatch, key=%s",
+                                key.c_str());
+          callback(prefetch_response.GetError());
+          return;
+        }
+
+        auto prefetch = prefetch_response.MoveResult();
+
+        // The quad trees of the roots are reused while the scope is the same.
+        const auto scope = std::to_string(version) + ":" +
+                           std::to_string(prefetch.min_level) + ":" +
+                           std::to_string(prefetch.max_level) + ":" +
+                           std::to_string(request.GetDataAggregationEnabled());
+
+        context.ExecuteOrCancelled(
+            [&]() {
+              return viewport_prefetcher_->Update(
+                  sequence, scope, prefetch.roots, std::move(prefetch.query),
+                  std::move(prefetch.filter), std::move(prefetch.download),
+                  focus, request.GetPriority(), std::move(callback));
+            },
+            [&]() { callback(ApiError::Cancelled()); });
+      },
+      request.GetPriority(), execution_context);
+}
+
+client::CancellableFuture<PrefetchTilesResponse>
+VersionedLayerClientImpl::PrefetchViewport(PrefetchTilesRequest request,
+                                           geo::TileKey focus) {
+  auto promise = std::make_shared<std::promise<PrefetchTilesResponse>>();
+  auto cancel_token = PrefetchViewport(
+      std::move(request), focus, [promise](PrefetchTilesResponse response) {
+        promise->set_value(std::move(response));
+      });
+  return client::CancellableFuture<PrefetchTilesResponse>(cancel_token,
+                                                          promise);
+}
+
+Response<VersionedLayerClientImpl::TilesPrefetch>
+VersionedLayerClientImpl::CreateTilesPrefetch(
+    const PrefetchTilesRequest& request, int64_t version) {
+  using client::ApiError;
+  using client::ErrorCode;
+
+  // Calculate the minimal set of Tile keys and depth to
+  // cover tree.
+  const bool request_only_input_tiles =
+      !(request.GetMinLevel() <= request.GetMaxLevel() &&
+        request.GetMaxLevel() < geo::TileKey::LevelCount &&
+        request.GetMinLevel() < geo::TileKey::LevelCount);
+
+  TilesPrefetch prefetch;
+  prefetch.min_level =
+      (request_only_input_tiles
+           ? static_cast<unsigned int>(geo::TileKey::LevelCount)
+           : request.GetMinLevel());
+  prefetch.max_level =
+      (request_only_input_tiles
+           ? static_cast<unsigned int>(geo::TileKey::LevelCount)
+           : request.GetMaxLevel());
+
+  repository::PrefetchTilesRepository repository(
+      catalog_, layer_id_, settings_, lookup_client_, request.GetBillingTag(),
+      mutex_storage_);
+
+  auto sliced_tiles = repository.GetSlicedTiles(
+      request.GetTileKeys(), prefetch.min_level, prefetch.max_level);
+
+  if (sliced_tiles.empty()) {
+    return ApiError(ErrorCode::InvalidArgument, "TileKeys/levels mismatch");
   }
 
-  CatalogVersionRequest request;
-  request.WithBillingTag(std::move(billing_tag));
-  request.WithFetchOption(fetch_options);
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "CreateTilesPrefetch, subquads=%zu",
+                      sliced_tiles.size());
 
-  repository::CatalogRepository repository(catalog_, settings_, lookup_client_);
-  auto response = repository.GetLatestVersion(request, context);
+  prefetch.roots =
+      repository::PrefetchTilesRepository::GetQueryRoots(sliced_tiles);
+
+  auto filter = [=](repository::SubQuadsResult tiles) mutable
+      -> repository::SubQuadsResult {
+    if (request_only_input_tiles) {
+      return repository.FilterTilesByList(request, std::move(tiles));
+    } else {
+      return repository.FilterTilesByLevel(request, std::move(tiles));
+    }
+  };
+  prefetch.filter = filter;
+
+  const bool aggregation_enabled = request.GetDataAggregationEnabled();
+  prefetch.query = [=](geo::TileKey root,
+                       client::CancellationContext context) mutable {
+    // the quad tree of a parent tile could be shared by another request
+    boost::optional<std::uint32_t> required_depth;
+    auto depth_it = sliced_tiles.find(root);
+    if (depth_it != sliced_tiles.end()) {
+      required_depth = depth_it->second;
+    }
+
+    auto response = repository.GetVersionedSubQuads(
+        root, kQuadTreeDepth, version, context, required_depth);
+
+    if (response.IsSuccessful() && aggregation_enabled) {
+      auto subquads = filter(response.GetResult());
+      auto network_stats = repository.LoadAggregatedSubQuads(
+          root, std::move(subquads), version, context);
+
+      // append network statistics
+      network_stats += GetNetworkStatistics(response);
+      response = {response.GetResult(), network_stats};
+    }
 
-  if (!response.IsSuccessful()) {
     return response;
-  }
+  };
 
-  if (!catalog_version_.compare_exchange_weak(
-          version, response.GetResult().GetVersion())) {
-    model::VersionResponse version_response;
-    version_response.SetVersion(version);
-    return version_response;
-  }
+  const auto billing_tag = request.GetBillingTag();
+  // The tiles are downloaded asynchronously, so the number of concurrent
+  // downloads is not limited by the worker threads.
+  prefetch.download = [=](std::string data_handle,
+                          client::CancellationContext context,
+                          DownloadCallback callback) {
+    if (data_handle.empty()) {
+      callback(
+          BlobApi::DataResponse(ApiError(ErrorCode::NotFound, "Not found")));
+      return;
+    }
+    repository::DataCacheRepository data_cache_repository(catalog_,
+                                                          settings_.cache);
+    if (data_cache_repository.IsCached(layer_id_, data_handle)) {
+      callback(BlobApi::DataResponse(nullptr));
+      return;
+    }
 
-  return response;
+    repository::DataRepository repository(catalog_, settings_, lookup_client_,
+                                          mutex_storage_, &task_sink_);
+    // Fetch from online
+    repository.GetBlobDataAsync(layer_id_,
+                                DataRequest()
+                                    .WithDataHandle(std::move(data_handle))
+                                    .WithBillingTag(billing_tag),
+                                std::move(context), std::move(callback), true);
+  };
+
+  return prefetch;
+}
+
+CatalogVersionResponse VersionedLayerClientImpl::GetVersion(
+    boost::optional<std::string> billing_tag, const FetchOptions& fetch_options,
+    const client::CancellationContext& context) {
+  return snapshot_->GetVersion(std::move(billing_tag), fetch_options, context,
+                               &task_sink_);
 }
 
 client::CancellationToken VersionedLayerClientImpl::GetData(
     TileRequest request, DataResponseCallback callback) {
-  auto data_task = [=](client::CancellationContext context) -> DataResponse {
+  // The worker only resolves the version, the quad tree and the blob are
+  // requested without holding it.
+  auto data_task = [=](client::CancellationContext context,
+                       DataResponseCallback data_callback) {
     if (request.GetFetchOption() == CacheWithUpdate) {
-      return {{client::ErrorCode::InvalidArgument,
-               "CacheWithUpdate option can not be used for versioned layer"}};
+      data_callback(
+          {{client::ErrorCode::InvalidArgument,
+            "CacheWithUpdate option can not be used for versioned layer"}});
+      return;
     }
 
     if (!request.GetTileKey().IsValid()) {
-      return {{client::ErrorCode::InvalidArgument, "Tile key is invalid"}};
+      data_callback(
+          {{client::ErrorCode::InvalidArgument, "Tile key is invalid"}});
+      return;
     }
 
     auto version_response =
         GetVersion(request.GetBillingTag(), request.GetFetchOption(), context);
     if (!version_response.IsSuccessful()) {
-      return version_response.GetError();
+      data_callback(version_response.GetError());
+      return;
     }
 
     repository::DataRepository repository(catalog_, settings_, lookup_client_,
-                                          mutex_storage_);
-    return repository.GetVersionedTile(
+                                          mutex_storage_, &task_sink_);
+    repository.GetVersionedTileAsync(
         layer_id_, request, version_response.GetResult().GetVersion(),
-        std::move(context));
+        std::move(context), [data_callback](BlobApi::DataResponse response) {
+          data_callback(std::move(response));
+        });
   };
 
-  return task_sink_.AddTask(std::move(data_task), std::move(callback),
-                            request.GetPriority());
+  return task_sink_
+      .AddAsyncTaskChecked<DataResponse>(std::move(data_task),
+                                         std::move(callback),
+                                         request.GetPriority())
+      .value_or(client::CancellationToken());
 }
 
 client::CancellableFuture<DataResponse> VersionedLayerClientImpl::GetData(
@@ -576,7 +810,7 @@ bool VersionedLayerClientImpl::RemoveFromCache(
   repository::PartitionsCacheRepository partitions_cache_repository(
       catalog_, layer_id_, settings_.cache);
   boost::optional<model::Partition> partition;
-  auto version = catalog_version_.load();
+  auto version = snapshot_->GetResolvedVersion();
   if (version == kInvalidVersion) {
     OLP_SDK_LOG_WARNING(
         kLogTag, "Method RemoveFromCache failed, version is not initialized");
@@ -602,7 +836,7 @@ bool VersionedLayerClientImpl::RemoveFromCache(const geo::TileKey& tile) {
   read::QuadTreeIndex cached_tree;
   repository::PartitionsCacheRepository partitions_cache_repository(
       catalog_, layer_id_, settings_.cache);
-  auto version = catalog_version_.load();
+  auto version = snapshot_->GetResolvedVersion();
   if (version == kInvalidVersion) {
     OLP_SDK_LOG_WARNING(
         kLogTag, "Method RemoveFromCache failed, version is not initialized");
@@ -634,7 +868,7 @@ bool VersionedLayerClientImpl::RemoveFromCache(const geo::TileKey& tile) {
 }
 
 bool VersionedLayerClientImpl::IsCached(const std::string& partition_id) {
-  auto version = catalog_version_.load();
+  auto version = snapshot_->GetResolvedVersion();
   if (version == kInvalidVersion) {
     OLP_SDK_LOG_WARNING(kLogTag,
                         "Method IsCached failed, version is not initialized");
@@ -656,7 +890,7 @@ bool VersionedLayerClientImpl::IsCached(const std::string& partition_id) {
 
 bool VersionedLayerClientImpl::IsCached(const geo::TileKey& tile,
                                         bool aggregated) {
-  auto version = catalog_version_.load();
+  auto version = snapshot_->GetResolvedVersion();
   if (version == kInvalidVersion) {
     OLP_SDK_LOG_WARNING(kLogTag,
                         "Method IsCached failed, version is not initialized");
@@ -704,7 +938,8 @@ client::CancellationToken VersionedLayerClientImpl::GetAggregatedData(
 
     auto version = version_response.GetResult().GetVersion();
     repository::PartitionsRepository repository(catalog_, layer_id_, settings_,
-                                                lookup_client_, mutex_storage_);
+                                                lookup_client_, mutex_storage_,
+                                                &task_sink_);
     auto partition_response =
         repository.GetAggregatedTile(std::move(request), version, context);
     if (!partition_response.IsSuccessful()) {
@@ -721,7 +956,8 @@ client::CancellationToken VersionedLayerClientImpl::GetAggregatedData(
                             .WithBillingTag(billing_tag);
 
     repository::DataRepository data_repository(catalog_, settings_,
-                                               lookup_client_, mutex_storage_);
+                                               lookup_client_, mutex_storage_,
+                                               &task_sink_);
     auto data_response = data_repository.GetVersionedData(
         layer_id_, data_request, version, context);
 
@@ -760,7 +996,7 @@ bool VersionedLayerClientImpl::Protect(const TileKeys& tiles) {
   if (!settings_.cache) {
     return false;
   }
-  auto version = catalog_version_.load();
+  auto version = snapshot_->GetResolvedVersion();
   if (version == kInvalidVersion) {
     OLP_SDK_LOG_WARNING(kLogTag,
                         "Method Protect failed, version is not initialized");
@@ -782,7 +1018,7 @@ bool VersionedLayerClientImpl::Release(const TileKeys& tiles) {
   if (!settings_.cache) {
     return false;
   }
-  auto version = catalog_version_.load();
+  auto version = snapshot_->GetResolvedVersion();
   if (version == kInvalidVersion) {
     OLP_SDK_LOG_WARNING(kLogTag,
                         "Method Release failed, version is not initialized");
@@ -806,7 +1042,7 @@ bool VersionedLayerClientImpl::Protect(const std::string& partition_id) {
     return {};
   }
 
-  auto version = catalog_version_.load();
+  auto version = snapshot_->GetResolvedVersion();
   if (version == kInvalidVersion) {
     OLP_SDK_LOG_WARNING(kLogTag,
                         "Method Protect failed, version is not initialized");
@@ -824,7 +1060,7 @@ bool VersionedLayerClientImpl::Release(const std::string& partition_id) {
     return {};
   }
 
-  auto version = catalog_version_.load();
+  auto version = snapshot_->GetResolvedVersion();
   if (version == kInvalidVersion) {
     OLP_SDK_LOG_WARNING(kLogTag,
                         "Method Release failed, version is not initialized");
@@ -837,6 +1073,56 @@ bool VersionedLayerClientImpl::Release(const std::string& partition_id) {
   return repository.Release(partition_id, version);
 }
 
+client::CancellationToken VersionedLayerClientImpl::UpgradeToVersion(
+    int64_t version, UpgradeToVersionResponseCallback callback) {
+  auto upgrade_task =
+      [=](client::CancellationContext context) -> UpgradeToVersionResponse {
+    auto version_response = GetVersion(boost::none, OnlineIfNotFound, context);
+    if (!version_response.IsSuccessful()) {
+      return version_response.GetError();
+    }
+
+    // The snapshot might have been moved by a client of another layer, the
+    // cached metadata of this layer still belongs to its last upgrade.
+    const auto current_version = snapshot_->GetLayerUpgradeVersion(layer_id_);
+
+    // The layer versions are shared by the clients of the snapshot.
+    boost::optional<model::LayerVersions> layer_versions;
+    if (version > current_version) {
+      auto layer_versions_response = snapshot_->GetLayerVersions(
+          version, boost::none, context, &task_sink_);
+      if (!layer_versions_response.IsSuccessful()) {
+        return layer_versions_response.GetError();
+      }
+      layer_versions = layer_versions_response.MoveResult();
+    }
+
+    repository::PartitionsRepository repository(catalog_, layer_id_, settings_,
+                                                lookup_client_, mutex_storage_,
+                                                &task_sink_);
+    auto response = repository.UpgradeToVersion(
+        current_version, version, boost::none, context, layer_versions);
+    if (response.IsSuccessful()) {
+      snapshot_->SetLayerUpgradeVersion(layer_id_, version);
+    }
+    return response;
+  };
+
+  return task_sink_.AddTask(std::move(upgrade_task), std::move(callback),
+                            thread::NORMAL);
+}
+
+client::CancellableFuture<UpgradeToVersionResponse>
+VersionedLayerClientImpl::UpgradeToVersion(int64_t version) {
+  auto promise = std::make_shared<std::promise<UpgradeToVersionResponse>>();
+  auto cancel_token =
+      UpgradeToVersion(version, [promise](UpgradeToVersionResponse response) {
+        promise->set_value(std::move(response));
+      });
+  return client::CancellableFuture<UpgradeToVersionResponse>(
+      std::move(cancel_token), std::move(promise));
+}
+
 }  // namespace read
 }  // namespace dataservice
 }  // namespace olp
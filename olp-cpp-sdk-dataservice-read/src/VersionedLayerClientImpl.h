@@ -35,6 +35,7 @@
 #include <olp/dataservice/read/TileRequest.h>
 #include <olp/dataservice/read/Types.h>
 #include <boost/optional.hpp>
+#include "CatalogSnapshotImpl.h"
 #include "TaskSink.h"
 #include "repositories/NamedMutex.h"
 
@@ -49,12 +50,18 @@ class PartitionsRepository;
 class PrefetchTilesRepository;
 }  // namespace repository
 
+class ViewportPrefetcher;
+
 class VersionedLayerClientImpl {
  public:
   VersionedLayerClientImpl(client::HRN catalog, std::string layer_id,
                            boost::optional<int64_t> catalog_version,
                            client::OlpClientSettings settings);
 
+  VersionedLayerClientImpl(std::shared_ptr<CatalogSnapshotImpl> snapshot,
+                           std::string layer_id,
+                           client::OlpClientSettings settings);
+
   virtual ~VersionedLayerClientImpl() = default;
 
   virtual bool CancelPendingRequests();
@@ -76,6 +83,11 @@ class VersionedLayerClientImpl {
   virtual client::CancellableFuture<PartitionsResponse> GetPartitions(
       PartitionsRequest partitions_request);
 
+  virtual client::CancellationToken StreamLayerPartitions(
+      PartitionsRequest partitions_request,
+      PartitionsStreamCallback partition_stream_callback,
+      CallbackNoResult callback);
+
   virtual client::CancellationToken PrefetchTiles(
       PrefetchTilesRequest request, PrefetchTilesResponseCallback callback,
       PrefetchStatusCallback status_callback);
@@ -83,6 +95,13 @@ class VersionedLayerClientImpl {
   virtual client::CancellableFuture<PrefetchTilesResponse> PrefetchTiles(
       PrefetchTilesRequest request, PrefetchStatusCallback status_callback);
 
+  virtual client::CancellationToken PrefetchViewport(
+      PrefetchTilesRequest request, geo::TileKey focus,
+      PrefetchTilesResponseCallback callback);
+
+  virtual client::CancellableFuture<PrefetchTilesResponse> PrefetchViewport(
+      PrefetchTilesRequest request, geo::TileKey focus);
+
   virtual client::CancellationToken PrefetchPartitions(
       PrefetchPartitionsRequest request,
       PrefetchPartitionsResponseCallback callback,
@@ -114,7 +133,20 @@ class VersionedLayerClientImpl {
 
   virtual bool Release(const std::string& partition_id);
 
+  virtual client::CancellationToken UpgradeToVersion(
+      int64_t version, UpgradeToVersionResponseCallback callback);
+
+  virtual client::CancellableFuture<UpgradeToVersionResponse>
+  UpgradeToVersion(int64_t version);
+
  private:
+  struct TilesPrefetch;
+
+  // Resolves the levels and the quad tree roots of the request, and creates
+  // the functions shared by the tiles and the viewport prefetch.
+  Response<TilesPrefetch> CreateTilesPrefetch(
+      const PrefetchTilesRequest& request, int64_t version);
+
   CatalogVersionResponse GetVersion(boost::optional<std::string> billing_tag,
                                     const FetchOptions& fetch_options,
                                     const client::CancellationContext& context);
@@ -122,10 +154,11 @@ class VersionedLayerClientImpl {
   client::HRN catalog_;
   std::string layer_id_;
   client::OlpClientSettings settings_;
-  std::atomic<int64_t> catalog_version_;
+  std::shared_ptr<CatalogSnapshotImpl> snapshot_;
   client::ApiLookupClient lookup_client_;
   repository::NamedMutexStorage mutex_storage_;
   TaskSink task_sink_;
+  std::shared_ptr<ViewportPrefetcher> viewport_prefetcher_;
 };
 
 }  // namespace read
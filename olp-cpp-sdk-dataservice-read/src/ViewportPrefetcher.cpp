@@ -0,0 +1,505 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "ViewportPrefetcher.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <olp/core/logging/Log.h>
+#include <olp/dataservice/read/PrefetchTileResult.h>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+namespace {
+constexpr auto kLogTag = "ViewportPrefetcher";
+}  // namespace
+
+constexpr size_t ViewportPrefetcher::kDefaultMaxDownloadsInFlight;
+constexpr size_t ViewportPrefetcher::kMaxResolvedRoots;
+constexpr size_t ViewportPrefetcher::kMaxDownloadedTiles;
+
+ViewportPrefetcher::ViewportPrefetcher(TaskSink& task_sink,
+                                       size_t max_downloads_in_flight)
+    : task_sink_(task_sink),
+      max_downloads_in_flight_(std::max<size_t>(max_downloads_in_flight, 1u)) {
+}
+
+uint64_t ViewportPrefetcher::NextSequence() { return ++next_sequence_; }
+
+client::CancellationToken ViewportPrefetcher::Update(
+    uint64_t sequence, const std::string& scope,
+    const std::vector<geo::TileKey>& roots, QueryFunc query, FilterFunc filter,
+    AsyncDownloadFunc download, geo::TileKey focus, uint32_t priority,
+    PrefetchTilesResponseCallback callback) {
+  auto viewport = std::make_shared<Viewport>();
+  viewport->generation = sequence;
+  viewport->focus = focus;
+  viewport->priority = priority;
+  viewport->download = std::move(download);
+  viewport->callback = std::move(callback);
+
+  std::vector<geo::TileKey> missing_roots;
+  PrefetchTilesResponseCallback previous_callback;
+  client::CancellationContext previous_context;
+  std::vector<client::CancellationContext> dropped;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // The updates are submitted as separate tasks, so a newer viewport might
+    // have been applied already.
+    if (sequence <= generation_) {
+      // Completed like a replaced viewport.
+      previous_callback = std::move(viewport->callback);
+      viewport.reset();
+    } else {
+      generation_ = sequence;
+
+      // The downloads of another catalog version would complete the tiles
+      // of this one, so they are cancelled and forgotten.
+      if (scope != scope_) {
+        scope_ = scope;
+        resolved_.clear();
+        downloaded_.clear();
+        queue_.clear();
+        for (const auto& download : in_flight_) {
+          dropped.push_back(download.second.context);
+        }
+        in_flight_.clear();
+        scope_first_download_id_ = next_download_id_ + 1;
+      }
+
+      // The downloads of the previous viewport keep running until the tiles
+      // of this one are known, only its pending queries are cancelled.
+      if (current_) {
+        previous_callback = std::move(current_->callback);
+        current_->callback = nullptr;
+        previous_context = current_->context;
+      }
+      current_ = viewport;
+
+      std::copy_if(roots.begin(), roots.end(),
+                   std::back_inserter(missing_roots),
+                   [&](const geo::TileKey& root) {
+                     return resolved_.find(root) == resolved_.end();
+                   });
+    }
+  }
+
+  previous_context.CancelOperation();
+  for (auto& context : dropped) {
+    context.CancelOperation();
+  }
+  if (previous_callback) {
+    previous_callback(PrefetchTilesHelper::Canceled());
+  }
+
+  if (!viewport) {
+    OLP_SDK_LOG_DEBUG_F(kLogTag,
+                        "Update, dropped out of order, sequence=%" PRIu64,
+                        sequence);
+    return client::CancellationToken();
+  }
+
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Update, roots=%zu, queries=%zu", roots.size(),
+                      missing_roots.size());
+
+  const auto generation = viewport->generation;
+
+  if (missing_roots.empty()) {
+    Apply(viewport, roots, filter);
+  } else {
+    Resolve(viewport, roots, std::move(missing_roots), std::move(query),
+            std::move(filter));
+  }
+
+  std::weak_ptr<ViewportPrefetcher> weak_self = shared_from_this();
+  return client::CancellationToken([weak_self, generation]() {
+    if (auto self = weak_self.lock()) {
+      self->Cancel(generation);
+    }
+  });
+}
+
+void ViewportPrefetcher::Cancel() {
+  ViewportPtr viewport;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    viewport = current_;
+  }
+
+  if (viewport) {
+    Abort(viewport, PrefetchTilesHelper::Canceled());
+  }
+}
+
+size_t ViewportPrefetcher::GetPendingCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size() + in_flight_.size();
+}
+
+double ViewportPrefetcher::Distance(const geo::TileKey& tile,
+                                    const geo::TileKey& focus) {
+  auto center_x = [](const geo::TileKey& key) {
+    return std::ldexp(key.Column() + 0.5, -static_cast<int>(key.Level()));
+  };
+  auto center_y = [](const geo::TileKey& key) {
+    return std::ldexp(key.Row() + 0.5, -static_cast<int>(key.Level()));
+  };
+
+  const auto dx = center_x(tile) - center_x(focus);
+  const auto dy = center_y(tile) - center_y(focus);
+  return dx * dx + dy * dy;
+}
+
+void ViewportPrefetcher::Resolve(ViewportPtr viewport,
+                                 std::vector<geo::TileKey> roots,
+                                 std::vector<geo::TileKey> missing_roots,
+                                 QueryFunc query, FilterFunc filter) {
+  struct Resolution {
+    std::mutex mutex;
+    size_t count{0};
+    std::map<geo::TileKey, repository::SubQuadsResult> trees;
+    std::vector<client::ApiError> errors;
+  };
+
+  auto resolution = std::make_shared<Resolution>();
+  resolution->count = missing_roots.size();
+
+  auto self = shared_from_this();
+
+  auto complete = [=](geo::TileKey root,
+                      repository::SubQuadsResponse response) {
+    {
+      std::lock_guard<std::mutex> lock(resolution->mutex);
+      if (response.IsSuccessful()) {
+        resolution->trees.emplace(root, response.MoveResult());
+      } else {
+        resolution->errors.push_back(response.GetError());
+      }
+
+      if (--resolution->count) {
+        return;
+      }
+    }
+
+    if (!resolution->errors.empty()) {
+      self->Abort(viewport, resolution->errors.front());
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(self->mutex_);
+      if (self->current_ != viewport) {
+        return;
+      }
+
+      // The quad trees of the current viewport survive the trimming.
+      if (self->resolved_.size() + resolution->trees.size() >
+          kMaxResolvedRoots) {
+        std::map<geo::TileKey, repository::SubQuadsResult> kept;
+        for (const auto& root : roots) {
+          auto it = self->resolved_.find(root);
+          if (it != self->resolved_.end()) {
+            kept.emplace(root, std::move(it->second));
+          }
+        }
+        self->resolved_.swap(kept);
+      }
+
+      for (auto& tree : resolution->trees) {
+        self->resolved_[tree.first] = std::move(tree.second);
+      }
+    }
+
+    self->Apply(viewport, roots, filter);
+  };
+
+  for (const auto& root : missing_roots) {
+    auto token = task_sink_.AddTaskChecked(
+        [=](client::CancellationContext context) {
+          return query(root, context);
+        },
+        [=](repository::SubQuadsResponse response) {
+          complete(root, std::move(response));
+        },
+        viewport->priority, viewport->context);
+    if (!token) {
+      complete(root, PrefetchTilesHelper::Canceled());
+    }
+  }
+}
+
+void ViewportPrefetcher::Apply(const ViewportPtr& viewport,
+                               const std::vector<geo::TileKey>& roots,
+                               const FilterFunc& filter) {
+  repository::SubQuadsResult tiles;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_ != viewport) {
+      return;
+    }
+
+    for (const auto& root : roots) {
+      auto it = resolved_.find(root);
+      if (it != resolved_.end()) {
+        tiles.insert(it->second.begin(), it->second.end());
+      }
+    }
+  }
+
+  if (filter) {
+    tiles = filter(std::move(tiles));
+  }
+
+  std::vector<client::CancellationContext> dropped;
+  std::function<void()> completion;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_ != viewport) {
+      return;
+    }
+
+    // The tiles which left the viewport are dropped in bulk.
+    for (const auto& download : in_flight_) {
+      if (tiles.find(download.first) == tiles.end()) {
+        dropped.push_back(download.second.context);
+      }
+    }
+
+    queue_.clear();
+
+    for (auto& tile : tiles) {
+      if (downloaded_.find(tile.first) != downloaded_.end()) {
+        viewport->result.push_back(std::make_shared<PrefetchTileResult>(
+            tile.first, PrefetchTileNoError()));
+        continue;
+      }
+
+      viewport->remaining.insert(tile.first);
+
+      // A download that was dropped by a previous viewport is queued again.
+      auto download_it = in_flight_.find(tile.first);
+      if (download_it == in_flight_.end() ||
+          download_it->second.context.IsCancelled()) {
+        queue_.emplace_back(tile.first, std::move(tile.second));
+      }
+    }
+
+    const auto& focus = viewport->focus;
+    std::sort(queue_.begin(), queue_.end(),
+              [&](const QueueItem& lhs, const QueueItem& rhs) {
+                return Distance(lhs.first, focus) > Distance(rhs.first, focus);
+              });
+
+    OLP_SDK_LOG_DEBUG_F(kLogTag, "Apply, tiles=%zu, queued=%zu, dropped=%zu",
+                        tiles.size(), queue_.size(), dropped.size());
+
+    completion = TakeCompletionIfDone(*viewport);
+  }
+
+  for (auto& context : dropped) {
+    context.CancelOperation();
+  }
+
+  if (completion) {
+    completion();
+  }
+
+  ScheduleDownloads();
+}
+
+void ViewportPrefetcher::Cancel(uint64_t generation) {
+  ViewportPtr viewport;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_ || current_->generation != generation) {
+      return;
+    }
+    viewport = current_;
+  }
+
+  Abort(viewport, PrefetchTilesHelper::Canceled());
+}
+
+void ViewportPrefetcher::Abort(const ViewportPtr& viewport,
+                               client::ApiError error) {
+  std::vector<client::CancellationContext> dropped;
+  PrefetchTilesResponseCallback callback;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_ != viewport) {
+      return;
+    }
+
+    callback = std::move(viewport->callback);
+    viewport->callback = nullptr;
+    viewport->remaining.clear();
+    queue_.clear();
+
+    dropped.push_back(viewport->context);
+    for (const auto& download : in_flight_) {
+      dropped.push_back(download.second.context);
+    }
+  }
+
+  for (auto& context : dropped) {
+    context.CancelOperation();
+  }
+
+  if (callback) {
+    callback(std::move(error));
+  }
+}
+
+void ViewportPrefetcher::ScheduleDownloads() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (scheduling_) {
+      // The thread which is already scheduling picks up the free slots.
+      return;
+    }
+    scheduling_ = true;
+  }
+
+  auto self = shared_from_this();
+
+  while (true) {
+    QueueItem item;
+    Download download;
+    AsyncDownloadFunc download_func;
+    uint32_t priority = 0;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!current_ || queue_.empty() ||
+          in_flight_.size() >= max_downloads_in_flight_) {
+        scheduling_ = false;
+        return;
+      }
+
+      item = std::move(queue_.back());
+      queue_.pop_back();
+      download.id = ++next_download_id_;
+      download_func = current_->download;
+      priority = current_->priority;
+      in_flight_[item.first] = download;
+    }
+
+    const auto tile = item.first;
+    const auto id = download.id;
+    const auto data_handle = std::move(item.second);
+
+    const bool added = static_cast<bool>(
+        task_sink_.AddAsyncTaskChecked<ExtendedDataResponse>(
+            [=](client::CancellationContext context,
+                DownloadCallback callback) {
+              download_func(data_handle, context, std::move(callback));
+            },
+            [=](ExtendedDataResponse response) {
+              self->CompleteDownload(tile, id, std::move(response));
+            },
+            priority, download.context));
+
+    if (!added) {
+      // The sink is closed, the remaining tiles are not downloaded.
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_flight_.erase(tile);
+        scheduling_ = false;
+      }
+      Cancel();
+      return;
+    }
+  }
+}
+
+void ViewportPrefetcher::CompleteDownload(const geo::TileKey& tile,
+                                          uint64_t id,
+                                          ExtendedDataResponse response) {
+  std::function<void()> completion;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // The download of a dropped tile could be replaced by a new one.
+    auto it = in_flight_.find(tile);
+    const bool replaced = it == in_flight_.end() || it->second.id != id;
+
+    // A dropped download fails with the Cancelled error, while its tile might
+    // be queued again by the current viewport.
+    bool dropped = false;
+    if (!replaced) {
+      dropped = it->second.context.IsCancelled();
+      in_flight_.erase(it);
+    }
+
+    // The tile of another scope is not downloaded in this one.
+    if (response.IsSuccessful() && id >= scope_first_download_id_) {
+      if (downloaded_.size() >= kMaxDownloadedTiles) {
+        downloaded_.clear();
+      }
+      downloaded_.insert(tile);
+    }
+
+    if (!replaced && !dropped && current_ &&
+        current_->remaining.erase(tile)) {
+      if (response.IsSuccessful()) {
+        current_->result.push_back(
+            std::make_shared<PrefetchTileResult>(tile, PrefetchTileNoError()));
+      } else {
+        current_->result.push_back(
+            std::make_shared<PrefetchTileResult>(tile, response.GetError()));
+      }
+      completion = TakeCompletionIfDone(*current_);
+    }
+  }
+
+  if (completion) {
+    completion();
+  }
+
+  ScheduleDownloads();
+}
+
+std::function<void()> ViewportPrefetcher::TakeCompletionIfDone(
+    Viewport& viewport) {
+  if (!viewport.remaining.empty() || !viewport.callback) {
+    return nullptr;
+  }
+
+  auto callback = std::move(viewport.callback);
+  viewport.callback = nullptr;
+  auto result = std::move(viewport.result);
+  viewport.result.clear();
+
+  return std::bind(
+      [](const PrefetchTilesResponseCallback& callback,
+         PrefetchTilesResult& result) { callback(std::move(result)); },
+      std::move(callback), std::move(result));
+}
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
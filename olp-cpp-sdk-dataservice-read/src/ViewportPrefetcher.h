@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <olp/core/client/CancellationContext.h>
+#include <olp/core/client/CancellationToken.h>
+#include <olp/core/geo/tiling/TileKey.h>
+#include <olp/dataservice/read/Types.h>
+#include "DownloadItemsJob.h"
+#include "PrefetchTilesHelper.h"
+#include "TaskSink.h"
+#include "repositories/PrefetchTilesRepository.h"
+
+namespace olp {
+namespace dataservice {
+namespace read {
+
+/**
+ * Prefetches the tiles of a viewport that moves over time.
+ *
+ * Every update replaces the viewport. The tiles that are no longer visible are
+ * dropped from the queue, and their downloads are cancelled, while the tiles
+ * that are still visible keep downloading. The queue is ordered by the
+ * distance to the focus tile, and only a small window of downloads is handed
+ * to the `TaskSink` at once, so the order follows the focus. The quad trees
+ * are kept in memory between the updates, so the overlapping viewports do not
+ * query them again.
+ */
+class ViewportPrefetcher
+    : public std::enable_shared_from_this<ViewportPrefetcher> {
+ public:
+  using QueryFunc = PrefetchTilesHelper::QueryFunc;
+  using FilterFunc = FilterItemsFunc<repository::SubQuadsResult>;
+
+  /// The default maximum number of downloads added to the `TaskSink` at once.
+  static constexpr size_t kDefaultMaxDownloadsInFlight = 32u;
+
+  /// The maximum number of quad trees kept in memory.
+  static constexpr size_t kMaxResolvedRoots = 256u;
+
+  /// The maximum number of downloaded tiles remembered.
+  static constexpr size_t kMaxDownloadedTiles = 65536u;
+
+  explicit ViewportPrefetcher(
+      TaskSink& task_sink,
+      size_t max_downloads_in_flight = kDefaultMaxDownloadsInFlight);
+
+  ViewportPrefetcher(const ViewportPrefetcher&) = delete;
+  ViewportPrefetcher& operator=(const ViewportPrefetcher&) = delete;
+
+  /**
+   * Takes the sequence number of the next update.
+   *
+   * The number is taken when the update is submitted, so the updates that
+   * run out of order are recognized.
+   */
+  uint64_t NextSequence();
+
+  /**
+   * Replaces the viewport.
+   *
+   * The callback of the previous viewport is invoked with the `Cancelled`
+   * error if it is still pending. An update which is older than the current
+   * viewport is dropped, and its callback is invoked with the `Cancelled`
+   * error.
+   *
+   * @param sequence The number taken by `NextSequence` on submit.
+   * @param scope Identifies the catalog version and the levels of the
+   * request. The quad trees and the downloaded tiles are forgotten, and the
+   * downloads in flight are cancelled, when it changes.
+   * @param roots The quad tree roots of the viewport.
+   * @param query Queries the quad tree of the root.
+   * @param filter Selects the tiles of the viewport from the quad trees.
+   * @param download Downloads the data of the tile.
+   * @param focus The tile that the user looks at.
+   * @param priority The priority of the tasks.
+   * @param callback Invoked when all tiles of the viewport are prefetched.
+   *
+   * @return A token that cancels the viewport while it is the current one.
+   */
+  client::CancellationToken Update(uint64_t sequence, const std::string& scope,
+                                   const std::vector<geo::TileKey>& roots,
+                                   QueryFunc query, FilterFunc filter,
+                                   AsyncDownloadFunc download,
+                                   geo::TileKey focus, uint32_t priority,
+                                   PrefetchTilesResponseCallback callback);
+
+  /// Cancels the current viewport and drops all queued tiles.
+  void Cancel();
+
+  /// Returns the number of tiles that are queued or downloading.
+  size_t GetPendingCount() const;
+
+  /**
+   * Returns the squared distance between the centers of the tiles, in the
+   * units of the level 0 tile, so the tiles of different levels compare.
+   */
+  static double Distance(const geo::TileKey& tile, const geo::TileKey& focus);
+
+ private:
+  struct Viewport {
+    uint64_t generation{0};
+    geo::TileKey focus;
+    uint32_t priority{0};
+    AsyncDownloadFunc download;
+    PrefetchTilesResponseCallback callback;
+    std::set<geo::TileKey> remaining;
+    PrefetchTilesResult result;
+    client::CancellationContext context;
+  };
+
+  struct Download {
+    client::CancellationContext context;
+    uint64_t id{0};
+  };
+
+  using ViewportPtr = std::shared_ptr<Viewport>;
+  using QueueItem = std::pair<geo::TileKey, std::string>;
+
+  void Resolve(ViewportPtr viewport, std::vector<geo::TileKey> roots,
+               std::vector<geo::TileKey> missing_roots, QueryFunc query,
+               FilterFunc filter);
+
+  void Apply(const ViewportPtr& viewport,
+             const std::vector<geo::TileKey>& roots, const FilterFunc& filter);
+
+  void Cancel(uint64_t generation);
+
+  // Drops all tiles and completes the viewport with the error.
+  void Abort(const ViewportPtr& viewport, client::ApiError error);
+
+  void ScheduleDownloads();
+
+  void CompleteDownload(const geo::TileKey& tile, uint64_t id,
+                        ExtendedDataResponse response);
+
+  // Returns the invocation of the callback when all tiles of the viewport
+  // are done. Must be called under the lock.
+  std::function<void()> TakeCompletionIfDone(Viewport& viewport);
+
+  TaskSink& task_sink_;
+  const size_t max_downloads_in_flight_;
+
+  mutable std::mutex mutex_;
+  std::string scope_;
+  std::map<geo::TileKey, repository::SubQuadsResult> resolved_;
+  std::set<geo::TileKey> downloaded_;
+  std::atomic<uint64_t> next_sequence_{0};
+  uint64_t generation_{0};
+  ViewportPtr current_;
+  // Ordered by the distance to the focus, the nearest tile is the last one.
+  std::vector<QueueItem> queue_;
+  std::map<geo::TileKey, Download> in_flight_;
+  uint64_t next_download_id_{0};
+  // The downloads with a lower id belong to a previous scope.
+  uint64_t scope_first_download_id_{0};
+  bool scheduling_{false};
+};
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
@@ -85,7 +85,8 @@ client::CancellationToken VolatileLayerClientImpl::GetPartitions(
                                      PartitionsResponseCallback callback) {
     auto data_task = [=](client::CancellationContext context) {
       repository::PartitionsRepository repository(
-          catalog_, layer_id_, settings_, lookup_client_, mutex_storage_);
+          catalog_, layer_id_, settings_, lookup_client_, mutex_storage_,
+          &task_sink_);
       return repository.GetVolatilePartitions(request, std::move(context));
     };
 
@@ -111,7 +112,7 @@ client::CancellationToken VolatileLayerClientImpl::GetData(
     DataRequest request, DataResponseCallback callback) {
   auto task = [=](client::CancellationContext context) {
     repository::DataRepository repository(catalog_, settings_, lookup_client_,
-                                          mutex_storage_);
+                                          mutex_storage_, &task_sink_);
     return repository.GetVolatileData(layer_id_, request, context);
   };
 
@@ -241,14 +242,17 @@ client::CancellationToken VolatileLayerClientImpl::PrefetchTiles(
             return BlobApi::DataResponse(
                 client::ApiError(client::ErrorCode::NotFound, "Not found"));
           }
+          // The stale data with validators stays in the cache, but needs
+          // to be revalidated.
           repository::DataCacheRepository data_cache_repository(
-              catalog_, settings_.cache);
+              catalog_, settings_.cache, settings_.default_cache_expiration);
           if (data_cache_repository.IsCached(layer_id_, data_handle)) {
             return BlobApi::DataResponse(nullptr);
           }
 
           repository::DataRepository repository(catalog_, settings_,
-                                                lookup_client_, mutex_storage_);
+                                                lookup_client_, mutex_storage_,
+                                                &task_sink_);
           // Fetch from online
           return repository.GetVolatileData(
               layer_id_,
@@ -258,14 +262,8 @@ client::CancellationToken VolatileLayerClientImpl::PrefetchTiles(
               std::move(inner_context), true);
         };
 
-        std::vector<geo::TileKey> roots;
-        roots.reserve(sliced_tiles.size());
-
-        std::transform(
-            sliced_tiles.begin(), sliced_tiles.end(), std::back_inserter(roots),
-            [](const repository::RootTilesForRequest::value_type& root) {
-              return root.first;
-            });
+        auto roots =
+            repository::PrefetchTilesRepository::GetQueryRoots(sliced_tiles);
 
         auto append_result = [](ExtendedDataResponse response,
                                 geo::TileKey item,
@@ -22,6 +22,7 @@
 #include <map>
 #include <memory>
 #include <sstream>
+#include <utility>
 
 #include <olp/core/client/HttpResponse.h>
 #include <olp/core/client/OlpClient.h>
@@ -32,26 +33,27 @@ namespace read {
 
 namespace client = olp::client;
 
-BlobApi::DataResponse BlobApi::GetBlob(
-    const client::OlpClient& client, const std::string& layer_id,
-    const std::string& data_handle, boost::optional<std::string> billing_tag,
-    boost::optional<std::string> range,
-    const client::CancellationContext& context) {
+namespace {
+std::multimap<std::string, std::string> GetBlobHeaders(
+    const boost::optional<std::string>& range) {
   std::multimap<std::string, std::string> header_params;
   header_params.emplace("Accept", "application/json");
   if (range) {
     header_params.emplace("Range", *range);
   }
+  return header_params;
+}
 
+std::multimap<std::string, std::string> GetBlobQuery(
+    const boost::optional<std::string>& billing_tag) {
   std::multimap<std::string, std::string> query_params;
   if (billing_tag) {
     query_params.emplace("billingTag", *billing_tag);
   }
+  return query_params;
+}
 
-  std::string metadata_uri = "/layers/" + layer_id + "/data/" + data_handle;
-  auto api_response = client.CallApi(metadata_uri, "GET", query_params,
-                                     header_params, {}, nullptr, "", context);
-
+BlobApi::DataResponse ParseBlobResponse(client::HttpResponse api_response) {
   if (api_response.status != http::HttpStatusCode::OK) {
     return {{api_response.status, api_response.response.str()},
             api_response.GetNetworkStatistics()};
@@ -61,6 +63,32 @@ BlobApi::DataResponse BlobApi::GetBlob(
   api_response.GetResponse(*result);
   return {result, api_response.GetNetworkStatistics()};
 }
+}  // namespace
+
+BlobApi::DataResponse BlobApi::GetBlob(
+    const client::OlpClient& client, const std::string& layer_id,
+    const std::string& data_handle, boost::optional<std::string> billing_tag,
+    boost::optional<std::string> range,
+    const client::CancellationContext& context) {
+  std::string metadata_uri = "/layers/" + layer_id + "/data/" + data_handle;
+  auto api_response =
+      client.CallApi(metadata_uri, "GET", GetBlobQuery(billing_tag),
+                     GetBlobHeaders(range), {}, nullptr, "", context);
+
+  return ParseBlobResponse(std::move(api_response));
+}
+
+client::CancellationToken BlobApi::GetBlob(
+    const client::OlpClient& client, const std::string& layer_id,
+    const std::string& data_handle, boost::optional<std::string> billing_tag,
+    boost::optional<std::string> range, DataResponseCallback callback) {
+  std::string metadata_uri = "/layers/" + layer_id + "/data/" + data_handle;
+  return client.CallApi(metadata_uri, "GET", GetBlobQuery(billing_tag),
+                        GetBlobHeaders(range), {}, nullptr, "",
+                        [callback](client::HttpResponse response) {
+                          callback(ParseBlobResponse(std::move(response)));
+                        });
+}
 }  // namespace read
 }  // namespace dataservice
 }  // namespace olp
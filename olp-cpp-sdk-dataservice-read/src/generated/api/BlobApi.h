@@ -19,10 +19,12 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 
 #include <olp/core/client/ApiError.h>
 #include <olp/core/client/ApiResponse.h>
+#include <olp/core/client/CancellationToken.h>
 #include <olp/core/client/HttpResponse.h>
 #include <boost/optional.hpp>
 #include "ExtendedApiResponse.h"
@@ -43,6 +45,7 @@ class BlobApi {
  public:
   using DataResponse = ExtendedApiResponse<model::Data, client::ApiError,
                                            client::NetworkStatistics>;
+  using DataResponseCallback = std::function<void(DataResponse)>;
 
   /**
    * @brief Retrieves a data blob for specified handle.
@@ -70,6 +73,23 @@ class BlobApi {
                               boost::optional<std::string> billing_tag,
                               boost::optional<std::string> range,
                               const client::CancellationContext& context);
+
+  /**
+   * @brief Retrieves a data blob for specified handle asynchronously.
+   * @param client Instance of OlpClient used to make REST request.
+   * @param layer_id Layer id.
+   * @param data_handle Indentifies a specific blob.
+   * @param billing_tag An optional free-form tag which is used for grouping
+   * billing records together.
+   * @param range An optional byte range to resume the download.
+   * @param callback The function callback used to receive the data response.
+   *
+   * @return The token used to cancel the request.
+   */
+  static client::CancellationToken GetBlob(
+      const client::OlpClient& client, const std::string& layer_id,
+      const std::string& data_handle, boost::optional<std::string> billing_tag,
+      boost::optional<std::string> range, DataResponseCallback callback);
 };
 
 }  // namespace read
@@ -54,6 +54,32 @@ ConfigApi::CatalogResponse ConfigApi::GetCatalog(
   return parser::parse_result<ConfigApi::CatalogResponse>(response.response);
 }
 
+client::HttpResponse ConfigApi::GetCatalogIfModified(
+    const client::OlpClient& client, const std::string& catalog_hrn,
+    boost::optional<std::string> billing_tag,
+    boost::optional<std::string> if_none_match,
+    boost::optional<std::string> if_modified_since,
+    client::CancellationContext context) {
+  std::multimap<std::string, std::string> header_params;
+  header_params.insert(std::make_pair("Accept", "application/json"));
+  if (if_none_match) {
+    header_params.insert(std::make_pair("If-None-Match", *if_none_match));
+  }
+  if (if_modified_since) {
+    header_params.insert(
+        std::make_pair("If-Modified-Since", *if_modified_since));
+  }
+  std::multimap<std::string, std::string> query_params;
+  if (billing_tag) {
+    query_params.insert(std::make_pair("billingTag", *billing_tag));
+  }
+  std::string catalog_uri = "/catalogs/" + catalog_hrn;
+
+  return client.CallApi(std::move(catalog_uri), "GET", std::move(query_params),
+                        std::move(header_params), {}, nullptr, std::string{},
+                        std::move(context));
+}
+
 }  // namespace read
 }  // namespace dataservice
 }  // namespace olp
@@ -31,7 +31,8 @@
 namespace olp {
 namespace client {
 class OlpClient;
-}
+class HttpResponse;
+}  // namespace client
 
 namespace dataservice {
 namespace read {
@@ -58,6 +59,30 @@ class ConfigApi {
                                     const std::string& catalog_hrn,
                                     boost::optional<std::string> billing_tag,
                                     client::CancellationContext context);
+
+  /**
+   * @brief Call to synchronously retrieve the configuration of a catalog
+   * if it is modified since the cached configuration was downloaded.
+   * @param client Instance of OlpClient used to make REST request.
+   * @param catalog_hrn Full catalog name.
+   * @param billing_tag An optional free-form tag which is used for grouping
+   * billing records together. If supplied, it must be between 4 - 16
+   * characters,
+   * contain only alpha/numeric ASCII characters  [A-Za-z0-9].
+   * @param if_none_match The ETag of the cached configuration.
+   * @param if_modified_since The Last-Modified date of the cached
+   * configuration.
+   * @param context A CancellationContext instance which can be used to cancel
+   * this method.
+   * @return The HTTP response, 304 (Not Modified) without a body if
+   * the cached configuration is valid.
+   */
+  static client::HttpResponse GetCatalogIfModified(
+      const client::OlpClient& client, const std::string& catalog_hrn,
+      boost::optional<std::string> billing_tag,
+      boost::optional<std::string> if_none_match,
+      boost::optional<std::string> if_modified_since,
+      client::CancellationContext context);
 };
 
 }  // namespace read
@@ -28,7 +28,7 @@
 
 // clang-format off
 #include "generated/parser/LayerVersionsParser.h"
-#include "generated/parser/PartitionsParser.h"
+#include "generated/parser/PartitionsSaxHandler.h"
 #include "generated/parser/VersionResponseParser.h"
 #include "generated/parser/VersionInfosParser.h"
 #include "JsonResultParser.h"
@@ -55,6 +55,53 @@ namespace olp {
 namespace dataservice {
 namespace read {
 
+namespace {
+std::multimap<std::string, std::string> GetPartitionsHeaders(
+    const boost::optional<std::string>& range) {
+  std::multimap<std::string, std::string> header_params;
+  header_params.emplace("Accept", "application/json");
+  if (range) {
+    header_params.emplace("Range", *range);
+  }
+  return header_params;
+}
+
+std::multimap<std::string, std::string> GetPartitionsQuery(
+    boost::optional<std::int64_t> version,
+    const std::vector<std::string>& additional_fields,
+    const boost::optional<std::string>& billing_tag) {
+  std::multimap<std::string, std::string> query_params;
+  if (!additional_fields.empty()) {
+    query_params.emplace("additionalFields",
+                         concatStringArray(additional_fields, ","));
+  }
+  if (billing_tag) {
+    query_params.emplace("billingTag", *billing_tag);
+  }
+  if (version) {
+    query_params.emplace("version", std::to_string(*version));
+  }
+  return query_params;
+}
+
+std::string GetPartitionsUri(const std::string& layer_id) {
+  return "/layers/" + layer_id + "/partitions";
+}
+
+client::HttpResponse CallGetPartitions(
+    const client::OlpClient& client, const std::string& layer_id,
+    boost::optional<std::int64_t> version,
+    const std::vector<std::string>& additional_fields,
+    boost::optional<std::string> range,
+    boost::optional<std::string> billing_tag,
+    const client::CancellationContext& context) {
+  return client.CallApi(
+      GetPartitionsUri(layer_id), "GET",
+      GetPartitionsQuery(version, additional_fields, billing_tag),
+      GetPartitionsHeaders(range), {}, nullptr, "", context);
+}
+}  // namespace
+
 MetadataApi::LayerVersionsResponse MetadataApi::GetLayerVersions(
     const client::OlpClient& client, std::int64_t version,
     boost::optional<std::string> billing_tag,
@@ -87,47 +134,70 @@ MetadataApi::PartitionsExtendedResponse MetadataApi::GetPartitions(
     boost::optional<std::string> range,
     boost::optional<std::string> billing_tag,
     const client::CancellationContext& context) {
-  std::multimap<std::string, std::string> header_params;
-  header_params.emplace("Accept", "application/json");
-  if (range) {
-    header_params.emplace("Range", *range);
-  }
+  auto http_response =
+      CallGetPartitions(client, layer_id, version, additional_fields,
+                        std::move(range), std::move(billing_tag), context);
 
-  std::multimap<std::string, std::string> query_params;
-  if (!additional_fields.empty()) {
-    query_params.emplace("additionalFields",
-                         concatStringArray(additional_fields, ","));
-  }
-  if (billing_tag) {
-    query_params.emplace("billingTag", *billing_tag);
+  if (http_response.status != olp::http::HttpStatusCode::OK) {
+    return {{http_response.status, http_response.response.str()},
+            http_response.GetNetworkStatistics()};
   }
-  if (version) {
-    query_params.emplace("version", std::to_string(*version));
+
+  model::Partitions partitions;
+  if (!parser::ParsePartitions(http_response.response, partitions)) {
+    return {{client::ErrorCode::Unknown, "Fail parsing response."},
+            http_response.GetNetworkStatistics()};
   }
 
-  std::string metadataUri = "/layers/" + layer_id + "/partitions";
+  return {std::move(partitions), http_response.GetNetworkStatistics()};
+}
 
-  auto http_response = client.CallApi(metadataUri, "GET", query_params,
-                                      header_params, {}, nullptr, "", context);
+client::HttpResponse MetadataApi::GetPartitionsRange(
+    const client::OlpClient& client, const std::string& layer_id,
+    std::int64_t version, const std::vector<std::string>& additional_fields,
+    const std::string& range, boost::optional<std::string> billing_tag,
+    const client::CancellationContext& context) {
+  return CallGetPartitions(client, layer_id, version, additional_fields, range,
+                           std::move(billing_tag), context);
+}
+
+client::CancellationToken MetadataApi::GetPartitionsRange(
+    const client::OlpClient& client, const std::string& layer_id,
+    std::int64_t version, const std::vector<std::string>& additional_fields,
+    const std::string& range, boost::optional<std::string> billing_tag,
+    HttpResponseCallback callback) {
+  return client.CallApi(
+      GetPartitionsUri(layer_id), "GET",
+      GetPartitionsQuery(version, additional_fields, billing_tag),
+      GetPartitionsHeaders(range), {}, nullptr, "", std::move(callback));
+}
+
+MetadataApi::PartitionsStreamResponse MetadataApi::GetPartitionsStream(
+    const client::OlpClient& client, const std::string& layer_id,
+    boost::optional<std::int64_t> version,
+    const std::vector<std::string>& additional_fields,
+    boost::optional<std::string> billing_tag,
+    const parser::PartitionCallback& callback,
+    const client::CancellationContext& context) {
+  auto http_response =
+      CallGetPartitions(client, layer_id, version, additional_fields,
+                        boost::none, std::move(billing_tag), context);
 
   if (http_response.status != olp::http::HttpStatusCode::OK) {
     return {{http_response.status, http_response.response.str()},
             http_response.GetNetworkStatistics()};
   }
 
-  using PartitionsResponse =
-      client::ApiResponse<model::Partitions, client::ApiError>;
-
-  auto partitions_response =
-      parser::parse_result<PartitionsResponse>(http_response.response);
-
-  if (!partitions_response.IsSuccessful()) {
-    return {{partitions_response.GetError()},
+  if (!parser::ParsePartitions(http_response.response, callback)) {
+    if (context.IsCancelled()) {
+      return {{client::ErrorCode::Cancelled, "Cancelled"},
+              http_response.GetNetworkStatistics()};
+    }
+    return {{client::ErrorCode::Unknown, "Fail parsing response."},
             http_response.GetNetworkStatistics()};
   }
 
-  return {partitions_response.MoveResult(),
-          http_response.GetNetworkStatistics()};
+  return {client::ApiNoResult{}, http_response.GetNetworkStatistics()};
 }
 
 MetadataApi::CatalogVersionResponse MetadataApi::GetLatestCatalogVersion(
@@ -19,13 +19,17 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 
 #include <olp/core/client/ApiError.h>
+#include <olp/core/client/ApiNoResult.h>
 #include <olp/core/client/ApiResponse.h>
+#include <olp/core/client/CancellationToken.h>
 #include <boost/optional.hpp>
 #include "ExtendedApiResponse.h"
+#include "generated/parser/PartitionsSaxHandler.h"
 #include "generated/model/LayerVersions.h"
 #include "olp/dataservice/read/model/Partitions.h"
 #include "olp/dataservice/read/model/VersionInfos.h"
@@ -35,6 +39,7 @@ namespace olp {
 namespace client {
 class OlpClient;
 class CancellationContext;
+class HttpResponse;
 }  // namespace client
 
 namespace dataservice {
@@ -57,6 +62,12 @@ class MetadataApi {
       ExtendedApiResponse<model::Partitions, client::ApiError,
                           client::NetworkStatistics>;
 
+  using PartitionsStreamResponse =
+      ExtendedApiResponse<client::ApiNoResult, client::ApiError,
+                          client::NetworkStatistics>;
+
+  using HttpResponseCallback = std::function<void(client::HttpResponse)>;
+
   /**
    * @brief Retrieves the latest metadata version for each layer of a specified
    * catalog metadata version.
@@ -105,6 +116,87 @@ class MetadataApi {
       boost::optional<std::string> billing_tag,
       const client::CancellationContext& context);
 
+  /**
+   * @brief Retrieves a byte range of the metadata for all partitions in
+   * a specified layer.
+   *
+   * The response is not parsed, so the ranges can be downloaded in parallel
+   * and joined later.
+   *
+   * @param client Instance of OlpClient used to make REST request.
+   * @param layer_id Layer id.
+   * @param version The version of a versioned layer.
+   * @param additional_fields Additional fields - dataSize, checksum,
+   * compressedDataSize.
+   * @param range The single byte range, for example, bytes=0-1023.
+   * @param billing_tag An optional free-form tag which is used for grouping
+   * billing records together. If supplied, it must be between 4 - 16
+   * characters, contain only alpha/numeric ASCII characters  [A-Za-z0-9].
+   * @param context A CancellationContext, which can be used to cancel request.
+   *
+   * @return The HTTP response, 206 (Partial Content) if the range is served.
+   */
+  static client::HttpResponse GetPartitionsRange(
+      const client::OlpClient& client, const std::string& layer_id,
+      std::int64_t version, const std::vector<std::string>& additional_fields,
+      const std::string& range, boost::optional<std::string> billing_tag,
+      const client::CancellationContext& context);
+
+  /**
+   * @brief Asynchronously retrieves a byte range of the metadata for all
+   * partitions in a specified layer.
+   *
+   * @param client Instance of OlpClient used to make REST request.
+   * @param layer_id Layer id.
+   * @param version The version of a versioned layer.
+   * @param additional_fields Additional fields - dataSize, checksum,
+   * compressedDataSize.
+   * @param range The single byte range, for example, bytes=0-1023.
+   * @param billing_tag An optional free-form tag which is used for grouping
+   * billing records together. If supplied, it must be between 4 - 16
+   * characters, contain only alpha/numeric ASCII characters  [A-Za-z0-9].
+   * @param callback The function callback used to receive the HTTP response,
+   * 206 (Partial Content) if the range is served.
+   *
+   * @return The token used to cancel the request.
+   */
+  static client::CancellationToken GetPartitionsRange(
+      const client::OlpClient& client, const std::string& layer_id,
+      std::int64_t version, const std::vector<std::string>& additional_fields,
+      const std::string& range, boost::optional<std::string> billing_tag,
+      HttpResponseCallback callback);
+
+  /**
+   * @brief Retrieves metadata for all partitions in a specified layer and
+   * passes the partitions to the callback while the response is parsed.
+   *
+   * Unlike `GetPartitions`, the parsed document and the list of partitions
+   * are not kept in memory.
+   *
+   * @param client Instance of OlpClient used to make REST request.
+   * @param layer_id Layer id.
+   * @param version Specify the version for a versioned layer. Doesn't apply for
+   * other layer types.
+   * @param additional_fields Additional fields - dataSize, checksum,
+   * compressedDataSize.
+   * @param billing_tag An optional free-form tag which is used for grouping
+   * billing records together. If supplied, it must be between 4 - 16
+   * characters, contain only alpha/numeric ASCII characters  [A-Za-z0-9].
+   * @param callback Receives the partitions one by one, returns false to stop
+   * the parsing.
+   * @param context A CancellationContext, which can be used to cancel request.
+   *
+   * @return The result of this operation as an extended client::ApiResponse
+   * object without a result.
+   */
+  static PartitionsStreamResponse GetPartitionsStream(
+      const client::OlpClient& client, const std::string& layer_id,
+      boost::optional<int64_t> version,
+      const std::vector<std::string>& additional_fields,
+      boost::optional<std::string> billing_tag,
+      const parser::PartitionCallback& callback,
+      const client::CancellationContext& context);
+
   /**
    * @brief Retrieves the latest metadata version for the catalog.
    * @param client Instance of OlpClient used to make REST request.
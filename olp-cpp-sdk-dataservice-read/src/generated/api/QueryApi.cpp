@@ -22,13 +22,14 @@
 #include <algorithm>
 #include <map>
 #include <sstream>
+#include <utility>
 
 #include <olp/core/client/HttpResponse.h>
 #include <olp/core/client/OlpClient.h>
 #include <olp/core/logging/Log.h>
 // clang-format off
 #include "generated/parser/IndexParser.h"
-#include "generated/parser/PartitionsParser.h"
+#include "generated/parser/PartitionsSaxHandler.h"
 #include "JsonResultParser.h"
 // clang-format on
 
@@ -53,22 +54,17 @@ std::string ConcatStringArray(const std::vector<std::string>& strings,
   return buffer.str();
 }
 
-}  // namespace
-
-namespace olp {
-namespace dataservice {
-namespace read {
+std::multimap<std::string, std::string> GetJsonHeaders() {
+  std::multimap<std::string, std::string> header_params;
+  header_params.emplace("Accept", "application/json");
+  return header_params;
+}
 
-QueryApi::PartitionsExtendedResponse QueryApi::GetPartitionsbyId(
-    const client::OlpClient& client, const std::string& layer_id,
+std::multimap<std::string, std::string> GetPartitionsbyIdQuery(
     const std::vector<std::string>& partitions,
-    boost::optional<int64_t> version,
+    const boost::optional<int64_t>& version,
     const std::vector<std::string>& additional_fields,
-    boost::optional<std::string> billing_tag,
-    client::CancellationContext context) {
-  std::multimap<std::string, std::string> header_params;
-  header_params.insert(std::make_pair("Accept", "application/json"));
-
+    const boost::optional<std::string>& billing_tag) {
   std::multimap<std::string, std::string> query_params;
   for (const auto& partition : partitions) {
     query_params.emplace("partition", partition);
@@ -83,13 +79,12 @@ QueryApi::PartitionsExtendedResponse QueryApi::GetPartitionsbyId(
   if (version) {
     query_params.insert(std::make_pair("version", std::to_string(*version)));
   }
+  return query_params;
+}
 
-  std::string metadata_uri = "/layers/" + layer_id + "/partitions";
-
-  client::HttpResponse http_response = client.CallApi(
-      metadata_uri, "GET", std::move(query_params), std::move(header_params),
-      {}, nullptr, std::string{}, std::move(context));
-
+olp::dataservice::read::QueryApi::PartitionsExtendedResponse
+ParsePartitionsbyIdResponse(const std::string& layer_id,
+                            olp::client::HttpResponse http_response) {
   OLP_SDK_LOG_TRACE_F(kLogTag, "GetPartitionsbyId, layer_id=%s, status=%d",
                       layer_id.c_str(), http_response.status);
 
@@ -97,30 +92,28 @@ QueryApi::PartitionsExtendedResponse QueryApi::GetPartitionsbyId(
     return {{http_response.status, http_response.response.str()},
             http_response.GetNetworkStatistics()};
   }
-  using PartitionsResponse =
-      client::ApiResponse<model::Partitions, client::ApiError>;
-
-  auto partitions_response =
-      parser::parse_result<PartitionsResponse>(http_response.response);
 
-  if (!partitions_response.IsSuccessful()) {
-    return {{partitions_response.GetError()},
+  olp::dataservice::read::model::Partitions partitions;
+  if (!olp::parser::ParsePartitions(http_response.response, partitions)) {
+    return {{olp::client::ErrorCode::Unknown, "Fail parsing response."},
             http_response.GetNetworkStatistics()};
   }
 
-  return {partitions_response.MoveResult(),
-          http_response.GetNetworkStatistics()};
+  return {std::move(partitions), http_response.GetNetworkStatistics()};
 }
 
-olp::client::HttpResponse QueryApi::QuadTreeIndex(
-    const client::OlpClient& client, const std::string& layer_id,
-    const std::string& quad_key, boost::optional<int64_t> version,
-    int32_t depth, boost::optional<std::vector<std::string>> additional_fields,
-    boost::optional<std::string> billing_tag,
-    client::CancellationContext context) {
-  std::multimap<std::string, std::string> header_params;
-  header_params.emplace("Accept", "application/json");
+std::string GetQuadTreeIndexUri(const std::string& layer_id,
+                                const std::string& quad_key,
+                                const boost::optional<int64_t>& version,
+                                int32_t depth) {
+  return "/layers/" + layer_id +
+         (version ? "/versions/" + std::to_string(version.get()) : "") +
+         "/quadkeys/" + quad_key + "/depths/" + std::to_string(depth);
+}
 
+std::multimap<std::string, std::string> GetQuadTreeIndexQuery(
+    const boost::optional<std::vector<std::string>>& additional_fields,
+    const boost::optional<std::string>& billing_tag) {
   std::multimap<std::string, std::string> query_params;
   if (additional_fields) {
     query_params.emplace("additionalFields",
@@ -129,15 +122,74 @@ olp::client::HttpResponse QueryApi::QuadTreeIndex(
   if (billing_tag) {
     query_params.emplace("billingTag", *billing_tag);
   }
+  return query_params;
+}
 
-  std::string metadata_uri =
-      "/layers/" + layer_id +
-      (version ? "/versions/" + std::to_string(version.get()) : "") +
-      "/quadkeys/" + quad_key + "/depths/" + std::to_string(depth);
+}  // namespace
 
-  return client.CallApi(metadata_uri, "GET", std::move(query_params),
-                        std::move(header_params), {}, nullptr, std::string{},
-                        std::move(context));
+namespace olp {
+namespace dataservice {
+namespace read {
+
+QueryApi::PartitionsExtendedResponse QueryApi::GetPartitionsbyId(
+    const client::OlpClient& client, const std::string& layer_id,
+    const std::vector<std::string>& partitions,
+    boost::optional<int64_t> version,
+    const std::vector<std::string>& additional_fields,
+    boost::optional<std::string> billing_tag,
+    client::CancellationContext context) {
+  std::string metadata_uri = "/layers/" + layer_id + "/partitions";
+
+  client::HttpResponse http_response = client.CallApi(
+      metadata_uri, "GET",
+      GetPartitionsbyIdQuery(partitions, version, additional_fields,
+                             billing_tag),
+      GetJsonHeaders(), {}, nullptr, std::string{}, std::move(context));
+
+  return ParsePartitionsbyIdResponse(layer_id, std::move(http_response));
+}
+
+client::CancellationToken QueryApi::GetPartitionsbyId(
+    const client::OlpClient& client, const std::string& layer_id,
+    const std::vector<std::string>& partitions,
+    boost::optional<int64_t> version,
+    const std::vector<std::string>& additional_fields,
+    boost::optional<std::string> billing_tag,
+    PartitionsExtendedCallback callback) {
+  std::string metadata_uri = "/layers/" + layer_id + "/partitions";
+
+  return client.CallApi(
+      metadata_uri, "GET",
+      GetPartitionsbyIdQuery(partitions, version, additional_fields,
+                             billing_tag),
+      GetJsonHeaders(), {}, nullptr, std::string{},
+      [layer_id, callback](client::HttpResponse http_response) {
+        callback(ParsePartitionsbyIdResponse(layer_id,
+                                             std::move(http_response)));
+      });
+}
+
+olp::client::HttpResponse QueryApi::QuadTreeIndex(
+    const client::OlpClient& client, const std::string& layer_id,
+    const std::string& quad_key, boost::optional<int64_t> version,
+    int32_t depth, boost::optional<std::vector<std::string>> additional_fields,
+    boost::optional<std::string> billing_tag,
+    client::CancellationContext context) {
+  return client.CallApi(
+      GetQuadTreeIndexUri(layer_id, quad_key, version, depth), "GET",
+      GetQuadTreeIndexQuery(additional_fields, billing_tag), GetJsonHeaders(),
+      {}, nullptr, std::string{}, std::move(context));
+}
+
+client::CancellationToken QueryApi::QuadTreeIndex(
+    const client::OlpClient& client, const std::string& layer_id,
+    const std::string& quad_key, boost::optional<int64_t> version,
+    int32_t depth, boost::optional<std::vector<std::string>> additional_fields,
+    boost::optional<std::string> billing_tag, HttpResponseCallback callback) {
+  return client.CallApi(
+      GetQuadTreeIndexUri(layer_id, quad_key, version, depth), "GET",
+      GetQuadTreeIndexQuery(additional_fields, billing_tag), GetJsonHeaders(),
+      {}, nullptr, std::string{}, std::move(callback));
 }
 
 QueryApi::QuadTreeIndexResponse QueryApi::QuadTreeIndexVolatile(
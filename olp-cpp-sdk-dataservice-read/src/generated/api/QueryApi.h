@@ -19,12 +19,14 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 
 #include <olp/core/client/ApiError.h>
 #include <olp/core/client/ApiResponse.h>
 #include <olp/core/client/CancellationContext.h>
+#include <olp/core/client/CancellationToken.h>
 #include <olp/core/client/HttpResponse.h>
 #include <boost/optional.hpp>
 #include "ExtendedApiResponse.h"
@@ -49,6 +51,9 @@ class QueryApi {
   using PartitionsExtendedResponse =
       ExtendedApiResponse<model::Partitions, client::ApiError,
                           client::NetworkStatistics>;
+  using PartitionsExtendedCallback =
+      std::function<void(PartitionsExtendedResponse)>;
+  using HttpResponseCallback = std::function<void(client::HttpResponse)>;
 
   /**
    * @brief Call to synchronously retrieve metadata for specified partitions in
@@ -80,6 +85,29 @@ class QueryApi {
       boost::optional<std::string> billing_tag,
       client::CancellationContext context);
 
+  /**
+   * @brief Call to asynchronously retrieve metadata for specified partitions
+   * in a specified layer.
+   * @param client Instance of OlpClient used to make REST request.
+   * @param layer_id Layer id.
+   * @param partition Partition ids to use for filtering.
+   * @param version Specify the version for a versioned layer.
+   * @param additional_fields Additional fields - dataSize, checksum,
+   * compressedDataSize.
+   * @param billing_tag An optional free-form tag which is used for grouping
+   * billing records together.
+   * @param callback A callback function to invoke with the partitions
+   * response.
+   * @return The token used to cancel the request.
+   */
+  static client::CancellationToken GetPartitionsbyId(
+      const client::OlpClient& client, const std::string& layer_id,
+      const std::vector<std::string>& partitions,
+      boost::optional<int64_t> version,
+      const std::vector<std::string>& additional_fields,
+      boost::optional<std::string> billing_tag,
+      PartitionsExtendedCallback callback);
+
   /**
    * @brief Gets index metadata
    * Gets metadata synchronously for the requested index. Only available for
@@ -117,6 +145,31 @@ class QueryApi {
       boost::optional<std::string> billing_tag,
       client::CancellationContext context);
 
+  /**
+   * @brief Gets index metadata asynchronously for the requested index. Only
+   * available for layers where the partitioning scheme is
+   * &#x60;heretile&#x60;.
+   *
+   * @param layer_id The ID of the layer specified in the request.
+   * @param quad_key The geometric area specified by an index in the request,
+   * represented as a HERE tile
+   * @param version The version of the catalog against
+   * which to run the query.
+   * @param depth The recursion depth of the response, at most 4.
+   * @param additional_fields Additional fields - &#x60;dataSize&#x60;,
+   * &#x60;checksum&#x60;, &#x60;compressedDataSize&#x60;
+   * @param billing_tag Billing Tag is an optional free-form tag used to
+   * group billing records together.
+   * @param callback The function callback used to receive the HttpResponse.
+   * @return The token used to cancel the request.
+   **/
+  static client::CancellationToken QuadTreeIndex(
+      const client::OlpClient& client, const std::string& layer_id,
+      const std::string& quad_key, boost::optional<int64_t> version,
+      int32_t depth,
+      boost::optional<std::vector<std::string>> additional_fields,
+      boost::optional<std::string> billing_tag, HttpResponseCallback callback);
+
   /**
    * @brief Gets index metadata
    * Gets metadata synchronously for the requested index. Only available for
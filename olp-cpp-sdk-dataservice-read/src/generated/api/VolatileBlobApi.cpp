@@ -57,6 +57,30 @@ VolatileBlobApi::DataResponse VolatileBlobApi::GetVolatileBlob(
   api_response.GetResponse(*result);
   return {result, api_response.GetNetworkStatistics()};
 }
+client::HttpResponse VolatileBlobApi::GetVolatileBlobIfModified(
+    const client::OlpClient& client, const std::string& layer_id,
+    const std::string& data_handle, boost::optional<std::string> billing_tag,
+    boost::optional<std::string> if_none_match,
+    boost::optional<std::string> if_modified_since,
+    const client::CancellationContext& context) {
+  std::multimap<std::string, std::string> header_params;
+  header_params.insert(std::make_pair("Accept", "application/json"));
+  if (if_none_match) {
+    header_params.insert(std::make_pair("If-None-Match", *if_none_match));
+  }
+  if (if_modified_since) {
+    header_params.insert(
+        std::make_pair("If-Modified-Since", *if_modified_since));
+  }
+  std::multimap<std::string, std::string> query_params;
+  if (billing_tag) {
+    query_params.insert(std::make_pair("billingTag", *billing_tag));
+  }
+
+  std::string metadata_uri = "/layers/" + layer_id + "/data/" + data_handle;
+  return client.CallApi(metadata_uri, "GET", query_params, header_params, {},
+                        nullptr, "", context);
+}
 }  // namespace read
 }  // namespace dataservice
 }  // namespace olp
@@ -32,6 +32,7 @@ namespace olp {
 namespace client {
 class OlpClient;
 class CancellationContext;
+class HttpResponse;
 }  // namespace client
 
 namespace dataservice {
@@ -60,6 +61,29 @@ class VolatileBlobApi {
       const client::OlpClient& client, const std::string& layer_id,
       const std::string& data_handle, boost::optional<std::string> billing_tag,
       const client::CancellationContext& context);
+
+  /**
+   * @brief Retrieves a volatile data blob for specified handle if it is
+   * modified since the cached blob was downloaded.
+   * @param client Instance of OlpClient used to make REST request.
+   * @param layer_id Layer id.
+   * @param data_handle Identifies a specific blob.
+   * @param billing_tag An optional free-form tag which is used for grouping
+   * billing records together. If supplied, it must be between 4 - 16
+   * characters, contain only alpha/numeric ASCII characters  [A-Za-z0-9].
+   * @param if_none_match The ETag of the cached blob.
+   * @param if_modified_since The Last-Modified date of the cached blob.
+   * @param context A CancellationContext, which can be used to cancel request.
+   *
+   * @return The HTTP response, 304 (Not Modified) without a body if the cached
+   * blob is valid.
+   */
+  static client::HttpResponse GetVolatileBlobIfModified(
+      const client::OlpClient& client, const std::string& layer_id,
+      const std::string& data_handle, boost::optional<std::string> billing_tag,
+      boost::optional<std::string> if_none_match,
+      boost::optional<std::string> if_modified_since,
+      const client::CancellationContext& context);
 };
 
 }  // namespace read
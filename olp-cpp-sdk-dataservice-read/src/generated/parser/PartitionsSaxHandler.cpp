@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "PartitionsSaxHandler.h"
+
+#include <cstring>
+#include <istream>
+#include <utility>
+#include <vector>
+
+#include <rapidjson/rapidjson.h>
+
+namespace olp {
+namespace parser {
+using namespace olp::dataservice::read;
+
+namespace {
+// The stream is read by chunks of this size.
+constexpr size_t kReadBufferSize = 16u * 1024u;
+
+// Reads the stream by chunks. The buffered `rapidjson::IStreamWrapper` is
+// not available in RapidJSON 1.1.0, the unbuffered one reads each character
+// separately.
+class BufferedReadStream {
+ public:
+  typedef char Ch;
+
+  explicit BufferedReadStream(std::istream& stream) : stream_(stream) {
+    Read();
+  }
+
+  Ch Peek() const { return current_ < end_ ? *current_ : '\0'; }
+
+  Ch Take() {
+    if (current_ >= end_) {
+      return '\0';
+    }
+    const Ch c = *current_++;
+    if (current_ == end_) {
+      Read();
+    }
+    return c;
+  }
+
+  size_t Tell() const { return consumed_ + (current_ - buffer_); }
+
+  // Only used by the in situ parsing.
+  Ch* PutBegin() {
+    RAPIDJSON_ASSERT(false);
+    return nullptr;
+  }
+  void Put(Ch) { RAPIDJSON_ASSERT(false); }
+  void Flush() { RAPIDJSON_ASSERT(false); }
+  size_t PutEnd(Ch*) {
+    RAPIDJSON_ASSERT(false);
+    return 0u;
+  }
+
+ private:
+  void Read() {
+    consumed_ += end_ - buffer_;
+    stream_.read(buffer_, sizeof(buffer_));
+    current_ = buffer_;
+    end_ = buffer_ + stream_.gcount();
+  }
+
+  std::istream& stream_;
+  Ch buffer_[kReadBufferSize];
+  const Ch* current_{buffer_};
+  const Ch* end_{buffer_};
+  size_t consumed_{0u};
+};
+
+// Reads consecutive memory segments as one stream without copying them.
+class SegmentedReadStream {
+ public:
+  typedef char Ch;
+  using Segment = std::pair<const Ch*, const Ch*>;
+
+  explicit SegmentedReadStream(std::vector<Segment> segments)
+      : segments_(std::move(segments)) {
+    Next();
+  }
+
+  Ch Peek() const { return current_ < end_ ? *current_ : '\0'; }
+
+  Ch Take() {
+    if (current_ >= end_) {
+      return '\0';
+    }
+    const Ch c = *current_++;
+    if (current_ == end_) {
+      Next();
+    }
+    return c;
+  }
+
+  size_t Tell() const { return consumed_ + (current_ - begin_); }
+
+  // Only used by the in situ parsing.
+  Ch* PutBegin() {
+    RAPIDJSON_ASSERT(false);
+    return nullptr;
+  }
+  void Put(Ch) { RAPIDJSON_ASSERT(false); }
+  void Flush() { RAPIDJSON_ASSERT(false); }
+  size_t PutEnd(Ch*) {
+    RAPIDJSON_ASSERT(false);
+    return 0u;
+  }
+
+ private:
+  // Moves to the next non-empty segment.
+  void Next() {
+    while (current_ == end_ && next_segment_ < segments_.size()) {
+      consumed_ += end_ - begin_;
+      begin_ = current_ = segments_[next_segment_].first;
+      end_ = segments_[next_segment_].second;
+      ++next_segment_;
+    }
+  }
+
+  const std::vector<Segment> segments_;
+  size_t next_segment_{0u};
+  const Ch* begin_{nullptr};
+  const Ch* current_{nullptr};
+  const Ch* end_{nullptr};
+  size_t consumed_{0u};
+};
+
+template <typename Stream>
+bool Parse(Stream& stream, const PartitionCallback& callback) {
+  PartitionsSaxHandler handler(callback);
+  rapidjson::Reader reader;
+  return !reader.Parse(stream, handler).IsError();
+}
+
+PartitionCallback AppendTo(model::Partitions& partitions) {
+  auto& partitions_list = partitions.GetMutablePartitions();
+  return [&](model::Partition partition) {
+    partitions_list.push_back(std::move(partition));
+    return true;
+  };
+}
+
+bool Equals(const char* str, rapidjson::SizeType length, const char* name) {
+  return std::strlen(name) == length && std::memcmp(str, name, length) == 0;
+}
+}  // namespace
+
+PartitionsSaxHandler::PartitionsSaxHandler(PartitionCallback callback)
+    : callback_(std::move(callback)) {}
+
+bool PartitionsSaxHandler::StartObject() {
+  if (in_partitions_ && depth_ == 2u) {
+    partition_ = model::Partition();
+    field_ = Field::kUnknown;
+  }
+  partitions_key_ = false;
+  ++depth_;
+  return true;
+}
+
+bool PartitionsSaxHandler::EndObject(rapidjson::SizeType) {
+  --depth_;
+  if (in_partitions_ && depth_ == 2u) {
+    return callback_(std::move(partition_));
+  }
+  return true;
+}
+
+bool PartitionsSaxHandler::StartArray() {
+  // The root must be an object.
+  if (depth_ == 0u) {
+    return false;
+  }
+  if (partitions_key_ && depth_ == 1u) {
+    in_partitions_ = true;
+  }
+  partitions_key_ = false;
+  ++depth_;
+  return true;
+}
+
+bool PartitionsSaxHandler::EndArray(rapidjson::SizeType) {
+  --depth_;
+  if (depth_ == 1u) {
+    in_partitions_ = false;
+  }
+  return true;
+}
+
+bool PartitionsSaxHandler::Key(const char* str, rapidjson::SizeType length,
+                               bool) {
+  if (depth_ == 1u) {
+    partitions_key_ = Equals(str, length, "partitions");
+    return true;
+  }
+
+  if (!IsPartitionField()) {
+    return true;
+  }
+
+  if (Equals(str, length, "partition")) {
+    field_ = Field::kPartition;
+  } else if (Equals(str, length, "dataHandle")) {
+    field_ = Field::kDataHandle;
+  } else if (Equals(str, length, "version")) {
+    field_ = Field::kVersion;
+  } else if (Equals(str, length, "dataSize")) {
+    field_ = Field::kDataSize;
+  } else if (Equals(str, length, "compressedDataSize")) {
+    field_ = Field::kCompressedDataSize;
+  } else if (Equals(str, length, "checksum")) {
+    field_ = Field::kChecksum;
+  } else if (Equals(str, length, "crc")) {
+    field_ = Field::kCrc;
+  } else {
+    field_ = Field::kUnknown;
+  }
+  return true;
+}
+
+bool PartitionsSaxHandler::String(const char* str, rapidjson::SizeType length,
+                                  bool) {
+  partitions_key_ = false;
+  if (!IsPartitionField()) {
+    return true;
+  }
+
+  switch (field_) {
+    case Field::kPartition:
+      partition_.GetMutablePartition().assign(str, length);
+      break;
+    case Field::kDataHandle:
+      partition_.GetMutableDataHandle().assign(str, length);
+      break;
+    case Field::kChecksum:
+      partition_.SetChecksum(std::string(str, length));
+      break;
+    case Field::kCrc:
+      partition_.SetCrc(std::string(str, length));
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+bool PartitionsSaxHandler::Int(int value) { return SetNumber(value); }
+
+bool PartitionsSaxHandler::Uint(unsigned value) { return SetNumber(value); }
+
+bool PartitionsSaxHandler::Int64(int64_t value) { return SetNumber(value); }
+
+bool PartitionsSaxHandler::Uint64(uint64_t value) {
+  return SetNumber(static_cast<int64_t>(value));
+}
+
+bool PartitionsSaxHandler::Default() {
+  partitions_key_ = false;
+  return true;
+}
+
+bool PartitionsSaxHandler::SetNumber(int64_t value) {
+  partitions_key_ = false;
+  if (!IsPartitionField()) {
+    return true;
+  }
+
+  switch (field_) {
+    case Field::kVersion:
+      partition_.SetVersion(value);
+      break;
+    case Field::kDataSize:
+      partition_.SetDataSize(value);
+      break;
+    case Field::kCompressedDataSize:
+      partition_.SetCompressedDataSize(value);
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+bool ParsePartitions(std::stringstream& json_stream,
+                     const PartitionCallback& callback) {
+  BufferedReadStream stream(json_stream);
+  return Parse(stream, callback);
+}
+
+bool ParsePartitions(std::stringstream& json_stream,
+                     model::Partitions& partitions) {
+  return ParsePartitions(json_stream, AppendTo(partitions));
+}
+
+bool ParsePartitions(const std::string& json, model::Partitions& partitions) {
+  SegmentedReadStream stream({{json.data(), json.data() + json.size()}});
+  return Parse(stream, AppendTo(partitions));
+}
+
+bool ParsePartitionsList(const char* begin, const char* end,
+                         model::Partitions& partitions) {
+  static constexpr char kPrefix[] = "{\"partitions\":[";
+  static constexpr char kSuffix[] = "]}";
+  SegmentedReadStream stream({{kPrefix, kPrefix + sizeof(kPrefix) - 1u},
+                              {begin, end},
+                              {kSuffix, kSuffix + sizeof(kSuffix) - 1u}});
+  return Parse(stream, AppendTo(partitions));
+}
+
+}  // namespace parser
+}  // namespace olp
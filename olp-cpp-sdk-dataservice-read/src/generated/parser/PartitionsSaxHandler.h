@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <string>
+
+#include <rapidjson/reader.h>
+#include "olp/dataservice/read/model/Partitions.h"
+
+namespace olp {
+namespace parser {
+
+/**
+ * @brief Receives the partitions parsed from the JSON stream.
+ *
+ * Return false to stop the parsing.
+ */
+using PartitionCallback =
+    std::function<bool(olp::dataservice::read::model::Partition)>;
+
+/**
+ * @brief The SAX handler that emits the partitions of the partitions list
+ * one by one, without building the document.
+ *
+ * Expects the JSON object with the `partitions` array. Other members and
+ * unknown fields of the partitions are skipped.
+ */
+class PartitionsSaxHandler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
+                                          PartitionsSaxHandler> {
+ public:
+  explicit PartitionsSaxHandler(PartitionCallback callback);
+
+  bool StartObject();
+  bool EndObject(rapidjson::SizeType member_count);
+  bool StartArray();
+  bool EndArray(rapidjson::SizeType element_count);
+  bool Key(const char* str, rapidjson::SizeType length, bool copy);
+  bool String(const char* str, rapidjson::SizeType length, bool copy);
+  bool Int(int value);
+  bool Uint(unsigned value);
+  bool Int64(int64_t value);
+  bool Uint64(uint64_t value);
+  bool Default();
+
+ private:
+  enum class Field {
+    kUnknown,
+    kChecksum,
+    kCompressedDataSize,
+    kDataHandle,
+    kDataSize,
+    kCrc,
+    kPartition,
+    kVersion
+  };
+
+  // The partition fields are the members of the objects in the array.
+  bool IsPartitionField() const { return in_partitions_ && depth_ == 3u; }
+
+  bool SetNumber(int64_t value);
+
+  PartitionCallback callback_;
+  olp::dataservice::read::model::Partition partition_;
+  uint32_t depth_{0u};
+  Field field_{Field::kUnknown};
+  bool partitions_key_{false};
+  bool in_partitions_{false};
+};
+
+/**
+ * @brief Parses the partitions list and passes the partitions to the
+ * callback as soon as they are parsed.
+ *
+ * The memory used by the parser does not depend on the number of
+ * partitions. The callback can receive partitions before a parsing error
+ * is detected.
+ *
+ * @param json_stream The JSON stream.
+ * @param callback The callback that receives the partitions.
+ *
+ * @return True if the stream is parsed completely; false otherwise.
+ */
+bool ParsePartitions(std::stringstream& json_stream,
+                     const PartitionCallback& callback);
+
+/**
+ * @brief Parses the partitions list into the `Partitions` model.
+ *
+ * Faster and takes less memory than parsing the document.
+ *
+ * @param json_stream The JSON stream.
+ * @param partitions The partitions to append the parsed partitions to.
+ *
+ * @return True if the stream is parsed completely; false otherwise.
+ */
+bool ParsePartitions(std::stringstream& json_stream,
+                     olp::dataservice::read::model::Partitions& partitions);
+
+/**
+ * @brief Parses the partitions list held in memory without copying it.
+ *
+ * @param json The JSON string.
+ * @param partitions The partitions to append the parsed partitions to.
+ *
+ * @return True if the string is parsed completely; false otherwise.
+ */
+bool ParsePartitions(const std::string& json,
+                     olp::dataservice::read::model::Partitions& partitions);
+
+/**
+ * @brief Parses the comma-separated partition objects of a partitions list.
+ *
+ * The range is parsed as if it was wrapped into `{"partitions":[...]}`,
+ * without copying it.
+ *
+ * @param begin The beginning of the range.
+ * @param end The end of the range.
+ * @param partitions The partitions to append the parsed partitions to.
+ *
+ * @return True if the range is parsed completely; false otherwise.
+ */
+bool ParsePartitionsList(
+    const char* begin, const char* end,
+    olp::dataservice::read::model::Partitions& partitions);
+
+}  // namespace parser
+}  // namespace olp
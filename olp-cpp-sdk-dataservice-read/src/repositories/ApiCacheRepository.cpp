@@ -21,6 +21,7 @@
 
 #include <olp/core/cache/KeyValueCache.h>
 #include <olp/core/logging/Log.h>
+#include "CacheKeyBuilder.h"
 
 namespace {
 constexpr auto kLogTag = "ApiCacheRepository";
@@ -28,7 +29,13 @@ constexpr time_t kLookupApiExpiryTime = 3600;
 
 std::string CreateKey(const std::string& hrn, const std::string& service,
                       const std::string& serviceVersion) {
-  return hrn + "::" + service + "::" + serviceVersion + "::api";
+  return olp::dataservice::read::repository::CacheKeyBuilder(hrn)
+      .Add("::")
+      .Add(service)
+      .Add("::")
+      .Add(serviceVersion)
+      .Add("::api")
+      .Get();
 }
 }  // namespace
 
@@ -38,13 +45,12 @@ namespace read {
 namespace repository {
 ApiCacheRepository::ApiCacheRepository(
     const client::HRN& hrn, std::shared_ptr<cache::KeyValueCache> cache)
-    : hrn_(hrn), cache_(cache) {}
+    : catalog_(hrn.ToCatalogHRNString()), cache_(cache) {}
 
 void ApiCacheRepository::Put(const std::string& service,
                              const std::string& version,
                              const std::string& url) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn, service, version);
+  const auto& key = CreateKey(catalog_, service, version);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "Put -> '%s'", key.c_str());
 
   cache_->Put(key, url, [&]() { return url; }, kLookupApiExpiryTime);
@@ -52,8 +58,7 @@ void ApiCacheRepository::Put(const std::string& service,
 
 boost::optional<std::string> ApiCacheRepository::Get(
     const std::string& service, const std::string& version) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn, service, version);
+  const auto& key = CreateKey(catalog_, service, version);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "Get -> '%s'", key.c_str());
 
   auto url = cache_->Get(key, [](const std::string& value) { return value; });
@@ -47,7 +47,7 @@ class ApiCacheRepository final {
                                    const std::string& version);
 
  private:
-  client::HRN hrn_;
+  const std::string catalog_;
   std::shared_ptr<cache::KeyValueCache> cache_;
 };
 }  // namespace repository
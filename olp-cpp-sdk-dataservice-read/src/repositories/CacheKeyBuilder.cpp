@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+
+#include "CacheKeyBuilder.h"
+
+#include <cassert>
+#include <limits>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+namespace repository {
+
+namespace {
+// Enough for the longest key of the catalogs with typical names.
+constexpr size_t kInitialCapacity = 256u;
+
+std::string& GetThreadBuffer() {
+  static thread_local std::string buffer;
+  return buffer;
+}
+
+// Counts the builders created by the calling thread.
+std::uint64_t& GetThreadGeneration() {
+  static thread_local std::uint64_t generation = 0u;
+  return generation;
+}
+}  // namespace
+
+CacheKeyBuilder::CacheKeyBuilder(const std::string& prefix)
+    : key_(GetThreadBuffer()), generation_(++GetThreadGeneration()) {
+  if (key_.capacity() < kInitialCapacity) {
+    key_.reserve(kInitialCapacity);
+  }
+  key_.assign(prefix);
+}
+
+CacheKeyBuilder& CacheKeyBuilder::Add(const std::string& part) {
+  CheckCurrent();
+  key_.append(part);
+  return *this;
+}
+
+CacheKeyBuilder& CacheKeyBuilder::Add(const char* part) {
+  CheckCurrent();
+  key_.append(part);
+  return *this;
+}
+
+CacheKeyBuilder& CacheKeyBuilder::Add(std::int64_t value) {
+  // Formats the digits from the end of the buffer.
+  char digits[std::numeric_limits<std::uint64_t>::digits10 + 2];
+  char* const end = digits + sizeof(digits);
+  char* begin = end;
+
+  auto magnitude = value < 0 ? 0u - static_cast<std::uint64_t>(value)
+                             : static_cast<std::uint64_t>(value);
+  do {
+    *--begin = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+
+  if (value < 0) {
+    *--begin = '-';
+  }
+
+  CheckCurrent();
+  key_.append(begin, end);
+  return *this;
+}
+
+CacheKeyBuilder& CacheKeyBuilder::Add(const geo::TileKey& tile_key) {
+  char here_tile[geo::TileKey::HereTileMaxLength];
+  const char* end =
+      tile_key.ToHereTile(here_tile, here_tile + sizeof(here_tile));
+  CheckCurrent();
+  key_.append(here_tile, static_cast<size_t>(end - here_tile));
+  return *this;
+}
+
+CacheKeyBuilder& CacheKeyBuilder::AddVersion(
+    const boost::optional<std::int64_t>& version) {
+  if (version) {
+    Add(*version).Add("::");
+  }
+  return *this;
+}
+
+const std::string& CacheKeyBuilder::Get() const {
+  CheckCurrent();
+  return key_;
+}
+
+void CacheKeyBuilder::CheckCurrent() const {
+  // Another builder has reused the buffer of this one.
+  assert(generation_ == GetThreadGeneration());
+}
+
+}  // namespace repository
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
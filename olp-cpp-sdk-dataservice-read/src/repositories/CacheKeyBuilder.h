@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <olp/core/geo/tiling/TileKey.h>
+#include <boost/optional.hpp>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+namespace repository {
+
+/*
+ * @brief Builds a cache key in a buffer that is reused by the calling thread.
+ *
+ * The buffer keeps its capacity between the keys, so building a key does not
+ * allocate memory once the buffer is large enough. The key is valid until
+ * the next key is built on the same thread; copy it to keep it longer, or to
+ * hold two keys at once. Building a key with a builder after the next one is
+ * created is asserted in the debug builds.
+ */
+class CacheKeyBuilder final {
+ public:
+  /// Starts a new key with the prefix.
+  explicit CacheKeyBuilder(const std::string& prefix);
+
+  CacheKeyBuilder& Add(const std::string& part);
+  CacheKeyBuilder& Add(const char* part);
+  CacheKeyBuilder& Add(std::int64_t value);
+  CacheKeyBuilder& Add(const geo::TileKey& tile_key);
+
+  /// Adds the version followed by the separator if the version is set.
+  CacheKeyBuilder& AddVersion(const boost::optional<std::int64_t>& version);
+
+  /// Gets the key, which is valid until the next key is built on the thread.
+  const std::string& Get() const;
+
+ private:
+  void CheckCurrent() const;
+
+  std::string& key_;
+  const std::uint64_t generation_;
+};
+
+}  // namespace repository
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
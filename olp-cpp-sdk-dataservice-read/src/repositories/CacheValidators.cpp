@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "CacheValidators.h"
+
+#include <cstdlib>
+
+#include <olp/core/http/NetworkUtils.h>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+namespace repository {
+
+namespace {
+constexpr auto kETagHeader = "ETag";
+constexpr auto kLastModifiedHeader = "Last-Modified";
+// The header values can't contain line breaks.
+constexpr char kSeparator = '\n';
+}  // namespace
+
+CacheValidators CacheValidators::FromHeaders(const http::Headers& headers) {
+  CacheValidators validators;
+  for (const auto& header : headers) {
+    if (http::NetworkUtils::CaseInsensitiveCompare(header.first,
+                                                   kETagHeader)) {
+      validators.etag = header.second;
+    } else if (http::NetworkUtils::CaseInsensitiveCompare(
+                   header.first, kLastModifiedHeader)) {
+      validators.last_modified = header.second;
+    }
+  }
+  return validators;
+}
+
+boost::optional<CacheValidators> CacheValidators::Parse(
+    const cache::KeyValueCache::ValueType& value) {
+  // Stored as `fresh_until\netag\nlast_modified`.
+  const std::string text(value.begin(), value.end());
+  const auto first = text.find(kSeparator);
+  const auto second =
+      first == std::string::npos ? first : text.find(kSeparator, first + 1u);
+  if (second == std::string::npos) {
+    return boost::none;
+  }
+
+  char* end = nullptr;
+  const auto fresh_until = std::strtoll(text.c_str(), &end, 10);
+  if (end != text.c_str() + first) {
+    return boost::none;
+  }
+
+  CacheValidators validators;
+  validators.fresh_until = static_cast<time_t>(fresh_until);
+  validators.etag = text.substr(first + 1u, second - first - 1u);
+  validators.last_modified = text.substr(second + 1u);
+  return validators;
+}
+
+cache::KeyValueCache::ValueTypePtr CacheValidators::Serialize() const {
+  const auto text = std::to_string(fresh_until) + kSeparator + etag +
+                    kSeparator + last_modified;
+  return std::make_shared<cache::KeyValueCache::ValueType>(text.begin(),
+                                                           text.end());
+}
+
+boost::optional<std::string> CacheValidators::IfNoneMatch() const {
+  return etag.empty() ? boost::none : boost::make_optional(etag);
+}
+
+boost::optional<std::string> CacheValidators::IfModifiedSince() const {
+  return last_modified.empty() ? boost::none
+                               : boost::make_optional(last_modified);
+}
+
+void CacheValidators::Update(const CacheValidators& other) {
+  if (!other.etag.empty()) {
+    etag = other.etag;
+  }
+  if (!other.last_modified.empty()) {
+    last_modified = other.last_modified;
+  }
+}
+
+}  // namespace repository
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
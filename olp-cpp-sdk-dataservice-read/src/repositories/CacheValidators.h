@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <ctime>
+#include <string>
+
+#include <olp/core/cache/KeyValueCache.h>
+#include <olp/core/http/NetworkTypes.h>
+#include <boost/optional.hpp>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+namespace repository {
+
+/*
+ * @brief The validators of a cached response and the time until which
+ * the response is fresh.
+ *
+ * A stale response with validators is revalidated with a conditional
+ * request. If the server responds with 304 (Not Modified), the cached
+ * response is used again without downloading it.
+ */
+struct CacheValidators {
+  std::string etag;
+  std::string last_modified;
+  time_t fresh_until{0};
+
+  static CacheValidators FromHeaders(const http::Headers& headers);
+
+  static boost::optional<CacheValidators> Parse(
+      const cache::KeyValueCache::ValueType& value);
+
+  cache::KeyValueCache::ValueTypePtr Serialize() const;
+
+  bool IsEmpty() const { return etag.empty() && last_modified.empty(); }
+
+  bool IsFresh() const { return std::time(nullptr) < fresh_until; }
+
+  // The values of the If-None-Match and If-Modified-Since headers.
+  boost::optional<std::string> IfNoneMatch() const;
+  boost::optional<std::string> IfModifiedSince() const;
+
+  // Replaces the validators that are present in the 304 response.
+  void Update(const CacheValidators& other);
+};
+
+}  // namespace repository
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
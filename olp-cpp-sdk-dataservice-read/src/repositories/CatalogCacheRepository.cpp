@@ -19,10 +19,12 @@
 
 #include "CatalogCacheRepository.h"
 
+#include <ctime>
 #include <string>
 
 #include <olp/core/cache/KeyValueCache.h>
 #include <olp/core/logging/Log.h>
+#include "CacheKeyBuilder.h"
 
 // clang-format off
 #include "generated/parser/CatalogParser.h"
@@ -39,9 +41,20 @@ constexpr auto kLogTag = "CatalogCacheRepository";
 constexpr auto kChronoSecondsMax = std::chrono::seconds::max();
 constexpr auto kTimetMax = std::numeric_limits<time_t>::max();
 
-std::string CreateKey(const std::string& hrn) { return hrn + "::catalog"; }
+std::string CreateKey(const std::string& hrn) {
+  return olp::dataservice::read::repository::CacheKeyBuilder(hrn)
+      .Add("::catalog")
+      .Get();
+}
 std::string VersionKey(const std::string& hrn) {
-  return hrn + "::latestVersion";
+  return olp::dataservice::read::repository::CacheKeyBuilder(hrn)
+      .Add("::latestVersion")
+      .Get();
+}
+std::string ValidatorsKey(const std::string& hrn) {
+  return olp::dataservice::read::repository::CacheKeyBuilder(hrn)
+      .Add("::catalog::validators")
+      .Get();
 }
 
 time_t ConvertTime(std::chrono::seconds time) {
@@ -55,12 +68,20 @@ namespace read {
 namespace repository {
 CatalogCacheRepository::CatalogCacheRepository(
     const client::HRN& hrn, std::shared_ptr<cache::KeyValueCache> cache,
-    std::chrono::seconds default_expiry)
-    : hrn_(hrn), cache_(cache), default_expiry_(ConvertTime(default_expiry)) {}
+    std::chrono::seconds default_expiry, std::chrono::seconds max_staleness)
+    : catalog_(hrn.ToCatalogHRNString()),
+      cache_(cache),
+      default_expiry_(ConvertTime(default_expiry)),
+      max_staleness_(ConvertTime(max_staleness)) {}
 
 void CatalogCacheRepository::Put(const model::Catalog& catalog) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn);
+  if (IsRevalidationEnabled() && max_staleness_ > 0) {
+    // The freshness is stored as for the catalog without validators.
+    Put(catalog, CacheValidators());
+    return;
+  }
+
+  const auto& key = CreateKey(catalog_);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "Put -> '%s'", key.c_str());
 
   cache_->Put(key, catalog,
@@ -68,9 +89,94 @@ void CatalogCacheRepository::Put(const model::Catalog& catalog) {
               default_expiry_);
 }
 
+void CatalogCacheRepository::Put(const model::Catalog& catalog,
+                                 const CacheValidators& validators) {
+  if (!IsRevalidationEnabled()) {
+    Put(catalog);
+    return;
+  }
+
+  if (validators.IsEmpty() && max_staleness_ == 0) {
+    // The validators of the previous catalog don't apply anymore.
+    cache_->Remove(ValidatorsKey(catalog_));
+    Put(catalog);
+    return;
+  }
+
+  // The stale catalog with validators stays until it is evicted, without
+  // validators for the max staleness. The validators tell when it needs to
+  // be refreshed.
+  auto expiry = cache::KeyValueCache::kDefaultExpiry;
+  if (validators.IsEmpty() && max_staleness_ < kTimetMax - default_expiry_) {
+    expiry = default_expiry_ + max_staleness_;
+  }
+
+  const auto& key = CreateKey(catalog_);
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Put with validators -> '%s'", key.c_str());
+
+  cache_->Put(key, catalog,
+              [&]() { return olp::serializer::serialize(catalog); }, expiry);
+
+  auto fresh_validators = validators;
+  fresh_validators.fresh_until = std::time(nullptr) + default_expiry_;
+  cache_->Put(ValidatorsKey(catalog_), fresh_validators.Serialize(), expiry);
+}
+
 boost::optional<model::Catalog> CatalogCacheRepository::Get() {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn);
+  auto cached_catalog = GetCatalog();
+  if (!cached_catalog) {
+    return boost::none;
+  }
+
+  const auto validators = GetValidators();
+  if (validators && !validators->IsFresh()) {
+    return boost::none;
+  }
+
+  return cached_catalog;
+}
+
+boost::optional<model::Catalog> CatalogCacheRepository::GetStale() {
+  const auto validators = GetValidators();
+  if (!validators ||
+      std::time(nullptr) - validators->fresh_until >= max_staleness_) {
+    return boost::none;
+  }
+
+  return GetCatalog();
+}
+
+boost::optional<CacheValidators> CatalogCacheRepository::GetValidators() {
+  if (!IsRevalidationEnabled()) {
+    return boost::none;
+  }
+
+  auto value = cache_->Get(ValidatorsKey(catalog_));
+  if (!value) {
+    return boost::none;
+  }
+
+  return CacheValidators::Parse(*value);
+}
+
+boost::optional<model::Catalog> CatalogCacheRepository::Revalidate(
+    CacheValidators validators) {
+  auto cached_catalog = GetCatalog();
+  if (!cached_catalog) {
+    return boost::none;
+  }
+
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Revalidate -> '%s'", catalog_.c_str());
+
+  // Only the validators are written, the catalog is not modified.
+  validators.fresh_until = std::time(nullptr) + default_expiry_;
+  cache_->Put(ValidatorsKey(catalog_), validators.Serialize(),
+              cache::KeyValueCache::kDefaultExpiry);
+  return cached_catalog;
+}
+
+boost::optional<model::Catalog> CatalogCacheRepository::GetCatalog() {
+  const auto& key = CreateKey(catalog_);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "Get -> '%s'", key.c_str());
 
   auto cached_catalog = cache_->Get(key, [](const std::string& value) {
@@ -85,17 +191,15 @@ boost::optional<model::Catalog> CatalogCacheRepository::Get() {
 }
 
 void CatalogCacheRepository::PutVersion(const model::VersionResponse& version) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  OLP_SDK_LOG_DEBUG_F(kLogTag, "PutVersion -> '%s'", hrn.c_str());
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "PutVersion -> '%s'", catalog_.c_str());
 
-  cache_->Put(VersionKey(hrn), version,
+  cache_->Put(VersionKey(catalog_), version,
               [&]() { return olp::serializer::serialize(version); },
               default_expiry_);
 }
 
 boost::optional<model::VersionResponse> CatalogCacheRepository::GetVersion() {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = VersionKey(hrn);
+  const auto& key = VersionKey(catalog_);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "GetVersion -> '%s'", key.c_str());
 
   auto cached_version = cache_->Get(key, [](const std::string& value) {
@@ -108,11 +212,14 @@ boost::optional<model::VersionResponse> CatalogCacheRepository::GetVersion() {
   return boost::any_cast<model::VersionResponse>(cached_version);
 }
 
+bool CatalogCacheRepository::IsRevalidationEnabled() const {
+  return default_expiry_ != kTimetMax;
+}
+
 void CatalogCacheRepository::Clear() {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  OLP_SDK_LOG_INFO_F(kLogTag, "Clear -> '%s'", CreateKey(hrn).c_str());
+  OLP_SDK_LOG_INFO_F(kLogTag, "Clear -> '%s'", CreateKey(catalog_).c_str());
 
-  cache_->RemoveKeysWithPrefix(hrn);
+  cache_->RemoveKeysWithPrefix(catalog_);
 }
 
 }  // namespace repository
@@ -21,11 +21,13 @@
 
 #include <chrono>
 #include <memory>
+#include <string>
 
 #include <olp/core/client/HRN.h>
 #include <olp/dataservice/read/model/Catalog.h>
 #include <olp/dataservice/read/model/VersionResponse.h>
 #include <boost/optional.hpp>
+#include "CacheValidators.h"
 
 namespace olp {
 namespace cache {
@@ -39,14 +41,38 @@ class CatalogCacheRepository final {
  public:
   CatalogCacheRepository(
       const client::HRN& hrn, std::shared_ptr<cache::KeyValueCache> cache,
-      std::chrono::seconds default_expiry = std::chrono::seconds::max());
+      std::chrono::seconds default_expiry = std::chrono::seconds::max(),
+      std::chrono::seconds max_staleness = std::chrono::seconds::zero());
 
   ~CatalogCacheRepository() = default;
 
   void Put(const model::Catalog& catalog);
 
+  /*
+   * @brief Stores the catalog with the validators of the response.
+   *
+   * If the entries expire and the validators are not empty, the catalog is
+   * kept after it becomes stale, so it can be revalidated. Without
+   * validators, the stale catalog is kept for the max staleness.
+   */
+  void Put(const model::Catalog& catalog, const CacheValidators& validators);
+
   boost::optional<model::Catalog> Get();
 
+  /// Gets the catalog that is stale for less than the max staleness.
+  boost::optional<model::Catalog> GetStale();
+
+  /// Gets the validators of the catalog, also if the catalog is stale.
+  boost::optional<CacheValidators> GetValidators();
+
+  /*
+   * @brief Makes the stale catalog fresh after the server confirms that it is
+   * not modified.
+   *
+   * @return The cached catalog, or `boost::none` if it is evicted.
+   */
+  boost::optional<model::Catalog> Revalidate(CacheValidators validators);
+
   void PutVersion(const model::VersionResponse& version);
 
   boost::optional<model::VersionResponse> GetVersion();
@@ -54,9 +80,16 @@ class CatalogCacheRepository final {
   void Clear();
 
  private:
-  client::HRN hrn_;
+  boost::optional<model::Catalog> GetCatalog();
+
+  // The validators are stored only if the entries expire.
+  bool IsRevalidationEnabled() const;
+
+
+  const std::string catalog_;
   std::shared_ptr<cache::KeyValueCache> cache_;
   time_t default_expiry_;
+  time_t max_staleness_;
 };
 }  // namespace repository
 }  // namespace read
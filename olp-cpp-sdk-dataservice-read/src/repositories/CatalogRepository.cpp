@@ -24,14 +24,21 @@
 
 #include <olp/core/client/CancellationContext.h>
 #include <olp/core/client/Condition.h>
+#include <olp/core/client/HttpResponse.h>
 #include <olp/core/logging/Log.h>
 
 #include "CatalogCacheRepository.h"
+#include "PartitionsCacheRepository.h"
+#include "StaleEntryRefresher.h"
 #include "generated/api/ConfigApi.h"
 #include "generated/api/MetadataApi.h"
 #include "olp/dataservice/read/CatalogRequest.h"
 #include "olp/dataservice/read/CatalogVersionRequest.h"
 #include "olp/dataservice/read/VersionsRequest.h"
+// clang-format off
+#include "generated/parser/CatalogParser.h"
+#include "JsonResultParser.h"
+// clang-format on
 
 namespace {
 constexpr auto kLogTag = "CatalogRepository";
@@ -44,10 +51,12 @@ namespace repository {
 
 CatalogRepository::CatalogRepository(client::HRN catalog,
                                      client::OlpClientSettings settings,
-                                     client::ApiLookupClient client)
+                                     client::ApiLookupClient client,
+                                     TaskSink* task_sink)
     : catalog_(std::move(catalog)),
       settings_(std::move(settings)),
-      lookup_client_(std::move(client)) {}
+      lookup_client_(std::move(client)),
+      task_sink_(task_sink) {}
 
 CatalogResponse CatalogRepository::GetCatalog(
     const CatalogRequest& request, client::CancellationContext context) {
@@ -56,7 +65,8 @@ CatalogResponse CatalogRepository::GetCatalog(
   const auto catalog_str = catalog_.ToCatalogHRNString();
 
   repository::CatalogCacheRepository repository(
-      catalog_, settings_.cache, settings_.default_cache_expiration);
+      catalog_, settings_.cache, settings_.default_cache_expiration,
+      settings_.max_staleness);
 
   if (fetch_options != OnlineOnly && fetch_options != CacheWithUpdate) {
     auto cached = repository.Get();
@@ -66,6 +76,24 @@ CatalogResponse CatalogRepository::GetCatalog(
                           catalog_str.c_str(), request_key.c_str());
 
       return *cached;
+    }
+
+    cached = fetch_options == StaleWhileRevalidate ? repository.GetStale()
+                                                   : boost::none;
+    if (cached) {
+      OLP_SDK_LOG_DEBUG_F(kLogTag,
+                          "GetCatalog found stale in cache, hrn='%s', key='%s'",
+                          catalog_str.c_str(), request_key.c_str());
+
+      auto refresh_request = request;
+      refresh_request.WithFetchOption(OnlineIfNotFound);
+      auto self = *this;
+      StaleEntryRefresher::Instance().Refresh(
+          settings_, task_sink_, catalog_str + "::catalog",
+          [=](client::CancellationContext refresh_context) mutable {
+            self.GetCatalog(refresh_request, std::move(refresh_context));
+          });
+      return *cached;
     } else if (fetch_options == CacheOnly) {
       OLP_SDK_LOG_INFO_F(kLogTag,
                          "GetCatalog not found in cache, hrn='%s', key='%s'",
@@ -84,11 +112,46 @@ CatalogResponse CatalogRepository::GetCatalog(
   }
 
   const client::OlpClient& config_client = config_api.GetResult();
-  auto catalog_response = ConfigApi::GetCatalog(
-      config_client, catalog_str, request.GetBillingTag(), context);
+
+  // The stale catalog is revalidated instead of downloaded again.
+  boost::optional<CacheValidators> validators;
+  if (fetch_options != OnlineOnly) {
+    validators = repository.GetValidators();
+  }
+
+  auto http_response = ConfigApi::GetCatalogIfModified(
+      config_client, catalog_str, request.GetBillingTag(),
+      validators ? validators->IfNoneMatch() : boost::none,
+      validators ? validators->IfModifiedSince() : boost::none, context);
+
+  if (validators &&
+      http_response.GetStatus() == http::HttpStatusCode::NOT_MODIFIED) {
+    validators->Update(
+        CacheValidators::FromHeaders(http_response.GetHeaders()));
+    auto cached = repository.Revalidate(*validators);
+    if (cached) {
+      OLP_SDK_LOG_DEBUG_F(kLogTag,
+                          "GetCatalog not modified, hrn='%s', key='%s'",
+                          catalog_str.c_str(), request_key.c_str());
+      return *cached;
+    }
+
+    // The stale catalog is evicted after the request is sent.
+    http_response = ConfigApi::GetCatalogIfModified(
+        config_client, catalog_str, request.GetBillingTag(), boost::none,
+        boost::none, context);
+  }
+
+  CatalogResponse catalog_response =
+      http_response.GetStatus() == http::HttpStatusCode::OK
+          ? parser::parse_result<ConfigApi::CatalogResponse>(
+                http_response.response)
+          : client::ApiError(http_response.GetStatus(),
+                             http_response.response.str());
 
   if (catalog_response.IsSuccessful() && fetch_options != OnlineOnly) {
-    repository.Put(catalog_response.GetResult());
+    repository.Put(catalog_response.GetResult(),
+                   CacheValidators::FromHeaders(http_response.GetHeaders()));
   }
   if (!catalog_response.IsSuccessful()) {
     const auto& error = catalog_response.GetError();
@@ -107,9 +170,32 @@ CatalogResponse CatalogRepository::GetCatalog(
 CatalogVersionResponse CatalogRepository::GetLatestVersion(
     const CatalogVersionRequest& request, client::CancellationContext context) {
   repository::CatalogCacheRepository repository(
-      catalog_, settings_.cache, settings_.default_cache_expiration);
+      catalog_, settings_.cache, settings_.default_cache_expiration,
+      settings_.max_staleness);
 
   const auto fetch_option = request.GetFetchOption();
+
+  // The latest version can change any time, so the cached one is always
+  // returned and refreshed in the background.
+  if (fetch_option == StaleWhileRevalidate) {
+    auto cached_version = repository.GetVersion();
+    if (cached_version) {
+      OLP_SDK_LOG_DEBUG_F(
+          kLogTag, "Latest cached version, hrn='%s', version=%" PRId64,
+          catalog_.ToCatalogHRNString().c_str(), cached_version->GetVersion());
+
+      auto refresh_request = request;
+      refresh_request.WithFetchOption(OnlineIfNotFound);
+      auto self = *this;
+      StaleEntryRefresher::Instance().Refresh(
+          settings_, task_sink_,
+          catalog_.ToCatalogHRNString() + "::latestVersion",
+          [=](client::CancellationContext refresh_context) mutable {
+            self.GetLatestVersion(refresh_request, std::move(refresh_context));
+          });
+      return std::move(*cached_version);
+    }
+  }
   // in case if get version online was never called and version was not found in
   // cache
   CatalogVersionResponse version_response = {
@@ -160,6 +246,45 @@ CatalogVersionResponse CatalogRepository::GetLatestVersion(
   return version_response;
 }
 
+CatalogRepository::LayerVersionsResponse CatalogRepository::GetLayerVersions(
+    int64_t version, const boost::optional<std::string>& billing_tag,
+    FetchOptions fetch_options, client::CancellationContext context) {
+  // The layer versions do not depend on the layer.
+  repository::PartitionsCacheRepository repository(
+      catalog_, "", settings_.cache, settings_.default_cache_expiration);
+
+  if (fetch_options != OnlineOnly && fetch_options != CacheWithUpdate) {
+    auto cached = repository.Get(version);
+    if (cached) {
+      OLP_SDK_LOG_DEBUG_F(kLogTag,
+                          "GetLayerVersions found in cache, hrn='%s', "
+                          "version=%" PRId64,
+                          catalog_.ToCatalogHRNString().c_str(), version);
+      return std::move(*cached);
+    } else if (fetch_options == CacheOnly) {
+      return {{client::ErrorCode::NotFound,
+               "CacheOnly: resource not found in cache"}};
+    }
+  }
+
+  auto metadata_api = lookup_client_.LookupApi(
+      "metadata", "v1", static_cast<client::FetchOptions>(fetch_options),
+      context);
+
+  if (!metadata_api.IsSuccessful()) {
+    return metadata_api.GetError();
+  }
+
+  auto response = MetadataApi::GetLayerVersions(metadata_api.GetResult(),
+                                                version, billing_tag, context);
+
+  if (response.IsSuccessful() && fetch_options != OnlineOnly) {
+    repository.Put(version, response.GetResult());
+  }
+
+  return response;
+}
+
 VersionsResponse CatalogRepository::GetVersionsList(
     const VersionsRequest& request, client::CancellationContext context) {
   auto metadata_api =
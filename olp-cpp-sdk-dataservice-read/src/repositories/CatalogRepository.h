@@ -25,6 +25,7 @@
 #include <olp/core/client/CancellationToken.h>
 #include <olp/core/client/HRN.h>
 #include <olp/core/client/OlpClientSettings.h>
+#include "generated/model/LayerVersions.h"
 #include "olp/dataservice/read/Types.h"
 
 namespace olp {
@@ -33,14 +34,19 @@ namespace read {
 
 class CatalogRequest;
 class CatalogVersionRequest;
+class TaskSink;
 class VersionsRequest;
 
 namespace repository {
 
 class CatalogRepository final {
  public:
+  using LayerVersionsResponse =
+      client::ApiResponse<model::LayerVersions, client::ApiError>;
+
   CatalogRepository(client::HRN catalog, client::OlpClientSettings settings,
-                    client::ApiLookupClient client);
+                    client::ApiLookupClient client,
+                    TaskSink* task_sink = nullptr);
 
   CatalogResponse GetCatalog(const CatalogRequest& request,
                              client::CancellationContext context);
@@ -48,6 +54,10 @@ class CatalogRepository final {
   CatalogVersionResponse GetLatestVersion(const CatalogVersionRequest& request,
                                           client::CancellationContext context);
 
+  LayerVersionsResponse GetLayerVersions(
+      int64_t version, const boost::optional<std::string>& billing_tag,
+      FetchOptions fetch_options, client::CancellationContext context);
+
   VersionsResponse GetVersionsList(const VersionsRequest& request,
                                    client::CancellationContext context);
 
@@ -59,6 +69,7 @@ class CatalogRepository final {
   client::HRN catalog_;
   client::OlpClientSettings settings_;
   client::ApiLookupClient lookup_client_;
+  TaskSink* task_sink_;
 };
 
 }  // namespace repository
@@ -19,11 +19,13 @@
 
 #include "DataCacheRepository.h"
 
+#include <ctime>
 #include <limits>
 #include <string>
 
 #include <olp/core/cache/KeyValueCache.h>
 #include <olp/core/logging/Log.h>
+#include "CacheKeyBuilder.h"
 
 namespace {
 constexpr auto kLogTag = "DataCacheRepository";
@@ -41,19 +43,61 @@ namespace read {
 namespace repository {
 DataCacheRepository::DataCacheRepository(
     const client::HRN& hrn, std::shared_ptr<cache::KeyValueCache> cache,
-    std::chrono::seconds default_expiry)
-    : hrn_(hrn),
+    std::chrono::seconds default_expiry, std::chrono::seconds max_staleness,
+    bool response_validators)
+    : key_prefix_(hrn.ToCatalogHRNString() + "::"),
       cache_(std::move(cache)),
-      default_expiry_(ConvertTime(default_expiry)) {}
+      default_expiry_(ConvertTime(default_expiry)),
+      max_staleness_(ConvertTime(max_staleness)),
+      response_validators_(response_validators) {}
 
 client::ApiNoResponse DataCacheRepository::Put(const model::Data& data,
                                                const std::string& layer_id,
                                                const std::string& data_handle) {
-  auto key = CreateKey(layer_id, data_handle);
-  OLP_SDK_LOG_DEBUG_F(kLogTag, "Put -> '%s'", key.c_str());
+  if (IsRevalidationEnabled() && max_staleness_ > 0) {
+    // The freshness is stored as for the data without validators.
+    return Put(data, layer_id, data_handle, CacheValidators());
+  }
 
-  if (!cache_->Put(key, data, default_expiry_)) {
-    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write -> '%s'", key.c_str());
+  return PutData(data, BuildKey(layer_id, data_handle), default_expiry_);
+}
+
+client::ApiNoResponse DataCacheRepository::Put(
+    const model::Data& data, const std::string& layer_id,
+    const std::string& data_handle, const CacheValidators& validators) {
+  if (!IsRevalidationEnabled()) {
+    return PutData(data, BuildKey(layer_id, data_handle), default_expiry_);
+  }
+
+  if (validators.IsEmpty() && max_staleness_ == 0) {
+    // The validators of the previous data don't apply anymore.
+    cache_->Remove(BuildValidatorsKey(layer_id, data_handle));
+    return PutData(data, BuildKey(layer_id, data_handle), default_expiry_);
+  }
+
+  // The stale data with validators stays until it is evicted, without
+  // validators for the max staleness. The validators tell when it needs to
+  // be refreshed.
+  auto expiry = cache::KeyValueCache::kDefaultExpiry;
+  if (validators.IsEmpty() && max_staleness_ < kTimetMax - default_expiry_) {
+    expiry = default_expiry_ + max_staleness_;
+  }
+
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Put with validators, layer='%s', key='%s'",
+                      layer_id.c_str(), data_handle.c_str());
+
+  auto put_result = PutData(data, BuildKey(layer_id, data_handle), expiry);
+  if (!put_result.IsSuccessful()) {
+    return put_result;
+  }
+
+  auto fresh_validators = validators;
+  fresh_validators.fresh_until = std::time(nullptr) + default_expiry_;
+
+  const auto& validators_key = BuildValidatorsKey(layer_id, data_handle);
+  if (!cache_->Put(validators_key, fresh_validators.Serialize(), expiry)) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write -> '%s'",
+                        validators_key.c_str());
     return {{client::ErrorCode::CacheIO, "Put to cache failed"}};
   }
 
@@ -62,11 +106,11 @@ client::ApiNoResponse DataCacheRepository::Put(const model::Data& data,
 
 boost::optional<model::Data> DataCacheRepository::Get(
     const std::string& layer_id, const std::string& data_handle) {
-  auto key = CreateKey(layer_id, data_handle);
+  const auto& key = BuildKey(layer_id, data_handle);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "Get '%s'", key.c_str());
 
   auto cached_data = cache_->Get(key);
-  if (!cached_data) {
+  if (!cached_data || IsStale(layer_id, data_handle)) {
     return boost::none;
   }
 
@@ -75,23 +119,116 @@ boost::optional<model::Data> DataCacheRepository::Get(
 
 bool DataCacheRepository::IsCached(const std::string& layer_id,
                                    const std::string& data_handle) const {
-  auto data_key = CreateKey(layer_id, data_handle);
+  const auto& data_key = BuildKey(layer_id, data_handle);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "IsCached key -> '%s'", data_key.c_str());
-  return cache_->Contains(data_key);
+  return cache_->Contains(data_key) && !IsStale(layer_id, data_handle);
+}
+
+boost::optional<model::Data> DataCacheRepository::GetStale(
+    const std::string& layer_id, const std::string& data_handle) {
+  const auto validators = GetValidators(layer_id, data_handle);
+  if (!validators ||
+      std::time(nullptr) - validators->fresh_until >= max_staleness_) {
+    return boost::none;
+  }
+
+  const auto& key = BuildKey(layer_id, data_handle);
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "GetStale '%s'", key.c_str());
+  return cache_->Get(key);
+}
+
+boost::optional<CacheValidators> DataCacheRepository::GetValidators(
+    const std::string& layer_id, const std::string& data_handle) const {
+  if (!IsRevalidationEnabled()) {
+    return boost::none;
+  }
+
+  auto value = cache_->Get(BuildValidatorsKey(layer_id, data_handle));
+  if (!value) {
+    return boost::none;
+  }
+
+  return CacheValidators::Parse(*value);
+}
+
+boost::optional<model::Data> DataCacheRepository::Revalidate(
+    const std::string& layer_id, const std::string& data_handle,
+    CacheValidators validators) {
+  const auto& key = BuildKey(layer_id, data_handle);
+  auto cached_data = cache_->Get(key);
+  if (!cached_data) {
+    return boost::none;
+  }
+
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Revalidate -> '%s'", key.c_str());
+
+  // Only the validators are written, the data is not modified.
+  validators.fresh_until = std::time(nullptr) + default_expiry_;
+  cache_->Put(BuildValidatorsKey(layer_id, data_handle),
+              validators.Serialize(), cache::KeyValueCache::kDefaultExpiry);
+  return cached_data;
 }
 
 bool DataCacheRepository::Clear(const std::string& layer_id,
                                 const std::string& data_handle) {
-  auto key = CreateKey(layer_id, data_handle);
+  const auto& key = BuildKey(layer_id, data_handle);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "Clear -> '%s'", key.c_str());
 
   return cache_->RemoveKeysWithPrefix(key);
 }
 
+client::ApiNoResponse DataCacheRepository::PutData(const model::Data& data,
+                                                   const std::string& key,
+                                                   time_t expiry) {
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Put -> '%s'", key.c_str());
+
+  if (!cache_->Put(key, data, expiry)) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write -> '%s'", key.c_str());
+    return {{client::ErrorCode::CacheIO, "Put to cache failed"}};
+  }
+
+  return {client::ApiNoResult{}};
+}
+
 std::string DataCacheRepository::CreateKey(
     const std::string& layer_id, const std::string& datahandle) const {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  return hrn + "::" + layer_id + "::" + datahandle + "::Data";
+  return BuildKey(layer_id, datahandle);
+}
+
+const std::string& DataCacheRepository::BuildKey(
+    const std::string& layer_id, const std::string& datahandle) const {
+  return CacheKeyBuilder(key_prefix_)
+      .Add(layer_id)
+      .Add("::")
+      .Add(datahandle)
+      .Add("::Data")
+      .Get();
+}
+
+std::string DataCacheRepository::BuildValidatorsKey(
+    const std::string& layer_id, const std::string& datahandle) const {
+  return CacheKeyBuilder(key_prefix_)
+      .Add(layer_id)
+      .Add("::")
+      .Add(datahandle)
+      .Add("::Data::validators")
+      .Get();
+}
+
+bool DataCacheRepository::IsRevalidationEnabled() const {
+  return default_expiry_ != kTimetMax;
+}
+
+bool DataCacheRepository::IsStale(const std::string& layer_id,
+                                  const std::string& data_handle) const {
+  // Without the stale data, the entries without the validators of the
+  // responses expire on their own.
+  if (!response_validators_ && max_staleness_ == 0) {
+    return false;
+  }
+
+  const auto validators = GetValidators(layer_id, data_handle);
+  return validators && !validators->IsFresh();
 }
 
 }  // namespace repository
@@ -21,11 +21,13 @@
 
 #include <chrono>
 #include <memory>
+#include <string>
 
 #include <olp/core/client/ApiNoResult.h>
 #include <olp/core/client/HRN.h>
 #include <olp/dataservice/read/model/Data.h>
 #include <boost/optional.hpp>
+#include "CacheValidators.h"
 
 namespace olp {
 namespace cache {
@@ -37,9 +39,18 @@ namespace repository {
 
 class DataCacheRepository final {
  public:
+  /*
+   * @brief Creates the repository.
+   *
+   * @param response_validators False if the data is never stored with the
+   * validators of the responses, as the versioned blobs are immutable. Then
+   * the lookups do not read the validators unless the stale data is kept.
+   */
   DataCacheRepository(
       const client::HRN& hrn, std::shared_ptr<cache::KeyValueCache> cache,
-      std::chrono::seconds default_expiry = std::chrono::seconds::max());
+      std::chrono::seconds default_expiry = std::chrono::seconds::max(),
+      std::chrono::seconds max_staleness = std::chrono::seconds::zero(),
+      bool response_validators = true);
 
   ~DataCacheRepository() = default;
 
@@ -47,20 +58,73 @@ class DataCacheRepository final {
                             const std::string& layer_id,
                             const std::string& data_handle);
 
+  /*
+   * @brief Stores the data with the validators of the response.
+   *
+   * If the entries expire and the validators are not empty, the data is kept
+   * after it becomes stale, so it can be revalidated. Without validators, the
+   * stale data is kept for the max staleness. Otherwise, it is stored as by
+   * `Put` without validators.
+   */
+  client::ApiNoResponse Put(const model::Data& data,
+                            const std::string& layer_id,
+                            const std::string& data_handle,
+                            const CacheValidators& validators);
+
   boost::optional<model::Data> Get(const std::string& layer_id,
                                    const std::string& data_handle);
   bool IsCached(const std::string& layer_id,
                 const std::string& data_handle) const;
 
+  /// Gets the data that is stale for less than the max staleness.
+  boost::optional<model::Data> GetStale(const std::string& layer_id,
+                                        const std::string& data_handle);
+
+  /// Gets the validators of the data, also if the data is stale.
+  boost::optional<CacheValidators> GetValidators(
+      const std::string& layer_id, const std::string& data_handle) const;
+
+  /*
+   * @brief Makes the stale data fresh after the server confirms that it is
+   * not modified.
+   *
+   * @return The cached data, or `boost::none` if it is evicted.
+   */
+  boost::optional<model::Data> Revalidate(const std::string& layer_id,
+                                          const std::string& data_handle,
+                                          CacheValidators validators);
+
   bool Clear(const std::string& layer_id, const std::string& data_handle);
 
   std::string CreateKey(const std::string& layer_id,
                         const std::string& datahandle) const;
 
  private:
-  client::HRN hrn_;
+  // Returns the key in the buffer of the calling thread, the key is valid
+  // until the next key is built on the thread. Only one such key is held at
+  // a time, the other keys are returned by value.
+  const std::string& BuildKey(const std::string& layer_id,
+                              const std::string& datahandle) const;
+
+  std::string BuildValidatorsKey(const std::string& layer_id,
+                                 const std::string& datahandle) const;
+
+  client::ApiNoResponse PutData(const model::Data& data,
+                                const std::string& key, time_t expiry);
+
+  // The validators are stored only if the entries expire.
+  bool IsRevalidationEnabled() const;
+
+  // Checks the validators of the data that is found in the cache, if the
+  // data can have them.
+  bool IsStale(const std::string& layer_id,
+               const std::string& data_handle) const;
+
+  const std::string key_prefix_;
   std::shared_ptr<cache::KeyValueCache> cache_;
   time_t default_expiry_;
+  time_t max_staleness_;
+  bool response_validators_;
 };
 }  // namespace repository
 }  // namespace read
@@ -20,16 +20,24 @@
 #include "DataRepository.h"
 
 #include <algorithm>
+#include <cctype>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <utility>
 
 #include <olp/core/client/Condition.h>
+#include <olp/core/client/HttpResponse.h>
 #include <olp/core/logging/Log.h>
+#include <olp/core/tracing/Tracer.h>
+#include <olp/core/utils/Sha256.h>
 #include "CatalogRepository.h"
+#include "Common.h"
 #include "DataCacheRepository.h"
 #include "PartitionsCacheRepository.h"
 #include "PartitionsRepository.h"
+#include "StaleEntryRefresher.h"
 #include "generated/api/BlobApi.h"
 #include "generated/api/VolatileBlobApi.h"
 #include "olp/dataservice/read/CatalogRequest.h"
@@ -46,22 +54,125 @@ namespace {
 constexpr auto kLogTag = "DataRepository";
 constexpr auto kBlobService = "blob";
 constexpr auto kVolatileBlobService = "volatile-blob";
+
+boost::optional<std::string> GetChecksumToVerify(
+    const DataRequest& request, const model::Partition& partition) {
+  // The empty checksum marks the partition that has none in the service.
+  const auto& checksum = partition.GetChecksum();
+  if (!request.GetChecksumVerificationEnabled() || !checksum ||
+      checksum->empty()) {
+    return boost::none;
+  }
+  return checksum;
+}
+
+// Verifies the downloaded blob and stores it in the cache.
+BlobApi::DataResponse FinishBlobResponse(
+    BlobApi::DataResponse response, DataCacheRepository& repository,
+    const std::string& catalog, const std::string& layer,
+    const std::string& data_handle, FetchOptions fetch_option,
+    bool fail_on_cache_error, const boost::optional<std::string>& checksum,
+    const boost::optional<CacheValidators>& validators = boost::none) {
+  // Verify the data before it is stored in the cache, so a corrupted blob
+  // never becomes visible to other requests.
+  if (response.IsSuccessful() && checksum &&
+      !DataRepository::VerifyChecksum(response.GetResult(), *checksum)) {
+    OLP_SDK_LOG_WARNING_F(kLogTag,
+                          "GetBlobData checksum mismatch, hrn='%s', "
+                          "layer='%s', data_handle='%s'",
+                          catalog.c_str(), layer.c_str(), data_handle.c_str());
+    return {{client::ErrorCode::ChecksumMismatch, "Data checksum mismatch"}};
+  }
+
+  if (response.IsSuccessful() && fetch_option != OnlineOnly) {
+    const auto put_result =
+        validators
+            ? repository.Put(response.GetResult(), layer, data_handle,
+                             *validators)
+            : repository.Put(response.GetResult(), layer, data_handle);
+    if (!put_result.IsSuccessful() && fail_on_cache_error) {
+      OLP_SDK_LOG_ERROR_F(kLogTag,
+                          "Failed to write data to cache, hrn='%s', "
+                          "layer='%s', data_handle='%s'",
+                          catalog.c_str(), layer.c_str(), data_handle.c_str());
+      return put_result.GetError();
+    }
+  }
+
+  if (!response.IsSuccessful() && response.GetError().GetHttpStatusCode() ==
+                                      http::HttpStatusCode::FORBIDDEN) {
+    OLP_SDK_LOG_WARNING_F(
+        kLogTag,
+        "GetBlobData 403 received, remove from cache, hrn='%s', key='%s'",
+        catalog.c_str(), data_handle.c_str());
+    repository.Clear(layer, data_handle);
+  }
+
+  return response;
+}
+
+// Downloads the volatile blob. If the stale blob is in the cache, sends its
+// validators and uses it again if the server responds with 304 (Not
+// Modified), so the blob is not downloaded.
+BlobApi::DataResponse GetVolatileBlob(
+    const client::OlpClient& client, const std::string& layer,
+    const std::string& data_handle,
+    const boost::optional<std::string>& billing_tag,
+    DataCacheRepository& repository, FetchOptions fetch_option,
+    CacheValidators& validators, bool& not_modified,
+    const client::CancellationContext& context) {
+  boost::optional<CacheValidators> cached;
+  if (fetch_option != OnlineOnly) {
+    cached = repository.GetValidators(layer, data_handle);
+  }
+
+  auto response = VolatileBlobApi::GetVolatileBlobIfModified(
+      client, layer, data_handle, billing_tag,
+      cached ? cached->IfNoneMatch() : boost::none,
+      cached ? cached->IfModifiedSince() : boost::none, context);
+  auto statistics = response.GetNetworkStatistics();
+
+  if (cached && response.GetStatus() == http::HttpStatusCode::NOT_MODIFIED) {
+    cached->Update(CacheValidators::FromHeaders(response.GetHeaders()));
+    auto cached_data = repository.Revalidate(layer, data_handle, *cached);
+    if (cached_data) {
+      not_modified = true;
+      return {std::move(*cached_data), statistics};
+    }
+
+    // The stale blob is evicted after the request is sent.
+    response = VolatileBlobApi::GetVolatileBlobIfModified(
+        client, layer, data_handle, billing_tag, boost::none, boost::none,
+        context);
+    statistics += response.GetNetworkStatistics();
+  }
+
+  if (response.GetStatus() != http::HttpStatusCode::OK) {
+    return {{response.GetStatus(), response.response.str()}, statistics};
+  }
+
+  validators = CacheValidators::FromHeaders(response.GetHeaders());
+  auto data = std::make_shared<std::vector<unsigned char>>();
+  response.GetResponse(*data);
+  return {data, statistics};
+}
 }  // namespace
 
 DataRepository::DataRepository(client::HRN catalog,
                                client::OlpClientSettings settings,
                                client::ApiLookupClient client,
-                               NamedMutexStorage storage)
+                               NamedMutexStorage storage, TaskSink* task_sink)
     : catalog_(std::move(catalog)),
       settings_(std::move(settings)),
       lookup_client_(std::move(client)),
-      storage_(std::move(storage)) {}
+      storage_(std::move(storage)),
+      task_sink_(task_sink) {}
 
 DataResponse DataRepository::GetVersionedTile(
     const std::string& layer_id, const TileRequest& request, int64_t version,
     client::CancellationContext context) {
   PartitionsRepository repository(catalog_, layer_id, settings_, lookup_client_,
-                                  storage_);
+                                  storage_, task_sink_);
   auto response = repository.GetTile(request, version, context);
 
   if (!response.IsSuccessful()) {
@@ -91,10 +202,11 @@ BlobApi::DataResponse DataRepository::GetVersionedData(
   }
 
   auto blob_request = request;
+  boost::optional<std::string> checksum;
   if (!request.GetDataHandle()) {
     // get data handle for a partition to be queried
     PartitionsRepository repository(catalog_, layer_id, settings_,
-                                    lookup_client_, storage_);
+                                    lookup_client_, storage_, task_sink_);
     auto partitions_response =
         repository.GetPartitionById(request, version, context);
 
@@ -116,18 +228,20 @@ BlobApi::DataResponse DataRepository::GetVersionedData(
     }
 
     blob_request.WithDataHandle(partitions.front().GetDataHandle());
+    checksum = GetChecksumToVerify(request, partitions.front());
   }
 
   // finally get the data using a data handle
   return repository::DataRepository::GetBlobData(
       layer_id, kBlobService, blob_request, std::move(context),
-      fail_on_cache_error);
+      fail_on_cache_error, checksum);
 }
 
 BlobApi::DataResponse DataRepository::GetBlobData(
     const std::string& layer, const std::string& service,
     const DataRequest& request, client::CancellationContext context,
-    const bool fail_on_cache_error) {
+    const bool fail_on_cache_error,
+    const boost::optional<std::string>& checksum) {
   auto fetch_option = request.GetFetchOption();
   const auto& data_handle = request.GetDataHandle();
 
@@ -135,23 +249,37 @@ BlobApi::DataResponse DataRepository::GetBlobData(
     return {{client::ErrorCode::PreconditionFailed, "Data handle is missing"}};
   }
 
-  NamedMutex mutex(storage_, catalog_.ToString() + layer + *data_handle);
-  std::unique_lock<NamedMutex> lock(mutex, std::defer_lock);
-
-  // If we are not planning to go online or access the cache, do not lock.
-  if (fetch_option != CacheOnly && fetch_option != OnlineOnly) {
-    lock.lock();
+  tracing::Span span("DataRepository::GetBlobData", [&] {
+    return tracing::SpanAttributes()
+        .WithRequestId(catalog_.ToString() + layer + *data_handle)
+        .WithCatalog(catalog_.ToCatalogHRNString())
+        .WithLayer(layer)
+        .WithPartition(request.GetPartitionId().value_or(*data_handle));
+  });
+
+  // The cached blob is returned without waiting for the requests in flight.
+  if (fetch_option == StaleWhileRevalidate) {
+    auto cached_data =
+        GetStaleWhileRevalidate(layer, service, request, checksum);
+    if (cached_data) {
+      return std::move(*cached_data);
+    }
   }
 
   repository::DataCacheRepository repository(
-      catalog_, settings_.cache, settings_.default_cache_expiration);
-
-  if (fetch_option != OnlineOnly && fetch_option != CacheWithUpdate) {
+      catalog_, settings_.cache, settings_.default_cache_expiration,
+      settings_.max_staleness, service == kVolatileBlobService);
+
+  // The cache hit neither builds the request key nor waits for the requests
+  // in flight.
+  const bool use_cache =
+      fetch_option != OnlineOnly && fetch_option != CacheWithUpdate;
+  if (use_cache) {
     auto cached_data = repository.Get(layer, data_handle.value());
     if (cached_data) {
-      OLP_SDK_LOG_DEBUG_F(
-          kLogTag, "GetBlobData found in cache, hrn='%s', key='%s'",
-          catalog_.ToCatalogHRNString().c_str(), data_handle->c_str());
+      OLP_SDK_LOG_DEBUG_F(kLogTag,
+                          "GetBlobData found in cache, layer='%s', key='%s'",
+                          layer.c_str(), data_handle->c_str());
       return cached_data.value();
     } else if (fetch_option == CacheOnly) {
       OLP_SDK_LOG_INFO_F(
@@ -162,6 +290,26 @@ BlobApi::DataResponse DataRepository::GetBlobData(
     }
   }
 
+  const auto request_key = catalog_.ToString() + layer + *data_handle;
+  NamedMutex mutex(storage_, request_key);
+  std::unique_lock<NamedMutex> lock(mutex, std::defer_lock);
+
+  // If we are not planning to go online, do not lock.
+  if (fetch_option != OnlineOnly) {
+    lock.lock();
+  }
+
+  if (use_cache) {
+    // The blob may be downloaded by another thread while waiting for the lock.
+    auto cached_data = repository.Get(layer, data_handle.value());
+    if (cached_data) {
+      OLP_SDK_LOG_DEBUG_F(
+          kLogTag, "GetBlobData found in cache, hrn='%s', key='%s'",
+          catalog_.ToCatalogHRNString().c_str(), data_handle->c_str());
+      return cached_data.value();
+    }
+  }
+
   // Check if other threads have faced an error.
   const auto optional_error = mutex.GetError();
   if (optional_error) {
@@ -185,46 +333,286 @@ BlobApi::DataResponse DataRepository::GetBlobData(
   }
 
   BlobApi::DataResponse storage_response;
+  boost::optional<CacheValidators> validators;
 
   if (service == kBlobService) {
     storage_response = BlobApi::GetBlob(
         storage_api_lookup.GetResult(), layer, data_handle.value(),
         request.GetBillingTag(), boost::none, context);
   } else {
-    auto volatile_blob = VolatileBlobApi::GetVolatileBlob(
+    bool not_modified = false;
+    validators = CacheValidators();
+    storage_response = GetVolatileBlob(
         storage_api_lookup.GetResult(), layer, data_handle.value(),
-        request.GetBillingTag(), context);
-    storage_response = BlobApi::DataResponse(volatile_blob.MoveResult());
-  }
+        request.GetBillingTag(), repository, fetch_option, *validators,
+        not_modified, context);
 
-  if (storage_response.IsSuccessful() && fetch_option != OnlineOnly) {
-    const auto put_result = repository.Put(storage_response.GetResult(), layer,
-                                           data_handle.value());
-    if (!put_result.IsSuccessful() && fail_on_cache_error) {
-      OLP_SDK_LOG_ERROR_F(kLogTag,
-                          "Failed to write data to cache, hrn='%s', "
-                          "layer='%s', data_handle='%s'",
-                          catalog_.ToCatalogHRNString().c_str(), layer.c_str(),
-                          data_handle->c_str());
-      return put_result.GetError();
+    if (not_modified) {
+      OLP_SDK_LOG_DEBUG_F(
+          kLogTag, "GetBlobData not modified, hrn='%s', key='%s'",
+          catalog_.ToCatalogHRNString().c_str(), data_handle->c_str());
+      return storage_response;
     }
   }
 
   if (!storage_response.IsSuccessful()) {
-    const auto& error = storage_response.GetError();
-    if (error.GetHttpStatusCode() == http::HttpStatusCode::FORBIDDEN) {
+    // Store an error to share it with other threads.
+    mutex.SetError(storage_response.GetError());
+  }
+
+  return FinishBlobResponse(std::move(storage_response), repository,
+                            catalog_.ToCatalogHRNString(), layer, *data_handle,
+                            fetch_option, fail_on_cache_error, checksum,
+                            validators);
+}
+
+void DataRepository::GetBlobDataAsync(
+    const std::string& layer, const DataRequest& request,
+    client::CancellationContext context, DataResponseCallback callback,
+    const bool fail_on_cache_error,
+    const boost::optional<std::string>& checksum) {
+  const auto fetch_option = request.GetFetchOption();
+  const auto& data_handle = request.GetDataHandle();
+
+  if (!data_handle) {
+    callback({{client::ErrorCode::PreconditionFailed,
+               "Data handle is missing"}});
+    return;
+  }
+
+  if (fetch_option == StaleWhileRevalidate) {
+    auto cached_data =
+        GetStaleWhileRevalidate(layer, kBlobService, request, checksum);
+    if (cached_data) {
+      callback(std::move(*cached_data));
+      return;
+    }
+  }
+
+  const auto request_key = catalog_.ToString() + layer + *data_handle;
+  auto self = *this;
+  auto send = [=](DataResponseCallback send_callback) mutable {
+    self.DownloadBlobAsync(layer, request, context, std::move(send_callback),
+                           fail_on_cache_error, checksum);
+  };
+
+  SendOrJoin<BlobApi::DataResponse>(storage_, request_key, fetch_option,
+                                    std::move(context), std::move(send),
+                                    std::move(callback));
+}
+
+void DataRepository::GetVersionedDataAsync(const std::string& layer_id,
+                                           const DataRequest& request,
+                                           int64_t version,
+                                           client::CancellationContext context,
+                                           DataResponseCallback callback) {
+  if (request.GetDataHandle() && request.GetPartitionId()) {
+    callback({{client::ErrorCode::PreconditionFailed,
+               "Both data handle and partition id specified"}});
+    return;
+  }
+
+  if (request.GetDataHandle()) {
+    GetBlobDataAsync(layer_id, request, std::move(context),
+                     std::move(callback));
+    return;
+  }
+
+  auto self = *this;
+  auto on_partitions = [=](PartitionsResponse partitions_response) mutable {
+    if (!partitions_response.IsSuccessful()) {
+      callback(partitions_response.GetError());
+      return;
+    }
+
+    const auto& partitions = partitions_response.GetResult().GetPartitions();
+    if (partitions.empty()) {
+      OLP_SDK_LOG_INFO_F(
+          kLogTag,
+          "GetVersionedDataAsync partition %s not found, hrn='%s', key='%s'",
+          request.GetPartitionId() ? request.GetPartitionId().get().c_str()
+                                   : "<none>",
+          self.catalog_.ToCatalogHRNString().c_str(),
+          request.CreateKey(layer_id, version).c_str());
+
+      callback({{client::ErrorCode::NotFound, "Partition not found"}});
+      return;
+    }
+
+    auto blob_request = request;
+    blob_request.WithDataHandle(partitions.front().GetDataHandle());
+    self.GetBlobDataAsync(layer_id, blob_request, std::move(context),
+                          std::move(callback), false,
+                          GetChecksumToVerify(request, partitions.front()));
+  };
+
+  PartitionsRepository repository(catalog_, layer_id, settings_, lookup_client_,
+                                  storage_, task_sink_);
+  repository.GetPartitionByIdAsync(request, version, context,
+                                   std::move(on_partitions));
+}
+
+void DataRepository::GetVersionedTileAsync(const std::string& layer_id,
+                                           const TileRequest& request,
+                                           int64_t version,
+                                           client::CancellationContext context,
+                                           DataResponseCallback callback) {
+  auto self = *this;
+  auto on_partition = [=](PartitionResponse response) mutable {
+    if (!response.IsSuccessful()) {
       OLP_SDK_LOG_WARNING_F(
           kLogTag,
-          "GetBlobData 403 received, remove from cache, hrn='%s', key='%s'",
-          catalog_.ToCatalogHRNString().c_str(), data_handle->c_str());
-      repository.Clear(layer, data_handle.value());
+          "GetVersionedTileAsync partition request failed, hrn='%s', "
+          "key='%s'",
+          self.catalog_.ToCatalogHRNString().c_str(),
+          request.CreateKey(layer_id).c_str());
+      callback(response.GetError());
+      return;
     }
 
-    // Store an error to share it with other threads.
-    mutex.SetError(storage_response.GetError());
+    const auto data_request =
+        DataRequest()
+            .WithDataHandle(response.GetResult().GetDataHandle())
+            .WithFetchOption(request.GetFetchOption());
+    self.GetBlobDataAsync(layer_id, data_request, std::move(context),
+                          std::move(callback));
+  };
+
+  PartitionsRepository repository(catalog_, layer_id, settings_, lookup_client_,
+                                  storage_, task_sink_);
+  repository.GetTileAsync(request, version, context, std::move(on_partition));
+}
+
+void DataRepository::DownloadBlobAsync(
+    const std::string& layer, const DataRequest& request,
+    client::CancellationContext context, DataResponseCallback callback,
+    const bool fail_on_cache_error,
+    const boost::optional<std::string>& checksum) {
+  const auto fetch_option = request.GetFetchOption();
+  const auto data_handle = *request.GetDataHandle();
+  const auto catalog = catalog_.ToCatalogHRNString();
+  repository::DataCacheRepository repository(
+      catalog_, settings_.cache, settings_.default_cache_expiration,
+      settings_.max_staleness, false);
+
+  if (fetch_option != OnlineOnly && fetch_option != CacheWithUpdate) {
+    auto cached_data = repository.Get(layer, data_handle);
+    if (cached_data) {
+      OLP_SDK_LOG_DEBUG_F(
+          kLogTag, "GetBlobDataAsync found in cache, hrn='%s', key='%s'",
+          catalog.c_str(), data_handle.c_str());
+      callback(std::move(*cached_data));
+      return;
+    } else if (fetch_option == CacheOnly) {
+      OLP_SDK_LOG_INFO_F(
+          kLogTag, "GetBlobDataAsync not found in cache, hrn='%s', key='%s'",
+          catalog.c_str(), data_handle.c_str());
+      callback({{client::ErrorCode::NotFound,
+                 "CacheOnly: resource not found in cache"}});
+      return;
+    }
   }
 
-  return storage_response;
+  const auto billing_tag = request.GetBillingTag();
+  const auto task_scheduler = settings_.task_scheduler;
+  auto on_lookup = [=](client::ApiLookupClient::LookupApiResponse
+                           lookup_response) mutable {
+    if (!lookup_response.IsSuccessful()) {
+      callback(lookup_response.GetError());
+      return;
+    }
+
+    const auto blob_client = lookup_response.MoveResult();
+    ExecuteAsync<BlobApi::DataResponse>(
+        context,
+        [&](DataResponseCallback on_blob) {
+          return BlobApi::GetBlob(blob_client, layer, data_handle, billing_tag,
+                                  boost::none, std::move(on_blob));
+        },
+        [=](BlobApi::DataResponse response) mutable {
+          // The checksum and the cache write take time for big blobs, so
+          // they run on the task scheduler instead of the network thread.
+          auto finish = [=]() mutable {
+            callback(FinishBlobResponse(std::move(response), repository,
+                                        catalog, layer, data_handle,
+                                        fetch_option, fail_on_cache_error,
+                                        checksum));
+          };
+
+          if (task_scheduler) {
+            task_scheduler->ScheduleTask(std::move(finish));
+          } else {
+            finish();
+          }
+        });
+  };
+
+  LookupApiAsync(lookup_client_, kBlobService, fetch_option, context,
+                 std::move(on_lookup));
+}
+
+boost::optional<model::Data> DataRepository::GetStaleWhileRevalidate(
+    const std::string& layer, const std::string& service,
+    const DataRequest& request,
+    const boost::optional<std::string>& checksum) {
+  const auto& data_handle = *request.GetDataHandle();
+  repository::DataCacheRepository repository(
+      catalog_, settings_.cache, settings_.default_cache_expiration,
+      settings_.max_staleness, service == kVolatileBlobService);
+
+  auto cached_data = repository.Get(layer, data_handle);
+  if (cached_data) {
+    OLP_SDK_LOG_DEBUG_F(kLogTag,
+                        "GetBlobData found in cache, hrn='%s', key='%s'",
+                        catalog_.ToCatalogHRNString().c_str(),
+                        data_handle.c_str());
+    return cached_data;
+  }
+
+  cached_data = repository.GetStale(layer, data_handle);
+  if (!cached_data) {
+    return boost::none;
+  }
+
+  OLP_SDK_LOG_DEBUG_F(kLogTag,
+                      "GetBlobData found stale in cache, hrn='%s', key='%s'",
+                      catalog_.ToCatalogHRNString().c_str(),
+                      data_handle.c_str());
+
+  auto refresh_request = request;
+  refresh_request.WithFetchOption(OnlineIfNotFound);
+  auto self = *this;
+
+  StaleEntryRefresher::Instance().Refresh(
+      settings_, task_sink_, repository.CreateKey(layer, data_handle),
+      [=](client::CancellationContext refresh_context) mutable {
+        self.GetBlobData(layer, service, refresh_request,
+                         std::move(refresh_context), false, checksum);
+      });
+
+  return cached_data;
+}
+
+bool DataRepository::VerifyChecksum(const model::Data& data,
+                                    const std::string& checksum) {
+  // Only SHA-256 checksums are verified, the others are accepted as is.
+  if (checksum.size() != utils::Sha256::kDigestLength * 2) {
+    OLP_SDK_LOG_WARNING_F(kLogTag,
+                          "VerifyChecksum: unsupported checksum format, "
+                          "length=%zu, the data is not verified",
+                          checksum.size());
+    return true;
+  }
+
+  const auto digest = utils::Sha256::ToHexString(
+      utils::Sha256::Compute(data ? data->data() : nullptr,
+                             data ? data->size() : 0u));
+
+  return std::equal(digest.begin(), digest.end(), checksum.begin(),
+                    [](char lhs, char rhs) {
+                      return lhs == std::tolower(static_cast<unsigned char>(
+                                        rhs));
+                    });
 }
 
 BlobApi::DataResponse DataRepository::GetVolatileData(
@@ -236,9 +624,10 @@ BlobApi::DataResponse DataRepository::GetVolatileData(
   }
 
   auto blob_request = request;
+  boost::optional<std::string> checksum;
   if (!request.GetDataHandle()) {
     PartitionsRepository repository(catalog_, layer_id, settings_,
-                                    lookup_client_, storage_);
+                                    lookup_client_, storage_, task_sink_);
     auto partitions_response =
         repository.GetPartitionById(request, boost::none, context);
 
@@ -259,10 +648,11 @@ BlobApi::DataResponse DataRepository::GetVolatileData(
     }
 
     blob_request.WithDataHandle(partitions.front().GetDataHandle());
+    checksum = GetChecksumToVerify(request, partitions.front());
   }
 
   return GetBlobData(layer_id, kVolatileBlobService, blob_request,
-                     std::move(context), fail_on_cache_error);
+                     std::move(context), fail_on_cache_error, checksum);
 }
 
 }  // namespace repository
@@ -33,14 +33,18 @@
 namespace olp {
 namespace dataservice {
 namespace read {
+class TaskSink;
 class TileRequest;
 namespace repository {
 
 class DataRepository final {
  public:
+  using DataResponseCallback = BlobApi::DataResponseCallback;
+
   DataRepository(client::HRN catalog, client::OlpClientSettings settings,
                  client::ApiLookupClient client,
-                 NamedMutexStorage storage = NamedMutexStorage());
+                 NamedMutexStorage storage = NamedMutexStorage(),
+                 TaskSink* task_sink = nullptr);
 
   DataResponse GetVersionedTile(const std::string& layer_id,
                                 const TileRequest& request, int64_t version,
@@ -57,17 +61,64 @@ class DataRepository final {
                                         client::CancellationContext context,
                                         bool fail_on_cache_error = false);
 
-  BlobApi::DataResponse GetBlobData(const std::string& layer,
-                                    const std::string& service,
-                                    const DataRequest& request,
-                                    client::CancellationContext context,
-                                    bool fail_on_cache_error = false);
+  BlobApi::DataResponse GetBlobData(
+      const std::string& layer, const std::string& service,
+      const DataRequest& request, client::CancellationContext context,
+      bool fail_on_cache_error = false,
+      const boost::optional<std::string>& checksum = boost::none);
+
+  /**
+   * Gets the blob without blocking the calling thread on the network: the API
+   * lookup and the download are continued from the network callbacks. The
+   * downloaded blob is verified and cached on the task scheduler, if there is
+   * one, otherwise on the network thread. The concurrent requests of the same
+   * blob are merged like in `GetBlobData`.
+   */
+  void GetBlobDataAsync(
+      const std::string& layer, const DataRequest& request,
+      client::CancellationContext context, DataResponseCallback callback,
+      bool fail_on_cache_error = false,
+      const boost::optional<std::string>& checksum = boost::none);
+
+  /// Gets the versioned data like `GetVersionedData`, the partition and
+  /// the blob are requested without blocking the calling thread.
+  void GetVersionedDataAsync(const std::string& layer_id,
+                             const DataRequest& request, int64_t version,
+                             client::CancellationContext context,
+                             DataResponseCallback callback);
+
+  /// Gets the tile data like `GetVersionedTile`, the quad tree and the blob
+  /// are requested without blocking the calling thread.
+  void GetVersionedTileAsync(const std::string& layer_id,
+                             const TileRequest& request, int64_t version,
+                             client::CancellationContext context,
+                             DataResponseCallback callback);
+
+  /// Returns false only if the checksum is SHA-256 and does not match.
+  static bool VerifyChecksum(const model::Data& data,
+                             const std::string& checksum);
 
  private:
+  // Gets the blob from the cache or from the network, the part of
+  // `GetBlobDataAsync` that is not shared with the identical requests.
+  void DownloadBlobAsync(const std::string& layer, const DataRequest& request,
+                         client::CancellationContext context,
+                         DataResponseCallback callback,
+                         bool fail_on_cache_error,
+                         const boost::optional<std::string>& checksum);
+
+  // Gets the cached blob for the `StaleWhileRevalidate` option. The stale
+  // blob is refreshed in the background.
+  boost::optional<model::Data> GetStaleWhileRevalidate(
+      const std::string& layer, const std::string& service,
+      const DataRequest& request,
+      const boost::optional<std::string>& checksum);
+
   client::HRN catalog_;
   client::OlpClientSettings settings_;
   client::ApiLookupClient lookup_client_;
   NamedMutexStorage storage_;
+  TaskSink* task_sink_;
 };
 
 }  // namespace repository
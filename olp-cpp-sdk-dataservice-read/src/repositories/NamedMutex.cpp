@@ -19,7 +19,11 @@
 
 #include "NamedMutex.h"
 
+#include <utility>
+#include <vector>
+
 #include <olp/core/porting/make_unique.h>
+#include <olp/core/tracing/Tracer.h>
 
 namespace olp {
 namespace dataservice {
@@ -30,8 +34,11 @@ class NamedMutexStorage::Impl {
  public:
   std::mutex& AquireLock(const std::string& resource);
   void ReleaseLock(const std::string& resource);
+  bool IsInUse(const std::string& resource);
   void SetError(const std::string& resource, const client::ApiError& error);
   boost::optional<client::ApiError> GetError(const std::string& resource);
+  bool JoinRequest(const std::string& resource, RequestCallback callback);
+  void CompleteRequest(const std::string& resource, const void* response);
 
  private:
   struct RefCounterMutex {
@@ -42,6 +49,7 @@ class NamedMutexStorage::Impl {
 
   std::mutex mutex_;
   std::unordered_map<std::string, RefCounterMutex> mutexes_;
+  std::unordered_map<std::string, std::vector<RequestCallback>> requests_;
 };
 
 std::mutex& NamedMutexStorage::Impl::AquireLock(const std::string& resource) {
@@ -64,6 +72,11 @@ void NamedMutexStorage::Impl::ReleaseLock(const std::string& resource) {
   }
 }
 
+bool NamedMutexStorage::Impl::IsInUse(const std::string& resource) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return mutexes_.find(resource) != mutexes_.end();
+}
+
 void NamedMutexStorage::Impl::SetError(const std::string& resource,
                                        const client::ApiError& error) {
   std::lock_guard<std::mutex> lock(mutex_);
@@ -84,6 +97,38 @@ boost::optional<client::ApiError> NamedMutexStorage::Impl::GetError(
   return mutex_it->second.optional_error;
 }
 
+bool NamedMutexStorage::Impl::JoinRequest(const std::string& resource,
+                                          RequestCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto request_it = requests_.find(resource);
+  if (request_it == requests_.end()) {
+    requests_.emplace(resource, std::vector<RequestCallback>());
+    return true;
+  }
+
+  request_it->second.emplace_back(std::move(callback));
+  return false;
+}
+
+void NamedMutexStorage::Impl::CompleteRequest(const std::string& resource,
+                                              const void* response) {
+  std::vector<RequestCallback> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto request_it = requests_.find(resource);
+    if (request_it == requests_.end()) {
+      return;
+    }
+
+    callbacks = std::move(request_it->second);
+    requests_.erase(request_it);
+  }
+
+  for (const auto& callback : callbacks) {
+    callback(response);
+  }
+}
+
 NamedMutexStorage::NamedMutexStorage() : impl_(std::make_shared<Impl>()) {}
 
 std::mutex& NamedMutexStorage::AquireLock(const std::string& resource) {
@@ -94,6 +139,10 @@ void NamedMutexStorage::ReleaseLock(const std::string& resource) {
   impl_->ReleaseLock(resource);
 }
 
+bool NamedMutexStorage::IsInUse(const std::string& resource) {
+  return impl_->IsInUse(resource);
+}
+
 void NamedMutexStorage::SetError(const std::string& resource,
                                  const client::ApiError& error) {
   impl_->SetError(resource, error);
@@ -104,12 +153,27 @@ boost::optional<client::ApiError> NamedMutexStorage::GetError(
   return impl_->GetError(resource);
 }
 
+bool NamedMutexStorage::JoinRequest(const std::string& resource,
+                                    RequestCallback callback) {
+  return impl_->JoinRequest(resource, std::move(callback));
+}
+
+void NamedMutexStorage::CompleteRequest(const std::string& resource,
+                                        const void* response) {
+  impl_->CompleteRequest(resource, response);
+}
+
 NamedMutex::NamedMutex(NamedMutexStorage& storage, const std::string& name)
     : storage_{storage}, name_{name}, mutex_{storage_.AquireLock(name_)} {}
 
 NamedMutex::~NamedMutex() { storage_.ReleaseLock(name_); }
 
-void NamedMutex::lock() { mutex_.lock(); }
+void NamedMutex::lock() {
+  tracing::Span span("NamedMutex::lock", [&] {
+    return tracing::SpanAttributes().WithRequestId(name_);
+  });
+  mutex_.lock();
+}
 
 bool NamedMutex::try_lock() { return mutex_.try_lock(); }
 
@@ -19,12 +19,16 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 #include <olp/core/client/ApiError.h>
+#include <olp/core/client/CancellationContext.h>
+#include <olp/dataservice/read/FetchOptions.h>
 #include <boost/optional.hpp>
 
 namespace olp {
@@ -44,6 +48,16 @@ class NamedMutexStorage {
   std::mutex& AquireLock(const std::string& resource);
   void ReleaseLock(const std::string& resource);
 
+  /**
+   * @brief Checks whether the mutex is used by any thread.
+   *
+   * @param resource A name of a mutex to check.
+   *
+   * @return True if the mutex is locked or some thread waits for it; false
+   * otherwise.
+   */
+  bool IsInUse(const std::string& resource);
+
   /**
    * @brief Saves an error to share it among threads.
    *
@@ -62,6 +76,29 @@ class NamedMutexStorage {
    */
   boost::optional<client::ApiError> GetError(const std::string& resource);
 
+  /// Receives the type-erased response of an asynchronous request.
+  using RequestCallback = std::function<void(const void*)>;
+
+  /**
+   * @brief Joins the asynchronous request of the resource that is in flight.
+   *
+   * @param resource A name of the request.
+   * @param callback The callback that receives the response of the request
+   * in flight.
+   *
+   * @return True if no request is in flight, the caller must send it and
+   * call `CompleteRequest`; false if the callback is stored.
+   */
+  bool JoinRequest(const std::string& resource, RequestCallback callback);
+
+  /**
+   * @brief Passes the response to the callers that joined the request.
+   *
+   * @param resource A name of the request.
+   * @param response The response of the request.
+   */
+  void CompleteRequest(const std::string& resource, const void* response);
+
  private:
   class Impl;
   std::shared_ptr<Impl> impl_;
@@ -110,6 +147,47 @@ class NamedMutex final {
   std::mutex& mutex_;
 };
 
+/*
+ * @brief The asynchronous counterpart of `NamedMutex`. Sends the request, or
+ * joins the identical request in flight without blocking the thread.
+ *
+ * Only the first caller calls `send`, its response is passed to all
+ * callers. A caller that joined a request cancelled by its sender sends
+ * the request again, unless it is cancelled too. As with `NamedMutex`, the
+ * `CacheOnly` and `OnlineOnly` requests are not merged.
+ */
+template <typename Response>
+void SendOrJoin(NamedMutexStorage storage, const std::string& name,
+                FetchOptions fetch_option, client::CancellationContext context,
+                std::function<void(std::function<void(Response)>)> send,
+                std::function<void(Response)> callback) {
+  if (fetch_option == CacheOnly || fetch_option == OnlineOnly) {
+    send(std::move(callback));
+    return;
+  }
+
+  auto joined = [=](const void* response) {
+    const auto& result = *static_cast<const Response*>(response);
+    if (!result.IsSuccessful() &&
+        result.GetError().GetErrorCode() == client::ErrorCode::Cancelled &&
+        !context.IsCancelled()) {
+      SendOrJoin<Response>(storage, name, fetch_option, context, send,
+                           callback);
+      return;
+    }
+    callback(result);
+  };
+
+  if (!storage.JoinRequest(name, std::move(joined))) {
+    return;
+  }
+
+  send([=](Response response) mutable {
+    storage.CompleteRequest(name, &response);
+    callback(std::move(response));
+  });
+}
+
 }  // namespace repository
 }  // namespace read
 }  // namespace dataservice
@@ -20,6 +20,8 @@
 #include "PartitionsCacheRepository.h"
 
 #include <algorithm>
+#include <cstdlib>
+#include <ctime>
 #include <limits>
 #include <string>
 #include <utility>
@@ -27,6 +29,9 @@
 
 #include <olp/core/cache/KeyValueCache.h>
 #include <olp/core/logging/Log.h>
+#include "CacheKeyBuilder.h"
+#include "CacheValidators.h"
+#include "PrefetchManifest.h"
 // clang-format off
 #include "generated/parser/PartitionsParser.h"
 #include "generated/parser/LayerVersionsParser.h"
@@ -43,26 +48,63 @@ constexpr auto kLogTag = "PartitionsCacheRepository";
 constexpr auto kChronoSecondsMax = std::chrono::seconds::max();
 constexpr auto kTimetMax = std::numeric_limits<time_t>::max();
 constexpr auto kMaxQuadTreeIndexDepth = 4u;
+constexpr auto kFreshnessSuffix = "::validators";
+
+// The partition keys are built for every partition, so they are returned in
+// the buffer of the calling thread, and are valid until the next key is built.
+const std::string& CreateKey(const std::string& layer_prefix,
+                             const std::string& partition_id,
+                             const boost::optional<int64_t>& version) {
+  return olp::dataservice::read::repository::CacheKeyBuilder(layer_prefix)
+      .Add(partition_id)
+      .Add("::")
+      .AddVersion(version)
+      .Add("partition")
+      .Get();
+}
 
-std::string CreateKey(const std::string& hrn, const std::string& layer_id,
-                      const std::string& partitionId,
+std::string CreateKey(const std::string& layer_prefix,
                       const boost::optional<int64_t>& version) {
-  return hrn + "::" + layer_id + "::" + partitionId +
-         "::" + (version ? std::to_string(*version) + "::" : "") + "partition";
+  return olp::dataservice::read::repository::CacheKeyBuilder(layer_prefix)
+      .AddVersion(version)
+      .Add("partitions")
+      .Get();
 }
 
-std::string CreateKey(const std::string& hrn, const std::string& layer_id,
-                      const boost::optional<int64_t>& version) {
-  return hrn + "::" + layer_id +
-         "::" + (version ? std::to_string(*version) + "::" : "") + "partitions";
+std::string CreatePrefetchManifestKey(const std::string& layer_prefix,
+                                      const olp::geo::TileKey& root,
+                                      int64_t version) {
+  return olp::dataservice::read::repository::CacheKeyBuilder(layer_prefix)
+      .Add(root)
+      .Add("::")
+      .Add(version)
+      .Add("::prefetch_manifest")
+      .Get();
+}
+
+std::string CreateLayerVersionsKey(const std::string& hrn,
+                                   const int64_t catalog_version) {
+  return olp::dataservice::read::repository::CacheKeyBuilder(hrn)
+      .Add("::")
+      .Add(catalog_version)
+      .Add("::layerVersions")
+      .Get();
 }
-std::string CreateKey(const std::string& hrn, const int64_t catalogVersion) {
-  return hrn + "::" + std::to_string(catalogVersion) + "::layerVersions";
+
+std::string CreateBaseVersionKey(const std::string& layer_prefix,
+                                 int64_t version) {
+  return olp::dataservice::read::repository::CacheKeyBuilder(layer_prefix)
+      .Add(version)
+      .Add("::base_version")
+      .Get();
 }
 
-std::string CreateKey(const std::string& hrn, const std::string& layer_id,
-                      const std::string& datahandle) {
-  return hrn + "::" + layer_id + "::" + datahandle + "::Data";
+std::string CreateDataKey(const std::string& layer_prefix,
+                          const std::string& data_handle) {
+  return olp::dataservice::read::repository::CacheKeyBuilder(layer_prefix)
+      .Add(data_handle)
+      .Add("::Data")
+      .Get();
 }
 
 time_t ConvertTime(std::chrono::seconds time) {
@@ -77,11 +119,13 @@ namespace repository {
 PartitionsCacheRepository::PartitionsCacheRepository(
     const client::HRN& catalog, const std::string& layer_id,
     std::shared_ptr<cache::KeyValueCache> cache,
-    std::chrono::seconds default_expiry)
+    std::chrono::seconds default_expiry, std::chrono::seconds max_staleness)
     : catalog_(catalog.ToCatalogHRNString()),
       layer_id_(layer_id),
+      layer_prefix_(catalog_ + "::" + layer_id_ + "::"),
       cache_(std::move(cache)),
-      default_expiry_(ConvertTime(default_expiry)) {}
+      default_expiry_(ConvertTime(default_expiry)),
+      max_staleness_(ConvertTime(max_staleness)) {}
 
 client::ApiNoResponse PartitionsCacheRepository::Put(
     const model::Partitions& partitions,
@@ -92,17 +136,9 @@ client::ApiNoResponse PartitionsCacheRepository::Put(
   partition_ids.reserve(partitions_list.size());
 
   for (const auto& partition : partitions_list) {
-    auto key =
-        CreateKey(catalog_, layer_id_, partition.GetPartition(), version);
-    OLP_SDK_LOG_DEBUG_F(kLogTag, "Put -> '%s'", key.c_str());
-
-    const auto put_result = cache_->Put(
-        key, partition, [&]() { return serializer::serialize(partition); },
-        expiry.get_value_or(default_expiry_));
-
-    if (!put_result) {
-      OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write -> '%s'", key.c_str());
-      return {{client::ErrorCode::CacheIO, "Put to cache failed"}};
+    auto put_result = Put(partition, version, expiry);
+    if (!put_result.IsSuccessful()) {
+      return put_result;
     }
 
     if (layer_metadata) {
@@ -111,32 +147,81 @@ client::ApiNoResponse PartitionsCacheRepository::Put(
   }
 
   if (layer_metadata) {
-    auto key = CreateKey(catalog_, layer_id_, version);
-    OLP_SDK_LOG_DEBUG_F(kLogTag, "Put -> '%s'", key.c_str());
+    return PutPartitionIds(partition_ids, version, expiry);
+  }
 
-    const auto put_result =
-        cache_->Put(key, partition_ids,
-                    [&]() { return serializer::serialize(partition_ids); },
-                    expiry.get_value_or(default_expiry_));
+  return {client::ApiNoResult{}};
+}
 
-    if (!put_result) {
-      OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write -> '%s'", key.c_str());
-      return {{client::ErrorCode::CacheIO, "Put to cache failed"}};
-    }
+client::ApiNoResponse PartitionsCacheRepository::Put(
+    const model::Partition& partition, const boost::optional<int64_t>& version,
+    const boost::optional<time_t>& expiry) {
+  const auto& key = CreateKey(layer_prefix_, partition.GetPartition(), version);
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Put -> '%s'", key.c_str());
+
+  const auto entry_expiry = expiry.get_value_or(default_expiry_);
+  const auto put_result = cache_->Put(
+      key, partition, [&]() { return serializer::serialize(partition); },
+      StaleExpiry(entry_expiry));
+
+  if (!put_result) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write -> '%s'", key.c_str());
+    return {{client::ErrorCode::CacheIO, "Put to cache failed"}};
   }
 
+  PutFreshness(key, entry_expiry);
+  return {client::ApiNoResult{}};
+}
+
+client::ApiNoResponse PartitionsCacheRepository::PutPartitionIds(
+    const std::vector<std::string>& partition_ids,
+    const boost::optional<int64_t>& version,
+    const boost::optional<time_t>& expiry) {
+  const auto& key = CreateKey(layer_prefix_, version);
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Put -> '%s'", key.c_str());
+
+  const auto entry_expiry = expiry.get_value_or(default_expiry_);
+  const auto put_result =
+      cache_->Put(key, partition_ids,
+                  [&]() { return serializer::serialize(partition_ids); },
+                  StaleExpiry(entry_expiry));
+
+  if (!put_result) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write -> '%s'", key.c_str());
+    return {{client::ErrorCode::CacheIO, "Put to cache failed"}};
+  }
+
+  PutFreshness(key, entry_expiry);
   return {client::ApiNoResult{}};
 }
 
 model::Partitions PartitionsCacheRepository::Get(
     const std::vector<std::string>& partition_ids,
     const boost::optional<int64_t>& version) {
+  return Get(partition_ids, version, nullptr);
+}
+
+boost::optional<model::Partitions> PartitionsCacheRepository::Get(
+    const PartitionsRequest& request, const boost::optional<int64_t>& version) {
+  return Get(request, version, nullptr);
+}
+
+boost::optional<model::Partitions> PartitionsCacheRepository::GetStale(
+    const PartitionsRequest& request, const boost::optional<int64_t>& version,
+    bool& stale) {
+  stale = false;
+  return Get(request, version, &stale);
+}
+
+model::Partitions PartitionsCacheRepository::Get(
+    const std::vector<std::string>& partition_ids,
+    const boost::optional<int64_t>& version, bool* stale) {
   model::Partitions cached_partitions_model;
   auto& cached_partitions = cached_partitions_model.GetMutablePartitions();
   cached_partitions.reserve(partition_ids.size());
 
   for (const auto& partition_id : partition_ids) {
-    auto key = CreateKey(catalog_, layer_id_, partition_id, version);
+    const auto& key = CreateKey(layer_prefix_, partition_id, version);
     OLP_SDK_LOG_DEBUG_F(kLogTag, "Get '%s'", key.c_str());
 
     auto cached_partition =
@@ -144,7 +229,7 @@ model::Partitions PartitionsCacheRepository::Get(
           return parser::parse<model::Partition>(serialized_object);
         });
 
-    if (!cached_partition.empty()) {
+    if (!cached_partition.empty() && IsUsable(key, stale)) {
       cached_partitions.emplace_back(
           boost::any_cast<model::Partition>(cached_partition));
     }
@@ -155,8 +240,9 @@ model::Partitions PartitionsCacheRepository::Get(
 }
 
 boost::optional<model::Partitions> PartitionsCacheRepository::Get(
-    const PartitionsRequest& request, const boost::optional<int64_t>& version) {
-  auto key = CreateKey(catalog_, layer_id_, version);
+    const PartitionsRequest& request, const boost::optional<int64_t>& version,
+    bool* stale) {
+  const auto& key = CreateKey(layer_prefix_, version);
   boost::optional<model::Partitions> partitions;
   const auto& partition_ids = request.GetPartitionIds();
 
@@ -166,14 +252,14 @@ boost::optional<model::Partitions> PartitionsCacheRepository::Get(
     });
 
     partitions =
-        cached_ids.empty()
+        cached_ids.empty() || !IsUsable(key, stale)
             ? boost::none
             : boost::optional<model::Partitions>(
                   Get(boost::any_cast<std::vector<std::string>>(cached_ids),
-                      version));
+                      version, stale));
 
   } else {
-    auto available_partitions = Get(partition_ids, version);
+    auto available_partitions = Get(partition_ids, version, stale);
     // In the case when not all partitions are available, we fail the cache
     // lookup. This can be enhanced in the future.
     if (available_partitions.GetPartitions().size() != partition_ids.size()) {
@@ -186,9 +272,72 @@ boost::optional<model::Partitions> PartitionsCacheRepository::Get(
   return partitions;
 }
 
+client::ApiNoResponse PartitionsCacheRepository::PutBaseVersion(
+    int64_t version, int64_t base_version) {
+  const auto& key = CreateBaseVersionKey(layer_prefix_, version);
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Put -> '%s'", key.c_str());
+
+  const auto value = std::to_string(base_version);
+  if (!cache_->Put(key,
+                   std::make_shared<cache::KeyValueCache::ValueType>(
+                       value.begin(), value.end()),
+                   default_expiry_)) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write -> '%s'", key.c_str());
+    return {{client::ErrorCode::CacheIO, "Put to cache failed"}};
+  }
+
+  return {client::ApiNoResult{}};
+}
+
+boost::optional<int64_t> PartitionsCacheRepository::GetBaseVersion(
+    const boost::optional<int64_t>& version) {
+  if (!version) {
+    return boost::none;
+  }
+
+  const auto data = cache_->Get(CreateBaseVersionKey(layer_prefix_, *version));
+  if (!data || data->empty()) {
+    return boost::none;
+  }
+
+  const std::string value(data->begin(), data->end());
+  const auto base_version = std::strtoll(value.c_str(), nullptr, 10);
+
+  // Only older versions are linked, anything else is a corrupted entry.
+  if (base_version < 0 || base_version >= *version) {
+    return boost::none;
+  }
+  return static_cast<int64_t>(base_version);
+}
+
+boost::optional<model::Partitions>
+PartitionsCacheRepository::GetFromBaseVersion(
+    const PartitionsRequest& request, const boost::optional<int64_t>& version) {
+  const auto base_version = GetBaseVersion(version);
+  if (!base_version) {
+    return boost::none;
+  }
+
+  auto partitions = Get(request, base_version);
+  if (!partitions) {
+    partitions = GetFromBaseVersion(request, base_version);
+  }
+
+  if (partitions) {
+    OLP_SDK_LOG_DEBUG_F(kLogTag,
+                        "GetFromBaseVersion, layer='%s', version=%" PRId64
+                        ", base_version=%" PRId64 ", partitions=%zu",
+                        layer_id_.c_str(), *version, *base_version,
+                        partitions->GetPartitions().size());
+    Put(*partitions, version, boost::none,
+        request.GetPartitionIds().empty());
+  }
+  return partitions;
+}
+
 void PartitionsCacheRepository::Put(
     int64_t catalog_version, const model::LayerVersions& layer_versions) {
-  const auto key = CreateKey(catalog_, catalog_version);
+  const auto& key = CreateLayerVersionsKey(catalog_, catalog_version);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "Put -> '%s'", key.c_str());
 
   cache_->Put(key, layer_versions,
@@ -198,7 +347,7 @@ void PartitionsCacheRepository::Put(
 
 boost::optional<model::LayerVersions> PartitionsCacheRepository::Get(
     int64_t catalog_version) {
-  auto key = CreateKey(catalog_, catalog_version);
+  const auto& key = CreateLayerVersionsKey(catalog_, catalog_version);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "Get -> '%s'", key.c_str());
 
   auto cached_layer_versions =
@@ -216,7 +365,7 @@ boost::optional<model::LayerVersions> PartitionsCacheRepository::Get(
 client::ApiNoResponse PartitionsCacheRepository::Put(
     geo::TileKey tile_key, int32_t depth, const QuadTreeIndex& quad_tree,
     const boost::optional<int64_t>& version) {
-  const auto key = CreateQuadKey(tile_key, depth, version);
+  const auto& key = BuildQuadKey(tile_key, depth, version);
 
   if (quad_tree.IsNull()) {
     OLP_SDK_LOG_WARNING_F(kLogTag, "Put: invalid QuadTreeIndex -> '%s'",
@@ -237,7 +386,7 @@ client::ApiNoResponse PartitionsCacheRepository::Put(
 bool PartitionsCacheRepository::Get(geo::TileKey tile_key, int32_t depth,
                                     const boost::optional<int64_t>& version,
                                     QuadTreeIndex& tree) {
-  auto key = CreateQuadKey(tile_key, depth, version);
+  const auto& key = BuildQuadKey(tile_key, depth, version);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "Get -> '%s'", key.c_str());
   auto data = cache_->Get(key);
   if (data) {
@@ -248,10 +397,36 @@ bool PartitionsCacheRepository::Get(geo::TileKey tile_key, int32_t depth,
   return false;
 }
 
+client::ApiNoResponse PartitionsCacheRepository::Put(
+    const PrefetchManifest& manifest, int64_t version) {
+  const auto& key =
+      CreatePrefetchManifestKey(layer_prefix_, manifest.GetRoot(), version);
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Put -> '%s'", key.c_str());
+
+  if (!cache_->Put(key, manifest.Serialize(), default_expiry_)) {
+    OLP_SDK_LOG_WARNING_F(kLogTag, "Failed to write -> '%s'", key.c_str());
+    return {{client::ErrorCode::CacheIO, "Put to cache failed"}};
+  }
+
+  return {client::ApiNoResult{}};
+}
+
+bool PartitionsCacheRepository::Get(geo::TileKey root, int64_t version,
+                                    PrefetchManifest& manifest) {
+  const auto& key = CreatePrefetchManifestKey(layer_prefix_, root, version);
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Get -> '%s'", key.c_str());
+  auto data = cache_->Get(key);
+  if (!data) {
+    return false;
+  }
+
+  manifest = PrefetchManifest(root, *data);
+  return true;
+}
+
 void PartitionsCacheRepository::Clear() {
-  auto key = catalog_ + "::" + layer_id_ + "::";
-  OLP_SDK_LOG_INFO_F(kLogTag, "Clear -> '%s'", key.c_str());
-  cache_->RemoveKeysWithPrefix(key);
+  OLP_SDK_LOG_INFO_F(kLogTag, "Clear -> '%s'", layer_prefix_.c_str());
+  cache_->RemoveKeysWithPrefix(layer_prefix_);
 }
 
 void PartitionsCacheRepository::ClearPartitions(
@@ -262,17 +437,17 @@ void PartitionsCacheRepository::ClearPartitions(
 
   // Partitions not processed here are not cached to begin with.
   for (const auto& partition : cached_partitions.GetPartitions()) {
-    cache_->RemoveKeysWithPrefix(catalog_ + "::" + layer_id_ +
-                                 "::" + partition.GetDataHandle());
-    cache_->RemoveKeysWithPrefix(catalog_ + "::" + layer_id_ +
-                                 "::" + partition.GetPartition());
+    cache_->RemoveKeysWithPrefix(
+        CacheKeyBuilder(layer_prefix_).Add(partition.GetDataHandle()).Get());
+    cache_->RemoveKeysWithPrefix(
+        CacheKeyBuilder(layer_prefix_).Add(partition.GetPartition()).Get());
   }
 }
 
 bool PartitionsCacheRepository::ClearQuadTree(
     geo::TileKey tile_key, int32_t depth,
     const boost::optional<int64_t>& version) {
-  const auto key = CreateQuadKey(tile_key, depth, version);
+  const auto& key = BuildQuadKey(tile_key, depth, version);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "ClearQuadTree -> '%s'", key.c_str());
   return cache_->RemoveKeysWithPrefix(key);
 }
@@ -281,7 +456,7 @@ bool PartitionsCacheRepository::ClearPartitionMetadata(
     const std::string& partition_id,
     const boost::optional<int64_t>& catalog_version,
     boost::optional<model::Partition>& out_partition) {
-  auto key = CreateKey(catalog_, layer_id_, partition_id, catalog_version);
+  const auto& key = CreateKey(layer_prefix_, partition_id, catalog_version);
   OLP_SDK_LOG_INFO_F(kLogTag, "ClearPartitionMetadata -> '%s'", key.c_str());
 
   auto cached_partition =
@@ -300,7 +475,7 @@ bool PartitionsCacheRepository::ClearPartitionMetadata(
 bool PartitionsCacheRepository::GetPartitionHandle(
     const std::string& partition_id,
     const boost::optional<int64_t>& catalog_version, std::string& data_handle) {
-  auto key = CreateKey(catalog_, layer_id_, partition_id, catalog_version);
+  const auto& key = CreateKey(layer_prefix_, partition_id, catalog_version);
   OLP_SDK_LOG_DEBUG_F(kLogTag, "IsPartitionCached -> '%s'", key.c_str());
   auto cached_partition =
       cache_->Get(key, [](const std::string& serialized_object) {
@@ -318,9 +493,19 @@ bool PartitionsCacheRepository::GetPartitionHandle(
 std::string PartitionsCacheRepository::CreateQuadKey(
     geo::TileKey key, int32_t depth,
     const boost::optional<int64_t>& version) const {
-  return catalog_ + "::" + layer_id_ + "::" + key.ToHereTile() +
-         "::" + (version ? std::to_string(*version) + "::" : "") +
-         std::to_string(depth) + "::quadtree";
+  return BuildQuadKey(key, depth, version);
+}
+
+const std::string& PartitionsCacheRepository::BuildQuadKey(
+    geo::TileKey key, int32_t depth,
+    const boost::optional<int64_t>& version) const {
+  return CacheKeyBuilder(layer_prefix_)
+      .Add(key)
+      .Add("::")
+      .AddVersion(version)
+      .Add(depth)
+      .Add("::quadtree")
+      .Get();
 }
 
 bool PartitionsCacheRepository::FindQuadTree(geo::TileKey key,
@@ -346,10 +531,71 @@ bool PartitionsCacheRepository::FindQuadTree(geo::TileKey key,
   return false;
 }
 
+bool PartitionsCacheRepository::FindQuadTreeInBaseVersion(
+    geo::TileKey key, const boost::optional<int64_t>& version,
+    read::QuadTreeIndex& tree) {
+  const auto base_version = GetBaseVersion(version);
+  if (!base_version) {
+    return false;
+  }
+
+  if (!FindQuadTree(key, base_version, tree) &&
+      !FindQuadTreeInBaseVersion(key, base_version, tree)) {
+    return false;
+  }
+
+  Put(tree.GetRootTile(), kMaxQuadTreeIndexDepth, tree, version);
+  return true;
+}
+
 bool PartitionsCacheRepository::ContainsTree(
     geo::TileKey key, int32_t depth,
     const boost::optional<int64_t>& version) const {
-  return cache_->Contains(CreateQuadKey(key, depth, version));
+  return cache_->Contains(BuildQuadKey(key, depth, version));
+}
+
+time_t PartitionsCacheRepository::StaleExpiry(time_t expiry) const {
+  if (max_staleness_ == 0 || expiry == kTimetMax) {
+    return expiry;
+  }
+
+  return max_staleness_ < kTimetMax - expiry ? expiry + max_staleness_
+                                             : kTimetMax;
+}
+
+void PartitionsCacheRepository::PutFreshness(const std::string& key,
+                                             time_t expiry) {
+  if (max_staleness_ == 0 || expiry == kTimetMax) {
+    return;
+  }
+
+  CacheValidators freshness;
+  freshness.fresh_until = std::time(nullptr) + expiry;
+  cache_->Put(key + kFreshnessSuffix, freshness.Serialize(),
+              StaleExpiry(expiry));
+}
+
+bool PartitionsCacheRepository::IsUsable(const std::string& key,
+                                         bool* stale) {
+  // The freshness is stored only if the stale entries are kept.
+  if (max_staleness_ == 0) {
+    return true;
+  }
+
+  const auto value = cache_->Get(key + kFreshnessSuffix);
+  const auto freshness =
+      value ? CacheValidators::Parse(*value) : boost::none;
+  if (!freshness || freshness->IsFresh()) {
+    return true;
+  }
+
+  if (!stale ||
+      std::time(nullptr) - freshness->fresh_until >= max_staleness_) {
+    return false;
+  }
+
+  *stale = true;
+  return true;
 }
 
 cache::KeyValueCache::KeyListType
@@ -358,9 +604,11 @@ PartitionsCacheRepository::CreatePartitionKeys(
   std::string handle;
 
   if (GetPartitionHandle(partition_id, version, handle)) {
-    return cache::KeyValueCache::KeyListType{
-        CreateKey(catalog_, layer_id_, partition_id, version),
-        CreateKey(catalog_, layer_id_, handle)};
+    cache::KeyValueCache::KeyListType keys;
+    keys.reserve(2);
+    keys.push_back(CreateKey(layer_prefix_, partition_id, version));
+    keys.push_back(CreateDataKey(layer_prefix_, handle));
+    return keys;
   }
 
   return {};
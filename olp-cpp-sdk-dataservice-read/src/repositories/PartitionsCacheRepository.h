@@ -38,12 +38,15 @@ namespace dataservice {
 namespace read {
 namespace repository {
 
+class PrefetchManifest;
+
 class PartitionsCacheRepository final {
  public:
   PartitionsCacheRepository(
       const client::HRN& catalog, const std::string& layer_id,
       std::shared_ptr<cache::KeyValueCache> cache,
-      std::chrono::seconds default_expiry = std::chrono::seconds::max());
+      std::chrono::seconds default_expiry = std::chrono::seconds::max(),
+      std::chrono::seconds max_staleness = std::chrono::seconds::zero());
 
   ~PartitionsCacheRepository() = default;
 
@@ -52,6 +55,16 @@ class PartitionsCacheRepository final {
                             const boost::optional<time_t>& expiry,
                             bool layer_metadata = false);
 
+  client::ApiNoResponse Put(const model::Partition& partition,
+                            const boost::optional<int64_t>& version,
+                            const boost::optional<time_t>& expiry);
+
+  /// Stores the list of all partitions of the layer.
+  client::ApiNoResponse PutPartitionIds(
+      const std::vector<std::string>& partition_ids,
+      const boost::optional<int64_t>& version,
+      const boost::optional<time_t>& expiry);
+
   model::Partitions Get(const std::vector<std::string>& partition_ids,
                         const boost::optional<int64_t>& version);
 
@@ -59,6 +72,24 @@ class PartitionsCacheRepository final {
       const PartitionsRequest& request,
       const boost::optional<int64_t>& version);
 
+  /// Gets the partitions, also the ones that are stale for less than the max
+  /// staleness. Sets `stale` if any of the partitions is stale.
+  boost::optional<model::Partitions> GetStale(
+      const PartitionsRequest& request,
+      const boost::optional<int64_t>& version, bool& stale);
+
+  /// Marks the layer as unchanged between the base version and the version,
+  /// so the entries of the base version can be used by the version.
+  client::ApiNoResponse PutBaseVersion(int64_t version, int64_t base_version);
+
+  boost::optional<int64_t> GetBaseVersion(
+      const boost::optional<int64_t>& version);
+
+  /// Copies the partitions from the base version, see `PutBaseVersion`.
+  boost::optional<model::Partitions> GetFromBaseVersion(
+      const PartitionsRequest& request,
+      const boost::optional<int64_t>& version);
+
   void Put(int64_t catalog_version, const model::LayerVersions& layer_versions);
 
   boost::optional<model::LayerVersions> Get(int64_t catalog_version);
@@ -70,6 +101,10 @@ class PartitionsCacheRepository final {
   bool Get(geo::TileKey tile_key, int32_t depth,
            const boost::optional<int64_t>& version, QuadTreeIndex& tree);
 
+  client::ApiNoResponse Put(const PrefetchManifest& manifest, int64_t version);
+
+  bool Get(geo::TileKey root, int64_t version, PrefetchManifest& manifest);
+
   void Clear();
 
   void ClearPartitions(const std::vector<std::string>& partition_ids,
@@ -92,6 +127,11 @@ class PartitionsCacheRepository final {
   bool FindQuadTree(geo::TileKey key, boost::optional<int64_t> version,
                     read::QuadTreeIndex& tree);
 
+  /// Copies the quad tree from the base version, see `PutBaseVersion`.
+  bool FindQuadTreeInBaseVersion(geo::TileKey key,
+                                 const boost::optional<int64_t>& version,
+                                 read::QuadTreeIndex& tree);
+
   bool ContainsTree(geo::TileKey key, int32_t depth,
                     const boost::optional<int64_t>& version) const;
 
@@ -102,13 +142,38 @@ class PartitionsCacheRepository final {
                const boost::optional<int64_t>& version);
 
  private:
+  model::Partitions Get(const std::vector<std::string>& partition_ids,
+                        const boost::optional<int64_t>& version, bool* stale);
+
+  boost::optional<model::Partitions> Get(
+      const PartitionsRequest& request,
+      const boost::optional<int64_t>& version, bool* stale);
+
+  // The entries that expire are kept for the max staleness after that.
+  time_t StaleExpiry(time_t expiry) const;
+
+  // Stores when the entry becomes stale, if it is kept after that.
+  void PutFreshness(const std::string& key, time_t expiry);
+
+  // Checks whether the cached entry is fresh. The stale entry is also
+  // accepted if `stale` is not null, which is then set to true.
+  bool IsUsable(const std::string& key, bool* stale);
+
   cache::KeyValueCache::KeyListType CreatePartitionKeys(
       const std::string& partition_id, const boost::optional<int64_t>& version);
 
+  // Returns the key in the buffer of the calling thread.
+  const std::string& BuildQuadKey(
+      geo::TileKey key, int32_t depth,
+      const boost::optional<int64_t>& version) const;
+
   const std::string catalog_;
   const std::string layer_id_;
+  // The common prefix of the layer keys, "<catalog>::<layer>::".
+  const std::string layer_prefix_;
   std::shared_ptr<cache::KeyValueCache> cache_;
   time_t default_expiry_;
+  time_t max_staleness_;
 };
 }  // namespace repository
 }  // namespace read
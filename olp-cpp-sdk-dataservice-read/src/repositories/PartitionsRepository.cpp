@@ -20,13 +20,20 @@
 #include "PartitionsRepository.h"
 
 #include <algorithm>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include <boost/functional/hash.hpp>
 
 #include <olp/core/client/Condition.h>
 #include <olp/core/logging/Log.h>
+#include <olp/core/tracing/Tracer.h>
 #include "CatalogRepository.h"
+#include "Common.h"
+#include "ShardedPartitionsLoader.h"
+#include "StaleEntryRefresher.h"
 #include "generated/api/MetadataApi.h"
 #include "generated/api/QueryApi.h"
 #include "olp/dataservice/read/CatalogRequest.h"
@@ -63,6 +70,94 @@ client::ApiResponse<boost::optional<time_t>, client::ApiError> TtlForLayer(
   return ttl ? boost::make_optional<time_t>(ttl.value() / 1000) : boost::none;
 }
 
+boost::optional<int64_t> FindLayerVersion(
+    const model::LayerVersions& layer_versions, const std::string& layer_id) {
+  const auto& versions = layer_versions.GetLayerVersions();
+  auto it = std::find_if(versions.begin(), versions.end(),
+                         [&](const model::LayerVersion& layer_version) {
+                           return layer_version.GetLayer() == layer_id;
+                         });
+  if (it == versions.end()) {
+    return boost::none;
+  }
+  return it->GetVersion();
+}
+
+// Copies the cached quad trees that are the same in both versions. Returns
+// the number of copied trees.
+size_t CopyUnchangedQuadTrees(repository::PartitionsCacheRepository& cache,
+                              const model::Partitions& partitions,
+                              const read::UpgradeToVersionResult& result) {
+  std::set<olp::geo::TileKey> changed_tiles;
+  for (const auto& partition : result.GetChangedPartitions()) {
+    changed_tiles.insert(olp::geo::TileKey::FromHereTile(partition));
+  }
+
+  // The roots of the trees that contain added or changed subquads.
+  std::set<olp::geo::TileKey> changed_roots;
+  for (const auto& tile : changed_tiles) {
+    if (!tile.IsValid()) {
+      return 0u;
+    }
+    const auto depth = std::min<int>(tile.Level(), kAggregateQuadTreeDepth);
+    for (auto i = 0; i <= depth; ++i) {
+      changed_roots.insert(tile.ChangedLevelBy(-i));
+    }
+  }
+
+  std::unordered_map<std::string, std::string> data_handles;
+  std::set<olp::geo::TileKey> roots;
+  for (const auto& partition : partitions.GetPartitions()) {
+    const auto tile = olp::geo::TileKey::FromHereTile(partition.GetPartition());
+    if (!tile.IsValid()) {
+      return 0u;
+    }
+    data_handles[partition.GetPartition()] = partition.GetDataHandle();
+    const auto depth = std::min<int>(tile.Level(), kAggregateQuadTreeDepth);
+    for (auto i = 0; i <= depth; ++i) {
+      roots.insert(tile.ChangedLevelBy(-i));
+    }
+  }
+
+  auto is_unchanged = [&](const read::QuadTreeIndex& tree) {
+    for (const auto& index_data : tree.GetIndexData()) {
+      auto it = data_handles.find(index_data.tile_key.ToHereTile());
+      if (it == data_handles.end() || it->second != index_data.data_handle) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  const auto from_version = result.GetFromVersion();
+  const auto to_version = result.GetToVersion();
+  size_t copied_trees = 0u;
+
+  for (const auto& root : roots) {
+    if (changed_roots.count(root) > 0 ||
+        cache.ContainsTree(root, kAggregateQuadTreeDepth, to_version)) {
+      continue;
+    }
+
+    // The trees also contain the parents of the root tile.
+    auto changed_parent = false;
+    for (auto parent = root; parent.Level() > 0 && !changed_parent;) {
+      parent = parent.Parent();
+      changed_parent = changed_tiles.count(parent) > 0;
+    }
+
+    read::QuadTreeIndex tree;
+    if (!changed_parent &&
+        cache.Get(root, kAggregateQuadTreeDepth, from_version, tree) &&
+        is_unchanged(tree)) {
+      cache.Put(root, kAggregateQuadTreeDepth, tree, to_version);
+      ++copied_trees;
+    }
+  }
+
+  return copied_trees;
+}
+
 repository::PartitionResponse FindPartition(
     const read::QuadTreeIndex& quad_tree, const read::TileRequest& request,
     bool aggregated) {
@@ -93,6 +188,36 @@ repository::PartitionResponse FindPartition(
   return std::move(aggregated_partition);
 }
 
+read::PartitionsRequest::AdditionalFields PartitionByIdFields(
+    const read::DataRequest& request) {
+  read::PartitionsRequest::AdditionalFields additional_fields;
+  if (request.GetChecksumVerificationEnabled()) {
+    additional_fields.emplace_back(read::PartitionsRequest::kChecksum);
+  }
+  return additional_fields;
+}
+
+// The partitions cached without the checksum field cannot be verified.
+bool HasRequestedChecksum(const read::DataRequest& request,
+                          const model::Partitions& partitions) {
+  if (!request.GetChecksumVerificationEnabled()) {
+    return true;
+  }
+  const auto& list = partitions.GetPartitions();
+  return std::all_of(list.begin(), list.end(),
+                     [](const model::Partition& partition) {
+                       return static_cast<bool>(partition.GetChecksum());
+                     });
+}
+
+repository::SharedQuadTreeIndexResponse ShareQuadTree(
+    repository::QuadTreeIndexResponse response) {
+  if (!response.IsSuccessful()) {
+    return response.GetError();
+  }
+  return std::make_shared<const read::QuadTreeIndex>(response.MoveResult());
+}
+
 std::string HashPartitions(
     const read::PartitionsRequest::PartitionIds& partitions) {
   size_t seed = 0;
@@ -113,14 +238,16 @@ PartitionsRepository::PartitionsRepository(client::HRN catalog,
                                            std::string layer,
                                            client::OlpClientSettings settings,
                                            client::ApiLookupClient client,
-                                           NamedMutexStorage storage)
+                                           NamedMutexStorage storage,
+                                           TaskSink* task_sink)
     : catalog_(std::move(catalog)),
       layer_id_(std::move(layer)),
       settings_(std::move(settings)),
       lookup_client_(std::move(client)),
       cache_(catalog_, layer_id_, settings_.cache,
-             settings_.default_cache_expiration),
-      storage_(std::move(storage)) {}
+             settings_.default_cache_expiration, settings_.max_staleness),
+      storage_(std::move(storage)),
+      task_sink_(task_sink) {}
 
 QueryApi::PartitionsExtendedResponse
 PartitionsRepository::GetVersionedPartitionsExtendedResponse(
@@ -130,6 +257,113 @@ PartitionsRepository::GetVersionedPartitionsExtendedResponse(
                                        boost::none, fail_on_cache_error);
 }
 
+client::ApiNoResponse PartitionsRepository::StreamVersionedPartitions(
+    const read::PartitionsRequest& request, std::int64_t version,
+    const PartitionsStreamCallback& callback,
+    client::CancellationContext context) {
+  // The requested partitions are few, no need to stream them.
+  if (!request.GetPartitionIds().empty()) {
+    auto response =
+        GetPartitionsExtendedResponse(request, version, std::move(context));
+    if (!response.IsSuccessful()) {
+      return response.GetError();
+    }
+    for (const auto& partition : response.GetResult().GetPartitions()) {
+      callback(partition);
+    }
+    return client::ApiNoResult{};
+  }
+
+  const auto fetch_option = request.GetFetchOption();
+  const auto catalog_str = catalog_.ToCatalogHRNString();
+  const auto key = request.CreateKey(layer_id_, version);
+
+  tracing::Span span("PartitionsRepository::StreamVersionedPartitions", [&] {
+    return tracing::SpanAttributes()
+        .WithCatalog(catalog_str)
+        .WithLayer(layer_id_);
+  });
+
+  if (fetch_option != OnlineOnly) {
+    auto cached_partitions = cache_.Get(request, version);
+    if (!cached_partitions) {
+      cached_partitions = cache_.GetFromBaseVersion(request, version);
+    }
+    if (cached_partitions) {
+      OLP_SDK_LOG_DEBUG_F(kLogTag,
+                          "StreamPartitions found in cache, hrn='%s', key='%s'",
+                          catalog_str.c_str(), key.c_str());
+      for (auto& partition : cached_partitions->GetMutablePartitions()) {
+        callback(std::move(partition));
+      }
+      return client::ApiNoResult{};
+    } else if (fetch_option == CacheOnly) {
+      OLP_SDK_LOG_INFO_F(
+          kLogTag, "StreamPartitions not found in cache, hrn='%s', key='%s'",
+          catalog_str.c_str(), key.c_str());
+      return {{client::ErrorCode::NotFound,
+               "CacheOnly: resource not found in cache"}};
+    }
+  }
+
+  auto metadata_api = lookup_client_.LookupApi(
+      "metadata", "v1", static_cast<client::FetchOptions>(fetch_option),
+      context);
+
+  if (!metadata_api.IsSuccessful()) {
+    return metadata_api.GetError();
+  }
+
+  // The partitions are written to the cache as they are parsed. The list of
+  // the layer partitions is written only if all partitions are stored.
+  bool write_to_cache = fetch_option != OnlineOnly;
+  std::vector<std::string> partition_ids;
+
+  auto response = MetadataApi::GetPartitionsStream(
+      metadata_api.GetResult(), layer_id_, version,
+      request.GetAdditionalFields(), request.GetBillingTag(),
+      [&](model::Partition partition) {
+        if (context.IsCancelled()) {
+          return false;
+        }
+
+        if (write_to_cache) {
+          if (cache_.Put(partition, version, boost::none).IsSuccessful()) {
+            partition_ids.push_back(partition.GetPartition());
+          } else {
+            write_to_cache = false;
+            partition_ids.clear();
+          }
+        }
+
+        callback(std::move(partition));
+        return true;
+      },
+      context);
+
+  if (!response.IsSuccessful()) {
+    const auto& error = response.GetError();
+    if (error.GetHttpStatusCode() == http::HttpStatusCode::FORBIDDEN) {
+      OLP_SDK_LOG_WARNING_F(
+          kLogTag,
+          "StreamPartitions 403 received, remove from cache, hrn='%s', "
+          "key='%s'",
+          catalog_str.c_str(), key.c_str());
+      cache_.Clear();
+    }
+    return error;
+  }
+
+  if (write_to_cache) {
+    OLP_SDK_LOG_DEBUG_F(kLogTag,
+                        "StreamPartitions put to cache, hrn='%s', key='%s'",
+                        catalog_str.c_str(), key.c_str());
+    cache_.PutPartitionIds(partition_ids, version, boost::none);
+  }
+
+  return client::ApiNoResult{};
+}
+
 PartitionsResponse PartitionsRepository::GetVersionedPartitions(
     const PartitionsRequest& request, int64_t version,
     client::CancellationContext context) {
@@ -142,7 +376,8 @@ PartitionsResponse PartitionsRepository::GetVolatilePartitions(
                              .WithBillingTag(request.GetBillingTag())
                              .WithFetchOption(request.GetFetchOption());
 
-  CatalogRepository repository(catalog_, settings_, lookup_client_);
+  CatalogRepository repository(catalog_, settings_, lookup_client_,
+                               task_sink_);
   auto catalog_response = repository.GetCatalog(catalog_request, context);
 
   if (!catalog_response.IsSuccessful()) {
@@ -176,8 +411,42 @@ PartitionsRepository::GetPartitionsExtendedResponse(
   const auto detail =
       partition_ids.empty() ? "" : HashPartitions(partition_ids);
   const auto version_str = version ? std::to_string(*version) : "";
+  const auto request_key = catalog_str + layer_id_ + version_str + detail;
+
+  tracing::Span span("PartitionsRepository::GetPartitions", [&] {
+    return tracing::SpanAttributes()
+        .WithRequestId(request_key)
+        .WithCatalog(catalog_str)
+        .WithLayer(layer_id_);
+  });
+
+  // The cached partitions are returned without waiting for the requests in
+  // flight, the stale ones are refreshed in the background.
+  if (fetch_option == StaleWhileRevalidate) {
+    bool stale = false;
+    auto cached_partitions = cache_.GetStale(request, version, stale);
+    if (cached_partitions) {
+      OLP_SDK_LOG_DEBUG_F(
+          kLogTag, "GetPartitions found in cache, hrn='%s', key='%s', stale=%s",
+          catalog_str.c_str(), key.c_str(), stale ? "true" : "false");
+
+      if (stale) {
+        auto refresh_request = request;
+        refresh_request.WithFetchOption(OnlineIfNotFound);
+        auto self = *this;
+        StaleEntryRefresher::Instance().Refresh(
+            settings_, task_sink_, request_key,
+            [=](client::CancellationContext refresh_context) mutable {
+              self.GetPartitionsExtendedResponse(
+                  refresh_request, version, std::move(refresh_context),
+                  expiry);
+            });
+      }
+      return std::move(*cached_partitions);
+    }
+  }
 
-  NamedMutex mutex(storage_, catalog_str + layer_id_ + version_str + detail);
+  NamedMutex mutex(storage_, request_key);
   std::unique_lock<NamedMutex> lock(mutex, std::defer_lock);
 
   // If we are not planning to go online or access the cache, do not lock.
@@ -187,6 +456,9 @@ PartitionsRepository::GetPartitionsExtendedResponse(
 
   if (fetch_option != OnlineOnly && fetch_option != CacheWithUpdate) {
     auto cached_partitions = cache_.Get(request, version);
+    if (!cached_partitions) {
+      cached_partitions = cache_.GetFromBaseVersion(request, version);
+    }
     if (cached_partitions) {
       OLP_SDK_LOG_DEBUG_F(kLogTag,
                           "GetPartitions found in cache, hrn='%s', key='%s'",
@@ -212,10 +484,18 @@ PartitionsRepository::GetPartitionsExtendedResponse(
       return metadata_api.GetError();
     }
 
-    response =
-        MetadataApi::GetPartitions(metadata_api.GetResult(), layer_id_, version,
-                                   request.GetAdditionalFields(), boost::none,
-                                   request.GetBillingTag(), context);
+    if (version && request.GetShardCount() > 1u) {
+      ShardedPartitionsLoader loader(metadata_api.GetResult(), layer_id_,
+                                     request.GetShardCount(),
+                                     settings_.task_scheduler);
+      response = loader.Load(*version, request.GetAdditionalFields(),
+                             request.GetBillingTag(), context);
+    } else {
+      response = MetadataApi::GetPartitions(
+          metadata_api.GetResult(), layer_id_, version,
+          request.GetAdditionalFields(), boost::none, request.GetBillingTag(),
+          context);
+    }
   } else {
     auto query_api = lookup_client_.LookupApi(
         "query", "v1", static_cast<client::FetchOptions>(fetch_option),
@@ -278,6 +558,23 @@ PartitionsResponse PartitionsRepository::GetPartitionById(
   const auto request_key =
       catalog_.ToString() + request.CreateKey(layer_id_, version);
 
+  tracing::Span span("PartitionsRepository::GetPartitionById", [&] {
+    return tracing::SpanAttributes()
+        .WithRequestId(request_key)
+        .WithCatalog(catalog_.ToCatalogHRNString())
+        .WithLayer(layer_id_)
+        .WithPartition(*partition_id);
+  });
+
+  // The cached partition is returned without waiting for the requests in
+  // flight, the stale one is refreshed in the background.
+  if (fetch_option == StaleWhileRevalidate) {
+    auto cached_partitions = GetStalePartitionById(request, version);
+    if (cached_partitions) {
+      return std::move(*cached_partitions);
+    }
+  }
+
   NamedMutex mutex(storage_, request_key);
   std::unique_lock<repository::NamedMutex> lock(mutex, std::defer_lock);
 
@@ -286,25 +583,9 @@ PartitionsResponse PartitionsRepository::GetPartitionById(
     lock.lock();
   }
 
-  std::chrono::seconds timeout{settings_.retry_settings.timeout};
-  const auto key = request.CreateKey(layer_id_, version);
-
-  const std::vector<std::string> partitions{partition_id.value()};
-
-  if (fetch_option != OnlineOnly && fetch_option != CacheWithUpdate) {
-    auto cached_partitions = cache_.Get(partitions, version);
-    if (cached_partitions.GetPartitions().size() == partitions.size()) {
-      OLP_SDK_LOG_DEBUG_F(kLogTag,
-                          "GetPartitionById found in cache, hrn='%s', key='%s'",
-                          catalog_.ToCatalogHRNString().c_str(), key.c_str());
-      return cached_partitions;
-    } else if (fetch_option == CacheOnly) {
-      OLP_SDK_LOG_INFO_F(
-          kLogTag, "GetPartitionById not found in cache, hrn='%s', key='%s'",
-          catalog_.ToCatalogHRNString().c_str(), key.c_str());
-      return {{client::ErrorCode::NotFound,
-               "CacheOnly: resource not found in cache"}};
-    }
+  auto cached_response = FindCachedPartitionById(request, version);
+  if (cached_response) {
+    return std::move(*cached_response);
   }
 
   auto query_api = lookup_client_.LookupApi(
@@ -316,28 +597,176 @@ PartitionsResponse PartitionsRepository::GetPartitionById(
 
   const client::OlpClient& client = query_api.GetResult();
 
-  PartitionsResponse query_response =
-      QueryApi::GetPartitionsbyId(client, layer_id_, partitions, version, {},
-                                  request.GetBillingTag(), context);
+  PartitionsResponse query_response = QueryApi::GetPartitionsbyId(
+      client, layer_id_, {partition_id.value()}, version,
+      PartitionByIdFields(request), request.GetBillingTag(), context);
+
+  StorePartitionById(query_response, request, version);
+  return query_response;
+}
+
+void PartitionsRepository::GetPartitionByIdAsync(
+    const DataRequest& request, boost::optional<int64_t> version,
+    client::CancellationContext context, PartitionsResponseCallback callback) {
+  const auto& partition_id = request.GetPartitionId();
+  if (!partition_id) {
+    callback({{client::ErrorCode::PreconditionFailed,
+               "Partition Id is missing"}});
+    return;
+  }
+
+  const auto fetch_option = request.GetFetchOption();
+  if (fetch_option == StaleWhileRevalidate) {
+    auto cached_partitions = GetStalePartitionById(request, version);
+    if (cached_partitions) {
+      callback(std::move(*cached_partitions));
+      return;
+    }
+  }
+
+  auto self = *this;
+  auto send = [=](PartitionsResponseCallback send_callback) mutable {
+    auto cached_response = self.FindCachedPartitionById(request, version);
+    if (cached_response) {
+      send_callback(std::move(*cached_response));
+      return;
+    }
+
+    auto on_lookup = [=](client::ApiLookupClient::LookupApiResponse
+                             lookup_response) mutable {
+      if (!lookup_response.IsSuccessful()) {
+        send_callback(lookup_response.GetError());
+        return;
+      }
+
+      const auto query_client = lookup_response.MoveResult();
+      ExecuteAsync<QueryApi::PartitionsExtendedResponse>(
+          context,
+          [&](QueryApi::PartitionsExtendedCallback on_partitions) {
+            return QueryApi::GetPartitionsbyId(
+                query_client, self.layer_id_,
+                {request.GetPartitionId().value()}, version,
+                PartitionByIdFields(request), request.GetBillingTag(),
+                std::move(on_partitions));
+          },
+          [=](QueryApi::PartitionsExtendedResponse response) mutable {
+            PartitionsResponse query_response = std::move(response);
+            self.StorePartitionById(query_response, request, version);
+            send_callback(std::move(query_response));
+          });
+    };
+
+    LookupApiAsync(self.lookup_client_, "query", fetch_option, context,
+                   std::move(on_lookup));
+  };
+
+  SendOrJoin<PartitionsResponse>(
+      storage_, catalog_.ToString() + request.CreateKey(layer_id_, version),
+      fetch_option, std::move(context), std::move(send), std::move(callback));
+}
+
+boost::optional<model::Partitions> PartitionsRepository::GetStalePartitionById(
+    const DataRequest& request, boost::optional<int64_t> version) {
+  const std::vector<std::string> partitions{request.GetPartitionId().value()};
+
+  bool stale = false;
+  auto cached_partitions = cache_.GetStale(
+      PartitionsRequest().WithPartitionIds(partitions), version, stale);
+  if (!cached_partitions ||
+      !HasRequestedChecksum(request, *cached_partitions)) {
+    return boost::none;
+  }
+
+  OLP_SDK_LOG_DEBUG_F(kLogTag,
+                      "GetPartitionById found in cache, hrn='%s', "
+                      "key='%s', stale=%s",
+                      catalog_.ToCatalogHRNString().c_str(),
+                      request.CreateKey(layer_id_, version).c_str(),
+                      stale ? "true" : "false");
+
+  if (stale) {
+    auto refresh_request = request;
+    refresh_request.WithFetchOption(OnlineIfNotFound);
+    auto self = *this;
+    StaleEntryRefresher::Instance().Refresh(
+        settings_, task_sink_,
+        catalog_.ToString() + request.CreateKey(layer_id_, version),
+        [=](client::CancellationContext refresh_context) mutable {
+          self.GetPartitionById(refresh_request, version,
+                                std::move(refresh_context));
+        });
+  }
+  return cached_partitions;
+}
+
+boost::optional<PartitionsResponse>
+PartitionsRepository::FindCachedPartitionById(
+    const DataRequest& request, boost::optional<int64_t> version) {
+  const auto fetch_option = request.GetFetchOption();
+  if (fetch_option == OnlineOnly || fetch_option == CacheWithUpdate) {
+    return boost::none;
+  }
+
+  const auto key = request.CreateKey(layer_id_, version);
+  const std::vector<std::string> partitions{request.GetPartitionId().value()};
+
+  auto cached_partitions = cache_.Get(partitions, version);
+  if (cached_partitions.GetPartitions().size() != partitions.size()) {
+    auto base_partitions = cache_.GetFromBaseVersion(
+        PartitionsRequest().WithPartitionIds(partitions), version);
+    if (base_partitions) {
+      cached_partitions = std::move(*base_partitions);
+    }
+  }
+  if (cached_partitions.GetPartitions().size() == partitions.size() &&
+      HasRequestedChecksum(request, cached_partitions)) {
+    OLP_SDK_LOG_DEBUG_F(kLogTag,
+                        "GetPartitionById found in cache, hrn='%s', key='%s'",
+                        catalog_.ToCatalogHRNString().c_str(), key.c_str());
+    return PartitionsResponse(std::move(cached_partitions));
+  } else if (fetch_option == CacheOnly) {
+    OLP_SDK_LOG_INFO_F(
+        kLogTag, "GetPartitionById not found in cache, hrn='%s', key='%s'",
+        catalog_.ToCatalogHRNString().c_str(), key.c_str());
+    return PartitionsResponse(client::ApiError(
+        client::ErrorCode::NotFound, "CacheOnly: resource not found in cache"));
+  }
+  return boost::none;
+}
 
-  if (query_response.IsSuccessful() && fetch_option != OnlineOnly) {
+void PartitionsRepository::StorePartitionById(
+    const PartitionsResponse& response, const DataRequest& request,
+    boost::optional<int64_t> version) {
+  const auto key = request.CreateKey(layer_id_, version);
+  if (response.IsSuccessful() && request.GetFetchOption() != OnlineOnly) {
     OLP_SDK_LOG_DEBUG_F(kLogTag,
                         "GetPartitionById put to cache, hrn='%s', key='%s'",
                         catalog_.ToCatalogHRNString().c_str(), key.c_str());
-    cache_.Put(query_response.GetResult(), version, boost::none);
-  } else if (!query_response.IsSuccessful()) {
-    const auto& error = query_response.GetError();
+    if (!request.GetChecksumVerificationEnabled()) {
+      cache_.Put(response.GetResult(), version, boost::none);
+      return;
+    }
+
+    // The partitions that have no checksum in the service are stored with
+    // the empty one, so they are not requested again.
+    auto partitions = response.GetResult();
+    for (auto& partition : partitions.GetMutablePartitions()) {
+      if (!partition.GetChecksum()) {
+        partition.SetChecksum(std::string());
+      }
+    }
+    cache_.Put(partitions, version, boost::none);
+  } else if (!response.IsSuccessful()) {
+    const auto& error = response.GetError();
     if (error.GetHttpStatusCode() == http::HttpStatusCode::FORBIDDEN) {
       OLP_SDK_LOG_WARNING_F(kLogTag,
                             "GetPartitionById 403 received, remove from cache, "
                             "hrn='%s', key='%s'",
                             catalog_.ToCatalogHRNString().c_str(), key.c_str());
       // Delete partitions only but not the layer
-      cache_.ClearPartitions(partitions, version);
+      cache_.ClearPartitions({request.GetPartitionId().value()}, version);
     }
   }
-
-  return query_response;
 }
 
 model::Partition PartitionsRepository::PartitionFromSubQuad(
@@ -364,6 +793,14 @@ QuadTreeIndexResponse PartitionsRepository::GetQuadTreeIndexForTile(
   const auto quad_cache_key =
       cache_.CreateQuadKey(root_tile_key, kAggregateQuadTreeDepth, version);
 
+  tracing::Span span("PartitionsRepository::GetQuadTreeIndexForTile", [&] {
+    return tracing::SpanAttributes()
+        .WithRequestId(quad_cache_key)
+        .WithCatalog(catalog_.ToCatalogHRNString())
+        .WithLayer(layer_id_)
+        .WithPartition(tile_key.ToHereTile());
+  });
+
   NamedMutex mutex(storage_, quad_cache_key);
   std::unique_lock<NamedMutex> lock(mutex, std::defer_lock);
 
@@ -373,23 +810,9 @@ QuadTreeIndexResponse PartitionsRepository::GetQuadTreeIndexForTile(
   }
 
   // Look for QuadTree covering the tile in the cache
-  if (fetch_option != OnlineOnly && fetch_option != CacheWithUpdate) {
-    read::QuadTreeIndex cached_tree;
-    if (cache_.FindQuadTree(tile_key, version, cached_tree)) {
-      OLP_SDK_LOG_DEBUG_F(kLogTag,
-                          "GetQuadTreeIndexForTile found in cache, "
-                          "tile='%s', depth='%" PRId32 "'",
-                          tile_key.ToHereTile().c_str(),
-                          kAggregateQuadTreeDepth);
-
-      return {std::move(cached_tree)};
-    } else if (fetch_option == CacheOnly) {
-      OLP_SDK_LOG_INFO_F(
-          kLogTag, "GetQuadTreeIndexForTile not found in cache, tile='%s'",
-          tile_key.ToHereTile().c_str());
-      return {{client::ErrorCode::NotFound,
-               "CacheOnly: resource not found in cache"}};
-    }
+  auto cached_tree = FindCachedQuadTree(request, version);
+  if (cached_tree) {
+    return std::move(*cached_tree);
   }
 
   // quad tree data not found in the cache
@@ -408,7 +831,97 @@ QuadTreeIndexResponse PartitionsRepository::GetQuadTreeIndexForTile(
       query_api.GetResult(), layer_id_, root_tile_here, version,
       kAggregateQuadTreeDepth, boost::none, request.GetBillingTag(), context);
 
-  if (quadtree_response.status != olp::http::HttpStatusCode::OK) {
+  return StoreQuadTree(std::move(quadtree_response), request, version);
+}
+
+void PartitionsRepository::GetQuadTreeIndexForTileAsync(
+    const TileRequest& request, boost::optional<int64_t> version,
+    client::CancellationContext context, SharedQuadTreeIndexCallback callback) {
+  const auto fetch_option = request.GetFetchOption();
+  const auto root_tile_key =
+      request.GetTileKey().ChangedLevelBy(-kAggregateQuadTreeDepth);
+
+  auto self = *this;
+  auto send = [=](SharedQuadTreeIndexCallback send_callback) mutable {
+    auto cached_tree = self.FindCachedQuadTree(request, version);
+    if (cached_tree) {
+      send_callback(ShareQuadTree(std::move(*cached_tree)));
+      return;
+    }
+
+    auto on_lookup = [=](client::ApiLookupClient::LookupApiResponse
+                             lookup_response) mutable {
+      if (!lookup_response.IsSuccessful()) {
+        OLP_SDK_LOG_WARNING_F(kLogTag,
+                              "GetQuadTreeIndexForTile LookupApi failed, "
+                              "hrn='%s', service='query', version='v1'",
+                              self.catalog_.ToString().c_str());
+        send_callback(lookup_response.GetError());
+        return;
+      }
+
+      // The tree is parsed on the network thread, it is small enough.
+      const auto query_client = lookup_response.MoveResult();
+      ExecuteAsync<SharedQuadTreeIndexResponse>(
+          context,
+          [&](SharedQuadTreeIndexCallback on_tree) {
+            return QueryApi::QuadTreeIndex(
+                query_client, self.layer_id_, root_tile_key.ToHereTile(),
+                version, kAggregateQuadTreeDepth, boost::none,
+                request.GetBillingTag(),
+                [=](client::HttpResponse response) mutable {
+                  on_tree(ShareQuadTree(self.StoreQuadTree(
+                      std::move(response), request, version)));
+                });
+          },
+          std::move(send_callback));
+    };
+
+    LookupApiAsync(self.lookup_client_, "query", fetch_option, context,
+                   std::move(on_lookup));
+  };
+
+  SendOrJoin<SharedQuadTreeIndexResponse>(
+      storage_,
+      cache_.CreateQuadKey(root_tile_key, kAggregateQuadTreeDepth, version),
+      fetch_option, std::move(context), std::move(send), std::move(callback));
+}
+
+boost::optional<QuadTreeIndexResponse> PartitionsRepository::FindCachedQuadTree(
+    const TileRequest& request, boost::optional<int64_t> version) {
+  const auto fetch_option = request.GetFetchOption();
+  if (fetch_option == OnlineOnly || fetch_option == CacheWithUpdate) {
+    return boost::none;
+  }
+
+  const auto& tile_key = request.GetTileKey();
+  read::QuadTreeIndex cached_tree;
+  if (cache_.FindQuadTree(tile_key, version, cached_tree) ||
+      cache_.FindQuadTreeInBaseVersion(tile_key, version, cached_tree)) {
+    OLP_SDK_LOG_DEBUG_F(kLogTag,
+                        "GetQuadTreeIndexForTile found in cache, "
+                        "tile='%s', depth='%" PRId32 "'",
+                        tile_key.ToHereTile().c_str(), kAggregateQuadTreeDepth);
+
+    return QuadTreeIndexResponse(std::move(cached_tree));
+  } else if (fetch_option == CacheOnly) {
+    OLP_SDK_LOG_INFO_F(kLogTag,
+                       "GetQuadTreeIndexForTile not found in cache, tile='%s'",
+                       tile_key.ToHereTile().c_str());
+    return QuadTreeIndexResponse(client::ApiError(
+        client::ErrorCode::NotFound, "CacheOnly: resource not found in cache"));
+  }
+  return boost::none;
+}
+
+QuadTreeIndexResponse PartitionsRepository::StoreQuadTree(
+    client::HttpResponse response, const TileRequest& request,
+    boost::optional<int64_t> version) {
+  const auto root_tile_key =
+      request.GetTileKey().ChangedLevelBy(-kAggregateQuadTreeDepth);
+  const auto root_tile_here = root_tile_key.ToHereTile();
+
+  if (response.status != olp::http::HttpStatusCode::OK) {
     OLP_SDK_LOG_WARNING_F(kLogTag,
                           "GetQuadTreeIndexForTile QuadTreeIndex failed, "
                           "hrn='%s', layer='%s', root='%s', "
@@ -416,11 +929,10 @@ QuadTreeIndexResponse PartitionsRepository::GetQuadTreeIndexForTile(
                           catalog_.ToString().c_str(), layer_id_.c_str(),
                           root_tile_here.c_str(), version.get_value_or(-1),
                           kAggregateQuadTreeDepth);
-    return {{quadtree_response.status, quadtree_response.response.str()}};
+    return {{response.status, response.response.str()}};
   }
 
-  QuadTreeIndex tree(root_tile_key, kAggregateQuadTreeDepth,
-                     quadtree_response.response);
+  QuadTreeIndex tree(root_tile_key, kAggregateQuadTreeDepth, response.response);
   if (tree.IsNull()) {
     OLP_SDK_LOG_WARNING_F(
         kLogTag,
@@ -431,7 +943,7 @@ QuadTreeIndexResponse PartitionsRepository::GetQuadTreeIndexForTile(
     return {{client::ErrorCode::Unknown, "Failed to parse quad tree response"}};
   }
 
-  if (fetch_option != OnlineOnly) {
+  if (request.GetFetchOption() != OnlineOnly) {
     cache_.Put(root_tile_key, kAggregateQuadTreeDepth, tree, version);
   }
   return {std::move(tree)};
@@ -479,6 +991,154 @@ PartitionResponse PartitionsRepository::GetTile(
   return FindPartition(quad_tree_response.GetResult(), request, false);
 }
 
+void PartitionsRepository::GetTileAsync(const TileRequest& request,
+                                        boost::optional<int64_t> version,
+                                        client::CancellationContext context,
+                                        PartitionResponseCallback callback) {
+  GetQuadTreeIndexForTileAsync(
+      request, version, std::move(context),
+      [=](SharedQuadTreeIndexResponse quad_tree_response) {
+        if (!quad_tree_response.IsSuccessful()) {
+          callback(quad_tree_response.GetError());
+          return;
+        }
+        callback(
+            FindPartition(*quad_tree_response.GetResult(), request, false));
+      });
+}
+
+UpgradeToVersionResponse PartitionsRepository::UpgradeToVersion(
+    std::int64_t from_version, std::int64_t to_version,
+    const boost::optional<std::string>& billing_tag,
+    client::CancellationContext context,
+    const boost::optional<model::LayerVersions>& layer_versions) {
+  if (to_version < from_version) {
+    return client::ApiError(client::ErrorCode::InvalidArgument,
+                            "Upgrade to an older version is not supported");
+  }
+
+  UpgradeToVersionResult result(from_version, to_version);
+  if (to_version == from_version) {
+    return result;
+  }
+
+  const auto catalog_str = catalog_.ToCatalogHRNString();
+
+  boost::optional<int64_t> layer_version;
+  if (layer_versions) {
+    layer_version = FindLayerVersion(*layer_versions, layer_id_);
+  } else {
+    CatalogRepository catalog_repository(catalog_, settings_, lookup_client_,
+                                         task_sink_);
+    auto layer_versions_response = catalog_repository.GetLayerVersions(
+        to_version, billing_tag, OnlineIfNotFound, context);
+    if (!layer_versions_response.IsSuccessful()) {
+      return layer_versions_response.GetError();
+    }
+    layer_version =
+        FindLayerVersion(layer_versions_response.GetResult(), layer_id_);
+  }
+
+  // The layer version is the catalog version of the last layer change. The
+  // entries of an unchanged layer are copied to the new version on demand.
+  if (layer_version && *layer_version <= from_version) {
+    OLP_SDK_LOG_DEBUG_F(kLogTag,
+                        "UpgradeToVersion: layer is unchanged, hrn='%s', "
+                        "layer='%s', from=%" PRId64 ", to=%" PRId64,
+                        catalog_str.c_str(), layer_id_.c_str(), from_version,
+                        to_version);
+    // Linked to the version that holds the entries, so the repeated upgrades
+    // do not build a chain of links.
+    const auto base_version =
+        cache_.GetBaseVersion(from_version).value_or(from_version);
+    auto put_response = cache_.PutBaseVersion(to_version, base_version);
+    if (!put_response.IsSuccessful()) {
+      return put_response.GetError();
+    }
+    return result;
+  }
+
+  result.SetLayerChanged(true);
+
+  // The unchanged partitions keep their data handles, so only the metadata
+  // is downloaded, the cached data is reused.
+  PartitionsRequest request;
+  request.WithBillingTag(billing_tag);
+  auto partitions_response = GetPartitions(request, to_version, context);
+  if (!partitions_response.IsSuccessful()) {
+    return partitions_response.GetError();
+  }
+
+  const auto& partitions = partitions_response.GetResult();
+  std::unordered_set<std::string> partition_ids;
+  partition_ids.reserve(partitions.GetPartitions().size());
+
+  // The previous partitions are needed to find the removed partitions, and
+  // the changed partitions if the metadata has no versions.
+  PartitionsRequest previous_request;
+  auto previous_partitions = cache_.Get(previous_request, from_version);
+  if (!previous_partitions) {
+    previous_partitions =
+        cache_.GetFromBaseVersion(previous_request, from_version);
+  }
+
+  // Without the previous partitions the result would miss the removed
+  // partitions. They are downloaded, but not cached, as the old version is
+  // not read anymore.
+  if (!previous_partitions) {
+    previous_request.WithBillingTag(billing_tag).WithFetchOption(OnlineOnly);
+    auto previous_response =
+        GetPartitions(previous_request, from_version, context);
+    if (!previous_response.IsSuccessful()) {
+      return previous_response.GetError();
+    }
+    previous_partitions = previous_response.MoveResult();
+  }
+
+  std::unordered_map<std::string, std::string> previous_handles;
+  for (const auto& partition : previous_partitions->GetPartitions()) {
+    previous_handles[partition.GetPartition()] = partition.GetDataHandle();
+  }
+
+  for (const auto& partition : partitions.GetPartitions()) {
+    const auto& partition_id = partition.GetPartition();
+    partition_ids.insert(partition_id);
+
+    const auto& version = partition.GetVersion();
+    if (version) {
+      if (*version > from_version) {
+        result.AddChangedPartition(partition_id);
+      }
+      continue;
+    }
+
+    auto it = previous_handles.find(partition_id);
+    if (it == previous_handles.end() ||
+        it->second != partition.GetDataHandle()) {
+      result.AddChangedPartition(partition_id);
+    }
+  }
+
+  for (const auto& partition : previous_partitions->GetPartitions()) {
+    const auto& partition_id = partition.GetPartition();
+    if (partition_ids.find(partition_id) == partition_ids.end()) {
+      result.AddRemovedPartition(partition_id);
+    }
+  }
+
+  const auto copied_trees =
+      CopyUnchangedQuadTrees(cache_, partitions, result);
+
+  OLP_SDK_LOG_DEBUG_F(kLogTag,
+                      "UpgradeToVersion: hrn='%s', layer='%s', from=%" PRId64
+                      ", to=%" PRId64 ", changed=%zu, removed=%zu, trees=%zu",
+                      catalog_str.c_str(), layer_id_.c_str(), from_version,
+                      to_version, result.GetChangedPartitions().size(),
+                      result.GetRemovedPartitions().size(), copied_trees);
+
+  return result;
+}
+
 }  // namespace repository
 }  // namespace read
 }  // namespace dataservice
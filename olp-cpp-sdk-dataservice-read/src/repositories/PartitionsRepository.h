@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -31,6 +32,7 @@
 #include "QuadTreeIndex.h"
 #include "generated/api/QueryApi.h"
 #include "generated/model/Index.h"
+#include "generated/model/LayerVersions.h"
 #include "olp/dataservice/read/DataRequest.h"
 #include "olp/dataservice/read/PartitionsRequest.h"
 #include "olp/dataservice/read/Types.h"
@@ -42,20 +44,28 @@ namespace olp {
 namespace dataservice {
 namespace read {
 
+class TaskSink;
 class TileRequest;
 
 namespace repository {
 
 /// The partition metadata response type.
 using PartitionResponse = Response<model::Partition>;
+using PartitionResponseCallback = Callback<model::Partition>;
 using QuadTreeIndexResponse = Response<QuadTreeIndex>;
+/// The quad tree response that can be passed to several callbacks.
+using SharedQuadTreeIndexResponse =
+    Response<std::shared_ptr<const QuadTreeIndex>>;
+using SharedQuadTreeIndexCallback =
+    Callback<std::shared_ptr<const QuadTreeIndex>>;
 
 class PartitionsRepository {
  public:
   PartitionsRepository(client::HRN catalog, std::string layer,
                        client::OlpClientSettings settings,
                        client::ApiLookupClient client,
-                       NamedMutexStorage storage = NamedMutexStorage());
+                       NamedMutexStorage storage = NamedMutexStorage(),
+                       TaskSink* task_sink = nullptr);
 
   PartitionsResponse GetVersionedPartitions(
       const read::PartitionsRequest& request, std::int64_t version,
@@ -69,10 +79,25 @@ class PartitionsRepository {
       const read::PartitionsRequest& request, std::int64_t version,
       client::CancellationContext context, bool fail_on_cache_error = false);
 
+  /// Passes the partitions of the layer to the callback one by one, without
+  /// keeping them in memory.
+  client::ApiNoResponse StreamVersionedPartitions(
+      const read::PartitionsRequest& request, std::int64_t version,
+      const PartitionsStreamCallback& callback,
+      client::CancellationContext context);
+
   PartitionsResponse GetPartitionById(const DataRequest& request,
                                       boost::optional<int64_t> version,
                                       client::CancellationContext context);
 
+  /// Gets the partition like `GetPartitionById` without blocking the calling
+  /// thread on the network. The callback can be invoked on the network
+  /// thread.
+  void GetPartitionByIdAsync(const DataRequest& request,
+                             boost::optional<int64_t> version,
+                             client::CancellationContext context,
+                             PartitionsResponseCallback callback);
+
   static model::Partition PartitionFromSubQuad(const model::SubQuad& sub_quad,
                                                const std::string& partition);
 
@@ -84,11 +109,59 @@ class PartitionsRepository {
                             boost::optional<int64_t> version,
                             client::CancellationContext context);
 
+  /// Gets the tile like `GetTile` without blocking the calling thread on the
+  /// network. The callback can be invoked on the network thread.
+  void GetTileAsync(const TileRequest& request,
+                    boost::optional<int64_t> version,
+                    client::CancellationContext context,
+                    PartitionResponseCallback callback);
+
+  /// Moves the cached metadata of the layer from one catalog version to
+  /// a newer one. Only the metadata of the changed layer is downloaded.
+  /// The layer versions of `to_version` are requested unless they are given.
+  UpgradeToVersionResponse UpgradeToVersion(
+      std::int64_t from_version, std::int64_t to_version,
+      const boost::optional<std::string>& billing_tag,
+      client::CancellationContext context,
+      const boost::optional<model::LayerVersions>& layer_versions =
+          boost::none);
+
  private:
   QuadTreeIndexResponse GetQuadTreeIndexForTile(
       const TileRequest& request, boost::optional<int64_t> version,
       client::CancellationContext context);
 
+  void GetQuadTreeIndexForTileAsync(const TileRequest& request,
+                                    boost::optional<int64_t> version,
+                                    client::CancellationContext context,
+                                    SharedQuadTreeIndexCallback callback);
+
+  // Gets the quad tree from the cache, or the `CacheOnly` error if it is not
+  // cached. Returns none if the tree must be downloaded.
+  boost::optional<QuadTreeIndexResponse> FindCachedQuadTree(
+      const TileRequest& request, boost::optional<int64_t> version);
+
+  // Parses the downloaded quad tree and stores it in the cache.
+  QuadTreeIndexResponse StoreQuadTree(client::HttpResponse response,
+                                      const TileRequest& request,
+                                      boost::optional<int64_t> version);
+
+  // Gets the cached partition for the `StaleWhileRevalidate` option, the
+  // stale one is refreshed in the background.
+  boost::optional<model::Partitions> GetStalePartitionById(
+      const DataRequest& request, boost::optional<int64_t> version);
+
+  // Gets the partition from the cache, or the `CacheOnly` error if it is not
+  // cached. Returns none if the partition must be downloaded.
+  boost::optional<PartitionsResponse> FindCachedPartitionById(
+      const DataRequest& request, boost::optional<int64_t> version);
+
+  // Stores the downloaded partition in the cache, or removes it from the
+  // cache if the access is forbidden.
+  void StorePartitionById(const PartitionsResponse& response,
+                          const DataRequest& request,
+                          boost::optional<int64_t> version);
+
   PartitionsResponse GetPartitions(
       const read::PartitionsRequest& request,
       boost::optional<std::int64_t> version,
@@ -108,6 +181,7 @@ class PartitionsRepository {
   client::ApiLookupClient lookup_client_;
   PartitionsCacheRepository cache_;
   NamedMutexStorage storage_;
+  TaskSink* task_sink_;
 };
 }  // namespace repository
 }  // namespace read
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "PrefetchManifest.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <olp/core/logging/Log.h>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+namespace repository {
+
+namespace {
+constexpr auto kLogTag = "PrefetchManifest";
+constexpr unsigned char kFormatVersion = 1u;
+}  // namespace
+
+constexpr std::uint32_t PrefetchManifest::kMaxDepth;
+constexpr size_t PrefetchManifest::kTileCount;
+
+PrefetchManifest::PrefetchManifest(geo::TileKey root)
+    : root_(std::move(root)) {}
+
+PrefetchManifest::PrefetchManifest(geo::TileKey root,
+                                   const cache::KeyValueCache::ValueType& data)
+    : root_(std::move(root)) {
+  const size_t bytes = (kTileCount + 7u) / 8u;
+  if (data.size() != bytes + 1u || data[0] != kFormatVersion) {
+    OLP_SDK_LOG_WARNING_F(kLogTag, "Invalid manifest, root='%s', size=%zu",
+                          root_.ToHereTile().c_str(), data.size());
+    return;
+  }
+
+  for (size_t index = 0; index < kTileCount; ++index) {
+    if (data[1u + index / 8u] & (1u << (index % 8u))) {
+      tiles_.set(index);
+    }
+  }
+}
+
+boost::optional<size_t> PrefetchManifest::GetIndex(
+    const geo::TileKey& tile) const {
+  if (!root_.IsValid() || tile.Level() < root_.Level() ||
+      tile.Level() > root_.Level() + kMaxDepth) {
+    return boost::none;
+  }
+
+  const int depth = static_cast<int>(tile.Level() - root_.Level());
+  if (tile.ChangedLevelBy(-depth) != root_) {
+    return boost::none;
+  }
+
+  // The tiles of each level follow the tiles of the previous levels:
+  // (4^depth - 1) / 3 tiles are above the level.
+  const std::uint64_t level_size = 1ull << (2 * depth);
+  const std::uint64_t level_offset = (level_size - 1u) / 3u;
+  return static_cast<size_t>(level_offset + tile.GetSubkey64(depth) -
+                             level_size);
+}
+
+bool PrefetchManifest::Contains(const geo::TileKey& tile) const {
+  const auto index = GetIndex(tile);
+  return index && tiles_.test(*index);
+}
+
+bool PrefetchManifest::Add(const geo::TileKey& tile) {
+  const auto index = GetIndex(tile);
+  if (!index || tiles_.test(*index)) {
+    return false;
+  }
+
+  tiles_.set(*index);
+  return true;
+}
+
+cache::KeyValueCache::ValueTypePtr PrefetchManifest::Serialize() const {
+  auto data = std::make_shared<cache::KeyValueCache::ValueType>(
+      1u + (kTileCount + 7u) / 8u, 0u);
+  (*data)[0] = kFormatVersion;
+  for (size_t index = 0; index < kTileCount; ++index) {
+    if (tiles_.test(index)) {
+      (*data)[1u + index / 8u] |=
+          static_cast<unsigned char>(1u << (index % 8u));
+    }
+  }
+  return data;
+}
+
+PrefetchManifestTracker::PrefetchManifestTracker(
+    PartitionsCacheRepository cache_repository, std::int64_t version)
+    : cache_repository_(std::move(cache_repository)), version_(version) {}
+
+void PrefetchManifestTracker::Load(
+    const geo::TileKey& root,
+    const std::map<geo::TileKey, std::string>& tiles) {
+  PrefetchManifest manifest(root);
+  if (!cache_repository_.Get(root, version_, manifest)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    manifests_.emplace(root, std::move(manifest));
+    return;
+  }
+
+  std::vector<std::string> handles;
+  for (const auto& tile : tiles) {
+    if (!tile.second.empty() && manifest.Contains(tile.first)) {
+      handles.push_back(tile.second);
+    }
+  }
+
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Load, root='%s', downloaded=%zu, tiles=%zu",
+                      root.ToHereTile().c_str(), handles.size(), tiles.size());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  manifests_[root] = std::move(manifest);
+  downloaded_handles_.insert(std::make_move_iterator(handles.begin()),
+                             std::make_move_iterator(handles.end()));
+}
+
+bool PrefetchManifestTracker::IsDownloaded(
+    const std::string& data_handle) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return downloaded_handles_.find(data_handle) != downloaded_handles_.end();
+}
+
+std::vector<geo::TileKey> PrefetchManifestTracker::RemoveDownloaded(
+    std::map<geo::TileKey, std::string>& tiles) const {
+  std::vector<geo::TileKey> removed;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (downloaded_handles_.empty()) {
+    return removed;
+  }
+
+  for (auto it = tiles.begin(); it != tiles.end();) {
+    if (downloaded_handles_.find(it->second) != downloaded_handles_.end()) {
+      removed.push_back(it->first);
+      it = tiles.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return removed;
+}
+
+void PrefetchManifestTracker::MarkDownloaded(const geo::TileKey& tile) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // The tile belongs to the nearest loaded root above it.
+  auto root = tile;
+  for (auto distance = 0u; distance <= 4u; ++distance) {
+    auto it = manifests_.find(root);
+    if (it != manifests_.end()) {
+      if (it->second.Add(tile)) {
+        modified_roots_.insert(root);
+      }
+      return;
+    }
+
+    if (root.Level() == 0) {
+      return;
+    }
+    root = root.Parent();
+  }
+}
+
+void PrefetchManifestTracker::Store() {
+  std::vector<PrefetchManifest> manifests;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    manifests.reserve(modified_roots_.size());
+    for (const auto& root : modified_roots_) {
+      manifests.push_back(manifests_[root]);
+    }
+    modified_roots_.clear();
+  }
+
+  for (const auto& manifest : manifests) {
+    cache_repository_.Put(manifest, version_);
+  }
+}
+
+}  // namespace repository
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
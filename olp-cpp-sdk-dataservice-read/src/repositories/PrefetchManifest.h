@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <bitset>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <olp/core/cache/KeyValueCache.h>
+#include <olp/core/geo/tiling/TileKey.h>
+#include <boost/optional.hpp>
+#include "PartitionsCacheRepository.h"
+
+namespace olp {
+namespace dataservice {
+namespace read {
+namespace repository {
+
+/**
+ * @brief A compact record of the tiles in the quad tree under a root tile that
+ * are downloaded and stored in the cache.
+ *
+ * Every tile of the quad tree with the maximum depth has a bit, so the
+ * manifest of one root takes 44 bytes in the cache: 43 bytes of bits and
+ * the format version.
+ */
+class PrefetchManifest final {
+ public:
+  PrefetchManifest() = default;
+  explicit PrefetchManifest(geo::TileKey root);
+  PrefetchManifest(geo::TileKey root,
+                   const cache::KeyValueCache::ValueType& data);
+
+  const geo::TileKey& GetRoot() const { return root_; }
+
+  bool Contains(const geo::TileKey& tile) const;
+
+  /**
+   * @brief Marks the tile as downloaded.
+   *
+   * @return False if the tile is outside of the quad tree, or it is already
+   * marked; true otherwise.
+   */
+  bool Add(const geo::TileKey& tile);
+
+  bool IsEmpty() const { return tiles_.none(); }
+
+  cache::KeyValueCache::ValueTypePtr Serialize() const;
+
+ private:
+  static constexpr std::uint32_t kMaxDepth = 4u;
+  // 1 + 4 + 16 + 64 + 256 tiles on the levels of the quad tree.
+  static constexpr size_t kTileCount = 341u;
+
+  boost::optional<size_t> GetIndex(const geo::TileKey& tile) const;
+
+  geo::TileKey root_;
+  std::bitset<kTileCount> tiles_;
+};
+
+/**
+ * @brief Shares the prefetch manifests between the tasks of one prefetch
+ * request.
+ *
+ * The manifests are loaded from the cache when the quad trees are queried,
+ * updated when the tiles are downloaded, and stored back when the prefetch
+ * completes, even if it was cancelled, so the next prefetch can resume.
+ */
+class PrefetchManifestTracker final {
+ public:
+  PrefetchManifestTracker(PartitionsCacheRepository cache_repository,
+                          std::int64_t version);
+
+  /**
+   * @brief Loads the manifest of the quad tree.
+   *
+   * @param root The root tile of the quad tree.
+   * @param tiles The tiles of the quad tree and their data handles.
+   */
+  void Load(const geo::TileKey& root,
+            const std::map<geo::TileKey, std::string>& tiles);
+
+  bool IsDownloaded(const std::string& data_handle) const;
+
+  /**
+   * @brief Removes the downloaded tiles from the tiles to download.
+   *
+   * The manifests of the quad trees must be loaded before.
+   *
+   * @param tiles The tiles and their data handles.
+   *
+   * @return The removed tiles.
+   */
+  std::vector<geo::TileKey> RemoveDownloaded(
+      std::map<geo::TileKey, std::string>& tiles) const;
+
+  void MarkDownloaded(const geo::TileKey& tile);
+
+  void Store();
+
+ private:
+  PartitionsCacheRepository cache_repository_;
+  const std::int64_t version_;
+  mutable std::mutex mutex_;
+  std::map<geo::TileKey, PrefetchManifest> manifests_;
+  std::set<geo::TileKey> modified_roots_;
+  std::unordered_set<std::string> downloaded_handles_;
+};
+
+}  // namespace repository
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -56,6 +57,31 @@ SubQuadsResult FlattenTree(const QuadTreeIndex& tree) {
   return result;
 }
 
+// Orders the tiles along the Z-order curve, a parent tile goes before its
+// children.
+bool MortonLess(const geo::TileKey& lhs, const geo::TileKey& rhs) {
+  const auto level = std::min(lhs.Level(), rhs.Level());
+  const auto lhs_key = lhs.ChangedLevelTo(level).ToQuadKey64();
+  const auto rhs_key = rhs.ChangedLevelTo(level).ToQuadKey64();
+  if (lhs_key != rhs_key) {
+    return lhs_key < rhs_key;
+  }
+  return lhs.Level() < rhs.Level();
+}
+
+// Keeps only the tile, its parents, and its children.
+SubQuadsResult FilterSubtree(const geo::TileKey& tile, SubQuadsResult tiles) {
+  for (auto it = tiles.begin(); it != tiles.end();) {
+    const auto& key = it->first;
+    if (key == tile || key.IsParentOf(tile) || tile.IsParentOf(key)) {
+      ++it;
+    } else {
+      it = tiles.erase(it);
+    }
+  }
+  return tiles;
+}
+
 }  // namespace
 
 PrefetchTilesRepository::PrefetchTilesRepository(
@@ -171,6 +197,49 @@ RootTilesForRequest PrefetchTilesRepository::GetSlicedTiles(
   return root_tiles_depth;
 }
 
+std::vector<geo::TileKey> PrefetchTilesRepository::GetQueryRoots(
+    const RootTilesForRequest& root_tiles) {
+  using RootTile = std::pair<geo::TileKey, std::uint32_t>;
+
+  std::vector<RootTile> sorted_roots(root_tiles.begin(), root_tiles.end());
+  std::sort(sorted_roots.begin(), sorted_roots.end(),
+            [](const RootTile& lhs, const RootTile& rhs) {
+              return MortonLess(lhs.first, rhs.first);
+            });
+
+  std::vector<geo::TileKey> roots;
+  roots.reserve(sorted_roots.size());
+
+  // Each root is queried with the maximum depth, so the quad tree of a parent
+  // root may already contain all the levels required for its child. As the
+  // parents go first in Morton order, they are already processed here.
+  std::set<geo::TileKey> queried_roots;
+  for (const auto& root : sorted_roots) {
+    const auto& tile = root.first;
+    const auto depth = std::min(root.second, kMaxQuadTreeIndexDepth);
+    const auto max_distance =
+        std::min(kMaxQuadTreeIndexDepth - depth, tile.Level());
+
+    bool covered = false;
+    for (auto distance = 1u; distance <= max_distance && !covered;
+         ++distance) {
+      covered = queried_roots.count(
+                    tile.ChangedLevelBy(-static_cast<int>(distance))) > 0;
+    }
+
+    if (covered) {
+      OLP_SDK_LOG_DEBUG_F(kLogTag, "GetQueryRoots: tile %s is covered",
+                          tile.ToHereTile().c_str());
+      continue;
+    }
+
+    queried_roots.insert(tile);
+    roots.push_back(tile);
+  }
+
+  return roots;
+}
+
 client::NetworkStatistics PrefetchTilesRepository::LoadAggregatedSubQuads(
     geo::TileKey root, const SubQuadsResult& tiles, std::int64_t version,
     client::CancellationContext context) {
@@ -178,11 +247,13 @@ client::NetworkStatistics PrefetchTilesRepository::LoadAggregatedSubQuads(
   QuadTreeIndex quad_tree;
   client::NetworkStatistics network_stats;
 
-  if (!cache_repository_.Get(root, kMaxQuadTreeIndexDepth, version,
-                             quad_tree)) {
+  // the quad tree of the root could be reused from one of its parents
+  if (!cache_repository_.FindQuadTree(root, version, quad_tree)) {
     return network_stats;
   }
 
+  root = quad_tree.GetRootTile();
+
   auto highest_tile_it = std::min_element(tiles.begin(), tiles.end());
 
   // Currently there is no better way to correctly handle the prefetch of
@@ -216,15 +287,56 @@ client::NetworkStatistics PrefetchTilesRepository::LoadAggregatedSubQuads(
   return network_stats;
 }
 
+bool PrefetchTilesRepository::FindCoveringQuadTree(
+    geo::TileKey tile, std::uint32_t required_depth, std::int64_t version,
+    QuadTreeIndex& tree) {
+  if (required_depth >= kMaxQuadTreeIndexDepth) {
+    return false;
+  }
+
+  const auto max_distance =
+      std::min(kMaxQuadTreeIndexDepth - required_depth, tile.Level());
+
+  for (auto distance = 1u; distance <= max_distance; ++distance) {
+    const auto parent = tile.ChangedLevelBy(-static_cast<int>(distance));
+    const auto quad_cache_key =
+        cache_repository_.CreateQuadKey(parent, kMaxQuadTreeIndexDepth, version);
+
+    // the parent tree could be downloaded by a concurrent request, wait for it
+    if (storage_.IsInUse(quad_cache_key)) {
+      NamedMutex mutex(storage_, quad_cache_key);
+      std::lock_guard<NamedMutex> lock(mutex);
+    }
+
+    if (cache_repository_.Get(parent, kMaxQuadTreeIndexDepth, version, tree)) {
+      OLP_SDK_LOG_DEBUG_F(kLogTag,
+                          "FindCoveringQuadTree found in cache, tile='%s', "
+                          "root='%s'",
+                          tile.ToHereTile().c_str(),
+                          parent.ToHereTile().c_str());
+      return true;
+    }
+  }
+
+  return false;
+}
+
 SubQuadsResponse PrefetchTilesRepository::GetVersionedSubQuads(
     geo::TileKey tile, int32_t depth, std::int64_t version,
-    client::CancellationContext context) {
+    client::CancellationContext context,
+    boost::optional<std::uint32_t> required_depth) {
   OLP_SDK_LOG_TRACE_F(kLogTag, "GetSubQuads(%s, %" PRId64 ", %" PRId32 ")",
                       tile.ToHereTile().c_str(), version, depth);
-  // check if quad tree with requested tile and depth already in cache
   QuadTreeIndex quad_tree;
   client::NetworkStatistics network_stats;
 
+  if (required_depth &&
+      FindCoveringQuadTree(tile, *required_depth, version, quad_tree)) {
+    return {FilterSubtree(tile, FlattenTree(quad_tree)), network_stats};
+  }
+
+  // check if quad tree with requested tile and depth already in cache
+
   const auto quad_cache_key =
       cache_repository_.CreateQuadKey(tile, kMaxQuadTreeIndexDepth, version);
 
@@ -21,6 +21,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <olp/core/client/ApiError.h>
 #include <olp/core/client/ApiLookupClient.h>
@@ -71,6 +72,22 @@ class PrefetchTilesRepository {
   RootTilesForRequest GetSlicedTiles(const std::vector<geo::TileKey>& tile_keys,
                                      std::uint32_t min, std::uint32_t max);
 
+  /**
+   * @brief Plans the quad tree index queries for the sliced tiles.
+   *
+   * Drops the root tiles whose levels are already covered by the quad tree of
+   * another root tile, and sorts the rest in Morton order, so that the
+   * neighbouring subtrees are queried one after another, and a parent tile is
+   * queried before its children.
+   *
+   * @param root_tiles The root tiles and their depths returned by
+   * `GetSlicedTiles`.
+   *
+   * @return The root tiles to query.
+   */
+  static std::vector<geo::TileKey> GetQueryRoots(
+      const RootTilesForRequest& root_tiles);
+
   /**
    * @brief Filters the input tiles according to the request.
    *
@@ -104,9 +121,27 @@ class PrefetchTilesRepository {
       geo::TileKey tile, const SubQuadsResult& tiles, std::int64_t version,
       client::CancellationContext context);
 
-  SubQuadsResponse GetVersionedSubQuads(geo::TileKey tile, int32_t depth,
-                                        std::int64_t version,
-                                        client::CancellationContext context);
+  /**
+   * @brief Gets the versioned quad tree index for the tile.
+   *
+   * If `required_depth` is set, the quad tree of a parent tile that covers
+   * the required levels is reused when it is already cached or being
+   * downloaded by another request. In this case, the result contains only the
+   * tile, its parents, and its children.
+   *
+   * @param tile The root tile of the quad tree.
+   * @param depth The depth of the quad tree to download.
+   * @param version The catalog version.
+   * @param context The `CancellationContext` instance.
+   * @param required_depth The number of levels below the tile that the result
+   * must contain.
+   *
+   * @return The tiles and their data handles.
+   */
+  SubQuadsResponse GetVersionedSubQuads(
+      geo::TileKey tile, int32_t depth, std::int64_t version,
+      client::CancellationContext context,
+      boost::optional<std::uint32_t> required_depth = boost::none);
 
   SubQuadsResponse GetVolatileSubQuads(geo::TileKey tile, int32_t depth,
                                        client::CancellationContext context);
@@ -119,6 +154,9 @@ class PrefetchTilesRepository {
   using QuadTreeResponse = ExtendedApiResponse<QuadTreeIndex, client::ApiError,
                                                client::NetworkStatistics>;
 
+  bool FindCoveringQuadTree(geo::TileKey tile, std::uint32_t required_depth,
+                            std::int64_t version, QuadTreeIndex& tree);
+
   QuadTreeResponse DownloadVersionedQuadTree(
       geo::TileKey tile, int32_t depth, std::int64_t version,
       client::CancellationContext context);
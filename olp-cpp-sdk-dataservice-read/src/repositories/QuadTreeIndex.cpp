@@ -119,7 +119,10 @@ QuadTreeIndex::QuadTreeIndex(const olp::geo::TileKey& root, int depth,
 
       IndexData data = ParseCommonIndexData(value);
       data.data_handle = obj[kDataHandleKey].GetString();
-      data.tile_key = root.FromHereTile(obj[kPartitionKey].GetString());
+      const auto& partition = obj[kPartitionKey];
+      data.tile_key = geo::TileKey::FromHereTile(
+          partition.GetString(),
+          partition.GetString() + partition.GetStringLength());
       parents.push_back(std::move(data));
     }
   }
@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "ShardedPartitionsLoader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <iterator>
+#include <memory>
+#include <mutex>
+
+#include <olp/core/http/HttpStatusCode.h>
+#include <olp/core/http/NetworkTypes.h>
+#include <olp/core/http/NetworkUtils.h>
+#include <olp/core/logging/Log.h>
+#include "generated/parser/PartitionsSaxHandler.h"
+
+namespace olp {
+namespace dataservice {
+namespace read {
+namespace repository {
+
+namespace {
+constexpr auto kLogTag = "ShardedPartitionsLoader";
+constexpr auto kWhitespace = " \t\r\n";
+constexpr auto kPartitionsKey = "\"partitions\"";
+// Smaller responses are faster to download and parse at once.
+constexpr size_t kMinShardSize = 1024u * 1024u;
+constexpr size_t kMinSliceSize = 256u * 1024u;
+
+using Range = ShardedPartitionsLoader::Range;
+
+// Collects the responses of the shards downloaded concurrently.
+struct ShardResponses {
+  explicit ShardResponses(size_t count) : responses(count), pending(count) {}
+
+  std::mutex mutex;
+  std::condition_variable completed;
+  std::vector<client::HttpResponse> responses;
+  size_t pending;
+};
+
+// The slices are taken by the caller and the scheduled tasks, whichever
+// comes first. The late tasks find no slice left and only use this state.
+struct ParseState {
+  explicit ParseState(size_t count) : count(count) {}
+
+  const size_t count;
+  std::atomic<size_t> next{0u};
+  std::mutex mutex;
+  std::condition_variable completed;
+  size_t parsed{0u};
+  bool success{true};
+};
+
+std::string FormatRange(size_t begin, boost::optional<size_t> end) {
+  auto range = "bytes=" + std::to_string(begin) + "-";
+  if (end) {
+    range += std::to_string(*end - 1u);
+  }
+  return range;
+}
+
+// Gets the total size from the `Content-Range: bytes 0-1023/4096` header.
+boost::optional<size_t> GetTotalSize(const http::Headers& headers) {
+  for (const auto& header : headers) {
+    if (!http::NetworkUtils::CaseInsensitiveCompare(header.first,
+                                                    "Content-Range")) {
+      continue;
+    }
+
+    const auto& value = header.second;
+    const auto slash = value.rfind('/');
+    if (slash == std::string::npos || slash + 1u == value.size() ||
+        value.find_first_not_of("0123456789", slash + 1u) !=
+            std::string::npos) {
+      return boost::none;
+    }
+    return static_cast<size_t>(std::stoull(value.substr(slash + 1u)));
+  }
+  return boost::none;
+}
+
+bool IsRangeResponse(client::HttpResponse& response, size_t size) {
+  if (response.GetStatus() != http::HttpStatusCode::PARTIAL_CONTENT) {
+    return false;
+  }
+  response.response.seekp(0, std::ios::end);
+  return static_cast<size_t>(response.response.tellp()) == size;
+}
+
+size_t SkipWhitespace(const std::string& json, size_t pos) {
+  pos = json.find_first_not_of(kWhitespace, pos);
+  return pos == std::string::npos ? json.size() : pos;
+}
+
+// Finds the comma between two partition objects at or after `pos`.
+size_t FindSeparator(const std::string& json, size_t pos, size_t end) {
+  while ((pos = json.find(',', pos)) < end) {
+    const auto prev = json.find_last_not_of(kWhitespace, pos - 1u);
+    const auto next = SkipWhitespace(json, pos + 1u);
+    if (json[prev] == '}' && next < end && json[next] == '{') {
+      return pos;
+    }
+    ++pos;
+  }
+  return std::string::npos;
+}
+
+// Parses the range in place as if it was wrapped into the partitions list.
+bool ParseSlice(const std::string& json, const Range& range,
+                model::Partitions& partitions) {
+  return parser::ParsePartitionsList(json.data() + range.first,
+                                     json.data() + range.second, partitions);
+}
+}  // namespace
+
+ShardedPartitionsLoader::ShardedPartitionsLoader(
+    client::OlpClient client, std::string layer_id, std::uint32_t shard_count,
+    std::shared_ptr<thread::TaskScheduler> task_scheduler)
+    : client_(std::move(client)),
+      layer_id_(std::move(layer_id)),
+      shard_count_(std::max(shard_count, 1u)),
+      task_scheduler_(std::move(task_scheduler)) {}
+
+MetadataApi::PartitionsExtendedResponse ShardedPartitionsLoader::Load(
+    std::int64_t version, const std::vector<std::string>& additional_fields,
+    const boost::optional<std::string>& billing_tag,
+    client::CancellationContext context) const {
+  auto download = [&](size_t begin, boost::optional<size_t> end,
+                      const client::CancellationContext& shard_context) {
+    return MetadataApi::GetPartitionsRange(
+        client_, layer_id_, version, additional_fields,
+        FormatRange(begin, end), billing_tag, shard_context);
+  };
+
+  // The head of the response tells the total size.
+  auto head = download(0u, kMinShardSize, context);
+  auto statistics = head.GetNetworkStatistics();
+
+  if (head.GetStatus() == http::HttpStatusCode::OK) {
+    // The server ignores the range and sends the whole response.
+    return Parse(head.response.str(), statistics);
+  }
+
+  if (head.GetStatus() != http::HttpStatusCode::PARTIAL_CONTENT) {
+    return {{head.GetStatus(), head.response.str()}, statistics};
+  }
+
+  auto json = head.response.str();
+  const auto total = GetTotalSize(head.GetHeaders());
+
+  if (!total) {
+    // The size is unknown, download the rest at once.
+    auto tail = download(json.size(), boost::none, context);
+    statistics += tail.GetNetworkStatistics();
+    if (tail.GetStatus() != http::HttpStatusCode::PARTIAL_CONTENT) {
+      return {{tail.GetStatus(), tail.response.str()}, statistics};
+    }
+    json += tail.response.str();
+    return Parse(json, statistics);
+  }
+
+  if (*total < json.size()) {
+    return {{client::ErrorCode::Unknown, "Invalid Content-Range header"},
+            statistics};
+  }
+
+  const auto offset = json.size();
+  const auto remaining = *total - offset;
+  const auto shards = std::min<size_t>(
+      shard_count_, (remaining + kMinShardSize - 1u) / kMinShardSize);
+
+  OLP_SDK_LOG_DEBUG_F(kLogTag,
+                      "Load, layer='%s', version=%" PRId64
+                      ", size=%zu, shards=%zu",
+                      layer_id_.c_str(), version, *total, shards);
+
+  // A failed shard cancels the other shards, but not the caller context.
+  auto shards_context = context.CreateChild();
+
+  // The shards are downloaded with the asynchronous requests, so no thread
+  // is blocked per shard.
+  auto shard_responses = std::make_shared<ShardResponses>(shards);
+  std::vector<Range> ranges;
+  std::vector<client::CancellationContext> shard_contexts;
+  ranges.reserve(shards);
+  shard_contexts.reserve(shards);
+
+  for (size_t shard = 0u; shard < shards; ++shard) {
+    const Range range(offset + remaining * shard / shards,
+                      offset + remaining * (shard + 1u) / shards);
+    ranges.push_back(range);
+
+    auto on_response = [=](client::HttpResponse response) mutable {
+      if (!IsRangeResponse(response, range.second - range.first)) {
+        shards_context.CancelOperation();
+      }
+
+      std::lock_guard<std::mutex> lock(shard_responses->mutex);
+      shard_responses->responses[shard] = std::move(response);
+      if (--shard_responses->pending == 0u) {
+        shard_responses->completed.notify_one();
+      }
+    };
+
+    // The parent keeps the children weakly, the contexts live until the end.
+    shard_contexts.push_back(shards_context.CreateChild());
+    shard_contexts.back().ExecuteOrCancelled(
+        [&]() {
+          return MetadataApi::GetPartitionsRange(
+              client_, layer_id_, version, additional_fields,
+              FormatRange(range.first, range.second), billing_tag,
+              on_response);
+        },
+        [&]() {
+          on_response(client::HttpResponse(
+              static_cast<int>(http::ErrorCode::CANCELLED_ERROR),
+              "Operation Cancelled."));
+        });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(shard_responses->mutex);
+    shard_responses->completed.wait(
+        lock, [&]() { return shard_responses->pending == 0u; });
+  }
+
+  json.reserve(*total);
+  boost::optional<client::ApiError> error;
+
+  for (size_t shard = 0u; shard < shards; ++shard) {
+    auto& response = shard_responses->responses[shard];
+    statistics += response.GetNetworkStatistics();
+
+    const auto& range = ranges[shard];
+    if (IsRangeResponse(response, range.second - range.first)) {
+      if (!error) {
+        json += response.response.str();
+      }
+      continue;
+    }
+
+    // The shards cancelled after a failure are not the cause.
+    if (!error || error->GetErrorCode() == client::ErrorCode::Cancelled) {
+      if (response.GetStatus() == http::HttpStatusCode::PARTIAL_CONTENT) {
+        error = client::ApiError(client::ErrorCode::Unknown,
+                                 "Unexpected size of the partitions range");
+      } else {
+        error = client::ApiError(response.GetStatus(), response.response.str());
+      }
+    }
+  }
+
+  if (context.IsCancelled()) {
+    return {{client::ErrorCode::Cancelled, "Cancelled"}, statistics};
+  }
+
+  if (error) {
+    return {*error, statistics};
+  }
+
+  return Parse(json, statistics);
+}
+
+MetadataApi::PartitionsExtendedResponse ShardedPartitionsLoader::Parse(
+    const std::string& json, client::NetworkStatistics statistics) const {
+  const auto count =
+      std::max<size_t>(1u, std::min<size_t>(shard_count_,
+                                            json.size() / kMinSliceSize));
+  const auto slices = SplitPartitions(json, count);
+
+  model::Partitions partitions;
+
+  if (slices.size() > 1u) {
+    std::vector<model::Partitions> results(slices.size());
+    auto state = std::make_shared<ParseState>(slices.size());
+
+    auto parse_slices = [=, &json, &slices, &results]() {
+      size_t slice;
+      while ((slice = state->next++) < state->count) {
+        const bool parsed = ParseSlice(json, slices[slice], results[slice]);
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->success = state->success && parsed;
+        if (++state->parsed == state->count) {
+          state->completed.notify_one();
+        }
+      }
+    };
+
+    if (task_scheduler_) {
+      for (size_t slice = 1u; slice < slices.size(); ++slice) {
+        task_scheduler_->ScheduleTask(parse_slices);
+      }
+    }
+
+    // Without the scheduler all slices are parsed by the caller.
+    parse_slices();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->completed.wait(lock,
+                          [&]() { return state->parsed == state->count; });
+    const bool success = state->success;
+    lock.unlock();
+
+    if (success) {
+      size_t size = 0u;
+      for (const auto& result : results) {
+        size += result.GetPartitions().size();
+      }
+
+      auto& partitions_list = partitions.GetMutablePartitions();
+      partitions_list.reserve(size);
+      for (auto& result : results) {
+        auto& result_list = result.GetMutablePartitions();
+        std::move(result_list.begin(), result_list.end(),
+                  std::back_inserter(partitions_list));
+      }
+      return {std::move(partitions), statistics};
+    }
+
+    // A split inside of a partition object is not parsed, try at once.
+    OLP_SDK_LOG_WARNING_F(kLogTag,
+                          "Parse, failed to parse the slices, layer='%s'",
+                          layer_id_.c_str());
+  }
+
+  if (!parser::ParsePartitions(json, partitions)) {
+    return {{client::ErrorCode::Unknown, "Fail parsing response."},
+            statistics};
+  }
+
+  return {std::move(partitions), statistics};
+}
+
+std::vector<Range> ShardedPartitionsLoader::SplitPartitions(
+    const std::string& json, size_t count) {
+  // Expects {"partitions":[...]} with optional whitespace.
+  const std::string key = kPartitionsKey;
+
+  auto pos = SkipWhitespace(json, 0u);
+  if (pos == json.size() || json[pos] != '{') {
+    return {};
+  }
+
+  pos = SkipWhitespace(json, pos + 1u);
+  if (json.compare(pos, key.size(), key) != 0) {
+    return {};
+  }
+
+  pos = SkipWhitespace(json, pos + key.size());
+  if (pos == json.size() || json[pos] != ':') {
+    return {};
+  }
+
+  pos = SkipWhitespace(json, pos + 1u);
+  if (pos == json.size() || json[pos] != '[') {
+    return {};
+  }
+
+  const auto begin = pos + 1u;
+
+  auto end = json.find_last_not_of(kWhitespace);
+  if (end == std::string::npos || end <= begin || json[end] != '}') {
+    return {};
+  }
+
+  end = json.find_last_not_of(kWhitespace, end - 1u);
+  if (end == std::string::npos || end < begin || json[end] != ']') {
+    return {};
+  }
+
+  std::vector<Range> ranges;
+  auto start = begin;
+
+  for (size_t slice = 1u; slice < count; ++slice) {
+    const auto target = begin + (end - begin) * slice / count;
+    const auto separator = FindSeparator(json, std::max(target, start), end);
+    if (separator == std::string::npos) {
+      break;
+    }
+
+    ranges.emplace_back(start, separator);
+    start = separator + 1u;
+  }
+
+  ranges.emplace_back(start, end);
+  return ranges;
+}
+
+}  // namespace repository
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
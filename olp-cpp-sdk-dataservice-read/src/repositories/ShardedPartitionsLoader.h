@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <olp/core/client/CancellationContext.h>
+#include <olp/core/client/HttpResponse.h>
+#include <olp/core/client/OlpClient.h>
+#include <olp/core/thread/TaskScheduler.h>
+#include <boost/optional.hpp>
+#include "generated/api/MetadataApi.h"
+
+namespace olp {
+namespace dataservice {
+namespace read {
+namespace repository {
+
+/*
+ * @brief Downloads the metadata of all partitions of a versioned layer with
+ * parallel byte range requests and parses it concurrently.
+ *
+ * The first request downloads the head of the response and tells its size.
+ * The rest is split into shards that are downloaded in parallel. The joined
+ * response is split at the boundaries of the partition objects, and
+ * the parts are parsed in parallel on the task scheduler. If the response
+ * doesn't have the expected layout, it is parsed at once.
+ */
+class ShardedPartitionsLoader final {
+ public:
+  /// The byte offsets of a part of the response, the end is exclusive.
+  using Range = std::pair<size_t, size_t>;
+
+  ShardedPartitionsLoader(
+      client::OlpClient client, std::string layer_id, std::uint32_t shard_count,
+      std::shared_ptr<thread::TaskScheduler> task_scheduler = nullptr);
+
+  MetadataApi::PartitionsExtendedResponse Load(
+      std::int64_t version, const std::vector<std::string>& additional_fields,
+      const boost::optional<std::string>& billing_tag,
+      client::CancellationContext context) const;
+
+  /*
+   * @brief Splits the elements of the partitions array into at most `count`
+   * ranges that contain whole partition objects.
+   *
+   * The separating commas are not included in the ranges.
+   *
+   * @return The ranges, or an empty vector if the response doesn't have
+   * the `{"partitions":[...]}` layout.
+   */
+  static std::vector<Range> SplitPartitions(const std::string& json,
+                                            size_t count);
+
+ private:
+  MetadataApi::PartitionsExtendedResponse Parse(
+      const std::string& json, client::NetworkStatistics statistics) const;
+
+  client::OlpClient client_;
+  std::string layer_id_;
+  std::uint32_t shard_count_;
+  std::shared_ptr<thread::TaskScheduler> task_scheduler_;
+};
+
+}  // namespace repository
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "StaleEntryRefresher.h"
+
+#include <cstdint>
+#include <utility>
+
+#include <olp/core/client/ApiNoResult.h>
+#include <olp/core/logging/Log.h>
+#include <olp/core/thread/TaskScheduler.h>
+#include "TaskSink.h"
+
+namespace olp {
+namespace dataservice {
+namespace read {
+namespace repository {
+
+namespace {
+constexpr auto kLogTag = "StaleEntryRefresher";
+}  // namespace
+
+StaleEntryRefresher& StaleEntryRefresher::Instance() {
+  static StaleEntryRefresher instance;
+  return instance;
+}
+
+bool StaleEntryRefresher::Refresh(const client::OlpClientSettings& settings,
+                                  TaskSink* task_sink, const std::string& key,
+                                  RefreshFunc refresh) {
+  if (!task_sink || !settings.task_scheduler) {
+    OLP_SDK_LOG_DEBUG_F(kLogTag, "Refresh skipped, no task scheduler, key='%s'",
+                        key.c_str());
+    return false;
+  }
+
+  auto id = CreateId(settings, key);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pending_.insert(id).second) {
+      OLP_SDK_LOG_DEBUG_F(kLogTag, "Refresh already pending, key='%s'",
+                          key.c_str());
+      return false;
+    }
+  }
+
+  OLP_SDK_LOG_DEBUG_F(kLogTag, "Refresh, key='%s'", key.c_str());
+
+  // The callback is invoked also when the task is cancelled before it runs.
+  auto added = task_sink->AddTaskChecked(
+      [refresh](client::CancellationContext context) {
+        refresh(std::move(context));
+        return client::ApiNoResponse(client::ApiNoResult());
+      },
+      [this, id](client::ApiNoResponse) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.erase(id);
+      },
+      thread::LOW);
+
+  if (!added) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.erase(id);
+    return false;
+  }
+
+  return true;
+}
+
+bool StaleEntryRefresher::IsRefreshing(
+    const client::OlpClientSettings& settings, const std::string& key) {
+  const auto id = CreateId(settings, key);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.find(id) != pending_.end();
+}
+
+std::string StaleEntryRefresher::CreateId(
+    const client::OlpClientSettings& settings, const std::string& key) {
+  return std::to_string(
+             reinterpret_cast<std::uintptr_t>(settings.cache.get())) +
+         "::" + key;
+}
+
+}  // namespace repository
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
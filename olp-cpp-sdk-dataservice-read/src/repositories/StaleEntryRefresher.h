@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include <olp/core/client/CancellationContext.h>
+#include <olp/core/client/OlpClientSettings.h>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+
+class TaskSink;
+
+namespace repository {
+
+/*
+ * @brief Refreshes the stale cache entries returned to the requests made with
+ * the `StaleWhileRevalidate` fetch option.
+ *
+ * The refresh is a task of the client, so the request does not wait for the
+ * network, and the refresh is cancelled with the other requests of the
+ * client. Only one refresh of an entry runs at a time, the refreshes
+ * requested meanwhile are dropped. The entries of the clients that use
+ * different caches are refreshed separately.
+ */
+class StaleEntryRefresher final {
+ public:
+  using RefreshFunc = std::function<void(client::CancellationContext)>;
+
+  /// Gets the refresher of the process.
+  static StaleEntryRefresher& Instance();
+
+  /**
+   * @brief Refreshes the entry in the background.
+   *
+   * The refresh is skipped without the task sink or the task scheduler, as
+   * it would block the request.
+   *
+   * @param settings The settings of the client.
+   * @param task_sink The task sink of the client.
+   * @param key The key of the entry.
+   * @param refresh The function that downloads the entry and stores it in
+   * the cache.
+   *
+   * @return True if the refresh is started; false if it is skipped, or the
+   * entry is already being refreshed.
+   */
+  bool Refresh(const client::OlpClientSettings& settings, TaskSink* task_sink,
+               const std::string& key, RefreshFunc refresh);
+
+  /// Checks whether the entry is being refreshed.
+  bool IsRefreshing(const client::OlpClientSettings& settings,
+                    const std::string& key);
+
+ private:
+  static std::string CreateId(const client::OlpClientSettings& settings,
+                              const std::string& key);
+
+  std::mutex mutex_;
+  std::unordered_set<std::string> pending_;
+};
+
+}  // namespace repository
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <matchers/NetworkUrlMatchers.h>
+#include <mocks/NetworkMock.h>
+
+#include <olp/core/client/OlpClientSettingsFactory.h>
+#include <olp/dataservice/read/CatalogSnapshot.h>
+#include "ApiDefaultResponses.h"
+#include "CatalogSnapshotImpl.h"
+#include "PlatformUrlsGenerator.h"
+#include "ReadDefaultResponses.h"
+#include "ResponseGenerator.h"
+// clang-format off
+#include "generated/serializer/ApiSerializer.h"
+#include "generated/serializer/VersionResponseSerializer.h"
+#include "generated/serializer/JsonSerializer.h"
+// clang-format on
+
+namespace {
+namespace read = olp::dataservice::read;
+using mockserver::ApiDefaultResponses;
+using mockserver::ReadDefaultResponses;
+using ::testing::_;
+
+const std::string kCatalog =
+    "hrn:here:data::olp-here-test:hereos-internal-test-v2";
+const auto kHrn = olp::client::HRN::FromString(kCatalog);
+constexpr auto kLayerId = "testlayer";
+constexpr auto kVersion = 4;
+constexpr auto kUrlLookup =
+    R"(https://api-lookup.data.api.platform.here.com/lookup/v1/resources/hrn:here:data::olp-here-test:hereos-internal-test-v2/apis)";
+constexpr auto kLayerVersions =
+    R"jsonString({"version":4,"layerVersions":[{"layer":"testlayer","version":3,"timestamp":1547159598712},{"layer":"other_layer","version":4,"timestamp":1547159598712}]})jsonString";
+
+TEST(CatalogSnapshotTest, ResolvesVersionOnce) {
+  auto network_mock = std::make_shared<NetworkMock>();
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler = network_mock;
+  settings.task_scheduler =
+      olp::client::OlpClientSettingsFactory::CreateDefaultTaskScheduler(1);
+
+  auto apis = ApiDefaultResponses::GenerateResourceApisResponse(kCatalog);
+  PlatformUrlsGenerator generator(apis, kLayerId);
+
+  EXPECT_CALL(*network_mock, Send(IsGetRequest(kUrlLookup), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   ResponseGenerator::ResourceApis(apis)));
+  EXPECT_CALL(*network_mock,
+              Send(IsGetRequest(generator.LatestVersion()), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(
+          olp::http::NetworkResponse().WithStatus(
+              olp::http::HttpStatusCode::OK),
+          olp::serializer::serialize(
+              ReadDefaultResponses::GenerateVersionResponse(kVersion))));
+
+  read::CatalogSnapshotImpl snapshot(kHrn, boost::none, settings);
+  EXPECT_EQ(snapshot.GetResolvedVersion(),
+            read::CatalogSnapshotImpl::kInvalidVersion);
+
+  // The clients of all layers ask for the version at the same time.
+  std::vector<std::future<read::CatalogVersionResponse>> responses;
+  for (auto i = 0; i < 4; ++i) {
+    responses.push_back(std::async(std::launch::async, [&]() {
+      return snapshot.GetVersion(boost::none, read::OnlineIfNotFound,
+                                 olp::client::CancellationContext());
+    }));
+  }
+
+  for (auto& future : responses) {
+    auto response = future.get();
+    ASSERT_TRUE(response.IsSuccessful());
+    EXPECT_EQ(response.GetResult().GetVersion(), kVersion);
+  }
+
+  EXPECT_EQ(snapshot.GetResolvedVersion(), kVersion);
+  // The layer versions are not requested with the catalog version.
+  EXPECT_FALSE(snapshot.GetLayerVersion(kLayerId));
+
+  testing::Mock::VerifyAndClearExpectations(network_mock.get());
+}
+
+TEST(CatalogSnapshotTest, SharesLayerVersions) {
+  auto network_mock = std::make_shared<NetworkMock>();
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler = network_mock;
+  settings.task_scheduler =
+      olp::client::OlpClientSettingsFactory::CreateDefaultTaskScheduler(1);
+
+  auto apis = ApiDefaultResponses::GenerateResourceApisResponse(kCatalog);
+  PlatformUrlsGenerator generator(apis, kLayerId);
+
+  EXPECT_CALL(*network_mock, Send(IsGetRequest(kUrlLookup), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   ResponseGenerator::ResourceApis(apis)));
+  EXPECT_CALL(*network_mock,
+              Send(IsGetRequest(generator.LayerVersions(kVersion)), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   kLayerVersions));
+
+  read::CatalogSnapshotImpl snapshot(kHrn, kVersion - 1, settings);
+
+  // The clients of all layers upgrade to the same version at the same time.
+  std::vector<std::future<read::CatalogSnapshotImpl::LayerVersionsResponse>>
+      responses;
+  for (auto i = 0; i < 4; ++i) {
+    responses.push_back(std::async(std::launch::async, [&]() {
+      return snapshot.GetLayerVersions(kVersion, boost::none,
+                                       olp::client::CancellationContext());
+    }));
+  }
+
+  for (auto& future : responses) {
+    auto response = future.get();
+    ASSERT_TRUE(response.IsSuccessful());
+    EXPECT_EQ(response.GetResult().GetLayerVersions().size(), 2u);
+  }
+
+  // The layer versions belong to the upgraded version only.
+  EXPECT_FALSE(snapshot.GetLayerVersion(kLayerId));
+
+  snapshot.SetLayerUpgradeVersion(kLayerId, kVersion);
+  EXPECT_EQ(snapshot.GetLayerVersion(kLayerId).value_or(0), 3);
+  EXPECT_EQ(snapshot.GetLayerVersion("other_layer").value_or(0), 4);
+  EXPECT_FALSE(snapshot.GetLayerVersion("unknown_layer"));
+
+  testing::Mock::VerifyAndClearExpectations(network_mock.get());
+}
+
+TEST(CatalogSnapshotTest, SpecifiedVersion) {
+  auto network_mock = std::make_shared<NetworkMock>();
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler = network_mock;
+
+  EXPECT_CALL(*network_mock, Send(_, _, _, _, _)).Times(0);
+
+  read::CatalogSnapshot snapshot(kHrn, kVersion, settings);
+  EXPECT_EQ(snapshot.GetCatalog(), kHrn);
+  EXPECT_EQ(snapshot.GetVersion().value_or(0), kVersion);
+  EXPECT_FALSE(snapshot.GetLayerVersion(kLayerId));
+
+  testing::Mock::VerifyAndClearExpectations(network_mock.get());
+}
+
+}  // namespace
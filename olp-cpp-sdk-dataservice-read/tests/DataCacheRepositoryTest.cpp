@@ -102,4 +102,132 @@ TEST(PartitionsCacheRepositoryTest, IsCached) {
   }
 }
 
+TEST(DataCacheRepositoryTest, Validators) {
+  const auto hrn = client::HRN::FromString(kCatalog);
+  const auto layer = "layer";
+  const auto data = std::vector<unsigned char>{1, 2, 3};
+  const auto model_data = std::make_shared<std::vector<unsigned char>>(data);
+
+  repository::CacheValidators validators;
+  validators.etag = "\"etag\"";
+  validators.last_modified = "Wed, 21 Oct 2015 07:28:00 GMT";
+
+  std::shared_ptr<cache::KeyValueCache> cache =
+      olp::client::OlpClientSettingsFactory::CreateDefaultCache({});
+
+  {
+    SCOPED_TRACE("Expiration disabled");
+
+    repository::DataCacheRepository repository(hrn, cache);
+    repository.Put(model_data, layer, kDataHandle, validators);
+
+    EXPECT_TRUE(repository.Get(layer, kDataHandle));
+    EXPECT_FALSE(repository.GetValidators(layer, kDataHandle));
+  }
+  {
+    SCOPED_TRACE("Stale data");
+
+    repository::DataCacheRepository repository(hrn, cache,
+                                               std::chrono::seconds(0));
+    repository.Put(model_data, layer, kDataHandle, validators);
+
+    EXPECT_FALSE(repository.Get(layer, kDataHandle));
+    EXPECT_FALSE(repository.IsCached(layer, kDataHandle));
+
+    const auto stored = repository.GetValidators(layer, kDataHandle);
+    ASSERT_TRUE(stored);
+    EXPECT_EQ(validators.etag, stored->etag);
+    EXPECT_EQ(validators.last_modified, stored->last_modified);
+
+    const auto revalidated =
+        repository.Revalidate(layer, kDataHandle, *stored);
+    ASSERT_TRUE(revalidated);
+    EXPECT_EQ(*model_data, **revalidated);
+  }
+  {
+    SCOPED_TRACE("Fresh data");
+
+    repository::DataCacheRepository repository(hrn, cache,
+                                               std::chrono::seconds(3600));
+    EXPECT_TRUE(repository.Revalidate(layer, kDataHandle, validators));
+    EXPECT_TRUE(repository.Get(layer, kDataHandle));
+    EXPECT_TRUE(repository.IsCached(layer, kDataHandle));
+  }
+  {
+    SCOPED_TRACE("Data without validators");
+
+    repository::DataCacheRepository repository(hrn, cache,
+                                               std::chrono::seconds(3600));
+    repository.Put(model_data, layer, kDataHandle,
+                   repository::CacheValidators());
+    EXPECT_FALSE(repository.GetValidators(layer, kDataHandle));
+    EXPECT_TRUE(repository.Get(layer, kDataHandle));
+  }
+  {
+    SCOPED_TRACE("Validators are not read for the immutable data");
+
+    repository::DataCacheRepository repository(hrn, cache,
+                                               std::chrono::seconds(0));
+    repository.Put(model_data, layer, kDataHandle, validators);
+    ASSERT_FALSE(repository.Get(layer, kDataHandle));
+
+    repository::DataCacheRepository immutable_repository(
+        hrn, cache, std::chrono::seconds(3600), std::chrono::seconds(0),
+        false);
+    EXPECT_TRUE(immutable_repository.Get(layer, kDataHandle));
+    EXPECT_TRUE(immutable_repository.IsCached(layer, kDataHandle));
+
+    // The freshness of the stale data is checked.
+    repository::DataCacheRepository stale_repository(
+        hrn, cache, std::chrono::seconds(3600), std::chrono::seconds(60),
+        false);
+    EXPECT_FALSE(stale_repository.Get(layer, kDataHandle));
+  }
+}
+
+TEST(DataCacheRepositoryTest, StaleData) {
+  const auto hrn = client::HRN::FromString(kCatalog);
+  const auto layer = "layer";
+  const auto model_data =
+      std::make_shared<std::vector<unsigned char>>(3, 'a');
+
+  std::shared_ptr<cache::KeyValueCache> cache =
+      olp::client::OlpClientSettingsFactory::CreateDefaultCache({});
+
+  {
+    SCOPED_TRACE("Stale data is not kept");
+
+    repository::DataCacheRepository repository(hrn, cache,
+                                               std::chrono::seconds(0));
+    repository.Put(model_data, layer, kDataHandle);
+
+    EXPECT_FALSE(repository.Get(layer, kDataHandle));
+    EXPECT_FALSE(repository.GetStale(layer, kDataHandle));
+  }
+  {
+    SCOPED_TRACE("Stale data is kept for the max staleness");
+
+    repository::DataCacheRepository repository(
+        hrn, cache, std::chrono::seconds(0), std::chrono::seconds(60));
+    repository.Put(model_data, layer, kDataHandle);
+
+    EXPECT_FALSE(repository.Get(layer, kDataHandle));
+    EXPECT_FALSE(repository.IsCached(layer, kDataHandle));
+
+    const auto stale = repository.GetStale(layer, kDataHandle);
+    ASSERT_TRUE(stale);
+    EXPECT_EQ(*model_data, **stale);
+  }
+  {
+    SCOPED_TRACE("Fresh data");
+
+    repository::DataCacheRepository repository(
+        hrn, cache, std::chrono::seconds(3600), std::chrono::seconds(60));
+    repository.Put(model_data, layer, kDataHandle);
+
+    EXPECT_TRUE(repository.Get(layer, kDataHandle));
+    EXPECT_TRUE(repository.IsCached(layer, kDataHandle));
+  }
+}
+
 }  // namespace
@@ -17,9 +17,14 @@
  * License-Filename: LICENSE
  */
 
+#include <chrono>
+#include <future>
+#include <thread>
+
 #include <gtest/gtest.h>
 
 #include <matchers/NetworkUrlMatchers.h>
+#include <mocks/CacheMock.h>
 #include <mocks/NetworkMock.h>
 #include <olp/core/cache/CacheSettings.h>
 #include <olp/core/cache/KeyValueCache.h>
@@ -33,6 +38,7 @@
 #include <repositories/NamedMutex.h>
 #include <repositories/PartitionsCacheRepository.h>
 #include <repositories/PartitionsRepository.h>
+#include "TaskSink.h"
 
 constexpr auto kUrlLookup =
     R"(https://api-lookup.data.api.platform.here.com/lookup/v1/resources/hrn:here:data::olp-here-test:hereos-internal-test-v2/apis)";
@@ -49,6 +55,12 @@ constexpr auto kUrlBlobData1476147 =
 constexpr auto kUrlResponseLookup =
     R"jsonString([{"api":"query","version":"v1","baseURL":"https://sab.query.data.api.platform.here.com/query/v1/catalogs/hrn:here:data::olp-here-test:hereos-internal-test-v2","parameters":{}},{"api":"blob","version":"v1","baseURL":"https://blob-ireland.data.api.platform.here.com/blobstore/v1/catalogs/hereos-internal-test-v2","parameters":{}}])jsonString";
 
+constexpr auto kUrlVolatileBlobData =
+    R"(https://volatile-blob-ireland.data.api.platform.here.com/blobstore/v1/catalogs/hereos-internal-test-v2/layers/testlayer/data/4eed6ed1-0d32-43b9-ae79-043cb4256432)";
+
+constexpr auto kUrlResponseVolatileLookup =
+    R"jsonString([{"api":"volatile-blob","version":"v1","baseURL":"https://volatile-blob-ireland.data.api.platform.here.com/blobstore/v1/catalogs/hereos-internal-test-v2","parameters":{}}])jsonString";
+
 constexpr auto kUrlResponse403 =
     R"jsonString("Forbidden - A catalog with the specified HRN doesn't exist or access to this catalog is forbidden)jsonString";
 
@@ -63,6 +75,7 @@ constexpr auto kSubQuads =
 namespace {
 
 using olp::client::ApiLookupClient;
+using olp::dataservice::read::BlobApi;
 using olp::dataservice::read::repository::DataRepository;
 using testing::_;
 
@@ -213,6 +226,163 @@ TEST_F(DataRepositoryTest, GetBlobDataCache) {
   ASSERT_TRUE(response.IsSuccessful());
 }
 
+TEST_F(DataRepositoryTest, GetBlobDataAsync) {
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlLookup), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   kUrlResponseLookup));
+
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlBlobData269), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   "someData"));
+
+  olp::dataservice::read::DataRequest request;
+  request.WithDataHandle(kUrlBlobDataHandle);
+
+  olp::client::HRN hrn(GetTestCatalog());
+  ApiLookupClient lookup_client(hrn, *settings_);
+  DataRepository repository(hrn, *settings_, lookup_client);
+
+  auto get_blob_data = [&](const olp::dataservice::read::DataRequest& req) {
+    std::promise<olp::dataservice::read::BlobApi::DataResponse> promise;
+    auto future = promise.get_future();
+    repository.GetBlobDataAsync(
+        kLayerId, req, olp::client::CancellationContext(),
+        [&](olp::dataservice::read::BlobApi::DataResponse response) {
+          promise.set_value(std::move(response));
+        });
+    return future.get();
+  };
+
+  // This should download data from network and cache it
+  auto response = get_blob_data(request);
+  ASSERT_TRUE(response.IsSuccessful());
+  ASSERT_TRUE(response.GetResult());
+  EXPECT_EQ(std::string(response.GetResult()->begin(),
+                        response.GetResult()->end()),
+            "someData");
+
+  // The data is cached, no network calls are expected
+  auto cache_only_request = request;
+  cache_only_request.WithFetchOption(olp::dataservice::read::CacheOnly);
+  response = get_blob_data(cache_only_request);
+  ASSERT_TRUE(response.IsSuccessful());
+}
+
+TEST_F(DataRepositoryTest, GetBlobDataAsyncCachesOnTaskScheduler) {
+  auto cache = std::make_shared<testing::NiceMock<CacheMock>>();
+  settings_->cache = cache;
+  settings_->task_scheduler =
+      olp::client::OlpClientSettingsFactory::CreateDefaultTaskScheduler(1);
+
+  std::promise<std::thread::id> worker_promise;
+  settings_->task_scheduler->ScheduleTask(
+      [&]() { worker_promise.set_value(std::this_thread::get_id()); });
+  const auto worker_id = worker_promise.get_future().get();
+
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlLookup), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   kUrlResponseLookup));
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlBlobData269), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   "someData"));
+
+  // The blob is written to the cache by the worker, not by the network
+  // thread that received it.
+  std::thread::id put_id;
+  using CacheValue = std::shared_ptr<std::vector<unsigned char>>;
+  EXPECT_CALL(*cache, Put(testing::HasSubstr(kUrlBlobDataHandle), _, _))
+      .WillOnce(testing::DoAll(
+          testing::Invoke([&](const std::string&, const CacheValue, time_t) {
+            put_id = std::this_thread::get_id();
+          }),
+          testing::Return(true)));
+
+  olp::dataservice::read::DataRequest request;
+  request.WithDataHandle(kUrlBlobDataHandle);
+
+  olp::client::HRN hrn(GetTestCatalog());
+  ApiLookupClient lookup_client(hrn, *settings_);
+  DataRepository repository(hrn, *settings_, lookup_client);
+
+  std::promise<BlobApi::DataResponse> promise;
+  repository.GetBlobDataAsync(kLayerId, request,
+                              olp::client::CancellationContext(),
+                              [&](BlobApi::DataResponse response) {
+                                promise.set_value(std::move(response));
+                              });
+  auto response = promise.get_future().get();
+
+  ASSERT_TRUE(response.IsSuccessful());
+  EXPECT_EQ(put_id, worker_id);
+}
+
+TEST_F(DataRepositoryTest, GetBlobDataVerifyChecksum) {
+  const std::string kChecksum =
+      "8fe66dfe080fa7fd45d60a308097217a92a85b1c0ac02f31b11572ea0422514e";
+  const std::string kWrongChecksum =
+      "0000000000000000000000000000000000000000000000000000000000000000";
+
+  olp::client::CancellationContext context;
+  olp::client::HRN hrn(GetTestCatalog());
+
+  olp::dataservice::read::DataRequest request;
+  request.WithDataHandle(kUrlBlobDataHandle);
+
+  {
+    SCOPED_TRACE("Checksum mismatch");
+
+    EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlLookup), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     kUrlResponseLookup));
+
+    EXPECT_CALL(*network_mock_,
+                Send(IsGetRequest(kUrlBlobData269), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     "someData"));
+
+    ApiLookupClient lookup_client(hrn, *settings_);
+    DataRepository repository(hrn, *settings_, lookup_client);
+    auto response = repository.GetBlobData(kLayerId, kService, request,
+                                           context, false, kWrongChecksum);
+
+    ASSERT_FALSE(response.IsSuccessful());
+    EXPECT_EQ(response.GetError().GetErrorCode(),
+              olp::client::ErrorCode::ChecksumMismatch);
+
+    // Corrupted data must not be cached
+    auto cache_only_request = request;
+    cache_only_request.WithFetchOption(olp::dataservice::read::CacheOnly);
+    response = repository.GetBlobData(kLayerId, kService, cache_only_request,
+                                      context);
+
+    ASSERT_FALSE(response.IsSuccessful());
+    testing::Mock::VerifyAndClearExpectations(network_mock_.get());
+  }
+
+  {
+    SCOPED_TRACE("Checksum match");
+
+    EXPECT_CALL(*network_mock_,
+                Send(IsGetRequest(kUrlBlobData269), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     "someData"));
+
+    ApiLookupClient lookup_client(hrn, *settings_);
+    DataRepository repository(hrn, *settings_, lookup_client);
+    auto response = repository.GetBlobData(kLayerId, kService, request,
+                                           context, false, kChecksum);
+
+    ASSERT_TRUE(response.IsSuccessful());
+  }
+}
+
 TEST_F(DataRepositoryTest, GetBlobDataImmediateCancel) {
   ON_CALL(*network_mock_, Send(IsGetRequest(kUrlLookup), _, _, _, _))
       .WillByDefault(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
@@ -335,6 +505,73 @@ TEST_F(DataRepositoryTest, GetBlobDataSimultaniousFailedCalls) {
   second_request_thread.join();
 }
 
+TEST_F(DataRepositoryTest, GetVolatileDataRevalidation) {
+  // The data is stale as soon as it is stored.
+  settings_->default_cache_expiration = std::chrono::seconds(0);
+
+  olp::dataservice::read::DataRequest request;
+  request.WithDataHandle(kUrlBlobDataHandle);
+
+  ApiLookupClient lookup_client(hrn_, *settings_);
+  DataRepository repository(hrn_, *settings_, lookup_client);
+
+  {
+    SCOPED_TRACE("Download the data with validators");
+
+    EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlLookup), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     kUrlResponseVolatileLookup));
+
+    EXPECT_CALL(*network_mock_,
+                Send(IsGetRequest(kUrlVolatileBlobData), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::OK),
+            "someData", {{"ETag", "\"v1\""}}));
+
+    auto response = repository.GetVolatileData(kLayerId, request, {});
+    ASSERT_TRUE(response.IsSuccessful());
+    testing::Mock::VerifyAndClearExpectations(network_mock_.get());
+  }
+  {
+    SCOPED_TRACE("Not modified");
+
+    EXPECT_CALL(*network_mock_,
+                Send(testing::AllOf(
+                         IsGetRequest(kUrlVolatileBlobData),
+                         HeadersContain(olp::http::Header(
+                             "If-None-Match", "\"v1\""))),
+                     _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::NOT_MODIFIED),
+            ""));
+
+    auto response = repository.GetVolatileData(kLayerId, request, {});
+    ASSERT_TRUE(response.IsSuccessful());
+    ASSERT_TRUE(response.GetResult());
+    EXPECT_EQ("someData", std::string(response.GetResult()->begin(),
+                                      response.GetResult()->end()));
+    testing::Mock::VerifyAndClearExpectations(network_mock_.get());
+  }
+  {
+    SCOPED_TRACE("Modified");
+
+    EXPECT_CALL(*network_mock_,
+                Send(IsGetRequest(kUrlVolatileBlobData), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::OK),
+            "newData", {{"ETag", "\"v2\""}}));
+
+    auto response = repository.GetVolatileData(kLayerId, request, {});
+    ASSERT_TRUE(response.IsSuccessful());
+    EXPECT_EQ("newData", std::string(response.GetResult()->begin(),
+                                     response.GetResult()->end()));
+  }
+}
+
 TEST_F(DataRepositoryTest, GetVersionedDataTile) {
   EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlLookup), _, _, _, _))
       .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
@@ -396,6 +633,52 @@ TEST_F(DataRepositoryTest, GetVersionedDataTile) {
   }
 }
 
+TEST_F(DataRepositoryTest, GetVersionedDataTileAsync) {
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlLookup), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   kUrlResponseLookup));
+
+  EXPECT_CALL(*network_mock_,
+              Send(IsGetRequest(kUrlQueryTreeIndex), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   kSubQuads));
+
+  EXPECT_CALL(*network_mock_,
+              Send(IsGetRequest(kUrlBlobData5904591), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   "someData"));
+
+  olp::client::HRN hrn(GetTestCatalog());
+  int64_t version = 4;
+
+  ApiLookupClient lookup_client(hrn, *settings_);
+  DataRepository repository(hrn, *settings_, lookup_client);
+
+  // identical requests in flight share the quadtree and blob downloads
+  auto request = olp::dataservice::read::TileRequest().WithTileKey(
+      olp::geo::TileKey::FromHereTile("5904591"));
+  std::promise<BlobApi::DataResponse> promises[2];
+  for (auto& promise : promises) {
+    repository.GetVersionedTileAsync(
+        kLayerId, request, version, olp::client::CancellationContext(),
+        [&promise](BlobApi::DataResponse response) {
+          promise.set_value(std::move(response));
+        });
+  }
+
+  for (auto& promise : promises) {
+    auto response = promise.get_future().get();
+    ASSERT_TRUE(response.IsSuccessful());
+    ASSERT_TRUE(response.GetResult());
+    EXPECT_EQ(std::string(response.GetResult()->begin(),
+                          response.GetResult()->end()),
+              "someData");
+  }
+}
+
 TEST_F(DataRepositoryTest, GetVersionedDataTileOnlineOnly) {
   EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlLookup), _, _, _, _))
       .Times(2)
@@ -523,4 +806,96 @@ TEST_F(DataRepositoryTest, GetVersionedDataTileReturnEmpty) {
   ASSERT_EQ(response.GetError().GetMessage(),
             "Failed to parse quad tree response");
 }
+
+TEST_F(DataRepositoryTest, GetVolatileDataStaleWhileRevalidate) {
+  // The data is stale as soon as it is stored, but kept for a minute.
+  settings_->default_cache_expiration = std::chrono::seconds(0);
+  settings_->max_staleness = std::chrono::seconds(60);
+  settings_->task_scheduler =
+      olp::client::OlpClientSettingsFactory::CreateDefaultTaskScheduler(1);
+
+  olp::dataservice::read::DataRequest request;
+  request.WithDataHandle(kUrlBlobDataHandle);
+
+  ApiLookupClient lookup_client(hrn_, *settings_);
+  olp::dataservice::read::TaskSink task_sink(settings_->task_scheduler);
+  olp::dataservice::read::repository::NamedMutexStorage storage;
+  DataRepository repository(hrn_, *settings_, lookup_client, storage,
+                            &task_sink);
+
+  {
+    SCOPED_TRACE("Download the data");
+
+    EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlLookup), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     kUrlResponseVolatileLookup));
+    EXPECT_CALL(*network_mock_,
+                Send(IsGetRequest(kUrlVolatileBlobData), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     "someData"));
+
+    auto response = repository.GetVolatileData(kLayerId, request, {});
+    ASSERT_TRUE(response.IsSuccessful());
+    testing::Mock::VerifyAndClearExpectations(network_mock_.get());
+  }
+  {
+    SCOPED_TRACE("Stale data is not refreshed without a task sink");
+
+    EXPECT_CALL(*network_mock_,
+                Send(IsGetRequest(kUrlVolatileBlobData), _, _, _, _))
+        .Times(0);
+
+    auto stale_request = request;
+    stale_request.WithFetchOption(olp::dataservice::read::StaleWhileRevalidate);
+
+    DataRepository other_repository(hrn_, *settings_, lookup_client);
+    auto response = other_repository.GetVolatileData(kLayerId, stale_request,
+                                                     {});
+    ASSERT_TRUE(response.IsSuccessful());
+    EXPECT_EQ("someData", std::string(response.GetResult()->begin(),
+                                      response.GetResult()->end()));
+    testing::Mock::VerifyAndClearExpectations(network_mock_.get());
+  }
+  {
+    SCOPED_TRACE("Stale data is returned and refreshed once");
+
+    EXPECT_CALL(*network_mock_,
+                Send(IsGetRequest(kUrlVolatileBlobData), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::OK),
+            "newData", {}, std::chrono::milliseconds(100)));
+
+    request.WithFetchOption(olp::dataservice::read::StaleWhileRevalidate);
+    for (int i = 0; i < 2; ++i) {
+      auto response = repository.GetVolatileData(kLayerId, request, {});
+      ASSERT_TRUE(response.IsSuccessful());
+      EXPECT_EQ("someData", std::string(response.GetResult()->begin(),
+                                        response.GetResult()->end()));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    testing::Mock::VerifyAndClearExpectations(network_mock_.get());
+  }
+  {
+    SCOPED_TRACE("Refreshed data");
+
+    EXPECT_CALL(*network_mock_,
+                Send(IsGetRequest(kUrlVolatileBlobData), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     "newData"));
+
+    auto response = repository.GetVolatileData(kLayerId, request, {});
+    ASSERT_TRUE(response.IsSuccessful());
+    EXPECT_EQ("newData", std::string(response.GetResult()->begin(),
+                                     response.GetResult()->end()));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    testing::Mock::VerifyAndClearExpectations(network_mock_.get());
+  }
+}
+
 }  // namespace
@@ -84,6 +84,34 @@ TEST(JsonResultParserTest, ParseResult) {
   }
 }
 
+TEST(JsonResultParserTest, ReusesParserMemory) {
+  {
+    SCOPED_TRACE("Verify repeated parsing on the same thread");
+    auto partitions =
+        mockserver::ReadDefaultResponses::GeneratePartitionsResponse();
+    auto partitions_string = olp::serializer::serialize(partitions);
+
+    for (auto i = 0; i < 3; ++i) {
+      auto str = std::stringstream(partitions_string);
+      auto responce = olp::parser::parse_result<dr::PartitionsResponse>(str);
+      ASSERT_TRUE(responce.IsSuccessful());
+      ASSERT_EQ(10u, responce.GetResult().GetPartitions().size());
+    }
+  }
+  {
+    SCOPED_TRACE("Verify response larger than the memory pool");
+    auto partitions =
+        mockserver::ReadDefaultResponses::GeneratePartitionsResponse(1000);
+    auto str = std::stringstream(olp::serializer::serialize(partitions));
+
+    auto responce = olp::parser::parse_result<dr::PartitionsResponse>(str);
+    ASSERT_TRUE(responce.IsSuccessful());
+    ASSERT_EQ(1000u, responce.GetResult().GetPartitions().size());
+    EXPECT_EQ(partitions.GetPartitions().back().GetPartition(),
+              responce.GetResult().GetPartitions().back().GetPartition());
+  }
+}
+
 TEST(JsonResultParserTest, ExtendedResponse) {
   auto partitions =
       mockserver::ReadDefaultResponses::GeneratePartitionsResponse();
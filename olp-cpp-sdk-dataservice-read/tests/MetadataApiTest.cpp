@@ -42,6 +42,12 @@ constexpr auto kUrlVersionsListBillingTag =
 constexpr auto kHttpVersionsListResponse =
     R"jsonString({"versions":[{"version":4,"timestamp":1547159598712,"partitionCounts":{"testlayer":5,"testlayer_res":1,"multilevel_testlayer":33, "hype-test-prefetch-2":7,"testlayer_gzip":1,"hype-test-prefetch":7},"dependencies":[ { "hrn":"hrn:here:data::olp-here-test:hereos-internal-test-v2","version":0,"direct":false},{"hrn":"hrn:here:data:::hereos-internal-test-v2","version":0,"direct":false }]}]})jsonString";
 
+constexpr auto kUrlPartitions =
+    R"(https://some.node.base.url/metadata/v1/catalogs/hrn:here:data::olp-here-test:hereos-internal-test-v2/layers/testlayer/partitions?version=4)";
+
+constexpr auto kHttpPartitionsResponse =
+    R"jsonString({"partitions":[{"version":4,"partition":"1","dataHandle":"handle-1"},{"version":4,"partition":"2","dataHandle":"handle-2"}]})jsonString";
+
 using ::testing::_;
 namespace http = olp::http;
 namespace client = olp::client;
@@ -125,4 +131,42 @@ TEST_F(MetadataApiTest, GetListVersions) {
   }
 }
 
+TEST_F(MetadataApiTest, GetPartitionsStream) {
+  {
+    SCOPED_TRACE("Stream partitions");
+    EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlPartitions), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            http::NetworkResponse().WithStatus(http::HttpStatusCode::OK),
+            kHttpPartitionsResponse));
+
+    std::vector<std::string> partitions;
+    auto response = olp::dataservice::read::MetadataApi::GetPartitionsStream(
+        *client_, "testlayer", kEndVersion, {}, boost::none,
+        [&](olp::dataservice::read::model::Partition partition) {
+          partitions.push_back(partition.GetPartition());
+          return true;
+        },
+        olp::client::CancellationContext{});
+
+    ASSERT_TRUE(response.IsSuccessful());
+    EXPECT_EQ(std::vector<std::string>({"1", "2"}), partitions);
+  }
+  {
+    SCOPED_TRACE("Invalid response");
+    EXPECT_CALL(*network_mock_, Send(IsGetRequest(kUrlPartitions), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            http::NetworkResponse().WithStatus(http::HttpStatusCode::OK),
+            "{\"partitions\":[{\"partition\":\"1\"}"));
+
+    auto response = olp::dataservice::read::MetadataApi::GetPartitionsStream(
+        *client_, "testlayer", kEndVersion, {}, boost::none,
+        [](olp::dataservice::read::model::Partition) { return true; },
+        olp::client::CancellationContext{});
+
+    ASSERT_FALSE(response.IsSuccessful());
+    EXPECT_EQ(olp::client::ErrorCode::Unknown,
+              response.GetError().GetErrorCode());
+  }
+}
+
 }  // namespace
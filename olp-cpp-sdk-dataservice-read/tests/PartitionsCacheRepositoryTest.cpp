@@ -224,4 +224,116 @@ TEST(PartitionsCacheRepositoryTest, GetPartitionHandle) {
   }
 }
 
+
+TEST(PartitionsCacheRepositoryTest, BaseVersion) {
+  const auto hrn = HRN::FromString(kCatalog);
+  const auto layer = "layer";
+  const auto tile_key = olp::geo::TileKey::FromHereTile(kHereTile);
+
+  model::Partition some_partition;
+  some_partition.SetPartition(kPartitionId);
+  some_partition.SetDataHandle(kDataHandle);
+  model::Partitions partitions;
+  partitions.GetMutablePartitions().push_back(some_partition);
+
+  std::shared_ptr<KeyValueCache> cache =
+      olp::client::OlpClientSettingsFactory::CreateDefaultCache({});
+  repository::PartitionsCacheRepository repository(hrn, layer, cache);
+  repository.Put(partitions, 1, boost::none, true);
+
+  auto stream = std::stringstream(kQuadkeyResponse);
+  repository.Put(tile_key, 4, read::QuadTreeIndex(tile_key, 4, stream), 1);
+
+  {
+    SCOPED_TRACE("Not linked version");
+
+    EXPECT_FALSE(repository.GetBaseVersion(2));
+    EXPECT_FALSE(repository.GetFromBaseVersion(read::PartitionsRequest(), 2));
+  }
+
+  ASSERT_TRUE(repository.PutBaseVersion(2, 1).IsSuccessful());
+  ASSERT_TRUE(repository.PutBaseVersion(3, 2).IsSuccessful());
+
+  {
+    SCOPED_TRACE("Linked versions");
+
+    EXPECT_EQ(repository.GetBaseVersion(3).value_or(0), 2);
+    EXPECT_FALSE(repository.GetBaseVersion(boost::none));
+
+    // The entries are copied through all linked versions.
+    const auto copied =
+        repository.GetFromBaseVersion(read::PartitionsRequest(), 3);
+    ASSERT_TRUE(copied);
+    ASSERT_EQ(copied->GetPartitions().size(), 1u);
+    EXPECT_EQ(copied->GetPartitions().front().GetDataHandle(), kDataHandle);
+
+    std::string handle;
+    EXPECT_TRUE(repository.GetPartitionHandle(kPartitionId, 3, handle));
+    EXPECT_TRUE(repository.Get(read::PartitionsRequest(), 3));
+
+    read::QuadTreeIndex tree;
+    EXPECT_FALSE(repository.FindQuadTree(tile_key, 3, tree));
+    EXPECT_TRUE(repository.FindQuadTreeInBaseVersion(tile_key, 3, tree));
+    EXPECT_TRUE(repository.ContainsTree(tile_key, 4, 3));
+  }
+  {
+    SCOPED_TRACE("Invalid link");
+
+    ASSERT_TRUE(repository.PutBaseVersion(4, 5).IsSuccessful());
+    EXPECT_FALSE(repository.GetBaseVersion(4));
+  }
+}
+
+TEST(PartitionsCacheRepositoryTest, StalePartitions) {
+  const auto hrn = HRN::FromString(kCatalog);
+  const auto layer = "layer";
+  const auto request = read::PartitionsRequest();
+  const auto by_id =
+      read::PartitionsRequest().WithPartitionIds({kPartitionId});
+
+  model::Partition some_partition;
+  some_partition.SetPartition(kPartitionId);
+  some_partition.SetDataHandle(kDataHandle);
+  model::Partitions partitions;
+  partitions.GetMutablePartitions().push_back(some_partition);
+
+  std::shared_ptr<KeyValueCache> cache =
+      olp::client::OlpClientSettingsFactory::CreateDefaultCache({});
+  // The partitions are stale as soon as they are stored.
+  repository::PartitionsCacheRepository repository(
+      hrn, layer, cache, std::chrono::seconds::max(), std::chrono::seconds(60));
+  repository.Put(partitions, boost::none, 0, true);
+
+  {
+    SCOPED_TRACE("Stale partitions are not returned by Get");
+
+    EXPECT_FALSE(repository.Get(request, boost::none));
+    EXPECT_FALSE(repository.Get(by_id, boost::none));
+  }
+  {
+    SCOPED_TRACE("Stale partitions are returned by GetStale");
+
+    bool stale = false;
+    auto cached = repository.GetStale(request, boost::none, stale);
+    ASSERT_TRUE(cached);
+    EXPECT_TRUE(stale);
+    ASSERT_EQ(cached->GetPartitions().size(), 1u);
+    EXPECT_EQ(cached->GetPartitions().front().GetDataHandle(), kDataHandle);
+
+    stale = false;
+    EXPECT_TRUE(repository.GetStale(by_id, boost::none, stale));
+    EXPECT_TRUE(stale);
+  }
+  {
+    SCOPED_TRACE("Fresh partitions");
+
+    repository.Put(partitions, boost::none, 3600, true);
+
+    bool stale = true;
+    EXPECT_TRUE(repository.GetStale(request, boost::none, stale));
+    EXPECT_FALSE(stale);
+    EXPECT_TRUE(repository.Get(request, boost::none));
+  }
+}
+
 }  // namespace
@@ -19,6 +19,8 @@
 
 #include "repositories/PartitionsRepository.h"
 
+#include <future>
+
 #include <gmock/gmock.h>
 #include <matchers/NetworkUrlMatchers.h>
 #include <mocks/CacheMock.h>
@@ -289,6 +291,39 @@ TEST_F(PartitionsRepositoryTest, GetPartitionById) {
 
     Mock::VerifyAndClearExpectations(cache.get());
   }
+  {
+    SCOPED_TRACE("Fetch from network asynchronously");
+    setup_online_only_mocks();
+    setup_positive_metadata_mocks();
+
+    EXPECT_CALL(*network,
+                Send(IsGetRequest(kOlpSdkUrlPartitionById), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     kOlpSdkHttpResponsePartitionById));
+
+    EXPECT_CALL(*cache, Put(Eq(cache_key), _, _, _)).Times(0);
+
+    std::promise<read::PartitionsResponse> promise;
+    repository.GetPartitionByIdAsync(
+        DataRequest(request).WithFetchOption(read::OnlineOnly), kVersion,
+        client::CancellationContext(),
+        [&](read::PartitionsResponse response) {
+          promise.set_value(std::move(response));
+        });
+    auto response = promise.get_future().get();
+
+    ASSERT_TRUE(response.IsSuccessful());
+    const auto& partitions = response.GetResult().GetPartitions();
+    EXPECT_EQ(partitions.size(), 1);
+    const auto& partition = partitions.front();
+    EXPECT_EQ(partition.GetDataHandle(),
+              "PartitionsRepositoryTest-partitionId");
+    EXPECT_EQ(partition.GetPartition(), "1111");
+
+    Mock::VerifyAndClearExpectations(network.get());
+    Mock::VerifyAndClearExpectations(cache.get());
+  }
   {
     SCOPED_TRACE("Fetch from network with missing version");
     setup_online_only_mocks();
@@ -714,6 +749,164 @@ TEST_F(PartitionsRepositoryTest, GetVersionedPartitions) {
   }
 }
 
+TEST_F(PartitionsRepositoryTest, StreamVersionedPartitions) {
+  using testing::EndsWith;
+  using testing::Mock;
+  using testing::Return;
+
+  auto mock_network = std::make_shared<NetworkMock>();
+  const auto catalog = HRN::FromString(kCatalog);
+  const std::string layer_prefix = kCatalog + "::" + kVersionedLayerId + "::";
+  const std::string partition_suffix =
+      "::" + std::to_string(kVersion) + "::partition";
+  const std::string partitions_key =
+      layer_prefix + std::to_string(kVersion) + "::partitions";
+
+  auto expect_partitions_request = [&](olp::http::NetworkResponse response,
+                                       const std::string& body) {
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(kOlpSdkUrlLookupMetadata2), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     kOlpSdkHttpResponseLookupMetadata2));
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(kOlpSdkUrlVersionedPartitions), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(response, body));
+  };
+
+  {
+    SCOPED_TRACE("Each partition is cached, then the list of partitions");
+
+    auto cache = std::make_shared<testing::NiceMock<CacheMock>>();
+    OlpClientSettings settings;
+    settings.cache = cache;
+    settings.network_request_handler = mock_network;
+    settings.retry_settings.timeout = 1;
+
+    expect_partitions_request(
+        olp::http::NetworkResponse().WithStatus(olp::http::HttpStatusCode::OK),
+        kOlpSdkHttpResponsePartitions);
+
+    {
+      testing::InSequence sequence;
+      EXPECT_CALL(*cache, Put(EndsWith(partition_suffix), _, _, _))
+          .Times(4)
+          .WillRepeatedly(Return(true));
+      EXPECT_CALL(*cache, Put(partitions_key, _, _, _))
+          .WillOnce(Return(true));
+    }
+
+    client::CancellationContext context;
+    olp::client::ApiLookupClient lookup_client(catalog, settings);
+    repository::PartitionsRepository repository(catalog, kVersionedLayerId,
+                                                settings, lookup_client);
+
+    std::vector<std::string> partitions;
+    auto response = repository.StreamVersionedPartitions(
+        read::PartitionsRequest(), kVersion,
+        [&](model::Partition partition) {
+          partitions.push_back(partition.GetPartition());
+        },
+        context);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    EXPECT_EQ(partitions, std::vector<std::string>(
+                              {"269", "270", "3", "here_van_wc2018_pool"}));
+    Mock::VerifyAndClearExpectations(cache.get());
+  }
+  {
+    SCOPED_TRACE("The list is not cached if a partition is not cached");
+
+    auto cache = std::make_shared<testing::NiceMock<CacheMock>>();
+    OlpClientSettings settings;
+    settings.cache = cache;
+    settings.network_request_handler = mock_network;
+    settings.retry_settings.timeout = 1;
+
+    expect_partitions_request(
+        olp::http::NetworkResponse().WithStatus(olp::http::HttpStatusCode::OK),
+        kOlpSdkHttpResponsePartitions);
+
+    // The partitions after the failed one are not written.
+    EXPECT_CALL(*cache, Put(EndsWith(partition_suffix), _, _, _))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*cache, Put(partitions_key, _, _, _)).Times(0);
+
+    client::CancellationContext context;
+    olp::client::ApiLookupClient lookup_client(catalog, settings);
+    repository::PartitionsRepository repository(catalog, kVersionedLayerId,
+                                                settings, lookup_client);
+
+    size_t partitions = 0u;
+    auto response = repository.StreamVersionedPartitions(
+        read::PartitionsRequest(), kVersion,
+        [&](model::Partition) { ++partitions; }, context);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    EXPECT_EQ(partitions, 4u);
+    Mock::VerifyAndClearExpectations(cache.get());
+  }
+  {
+    SCOPED_TRACE("Forbidden response clears the cached layer");
+
+    auto cache = std::make_shared<testing::NiceMock<CacheMock>>();
+    OlpClientSettings settings;
+    settings.cache = cache;
+    settings.network_request_handler = mock_network;
+    settings.retry_settings.timeout = 1;
+
+    expect_partitions_request(olp::http::NetworkResponse().WithStatus(
+                                  olp::http::HttpStatusCode::FORBIDDEN),
+                              "Forbidden");
+
+    EXPECT_CALL(*cache, RemoveKeysWithPrefix(layer_prefix))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*cache, Put(partitions_key, _, _, _)).Times(0);
+
+    client::CancellationContext context;
+    olp::client::ApiLookupClient lookup_client(catalog, settings);
+    repository::PartitionsRepository repository(catalog, kVersionedLayerId,
+                                                settings, lookup_client);
+
+    size_t partitions = 0u;
+    auto response = repository.StreamVersionedPartitions(
+        read::PartitionsRequest(), kVersion,
+        [&](model::Partition) { ++partitions; }, context);
+
+    ASSERT_FALSE(response.IsSuccessful());
+    EXPECT_EQ(response.GetError().GetHttpStatusCode(),
+              olp::http::HttpStatusCode::FORBIDDEN);
+    EXPECT_EQ(partitions, 0u);
+    Mock::VerifyAndClearExpectations(cache.get());
+  }
+  {
+    SCOPED_TRACE("CacheOnly does not stream from the network");
+
+    auto cache = std::make_shared<testing::NiceMock<CacheMock>>();
+    OlpClientSettings settings;
+    settings.cache = cache;
+    settings.network_request_handler = mock_network;
+    settings.retry_settings.timeout = 1;
+
+    EXPECT_CALL(*mock_network, Send(_, _, _, _, _)).Times(0);
+
+    client::CancellationContext context;
+    olp::client::ApiLookupClient lookup_client(catalog, settings);
+    repository::PartitionsRepository repository(catalog, kVersionedLayerId,
+                                                settings, lookup_client);
+
+    size_t partitions = 0u;
+    auto response = repository.StreamVersionedPartitions(
+        read::PartitionsRequest().WithFetchOption(read::CacheOnly), kVersion,
+        [&](model::Partition) { ++partitions; }, context);
+
+    ASSERT_FALSE(response.IsSuccessful());
+    EXPECT_EQ(response.GetError().GetErrorCode(), ErrorCode::NotFound);
+    EXPECT_EQ(partitions, 0u);
+    Mock::VerifyAndClearExpectations(mock_network.get());
+  }
+}
+
 TEST_F(PartitionsRepositoryTest, GetVolatilePartitions) {
   using testing::Return;
 
@@ -855,6 +1048,85 @@ TEST_F(PartitionsRepositoryTest, AdditionalFields) {
   EXPECT_EQ(partitions[0].GetCrc(), cached_partitions[0].GetCrc());
 }
 
+TEST_F(PartitionsRepositoryTest, GetPartitionByIdWithChecksum) {
+  using testing::Mock;
+
+  std::shared_ptr<cache::KeyValueCache> default_cache =
+      olp::client::OlpClientSettingsFactory::CreateDefaultCache({});
+  auto mock_network = std::make_shared<NetworkMock>();
+  const auto catalog = HRN::FromString(kCatalog);
+
+  OlpClientSettings settings;
+  settings.cache = default_cache;
+  settings.network_request_handler = mock_network;
+  settings.retry_settings.timeout = 1;
+
+  // The partition is cached by a request without the checksum.
+  repository::PartitionsCacheRepository cache_repository(
+      catalog, kVersionedLayerId, default_cache);
+  cache_repository.Put(
+      parser::parse<model::Partitions>(kOlpSdkHttpResponsePartitionById),
+      kVersion, boost::none, false);
+
+  olp::client::ApiLookupClient lookup_client(catalog, settings);
+  repository::PartitionsRepository repository(catalog, kVersionedLayerId,
+                                              settings, lookup_client);
+  client::CancellationContext context;
+  auto request = DataRequest()
+                     .WithPartitionId(kPartitionId)
+                     .WithChecksumVerificationEnabled(true);
+
+  {
+    SCOPED_TRACE("CacheOnly");
+
+    auto response = repository.GetPartitionById(
+        DataRequest(request).WithFetchOption(read::CacheOnly), kVersion,
+        context);
+
+    ASSERT_FALSE(response.IsSuccessful());
+    EXPECT_EQ(response.GetError().GetErrorCode(), ErrorCode::NotFound);
+  }
+  {
+    SCOPED_TRACE("The metadata is requested with the checksum");
+
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(kOlpSdkUrlLookupQuery), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     kOlpSdkHttpResponseLookupQuery));
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(kOlpSdkUrlPartitionByIdBase +
+                                  "?additionalFields=checksum&partition=" +
+                                  kPartitionId +
+                                  "&version=" + std::to_string(kVersion)),
+                     _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     kOlpSdkHttpResponsePartitionById));
+
+    auto response = repository.GetPartitionById(request, kVersion, context);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    ASSERT_EQ(response.GetResult().GetPartitions().size(), 1u);
+    EXPECT_FALSE(response.GetResult().GetPartitions()[0].GetChecksum());
+    Mock::VerifyAndClearExpectations(mock_network.get());
+  }
+  {
+    SCOPED_TRACE("The service has no checksum, it is not requested again");
+
+    EXPECT_CALL(*mock_network, Send(_, _, _, _, _)).Times(0);
+
+    auto response = repository.GetPartitionById(request, kVersion, context);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    ASSERT_EQ(response.GetResult().GetPartitions().size(), 1u);
+    EXPECT_EQ(
+        response.GetResult().GetPartitions()[0].GetChecksum().value_or("none"),
+        "");
+    Mock::VerifyAndClearExpectations(mock_network.get());
+  }
+}
+
 TEST_F(PartitionsRepositoryTest, CheckCashedPartitions) {
   std::shared_ptr<cache::KeyValueCache> default_cache =
       olp::client::OlpClientSettingsFactory::CreateDefaultCache({});
@@ -1269,4 +1541,233 @@ TEST_F(PartitionsRepositoryTest, GetTile) {
   }
 }
 
+
+TEST_F(PartitionsRepositoryTest, UpgradeToVersion) {
+  using testing::Mock;
+
+  std::shared_ptr<cache::KeyValueCache> default_cache =
+      olp::client::OlpClientSettingsFactory::CreateDefaultCache({});
+  auto mock_network = std::make_shared<NetworkMock>();
+  OlpClientSettings settings;
+  settings.cache = default_cache;
+  settings.network_request_handler = mock_network;
+  settings.retry_settings.timeout = 1;
+
+  const auto hrn = HRN::FromString(kCatalog);
+  const std::string layer = "testlayer";
+  const std::string metadata_url =
+      "https://metadata.data.api.platform.here.com/metadata/v1/catalogs/"
+      "hereos-internal-test-v2";
+
+  // Version 4 of the layer is in the cache.
+  repository::PartitionsCacheRepository cache_repository(hrn, layer,
+                                                         default_cache);
+  cache_repository.Put(
+      parser::parse<model::Partitions>(kOlpSdkHttpResponsePartitions), kVersion,
+      boost::none, true);
+
+  const auto root = olp::geo::TileKey::FromHereTile("23064");
+  auto stream = std::stringstream(kSubQuads);
+  cache_repository.Put(root, 4, read::QuadTreeIndex(root, 4, stream),
+                       kVersion);
+
+  EXPECT_CALL(*mock_network,
+              Send(IsGetRequest(kOlpSdkUrlLookupMetadata2), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   kOlpSdkHttpResponseLookupMetadata2));
+
+  olp::client::ApiLookupClient lookup_client(hrn, settings);
+  repository::PartitionsRepository repository(hrn, layer, settings,
+                                              lookup_client);
+
+  {
+    SCOPED_TRACE("Unchanged layer");
+
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(metadata_url + "/layerVersions?version=5"),
+                     _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::OK),
+            R"jsonString({"version":5,"layerVersions":[{"layer":"testlayer","version":4,"timestamp":1}]})jsonString"));
+
+    client::CancellationContext context;
+    auto response =
+        repository.UpgradeToVersion(kVersion, 5, boost::none, context);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    EXPECT_FALSE(response.GetResult().IsLayerChanged());
+    EXPECT_TRUE(response.GetResult().GetChangedPartitions().empty());
+
+    // The metadata of version 4 is used without downloading it again.
+    auto partitions_response = repository.GetVersionedPartitions(
+        read::PartitionsRequest().WithFetchOption(read::CacheOnly), 5,
+        context);
+    ASSERT_TRUE(partitions_response.IsSuccessful());
+    EXPECT_EQ(partitions_response.GetResult().GetPartitions().size(), 4u);
+
+    auto tile_response = repository.GetTile(
+        read::TileRequest()
+            .WithTileKey(olp::geo::TileKey::FromHereTile("1476147"))
+            .WithFetchOption(read::CacheOnly),
+        5, context);
+    ASSERT_TRUE(tile_response.IsSuccessful());
+    EXPECT_EQ(tile_response.GetResult().GetDataHandle(),
+              kBlobDataHandle1476147);
+
+    Mock::VerifyAndClearExpectations(mock_network.get());
+  }
+  {
+    SCOPED_TRACE("Changed layer");
+
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(metadata_url + "/layerVersions?version=6"),
+                     _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::OK),
+            R"jsonString({"version":6,"layerVersions":[{"layer":"testlayer","version":6,"timestamp":1}]})jsonString"));
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(metadata_url + "/layers/testlayer/"
+                                                 "partitions?version=6"),
+                     _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::OK),
+            R"jsonString({ "partitions": [{"version":4,"partition":"269","layer":"testlayer","dataHandle":"4eed6ed1-0d32-43b9-ae79-043cb4256432"},{"version":6,"partition":"270","layer":"testlayer","dataHandle":"1f5bd0c9-3b9c-4a35-8c4e-0e7a2a1f1f6b"},{"version":6,"partition":"271","layer":"testlayer","dataHandle":"8c0e3a6b-0a57-4b0c-9d6f-4f5b8d0f2b1e"}]})jsonString"));
+
+    client::CancellationContext context;
+    auto response = repository.UpgradeToVersion(5, 6, boost::none, context);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    const auto& result = response.GetResult();
+    EXPECT_TRUE(result.IsLayerChanged());
+    EXPECT_EQ(result.GetChangedPartitions(),
+              std::vector<std::string>({"270", "271"}));
+    EXPECT_EQ(result.GetRemovedPartitions(),
+              std::vector<std::string>({"3", "here_van_wc2018_pool"}));
+
+    Mock::VerifyAndClearExpectations(mock_network.get());
+  }
+  {
+    SCOPED_TRACE("Previous partitions are not cached");
+
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(metadata_url + "/layerVersions?version=3"),
+                     _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::OK),
+            R"jsonString({"version":3,"layerVersions":[{"layer":"testlayer","version":3,"timestamp":1}]})jsonString"));
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(metadata_url + "/layers/testlayer/"
+                                                 "partitions?version=3"),
+                     _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::OK),
+            R"jsonString({ "partitions": [{"version":3,"partition":"269","layer":"testlayer","dataHandle":"4eed6ed1-0d32-43b9-ae79-043cb4256432"}]})jsonString"));
+    // The previous partitions are downloaded online only, so the lookup
+    // bypasses the cache as well.
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(kOlpSdkUrlLookupMetadata2), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                         olp::http::HttpStatusCode::OK),
+                                     kOlpSdkHttpResponseLookupMetadata2));
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(metadata_url + "/layers/testlayer/"
+                                                 "partitions?version=2"),
+                     _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::OK),
+            R"jsonString({ "partitions": [{"version":1,"partition":"269","layer":"testlayer","dataHandle":"4eed6ed1-0d32-43b9-ae79-043cb4256432"},{"version":2,"partition":"270","layer":"testlayer","dataHandle":"1f5bd0c9-3b9c-4a35-8c4e-0e7a2a1f1f6b"}]})jsonString"));
+
+    client::CancellationContext context;
+    auto response = repository.UpgradeToVersion(2, 3, boost::none, context);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    const auto& result = response.GetResult();
+    EXPECT_TRUE(result.IsLayerChanged());
+    EXPECT_EQ(result.GetChangedPartitions(),
+              std::vector<std::string>({"269"}));
+    EXPECT_EQ(result.GetRemovedPartitions(),
+              std::vector<std::string>({"270"}));
+
+    // The previous partitions are not stored in the cache.
+    auto previous_response = repository.GetVersionedPartitions(
+        read::PartitionsRequest().WithFetchOption(read::CacheOnly), 2,
+        context);
+    EXPECT_FALSE(previous_response.IsSuccessful());
+
+    Mock::VerifyAndClearExpectations(mock_network.get());
+  }
+  {
+    SCOPED_TRACE("Given layer versions");
+
+    // The layer versions shared by the snapshot are not requested again.
+    EXPECT_CALL(*mock_network, Send(_, _, _, _, _)).Times(0);
+
+    model::LayerVersions layer_versions;
+    layer_versions.SetVersion(8);
+    model::LayerVersion layer_version;
+    layer_version.SetLayer(layer);
+    layer_version.SetVersion(kVersion);
+    layer_versions.SetLayerVersions({layer_version});
+
+    client::CancellationContext context;
+    auto response = repository.UpgradeToVersion(kVersion, 8, boost::none,
+                                                context, layer_versions);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    EXPECT_FALSE(response.GetResult().IsLayerChanged());
+
+    Mock::VerifyAndClearExpectations(mock_network.get());
+  }
+  {
+    SCOPED_TRACE("Repeated upgrades");
+
+    EXPECT_CALL(*mock_network, Send(_, _, _, _, _)).Times(0);
+
+    model::LayerVersion layer_version;
+    layer_version.SetLayer(layer);
+    layer_version.SetVersion(kVersion);
+
+    client::CancellationContext context;
+    for (int64_t version = 9; version <= 11; ++version) {
+      model::LayerVersions layer_versions;
+      layer_versions.SetVersion(version);
+      layer_versions.SetLayerVersions({layer_version});
+
+      auto response = repository.UpgradeToVersion(version - 1, version,
+                                                  boost::none, context,
+                                                  layer_versions);
+      ASSERT_TRUE(response.IsSuccessful())
+          << response.GetError().GetMessage();
+      EXPECT_FALSE(response.GetResult().IsLayerChanged());
+    }
+
+    // All versions are linked to the cached one, not to each other.
+    EXPECT_EQ(cache_repository.GetBaseVersion(11).value_or(0), kVersion);
+
+    auto partitions_response = repository.GetVersionedPartitions(
+        read::PartitionsRequest().WithFetchOption(read::CacheOnly), 11,
+        context);
+    ASSERT_TRUE(partitions_response.IsSuccessful());
+    EXPECT_EQ(partitions_response.GetResult().GetPartitions().size(), 4u);
+
+    Mock::VerifyAndClearExpectations(mock_network.get());
+  }
+  {
+    SCOPED_TRACE("Older version");
+
+    client::CancellationContext context;
+    auto response = repository.UpgradeToVersion(5, 4, boost::none, context);
+
+    ASSERT_FALSE(response.IsSuccessful());
+    EXPECT_EQ(response.GetError().GetErrorCode(), ErrorCode::InvalidArgument);
+  }
+}
+
 }  // namespace
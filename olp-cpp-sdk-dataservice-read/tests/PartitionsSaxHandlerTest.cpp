@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "generated/parser/PartitionsSaxHandler.h"
+
+namespace {
+namespace model = olp::dataservice::read::model;
+using olp::parser::ParsePartitions;
+using olp::parser::ParsePartitionsList;
+
+TEST(PartitionsSaxHandlerTest, ParsesAllFields) {
+  std::stringstream json_stream(
+      "{\"partitions\":[{"
+      "\"checksum\":\"291f66029c232400e3403cd6e9cfd36e\","
+      "\"compressedDataSize\":1024,"
+      "\"dataHandle\":\"1b2ca68f-d4a0-4379-8120-cd025640510c\","
+      "\"dataSize\":5000000000,"
+      "\"crc\":\"291f66\","
+      "\"unknown\":{\"partition\":\"nested\",\"list\":[1,{\"a\":2}]},"
+      "\"partition\":\"314010583\","
+      "\"version\":2"
+      "},{\"partition\":\"314010584\",\"dataHandle\":\"handle\"}],"
+      "\"next\":\"url\"}");
+
+  model::Partitions partitions;
+  ASSERT_TRUE(ParsePartitions(json_stream, partitions));
+  ASSERT_EQ(2u, partitions.GetPartitions().size());
+
+  const auto& partition = partitions.GetPartitions().at(0);
+  ASSERT_TRUE(partition.GetChecksum());
+  EXPECT_EQ("291f66029c232400e3403cd6e9cfd36e", *partition.GetChecksum());
+  ASSERT_TRUE(partition.GetCompressedDataSize());
+  EXPECT_EQ(1024, *partition.GetCompressedDataSize());
+  EXPECT_EQ("1b2ca68f-d4a0-4379-8120-cd025640510c",
+            partition.GetDataHandle());
+  ASSERT_TRUE(partition.GetDataSize());
+  EXPECT_EQ(5000000000ll, *partition.GetDataSize());
+  ASSERT_TRUE(partition.GetCrc());
+  EXPECT_EQ("291f66", *partition.GetCrc());
+  EXPECT_EQ("314010583", partition.GetPartition());
+  ASSERT_TRUE(partition.GetVersion());
+  EXPECT_EQ(2, *partition.GetVersion());
+
+  const auto& second = partitions.GetPartitions().at(1);
+  EXPECT_EQ("314010584", second.GetPartition());
+  EXPECT_EQ("handle", second.GetDataHandle());
+  EXPECT_FALSE(second.GetChecksum());
+  EXPECT_FALSE(second.GetVersion());
+}
+
+TEST(PartitionsSaxHandlerTest, StreamsPartitions) {
+  const size_t partitions_count = 10000u;
+  std::string json = "{\"partitions\":[";
+  for (size_t i = 0; i < partitions_count; ++i) {
+    json += (i ? ",{\"partition\":\"" : "{\"partition\":\"") +
+            std::to_string(i) + "\",\"dataHandle\":\"handle\"}";
+  }
+  json += "]}";
+
+  {
+    SCOPED_TRACE("All partitions");
+    std::stringstream json_stream(json);
+
+    size_t count = 0u;
+    EXPECT_TRUE(ParsePartitions(json_stream, [&](model::Partition partition) {
+      EXPECT_EQ(std::to_string(count++), partition.GetPartition());
+      return true;
+    }));
+    EXPECT_EQ(partitions_count, count);
+  }
+  {
+    SCOPED_TRACE("Stopped by the callback");
+    std::stringstream json_stream(json);
+
+    size_t count = 0u;
+    EXPECT_FALSE(ParsePartitions(json_stream, [&](model::Partition) {
+      return ++count < 10u;
+    }));
+    EXPECT_EQ(10u, count);
+  }
+}
+
+TEST(PartitionsSaxHandlerTest, InvalidJson) {
+  const std::vector<std::string> inputs = {
+      "{\"partitions\":[{\"partition\":\"1\"}]}_",
+      "{\"partitions\":[{\"partition\":\"1\"}]",
+      "{\"partitions\":[{\"partition\":\"1}]}",
+      "[{\"partition\":\"1\"}]"};
+
+  for (const auto& input : inputs) {
+    SCOPED_TRACE(input);
+    std::stringstream json_stream(input);
+
+    model::Partitions partitions;
+    EXPECT_FALSE(ParsePartitions(json_stream, partitions));
+  }
+}
+
+TEST(PartitionsSaxHandlerTest, ParsesMemory) {
+  {
+    SCOPED_TRACE("String");
+    const std::string json =
+        "{\"partitions\":[{\"partition\":\"1\"},{\"partition\":\"2\"}]}";
+
+    model::Partitions partitions;
+    ASSERT_TRUE(ParsePartitions(json, partitions));
+    ASSERT_EQ(2u, partitions.GetPartitions().size());
+    EXPECT_EQ("1", partitions.GetPartitions().at(0).GetPartition());
+    EXPECT_EQ("2", partitions.GetPartitions().at(1).GetPartition());
+    EXPECT_FALSE(ParsePartitions(json.substr(1u), partitions));
+  }
+  {
+    SCOPED_TRACE("Slice of the list");
+    const std::string json =
+        "[{\"partition\":\"1\"}, {\"partition\":\"2\"},"
+        "{\"partition\":\"3\"}]";
+    const auto begin = json.find(' ') + 1u;
+    const auto end = json.rfind(',');
+
+    model::Partitions partitions;
+    ASSERT_TRUE(ParsePartitionsList(json.data() + begin, json.data() + end,
+                                    partitions));
+    ASSERT_EQ(1u, partitions.GetPartitions().size());
+    EXPECT_EQ("2", partitions.GetPartitions().at(0).GetPartition());
+  }
+  {
+    SCOPED_TRACE("Empty and invalid slices");
+    const std::string json = "{\"partition\":\"1\"";
+
+    model::Partitions partitions;
+    EXPECT_TRUE(ParsePartitionsList(json.data(), json.data(), partitions));
+    EXPECT_TRUE(partitions.GetPartitions().empty());
+    EXPECT_FALSE(ParsePartitionsList(json.data(), json.data() + json.size(),
+                                     partitions));
+  }
+}
+
+}  // namespace
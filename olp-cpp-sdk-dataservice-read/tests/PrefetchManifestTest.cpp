@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <gtest/gtest.h>
+
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/client/OlpClientSettingsFactory.h>
+#include "repositories/PrefetchManifest.h"
+
+namespace {
+namespace repository = olp::dataservice::read::repository;
+using olp::geo::TileKey;
+using repository::PrefetchManifest;
+
+const auto kCatalog =
+    olp::client::HRN::FromString("hrn:here:data::olp-here-test:catalog");
+constexpr auto kLayer = "layer";
+constexpr auto kVersion = 4;
+const auto kRoot = TileKey::FromHereTile("5904591");  // level 11
+
+TEST(PrefetchManifestTest, AddTiles) {
+  PrefetchManifest manifest(kRoot);
+  EXPECT_TRUE(manifest.IsEmpty());
+
+  const auto deepest = kRoot.ChangedLevelBy(4).NextColumn().NextRow();
+  const std::vector<TileKey> tiles = {kRoot, kRoot.GetChild(3),
+                                      kRoot.GetChild(1).GetChild(2), deepest};
+
+  for (const auto& tile : tiles) {
+    EXPECT_FALSE(manifest.Contains(tile));
+    EXPECT_TRUE(manifest.Add(tile));
+    EXPECT_TRUE(manifest.Contains(tile));
+    EXPECT_FALSE(manifest.Add(tile));
+  }
+
+  EXPECT_FALSE(manifest.IsEmpty());
+  EXPECT_FALSE(manifest.Contains(kRoot.GetChild(0)));
+  EXPECT_FALSE(manifest.Contains(deepest.NextColumn()));
+
+  {
+    SCOPED_TRACE("Tiles outside of the quad tree are ignored");
+
+    EXPECT_FALSE(manifest.Add(kRoot.Parent()));
+    EXPECT_FALSE(manifest.Add(kRoot.NextColumn()));
+    EXPECT_FALSE(manifest.Add(kRoot.ChangedLevelBy(5)));
+  }
+  {
+    SCOPED_TRACE("Serialize and parse");
+
+    const auto data = manifest.Serialize();
+    ASSERT_TRUE(data);
+
+    PrefetchManifest parsed(kRoot, *data);
+    for (const auto& tile : tiles) {
+      EXPECT_TRUE(parsed.Contains(tile));
+    }
+    EXPECT_FALSE(parsed.Contains(kRoot.GetChild(0)));
+  }
+  {
+    SCOPED_TRACE("Invalid data");
+
+    PrefetchManifest parsed(kRoot, {1u, 2u, 3u});
+    EXPECT_TRUE(parsed.IsEmpty());
+  }
+}
+
+TEST(PrefetchManifestTest, TrackerStoresDownloadedTiles) {
+  std::shared_ptr<olp::cache::KeyValueCache> cache =
+      olp::client::OlpClientSettingsFactory::CreateDefaultCache({});
+  repository::PartitionsCacheRepository cache_repository(kCatalog, kLayer,
+                                                         cache);
+
+  const std::map<TileKey, std::string> tiles = {
+      {kRoot, "handle-0"},
+      {kRoot.GetChild(0), "handle-1"},
+      {kRoot.GetChild(1), "handle-2"}};
+
+  {
+    SCOPED_TRACE("First prefetch");
+
+    repository::PrefetchManifestTracker tracker(cache_repository, kVersion);
+    tracker.Load(kRoot, tiles);
+    EXPECT_FALSE(tracker.IsDownloaded("handle-0"));
+
+    tracker.MarkDownloaded(kRoot);
+    tracker.MarkDownloaded(kRoot.GetChild(1));
+    tracker.Store();
+  }
+  {
+    SCOPED_TRACE("Repeated prefetch");
+
+    repository::PrefetchManifestTracker tracker(cache_repository, kVersion);
+    tracker.Load(kRoot, tiles);
+    EXPECT_TRUE(tracker.IsDownloaded("handle-0"));
+    EXPECT_FALSE(tracker.IsDownloaded("handle-1"));
+    EXPECT_TRUE(tracker.IsDownloaded("handle-2"));
+
+    auto to_download = tiles;
+    const auto removed = tracker.RemoveDownloaded(to_download);
+    EXPECT_EQ(removed, std::vector<TileKey>({kRoot, kRoot.GetChild(1)}));
+    ASSERT_EQ(to_download.size(), 1u);
+    EXPECT_EQ(to_download.begin()->first, kRoot.GetChild(0));
+  }
+  {
+    SCOPED_TRACE("Other version");
+
+    repository::PrefetchManifestTracker tracker(cache_repository,
+                                                kVersion + 1);
+    tracker.Load(kRoot, tiles);
+    EXPECT_FALSE(tracker.IsDownloaded("handle-0"));
+  }
+}
+
+}  // namespace
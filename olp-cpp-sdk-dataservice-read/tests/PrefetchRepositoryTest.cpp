@@ -291,4 +291,46 @@ TEST(PrefetchRepositoryTest, GetSlicedTilesLowLevels) {
   }
 }
 
+TEST(PrefetchRepositoryTest, GetQueryRoots) {
+  auto tile = olp::geo::TileKey::FromHereTile("5904591");  // level 11
+  {
+    SCOPED_TRACE("Roots are sorted in Morton order");
+
+    repository::RootTilesForRequest root_tiles_depth;
+    for (std::uint8_t index = 0; index < 4; ++index) {
+      root_tiles_depth.emplace(tile.GetChild(index), 4);
+    }
+    root_tiles_depth.emplace(tile.GetChild(0).GetChild(3), 4);
+    root_tiles_depth.emplace(tile.GetChild(3).GetChild(0), 4);
+
+    const std::vector<olp::geo::TileKey> expected_roots = {
+        tile.GetChild(0),
+        tile.GetChild(0).GetChild(3),
+        tile.GetChild(1),
+        tile.GetChild(2),
+        tile.GetChild(3),
+        tile.GetChild(3).GetChild(0)};
+
+    EXPECT_EQ(PrefetchTilesRepository::GetQueryRoots(root_tiles_depth),
+              expected_roots);
+  }
+  {
+    SCOPED_TRACE("Roots covered by the parent quad tree are skipped");
+
+    repository::RootTilesForRequest root_tiles_depth;
+    root_tiles_depth.emplace(tile, 4);
+    // levels 12 - 15 are in the quad tree of the parent
+    root_tiles_depth.emplace(tile.GetChild(1), 3);
+    root_tiles_depth.emplace(tile.GetChild(1).GetChild(2), 2);
+    // level 16 is not in the quad tree of the parent
+    root_tiles_depth.emplace(tile.GetChild(2), 4);
+
+    const std::vector<olp::geo::TileKey> expected_roots = {tile,
+                                                           tile.GetChild(2)};
+
+    EXPECT_EQ(PrefetchTilesRepository::GetQueryRoots(root_tiles_depth),
+              expected_roots);
+  }
+}
+
 }  // namespace
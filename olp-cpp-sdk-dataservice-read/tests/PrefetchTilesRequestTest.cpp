@@ -20,7 +20,9 @@
 #include <vector>
 
 #include <gmock/gmock.h>
+#include <olp/core/geo/coordinates/GeoRectangle.h>
 #include <olp/core/geo/tiling/TileKey.h>
+#include <olp/core/geo/tiling/TilingSchemeRegistry.h>
 #include <olp/dataservice/read/PrefetchTilesRequest.h>
 
 using namespace ::testing;
@@ -63,4 +65,20 @@ TEST(PrefetchTilesRequestTest, TileKeys) {
   }
 }
 
+TEST(PrefetchTilesRequestTest, TileCover) {
+  const HalfQuadTreeEquirectangularTilingScheme tiling_scheme;
+  const GeoRectangle rectangle(GeoCoordinates::FromDegrees(52.0, 13.0),
+                               GeoCoordinates::FromDegrees(53.0, 14.0));
+  const auto cover = TileCover::FromGeoRectangle(tiling_scheme, rectangle, 14);
+
+  PrefetchTilesRequest request;
+  request.WithTileCover(cover);
+
+  EXPECT_EQ(request.GetMinLevel(), 14u);
+  EXPECT_EQ(request.GetMaxLevel(), 14u);
+  EXPECT_EQ(request.GetTileKeys(), cover.Compact().ToTileKeys());
+  EXPECT_LT(request.GetTileKeys().size(),
+            static_cast<size_t>(std::distance(cover.begin(), cover.end())));
+}
+
 }  // namespace
@@ -0,0 +1,339 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <olp/core/thread/ThreadPoolTaskScheduler.h>
+#include <olp/dataservice/read/PrefetchTileResult.h>
+#include "PrefetchTilesHelper.h"
+
+namespace {
+namespace read = olp::dataservice::read;
+namespace client = olp::client;
+namespace geo = olp::geo;
+
+using DownloadJob = read::PrefetchTilesHelper::DownloadJob;
+using QueryJob =
+    read::QueryMetadataJob<geo::TileKey, geo::TileKey,
+                           read::PrefetchTilesResult,
+                           read::repository::SubQuadsResponse,
+                           read::PrefetchStatus>;
+
+constexpr auto kWaitTimeout = std::chrono::seconds(10);
+constexpr size_t kMaxDownloadsInFlight = 8u;
+constexpr uint32_t kQueryDepth = 4u;
+constexpr size_t kTilesPerQuery = 256u;  // 4^kQueryDepth
+constexpr size_t kQueryCount = 4u;
+
+// Stops accepting the tasks like a sink that is being destroyed.
+class ClosableTaskSink : public read::TaskSink {
+ public:
+  using read::TaskSink::TaskSink;
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+  }
+};
+
+class QueryMetadataJobTest : public ::testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override {
+    if (GetParam()) {
+      scheduler_ = std::make_shared<olp::thread::ThreadPoolTaskScheduler>(4);
+    }
+    task_sink_ = std::make_shared<ClosableTaskSink>(scheduler_);
+  }
+
+  void TearDown() override {
+    task_sink_.reset();
+    scheduler_.reset();
+  }
+
+  // Runs the queries and downloads, returns the prefetch response.
+  std::future<read::PrefetchTilesResponse> Prefetch(
+      client::CancellationContext context,
+      std::function<void()> on_download = nullptr,
+      read::AsyncDownloadFunc async_download = nullptr) {
+    auto promise =
+        std::make_shared<std::promise<read::PrefetchTilesResponse>>();
+    auto future = promise->get_future();
+
+    auto download = [=](std::string, client::CancellationContext) {
+      const auto in_flight = ++downloads_in_flight_;
+      auto max_in_flight = max_downloads_in_flight_.load();
+      while (in_flight > max_in_flight &&
+             !max_downloads_in_flight_.compare_exchange_weak(max_in_flight,
+                                                             in_flight)) {
+      }
+
+      ++downloads_;
+      if (on_download) {
+        on_download();
+      }
+
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      --downloads_in_flight_;
+      return read::ExtendedDataResponse(
+          std::make_shared<std::vector<unsigned char>>(1u));
+    };
+
+    auto append_result = [](read::ExtendedDataResponse response,
+                            geo::TileKey item,
+                            read::PrefetchTilesResult& result) {
+      if (response.IsSuccessful()) {
+        result.push_back(std::make_shared<read::PrefetchTileResult>(
+            item, read::PrefetchTileNoError()));
+      } else {
+        result.push_back(std::make_shared<read::PrefetchTileResult>(
+            item, response.GetError()));
+      }
+    };
+
+    auto prefetch_callback = [=](read::PrefetchTilesResponse response) {
+      downloads_in_flight_on_completion_ = downloads_in_flight_.load();
+      promise->set_value(std::move(response));
+    };
+
+    auto download_job =
+        async_download
+            ? std::make_shared<DownloadJob>(std::move(async_download),
+                                            std::move(append_result),
+                                            std::move(prefetch_callback),
+                                            nullptr)
+            : std::make_shared<DownloadJob>(
+                  std::move(download), std::move(append_result),
+                  std::move(prefetch_callback), nullptr);
+
+    auto query = [](geo::TileKey root, client::CancellationContext) {
+      read::repository::SubQuadsResult result;
+      const auto first = root.ChangedLevelBy(kQueryDepth).ToQuadKey64();
+      for (auto key = first; key < first + kTilesPerQuery; ++key) {
+        result.emplace(geo::TileKey::FromQuadKey64(key), "handle");
+      }
+      return read::repository::SubQuadsResponse(std::move(result));
+    };
+
+    auto query_job = std::make_shared<QueryJob>(
+        std::move(query), nullptr, download_job, *task_sink_, context, 0u,
+        window_);
+    query_job->Initialize(kQueryCount);
+
+    for (auto column = 0u; column < kQueryCount; ++column) {
+      const auto root = geo::TileKey::FromRowColumnLevel(0u, column, 5u);
+      task_sink_->AddTask(
+          [=](client::CancellationContext inner_context) {
+            return query_job->Query(root, inner_context);
+          },
+          [=](read::repository::SubQuadsResponse response) {
+            query_job->CompleteQuery(std::move(response));
+          },
+          0u);
+    }
+
+    return future;
+  }
+
+  std::shared_ptr<olp::thread::TaskScheduler> scheduler_;
+  std::shared_ptr<ClosableTaskSink> task_sink_;
+  size_t window_{kMaxDownloadsInFlight};
+  std::atomic<size_t> downloads_{0u};
+  std::atomic<size_t> downloads_in_flight_{0u};
+  std::atomic<size_t> max_downloads_in_flight_{0u};
+  std::atomic<size_t> downloads_in_flight_on_completion_{0u};
+};
+
+TEST_P(QueryMetadataJobTest, DownloadsAllItems) {
+  auto future = Prefetch(client::CancellationContext());
+
+  ASSERT_EQ(future.wait_for(kWaitTimeout), std::future_status::ready);
+  auto response = future.get();
+
+  ASSERT_TRUE(response.IsSuccessful());
+  EXPECT_EQ(response.GetResult().size(), kQueryCount * kTilesPerQuery);
+  EXPECT_EQ(downloads_.load(), kQueryCount * kTilesPerQuery);
+  EXPECT_LE(max_downloads_in_flight_.load(), kMaxDownloadsInFlight);
+}
+
+TEST_P(QueryMetadataJobTest, StopsSchedulingWhenCancelled) {
+  client::CancellationContext context;
+  auto future = Prefetch(context, [=]() mutable {
+    if (downloads_ == kMaxDownloadsInFlight) {
+      context.CancelOperation();
+    }
+  });
+
+  ASSERT_EQ(future.wait_for(kWaitTimeout), std::future_status::ready);
+  auto response = future.get();
+
+  ASSERT_FALSE(response.IsSuccessful());
+  EXPECT_EQ(response.GetError().GetErrorCode(), client::ErrorCode::Cancelled);
+  EXPECT_LE(downloads_.load(), 2 * kMaxDownloadsInFlight);
+  EXPECT_EQ(downloads_in_flight_on_completion_.load(), 0u);
+}
+
+TEST_P(QueryMetadataJobTest, StopsSchedulingWhenSinkIsClosed) {
+  // The sink without a scheduler runs the tasks in place and never rejects
+  // them.
+  if (!GetParam()) {
+    return;
+  }
+
+  auto future = Prefetch(client::CancellationContext(), [=]() {
+    if (downloads_ == kMaxDownloadsInFlight) {
+      task_sink_->Close();
+    }
+  });
+
+  ASSERT_EQ(future.wait_for(kWaitTimeout), std::future_status::ready);
+  auto response = future.get();
+
+  ASSERT_FALSE(response.IsSuccessful());
+  EXPECT_EQ(response.GetError().GetErrorCode(), client::ErrorCode::Cancelled);
+  EXPECT_LE(downloads_.load(), 2 * kMaxDownloadsInFlight);
+  EXPECT_EQ(downloads_in_flight_on_completion_.load(), 0u);
+}
+
+TEST_P(QueryMetadataJobTest, ReportsCancelledAfterPendingDownloads) {
+  std::mutex mutex;
+  std::vector<read::DownloadCallback> pending;
+
+  auto async_download = [&](std::string, client::CancellationContext,
+                            read::DownloadCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back(std::move(callback));
+    ++downloads_;
+  };
+
+  client::CancellationContext context;
+  auto future = Prefetch(context, nullptr, std::move(async_download));
+
+  // Waits until the window is full.
+  const auto deadline = std::chrono::steady_clock::now() + kWaitTimeout;
+  while (downloads_ < kMaxDownloadsInFlight &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(downloads_.load(), kMaxDownloadsInFlight);
+
+  context.CancelOperation();
+
+  // The prefetch is not completed while the downloads are pending.
+  EXPECT_EQ(future.wait_for(std::chrono::milliseconds(50)),
+            std::future_status::timeout);
+
+  std::vector<read::DownloadCallback> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    callbacks.swap(pending);
+  }
+  for (auto& callback : callbacks) {
+    callback(read::ExtendedDataResponse(
+        std::make_shared<std::vector<unsigned char>>(1u)));
+  }
+
+  ASSERT_EQ(future.wait_for(kWaitTimeout), std::future_status::ready);
+  auto response = future.get();
+
+  ASSERT_FALSE(response.IsSuccessful());
+  EXPECT_EQ(response.GetError().GetErrorCode(), client::ErrorCode::Cancelled);
+  EXPECT_EQ(downloads_.load(), kMaxDownloadsInFlight);
+}
+
+TEST_P(QueryMetadataJobTest, ClampsEmptyWindow) {
+  window_ = 0u;
+  auto future = Prefetch(client::CancellationContext());
+
+  ASSERT_EQ(future.wait_for(kWaitTimeout), std::future_status::ready);
+  auto response = future.get();
+
+  ASSERT_TRUE(response.IsSuccessful());
+  EXPECT_EQ(response.GetResult().size(), kQueryCount * kTilesPerQuery);
+  EXPECT_EQ(max_downloads_in_flight_.load(), 1u);
+}
+
+TEST_P(QueryMetadataJobTest, AsyncDownloadsDoNotHoldWorkers) {
+  const size_t total_downloads = kQueryCount * kTilesPerQuery;
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<read::DownloadCallback> pending;
+
+  // The requests wait for the network without a worker thread, so the
+  // window fills up even though it is larger than the thread pool.
+  auto async_download = [&](std::string, client::CancellationContext,
+                            read::DownloadCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back(std::move(callback));
+    ++downloads_;
+    max_downloads_in_flight_ =
+        std::max(max_downloads_in_flight_.load(), pending.size());
+    condition.notify_one();
+  };
+
+  auto future = Prefetch(client::CancellationContext(), nullptr,
+                         std::move(async_download));
+
+  // Simulates the network, which responds once the window is full.
+  std::thread network([&]() {
+    size_t completed = 0u;
+    while (completed < total_downloads) {
+      std::vector<read::DownloadCallback> callbacks;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait_for(lock, kWaitTimeout, [&]() {
+          return pending.size() == kMaxDownloadsInFlight;
+        });
+        callbacks.swap(pending);
+      }
+
+      if (callbacks.empty()) {
+        return;
+      }
+
+      for (auto& callback : callbacks) {
+        callback(read::ExtendedDataResponse(
+            std::make_shared<std::vector<unsigned char>>(1u)));
+      }
+      completed += callbacks.size();
+    }
+  });
+
+  network.join();
+  ASSERT_EQ(future.wait_for(kWaitTimeout), std::future_status::ready);
+  auto response = future.get();
+
+  ASSERT_TRUE(response.IsSuccessful());
+  EXPECT_EQ(response.GetResult().size(), total_downloads);
+  EXPECT_EQ(downloads_.load(), total_downloads);
+  EXPECT_EQ(max_downloads_in_flight_.load(), kMaxDownloadsInFlight);
+}
+
+INSTANTIATE_TEST_SUITE_P(, QueryMetadataJobTest, ::testing::Bool());
+
+}  // namespace
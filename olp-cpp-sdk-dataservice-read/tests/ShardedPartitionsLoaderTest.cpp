@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <matchers/NetworkUrlMatchers.h>
+#include <mocks/NetworkMock.h>
+#include <olp/core/client/OlpClient.h>
+#include <olp/core/client/OlpClientFactory.h>
+#include <olp/core/client/OlpClientSettingsFactory.h>
+#include "repositories/ShardedPartitionsLoader.h"
+
+namespace {
+namespace client = olp::client;
+namespace http = olp::http;
+namespace repository = olp::dataservice::read::repository;
+using repository::ShardedPartitionsLoader;
+using ::testing::_;
+
+constexpr auto kNodeBaseUrl =
+    "https://some.node.base.url/metadata/v1/catalogs/"
+    "hrn:here:data::olp-here-test:hereos-internal-test-v2";
+constexpr auto kLayer = "testlayer";
+constexpr auto kVersion = 4;
+// Big enough to be downloaded in several shards.
+constexpr auto kPartitionCount = 60000;
+
+std::string PartitionsResponse(int count) {
+  std::string json = "{\"partitions\":[";
+  for (int i = 0; i < count; ++i) {
+    if (i > 0) {
+      json += ",";
+    }
+    json += "{\"version\":4,\"partition\":\"" + std::to_string(i) +
+            "\",\"dataHandle\":\"handle-" + std::to_string(i) + "\"}";
+  }
+  return json + "]}";
+}
+
+std::string GetRangeHeader(const http::NetworkRequest& request) {
+  for (const auto& header : request.GetHeaders()) {
+    if (header.first == "Range") {
+      return header.second;
+    }
+  }
+  return {};
+}
+
+// Serves the ranges of the body as an HTTP server does.
+NetworkCallback ReturnRange(const std::string& body,
+                            std::atomic<int>& requests) {
+  return [&](http::NetworkRequest request, http::Network::Payload payload,
+             http::Network::Callback callback,
+             http::Network::HeaderCallback header_callback,
+             http::Network::DataCallback data_callback) {
+    ++requests;
+    const auto range = GetRangeHeader(request);
+    const auto dash = range.find('-');
+    const auto begin = std::stoull(range.substr(6u, dash - 6u));
+    auto end = body.size() - 1u;
+    if (dash + 1u < range.size()) {
+      end = std::min<size_t>(end, std::stoull(range.substr(dash + 1u)));
+    }
+
+    const auto content_range = "bytes " + std::to_string(begin) + "-" +
+                               std::to_string(end) + "/" +
+                               std::to_string(body.size());
+    return ReturnHttpResponse(
+        GetResponse(http::HttpStatusCode::PARTIAL_CONTENT),
+        body.substr(begin, end - begin + 1u),
+        {{"Content-Range", content_range}})(
+        std::move(request), std::move(payload), std::move(callback),
+        std::move(header_callback), std::move(data_callback));
+  };
+}
+
+class ShardedPartitionsLoaderTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    network_mock_ = std::make_shared<NetworkMock>();
+
+    task_scheduler_ =
+        client::OlpClientSettingsFactory::CreateDefaultTaskScheduler(1u);
+
+    client::OlpClientSettings settings;
+    settings.network_request_handler = network_mock_;
+    settings.task_scheduler = task_scheduler_;
+
+    client_ = client::OlpClientFactory::Create(settings);
+    client_->SetBaseUrl(kNodeBaseUrl);
+  }
+
+  void TearDown() override { network_mock_.reset(); }
+
+  std::shared_ptr<client::OlpClient> client_;
+  std::shared_ptr<NetworkMock> network_mock_;
+  std::shared_ptr<olp::thread::TaskScheduler> task_scheduler_;
+};
+
+TEST(ShardedPartitionsLoaderSplitTest, SplitPartitions) {
+  const std::string json =
+      R"({ "partitions" : [{"partition":"1"}, {"partition":"2"},)"
+      R"({"partition":"3"}] })";
+
+  {
+    SCOPED_TRACE("Split into partition objects");
+
+    const auto ranges = ShardedPartitionsLoader::SplitPartitions(json, 10u);
+    ASSERT_EQ(3u, ranges.size());
+
+    std::vector<std::string> slices;
+    for (const auto& range : ranges) {
+      slices.push_back(
+          json.substr(range.first, range.second - range.first));
+    }
+    EXPECT_THAT(slices, testing::ElementsAre(R"({"partition":"1"})",
+                                             R"( {"partition":"2"})",
+                                             R"({"partition":"3"})"));
+  }
+  {
+    SCOPED_TRACE("Slices of similar size");
+
+    const auto ranges = ShardedPartitionsLoader::SplitPartitions(json, 2u);
+    ASSERT_EQ(2u, ranges.size());
+    EXPECT_EQ(json.rfind(','), ranges.front().second);
+    EXPECT_EQ(json.find(']'), ranges.back().second);
+  }
+  {
+    SCOPED_TRACE("Empty list");
+
+    const auto ranges =
+        ShardedPartitionsLoader::SplitPartitions(R"({"partitions":[]})", 2u);
+    ASSERT_EQ(1u, ranges.size());
+    EXPECT_EQ(ranges.front().first, ranges.front().second);
+  }
+  {
+    SCOPED_TRACE("Unexpected layout");
+
+    EXPECT_TRUE(ShardedPartitionsLoader::SplitPartitions(
+                    R"({"next":"url","partitions":[{"partition":"1"}]})", 2u)
+                    .empty());
+    EXPECT_TRUE(ShardedPartitionsLoader::SplitPartitions(
+                    R"({"partitions":[{"partition":"1"}],"next":"url"})", 2u)
+                    .empty());
+    EXPECT_TRUE(ShardedPartitionsLoader::SplitPartitions("", 2u).empty());
+  }
+}
+
+TEST_F(ShardedPartitionsLoaderTest, Load) {
+  const auto body = PartitionsResponse(kPartitionCount);
+
+  {
+    SCOPED_TRACE("Download in shards");
+
+    std::atomic<int> requests{0};
+    EXPECT_CALL(*network_mock_, Send(_, _, _, _, _))
+        .WillRepeatedly(ReturnRange(body, requests));
+
+    ShardedPartitionsLoader loader(*client_, kLayer, 4u, task_scheduler_);
+    auto response = loader.Load(kVersion, {}, boost::none, {});
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    EXPECT_GT(requests.load(), 2);
+
+    const auto& partitions = response.GetResult().GetPartitions();
+    ASSERT_EQ(static_cast<size_t>(kPartitionCount), partitions.size());
+    for (auto i = 0; i < kPartitionCount; ++i) {
+      ASSERT_EQ(std::to_string(i), partitions[i].GetPartition());
+    }
+    EXPECT_EQ("handle-0", partitions.front().GetDataHandle());
+    testing::Mock::VerifyAndClearExpectations(network_mock_.get());
+  }
+  {
+    SCOPED_TRACE("Range is not supported");
+
+    EXPECT_CALL(*network_mock_, Send(_, _, _, _, _))
+        .WillOnce(ReturnHttpResponse(GetResponse(http::HttpStatusCode::OK),
+                                     body));
+
+    // Without the task scheduler the slices are parsed by the caller.
+    ShardedPartitionsLoader loader(*client_, kLayer, 4u);
+    auto response = loader.Load(kVersion, {}, boost::none, {});
+
+    ASSERT_TRUE(response.IsSuccessful());
+    EXPECT_EQ(static_cast<size_t>(kPartitionCount),
+              response.GetResult().GetPartitions().size());
+    testing::Mock::VerifyAndClearExpectations(network_mock_.get());
+  }
+  {
+    SCOPED_TRACE("Failed shard");
+
+    std::atomic<int> requests{0};
+    EXPECT_CALL(*network_mock_, Send(_, _, _, _, _))
+        .WillOnce(ReturnRange(body, requests))
+        .WillRepeatedly(ReturnHttpResponse(
+            GetResponse(http::HttpStatusCode::BAD_REQUEST), "Bad request"));
+    EXPECT_CALL(*network_mock_, Cancel(_)).Times(testing::AnyNumber());
+
+    ShardedPartitionsLoader loader(*client_, kLayer, 4u, task_scheduler_);
+    auto response = loader.Load(kVersion, {}, boost::none, {});
+
+    ASSERT_FALSE(response.IsSuccessful());
+    EXPECT_EQ(http::HttpStatusCode::BAD_REQUEST,
+              response.GetError().GetHttpStatusCode());
+    testing::Mock::VerifyAndClearExpectations(network_mock_.get());
+  }
+}
+
+}  // namespace
@@ -1126,6 +1126,56 @@ TEST(VersionedLayerClientTest, PrefetchPartitionsCancel) {
   Mock::VerifyAndClearExpectations(network_mock.get());
 }
 
+TEST(VersionedLayerClientTest, StreamLayerPartitionsInvalidArguments) {
+  auto network_mock = std::make_shared<NetworkMock>();
+  auto cache_mock = std::make_shared<testing::NiceMock<CacheMock>>();
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler = network_mock;
+  settings.cache = cache_mock;
+
+  read::VersionedLayerClientImpl client(kHrn, kLayerId, kCatalogVersion,
+                                        settings);
+
+  EXPECT_CALL(*network_mock, Send(_, _, _, _, _)).Times(0);
+
+  auto stream = [&](read::PartitionsRequest request,
+                    read::PartitionsStreamCallback stream_callback) {
+    std::promise<olp::client::ApiNoResponse> promise;
+    auto future = promise.get_future();
+    client.StreamLayerPartitions(
+        std::move(request), std::move(stream_callback),
+        [&](olp::client::ApiNoResponse response) {
+          promise.set_value(std::move(response));
+        });
+    EXPECT_EQ(future.wait_for(kTimeout), std::future_status::ready);
+    return future.get();
+  };
+
+  {
+    SCOPED_TRACE("CacheWithUpdate");
+
+    size_t partitions = 0u;
+    const auto response =
+        stream(read::PartitionsRequest().WithFetchOption(read::CacheWithUpdate),
+               [&](model::Partition) { ++partitions; });
+
+    ASSERT_FALSE(response.IsSuccessful());
+    EXPECT_EQ(response.GetError().GetErrorCode(),
+              olp::client::ErrorCode::InvalidArgument);
+    EXPECT_EQ(partitions, 0u);
+  }
+  {
+    SCOPED_TRACE("No stream callback");
+
+    const auto response = stream(read::PartitionsRequest(), nullptr);
+
+    ASSERT_FALSE(response.IsSuccessful());
+    EXPECT_EQ(response.GetError().GetErrorCode(),
+              olp::client::ErrorCode::InvalidArgument);
+  }
+  Mock::VerifyAndClearExpectations(network_mock.get());
+}
+
 TEST(VersionedLayerClientTest, CacheErrorsDuringPrefetch) {
   olp::utils::Dir::Remove(kMutableCachePath);
 
@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <olp/dataservice/read/PrefetchTileResult.h>
+#include "ViewportPrefetcher.h"
+
+namespace {
+namespace read = olp::dataservice::read;
+namespace client = olp::client;
+namespace geo = olp::geo;
+
+constexpr uint32_t kLevel = 10u;
+
+// The quad tree of the root contains the root and its four children.
+read::repository::SubQuadsResponse Query(geo::TileKey root) {
+  read::repository::SubQuadsResult result;
+  result.emplace(root, root.ToHereTile());
+  for (auto index = 0u; index < 4u; ++index) {
+    const auto child = root.GetChild(static_cast<std::uint8_t>(index));
+    result.emplace(child, child.ToHereTile());
+  }
+  return read::repository::SubQuadsResponse(std::move(result));
+}
+
+class ViewportPrefetcherTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    task_sink_ = std::make_shared<read::TaskSink>(nullptr);
+    prefetcher_ = std::make_shared<read::ViewportPrefetcher>(*task_sink_, 1u);
+  }
+
+  void TearDown() override {
+    CompletePending();
+    prefetcher_.reset();
+    task_sink_.reset();
+  }
+
+  client::CancellationToken Update(const std::vector<geo::TileKey>& roots,
+                                   geo::TileKey focus) {
+    return Update(prefetcher_->NextSequence(), roots, focus);
+  }
+
+  client::CancellationToken Update(uint64_t sequence,
+                                   const std::vector<geo::TileKey>& roots,
+                                   geo::TileKey focus) {
+    auto query = [=](geo::TileKey root, client::CancellationContext) {
+      queries_.push_back(root);
+      return Query(root);
+    };
+
+    auto download = [=](std::string data_handle, client::CancellationContext,
+                        read::DownloadCallback callback) {
+      downloads_.push_back(data_handle);
+      if (hold_downloads_) {
+        pending_.push_back(std::move(callback));
+      } else {
+        callback(read::ExtendedDataResponse(
+            std::make_shared<std::vector<unsigned char>>(1u)));
+      }
+    };
+
+    return prefetcher_->Update(
+        sequence, scope_, roots, std::move(query), nullptr,
+        std::move(download), focus, 0u,
+        [=](read::PrefetchTilesResponse response) {
+          responses_.push_back(std::move(response));
+        });
+  }
+
+  void CompletePending() {
+    hold_downloads_ = false;
+    while (!pending_.empty()) {
+      auto callback = std::move(pending_.front());
+      pending_.erase(pending_.begin());
+      callback(read::ExtendedDataResponse(
+          std::make_shared<std::vector<unsigned char>>(1u)));
+    }
+  }
+
+  std::shared_ptr<read::TaskSink> task_sink_;
+  std::shared_ptr<read::ViewportPrefetcher> prefetcher_;
+  std::vector<geo::TileKey> queries_;
+  std::vector<std::string> downloads_;
+  std::vector<read::DownloadCallback> pending_;
+  std::vector<read::PrefetchTilesResponse> responses_;
+  std::string scope_{"scope"};
+  bool hold_downloads_{false};
+};
+
+TEST_F(ViewportPrefetcherTest, Distance) {
+  const auto focus = geo::TileKey::FromRowColumnLevel(4u, 4u, 4u);
+  const auto near = geo::TileKey::FromRowColumnLevel(4u, 5u, 4u);
+  const auto far = geo::TileKey::FromRowColumnLevel(4u, 7u, 4u);
+
+  EXPECT_EQ(read::ViewportPrefetcher::Distance(focus, focus), 0.0);
+  EXPECT_LT(read::ViewportPrefetcher::Distance(near, focus),
+            read::ViewportPrefetcher::Distance(far, focus));
+
+  // The children of the focus are nearer than the neighbour tile.
+  const auto child = focus.GetChild(static_cast<std::uint8_t>(0u));
+  EXPECT_LT(read::ViewportPrefetcher::Distance(child, focus),
+            read::ViewportPrefetcher::Distance(near, focus));
+}
+
+TEST_F(ViewportPrefetcherTest, DownloadsNearestFirst) {
+  const auto left = geo::TileKey::FromRowColumnLevel(0u, 0u, kLevel);
+  const auto right = geo::TileKey::FromRowColumnLevel(0u, 8u, kLevel);
+
+  Update({left, right}, right);
+
+  ASSERT_EQ(responses_.size(), 1u);
+  ASSERT_TRUE(responses_.front().IsSuccessful());
+  EXPECT_EQ(responses_.front().GetResult().size(), 10u);
+  ASSERT_EQ(downloads_.size(), 10u);
+
+  // The tiles of the root under the focus are downloaded first.
+  for (auto index = 0u; index < 5u; ++index) {
+    const auto tile = geo::TileKey::FromHereTile(downloads_[index]);
+    EXPECT_EQ(tile.ChangedLevelTo(kLevel), right);
+  }
+}
+
+TEST_F(ViewportPrefetcherTest, ReusesOverlappingQuadTrees) {
+  const auto first = geo::TileKey::FromRowColumnLevel(0u, 0u, kLevel);
+  const auto second = geo::TileKey::FromRowColumnLevel(0u, 1u, kLevel);
+  const auto third = geo::TileKey::FromRowColumnLevel(0u, 2u, kLevel);
+
+  Update({first, second}, first);
+  ASSERT_EQ(responses_.size(), 1u);
+  EXPECT_EQ(queries_.size(), 2u);
+  EXPECT_EQ(downloads_.size(), 10u);
+
+  Update({second, third}, third);
+  ASSERT_EQ(responses_.size(), 2u);
+  ASSERT_TRUE(responses_.back().IsSuccessful());
+  EXPECT_EQ(responses_.back().GetResult().size(), 10u);
+
+  // Only the new root is queried, and only its tiles are downloaded.
+  ASSERT_EQ(queries_.size(), 3u);
+  EXPECT_EQ(queries_.back(), third);
+  EXPECT_EQ(downloads_.size(), 15u);
+}
+
+TEST_F(ViewportPrefetcherTest, DropsObsoleteTiles) {
+  const auto first = geo::TileKey::FromRowColumnLevel(0u, 0u, kLevel);
+  const auto second = geo::TileKey::FromRowColumnLevel(0u, 4u, kLevel);
+
+  hold_downloads_ = true;
+
+  Update({first}, first);
+  EXPECT_TRUE(responses_.empty());
+  EXPECT_EQ(downloads_.size(), 1u);
+  EXPECT_EQ(prefetcher_->GetPendingCount(), 5u);
+
+  Update({second}, second);
+
+  // The previous viewport is cancelled, and its queued tiles are dropped.
+  ASSERT_EQ(responses_.size(), 1u);
+  ASSERT_FALSE(responses_.front().IsSuccessful());
+  EXPECT_EQ(responses_.front().GetError().GetErrorCode(),
+            client::ErrorCode::Cancelled);
+  EXPECT_EQ(prefetcher_->GetPendingCount(), 6u);
+
+  CompletePending();
+
+  ASSERT_EQ(responses_.size(), 2u);
+  ASSERT_TRUE(responses_.back().IsSuccessful());
+  EXPECT_EQ(responses_.back().GetResult().size(), 5u);
+  EXPECT_EQ(downloads_.size(), 6u);
+  EXPECT_EQ(prefetcher_->GetPendingCount(), 0u);
+}
+
+TEST_F(ViewportPrefetcherTest, RequeuesDroppedTile) {
+  const auto first = geo::TileKey::FromRowColumnLevel(0u, 0u, kLevel);
+  const auto second = geo::TileKey::FromRowColumnLevel(0u, 4u, kLevel);
+
+  hold_downloads_ = true;
+
+  // The download of the first root is dropped and queued again, while the
+  // dropped one is still running.
+  Update({first}, first);
+  Update({second}, second);
+  Update({first}, first);
+  ASSERT_EQ(responses_.size(), 2u);
+
+  CompletePending();
+
+  // The dropped download does not complete the queued tile.
+  ASSERT_EQ(responses_.size(), 3u);
+  ASSERT_TRUE(responses_.back().IsSuccessful());
+  const auto& result = responses_.back().GetResult();
+  EXPECT_EQ(result.size(), 5u);
+  for (const auto& tile_result : result) {
+    EXPECT_TRUE(tile_result->IsSuccessful())
+        << tile_result->tile_key_.ToHereTile();
+  }
+  EXPECT_EQ(prefetcher_->GetPendingCount(), 0u);
+}
+
+TEST_F(ViewportPrefetcherTest, ChangesScopeWithDownloadsInFlight) {
+  const auto root = geo::TileKey::FromRowColumnLevel(0u, 0u, kLevel);
+
+  hold_downloads_ = true;
+
+  Update({root}, root);
+  ASSERT_EQ(pending_.size(), 1u);
+
+  // The same viewport in another catalog version.
+  scope_ = "other scope";
+  Update({root}, root);
+
+  // The download of the previous version is forgotten, so the tile is
+  // downloaded again for the new version.
+  ASSERT_EQ(responses_.size(), 1u);
+  EXPECT_EQ(queries_.size(), 2u);
+  ASSERT_EQ(pending_.size(), 2u);
+  EXPECT_EQ(prefetcher_->GetPendingCount(), 5u);
+
+  // The download of the previous version does not complete the tile.
+  auto previous_download = std::move(pending_.front());
+  pending_.erase(pending_.begin());
+  previous_download(read::ExtendedDataResponse(
+      std::make_shared<std::vector<unsigned char>>(1u)));
+  EXPECT_EQ(responses_.size(), 1u);
+  EXPECT_EQ(prefetcher_->GetPendingCount(), 5u);
+
+  CompletePending();
+
+  ASSERT_EQ(responses_.size(), 2u);
+  ASSERT_TRUE(responses_.back().IsSuccessful());
+  EXPECT_EQ(responses_.back().GetResult().size(), 5u);
+  EXPECT_EQ(downloads_.size(), 6u);
+  EXPECT_EQ(prefetcher_->GetPendingCount(), 0u);
+}
+
+TEST_F(ViewportPrefetcherTest, DropsOutOfOrderUpdates) {
+  const auto first = geo::TileKey::FromRowColumnLevel(0u, 0u, kLevel);
+  const auto second = geo::TileKey::FromRowColumnLevel(0u, 4u, kLevel);
+
+  const auto first_sequence = prefetcher_->NextSequence();
+  const auto second_sequence = prefetcher_->NextSequence();
+
+  // The second viewport is applied before the first one.
+  Update(second_sequence, {second}, second);
+  ASSERT_EQ(responses_.size(), 1u);
+  ASSERT_TRUE(responses_.front().IsSuccessful());
+
+  Update(first_sequence, {first}, first);
+
+  ASSERT_EQ(responses_.size(), 2u);
+  ASSERT_FALSE(responses_.back().IsSuccessful());
+  EXPECT_EQ(responses_.back().GetError().GetErrorCode(),
+            client::ErrorCode::Cancelled);
+  ASSERT_EQ(queries_.size(), 1u);
+  EXPECT_EQ(queries_.front(), second);
+  EXPECT_EQ(downloads_.size(), 5u);
+}
+
+TEST_F(ViewportPrefetcherTest, Cancel) {
+  const auto root = geo::TileKey::FromRowColumnLevel(0u, 0u, kLevel);
+
+  hold_downloads_ = true;
+
+  auto token = Update({root}, root);
+  token.Cancel();
+
+  ASSERT_EQ(responses_.size(), 1u);
+  EXPECT_EQ(responses_.front().GetError().GetErrorCode(),
+            client::ErrorCode::Cancelled);
+
+  CompletePending();
+  EXPECT_EQ(responses_.size(), 1u);
+  EXPECT_EQ(downloads_.size(), 1u);
+  EXPECT_EQ(prefetcher_->GetPendingCount(), 0u);
+}
+}  // namespace
@@ -0,0 +1,35 @@
+#!/bin/bash -ex
+#
+# Copyright (C) 2021 HERE Europe B.V.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# SPDX-License-Identifier: Apache-2.0
+# License-Filename: LICENSE
+
+# Builds and runs the core tests that require C++20 coroutines.
+
+# For core dump backtrace
+ulimit -c unlimited
+
+mkdir -p build-cpp20
+cd build-cpp20
+cmake -DCMAKE_BUILD_TYPE=$BUILD_TYPE \
+    -DCMAKE_CXX_FLAGS="-Wall -Wextra -Werror" \
+    -DOLP_SDK_ENABLE_CPP20_TESTS=ON \
+    ..
+
+make -j$(nproc) olp-cpp-sdk-core-cpp20-tests
+
+olp-cpp-sdk-core/tests/olp-cpp-sdk-core-cpp20-tests \
+    --gtest_output="xml:olp-cpp-sdk-core-cpp20-tests-report.xml"
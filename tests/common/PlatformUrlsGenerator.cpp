@@ -71,6 +71,11 @@ std::string PlatformUrlsGenerator::LatestVersion() {
   return FullPath("metadata", "/versions/latest?startVersion=-1");
 }
 
+std::string PlatformUrlsGenerator::LayerVersions(uint64_t version) {
+  return FullPath("metadata",
+                  "/layerVersions?version=" + std::to_string(version));
+}
+
 std::string PlatformUrlsGenerator::VersionedQuadTree(const std::string& quadkey,
                                                      uint64_t version,
                                                      uint64_t depth) {
@@ -48,6 +48,8 @@ class PlatformUrlsGenerator {
 
   std::string LatestVersion();
 
+  std::string LayerVersions(uint64_t version);
+
   std::string VersionedQuadTree(const std::string& quadkey, uint64_t version,
                                 uint64_t depth);
 
@@ -3302,6 +3302,10 @@ TEST_F(DataserviceReadVersionedLayerClientTest, CheckLookupApiCacheExpiration) {
                           _))
       .Times(1)
       .WillOnce(Return(boost::any()));
+  EXPECT_CALL(*cache, Get("hrn:here:data::olp-here-test:hereos-internal-test-"
+                          "v2::testlayer::4::base_version"))
+      .Times(1)
+      .WillOnce(Return(nullptr));
   EXPECT_CALL(*cache, Put("hrn:here:data::olp-here-test:hereos-internal-test-"
                           "v2::testlayer::269::4::partition",
                           _, _, _))
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/cache/KeyValueCache.h>
+#include <olp/core/client/ApiLookupClient.h>
+#include <olp/core/client/CancellationContext.h>
+#include <olp/core/client/HRN.h>
+#include <olp/core/client/OlpClientSettings.h>
+#include <olp/core/client/OlpClientSettingsFactory.h>
+#include <olp/core/logging/Log.h>
+#include <olp/dataservice/read/DataRequest.h>
+#include "repositories/DataCacheRepository.h"
+#include "repositories/DataRepository.h"
+
+namespace {
+// Counts the allocations of all threads while the counting is enabled.
+std::atomic<bool> g_count_allocations{false};
+std::atomic<size_t> g_allocations{0u};
+
+void* Allocate(std::size_t size) {
+  if (g_count_allocations.load(std::memory_order_relaxed)) {
+    g_allocations.fetch_add(1u, std::memory_order_relaxed);
+  }
+  if (void* ptr = std::malloc(size == 0u ? 1u : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+class AllocationCounter {
+ public:
+  AllocationCounter() {
+    g_allocations = 0u;
+    g_count_allocations = true;
+  }
+  ~AllocationCounter() { g_count_allocations = false; }
+
+  size_t GetCount() const { return g_allocations.load(); }
+};
+}  // namespace
+
+void* operator new(std::size_t size) { return Allocate(size); }
+void* operator new[](std::size_t size) { return Allocate(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+namespace read = olp::dataservice::read;
+namespace repository = olp::dataservice::read::repository;
+
+constexpr auto kLogTag = "CacheAllocationTest";
+constexpr auto kLayer = "versioned-layer-with-a-long-name";
+constexpr auto kDataHandle = "4eed6ed1-0d32-43b9-ae79-043cb4256432";
+constexpr auto kCatalog =
+    "hrn:here:data::olp-here-test:hereos-internal-test-v2";
+constexpr auto kBlobService = "blob";
+constexpr size_t kIterations = 10000u;
+
+TEST(CacheAllocationTest, DataCacheHitDoesNotAllocate) {
+  const auto catalog = olp::client::HRN::FromString(kCatalog);
+  std::shared_ptr<olp::cache::KeyValueCache> cache =
+      olp::client::OlpClientSettingsFactory::CreateDefaultCache({});
+  repository::DataCacheRepository repository(catalog, cache);
+
+  // The debug logs of the repository are formatted when enabled.
+  const auto log_level = olp::logging::Log::getLevel();
+  olp::logging::Log::setLevel(olp::logging::Level::Warning);
+
+  auto data = std::make_shared<olp::cache::KeyValueCache::ValueType>(
+      1024u, 'd');
+  ASSERT_TRUE(repository.Put(data, kLayer, kDataHandle).IsSuccessful());
+
+  // The arguments are created outside of the counted scope, and the first
+  // lookup grows the key buffer of the thread.
+  const std::string layer = kLayer;
+  const std::string data_handle = kDataHandle;
+  ASSERT_TRUE(repository.Get(layer, data_handle));
+
+  size_t allocations = 0u;
+  size_t hits = 0u;
+  {
+    AllocationCounter counter;
+    for (size_t i = 0; i < kIterations; ++i) {
+      hits += repository.Get(layer, data_handle) ? 1u : 0u;
+    }
+    allocations = counter.GetCount();
+  }
+
+  olp::logging::Log::setLevel(log_level);
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(kLogTag, "Lookups=%zu, hits=%zu, allocations=%zu",
+                              kIterations, hits, allocations);
+  EXPECT_EQ(hits, kIterations);
+  EXPECT_EQ(allocations, 0u);
+}
+
+TEST(CacheAllocationTest, GetDataCacheHitAllocatesOnlyTheRepository) {
+  const auto catalog = olp::client::HRN::FromString(kCatalog);
+  olp::client::OlpClientSettings settings;
+  settings.cache =
+      olp::client::OlpClientSettingsFactory::CreateDefaultCache({});
+
+  const auto log_level = olp::logging::Log::getLevel();
+  olp::logging::Log::setLevel(olp::logging::Level::Warning);
+
+  auto data = std::make_shared<olp::cache::KeyValueCache::ValueType>(
+      1024u, 'd');
+  repository::DataCacheRepository cache_repository(catalog, settings.cache);
+  ASSERT_TRUE(cache_repository.Put(data, kLayer, kDataHandle).IsSuccessful());
+
+  const std::string layer = kLayer;
+  const auto request = read::DataRequest().WithDataHandle(kDataHandle);
+  const olp::client::CancellationContext context;
+  repository::DataRepository data_repository(
+      catalog, settings, olp::client::ApiLookupClient(catalog, settings));
+  ASSERT_TRUE(
+      data_repository.GetBlobData(layer, kBlobService, request, context)
+          .IsSuccessful());
+
+  // The cache repository is created per request, its key prefix is the only
+  // allocation of the cache hit.
+  size_t repository_allocations = 0u;
+  {
+    AllocationCounter counter;
+    for (size_t i = 0; i < kIterations; ++i) {
+      repository::DataCacheRepository per_request(
+          catalog, settings.cache, settings.default_cache_expiration,
+          settings.max_staleness);
+    }
+    repository_allocations = counter.GetCount();
+  }
+
+  size_t allocations = 0u;
+  size_t hits = 0u;
+  {
+    AllocationCounter counter;
+    for (size_t i = 0; i < kIterations; ++i) {
+      hits += data_repository.GetBlobData(layer, kBlobService, request, context)
+                      .IsSuccessful()
+                  ? 1u
+                  : 0u;
+    }
+    allocations = counter.GetCount();
+  }
+
+  olp::logging::Log::setLevel(log_level);
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag, "GetData lookups=%zu, hits=%zu, allocations=%zu, expected=%zu",
+      kIterations, hits, allocations, repository_allocations);
+  EXPECT_EQ(hits, kIterations);
+  EXPECT_EQ(allocations, repository_allocations);
+}
+
+}  // namespace
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/geo/coordinates/GeoCoordinates3d.h>
+#include <olp/core/geo/projection/EquirectangularProjection.h>
+#include <olp/core/geo/projection/SphereProjection.h>
+#include <olp/core/geo/projection/WebMercatorProjection.h>
+#include <olp/core/logging/Log.h>
+#include <olp/core/math/Math.h>
+
+namespace {
+namespace geo = olp::geo;
+
+constexpr auto kLogTag = "ProjectionBenchmark";
+constexpr size_t kTotalPoints = 10000000u;
+// The points are converted in chunks that fit into the CPU cache, so the
+// benchmark measures the conversion rather than the memory bandwidth.
+constexpr size_t kChunkSize = 16384u;
+
+struct BenchmarkConfiguration {
+  std::string name;
+  std::shared_ptr<geo::IProjection> projection;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const BenchmarkConfiguration& config) {
+  return os << "BenchmarkConfiguration(.name=" << config.name << ")";
+}
+
+class ProjectionBenchmark
+    : public ::testing::TestWithParam<BenchmarkConfiguration> {
+ protected:
+  void SetUp() override {
+    std::mt19937 generator(42u);
+    std::uniform_real_distribution<double> latitude(-1.4, 1.4);
+    std::uniform_real_distribution<double> longitude(-olp::math::pi,
+                                                     olp::math::pi);
+
+    points_.reserve(kChunkSize);
+    latitudes_.resize(kChunkSize);
+    longitudes_.resize(kChunkSize);
+    altitudes_.resize(kChunkSize, 0.0);
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      latitudes_[i] = latitude(generator);
+      longitudes_[i] = longitude(generator);
+      points_.emplace_back(latitudes_[i], longitudes_[i], altitudes_[i]);
+    }
+  }
+
+  std::vector<geo::GeoCoordinates3d> points_;
+  std::vector<double> latitudes_;
+  std::vector<double> longitudes_;
+  std::vector<double> altitudes_;
+};
+
+TEST_P(ProjectionBenchmark, ProjectPoints) {
+  const auto& parameter = GetParam();
+  const geo::IProjection& projection = *parameter.projection;
+
+  std::vector<geo::WorldCoordinates> world(kChunkSize);
+  std::vector<double> x(kChunkSize), y(kChunkSize), z(kChunkSize);
+  double checksum_single = 0.0;
+  double checksum_batch = 0.0;
+
+  const auto single_start = std::chrono::steady_clock::now();
+  for (size_t done = 0; done < kTotalPoints; done += kChunkSize) {
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      projection.Project(points_[i], world[i]);
+    }
+    checksum_single += world[done % kChunkSize].x;
+  }
+  const auto single_end = std::chrono::steady_clock::now();
+
+  for (size_t done = 0; done < kTotalPoints; done += kChunkSize) {
+    projection.ProjectBatch(latitudes_.data(), longitudes_.data(),
+                            altitudes_.data(), kChunkSize, x.data(),
+                            y.data(), z.data());
+    checksum_batch += x[done % kChunkSize];
+  }
+  const auto batch_end = std::chrono::steady_clock::now();
+
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  const auto single_time = Milliseconds(single_end - single_start).count();
+  const auto batch_time = Milliseconds(batch_end - single_end).count();
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Project %s, points=%zu, single=%.1f ms, batch=%.1f ms, speedup=%.2f",
+      parameter.name.c_str(), kTotalPoints, single_time, batch_time,
+      single_time / batch_time);
+
+  EXPECT_DOUBLE_EQ(checksum_single, checksum_batch);
+}
+
+TEST_P(ProjectionBenchmark, UnprojectPoints) {
+  const auto& parameter = GetParam();
+  const geo::IProjection& projection = *parameter.projection;
+
+  std::vector<geo::WorldCoordinates> world(kChunkSize);
+  std::vector<double> x(kChunkSize), y(kChunkSize), z(kChunkSize);
+  for (size_t i = 0; i < kChunkSize; ++i) {
+    projection.Project(points_[i], world[i]);
+    x[i] = world[i].x;
+    y[i] = world[i].y;
+    z[i] = world[i].z;
+  }
+
+  std::vector<geo::GeoCoordinates3d> geo_points(kChunkSize);
+  std::vector<double> latitudes(kChunkSize), longitudes(kChunkSize),
+      altitudes(kChunkSize);
+  double checksum_single = 0.0;
+  double checksum_batch = 0.0;
+
+  const auto single_start = std::chrono::steady_clock::now();
+  for (size_t done = 0; done < kTotalPoints; done += kChunkSize) {
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      projection.Unproject(world[i], geo_points[i]);
+    }
+    checksum_single += geo_points[done % kChunkSize].GetLatitude();
+  }
+  const auto single_end = std::chrono::steady_clock::now();
+
+  for (size_t done = 0; done < kTotalPoints; done += kChunkSize) {
+    projection.UnprojectBatch(x.data(), y.data(), z.data(), kChunkSize,
+                              latitudes.data(), longitudes.data(),
+                              altitudes.data());
+    checksum_batch += latitudes[done % kChunkSize];
+  }
+  const auto batch_end = std::chrono::steady_clock::now();
+
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  const auto single_time = Milliseconds(single_end - single_start).count();
+  const auto batch_time = Milliseconds(batch_end - single_end).count();
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Unproject %s, points=%zu, single=%.1f ms, batch=%.1f ms, speedup=%.2f",
+      parameter.name.c_str(), kTotalPoints, single_time, batch_time,
+      single_time / batch_time);
+
+  EXPECT_DOUBLE_EQ(checksum_single, checksum_batch);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Performance, ProjectionBenchmark,
+    ::testing::Values(
+        BenchmarkConfiguration{
+            "equirectangular",
+            std::make_shared<geo::EquirectangularProjection>()},
+        BenchmarkConfiguration{"sphere",
+                               std::make_shared<geo::SphereProjection>()},
+        BenchmarkConfiguration{
+            "web_mercator", std::make_shared<geo::WebMercatorProjection>()}));
+
+}  // namespace
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2021 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/geo/tiling/TileKey.h>
+#include <olp/core/logging/Log.h>
+
+namespace {
+using olp::geo::TileKey;
+
+constexpr auto kLogTag = "TileKeyBenchmark";
+constexpr size_t kTotalKeys = 20000000u;
+constexpr size_t kChunkSize = 16384u;
+constexpr std::uint32_t kLevel = 14u;
+
+// The conversions as they were implemented before the fast paths.
+namespace legacy {
+
+struct MortonTable {
+  MortonTable() {
+    for (std::uint32_t value = 0; value < 256; ++value) {
+      std::uint64_t result = 0;
+      for (std::uint32_t bit = 0; bit < 8; ++bit) {
+        result |= static_cast<std::uint64_t>((value >> bit) & 1u) << (2 * bit);
+      }
+      table[value] = result;
+    }
+  }
+
+  std::uint64_t table[256];
+};
+
+std::uint64_t ToQuadKey64(const TileKey& tile_key) {
+  static const MortonTable kMorton;
+  const auto* table = kMorton.table;
+  const auto row = tile_key.Row();
+  const auto column = tile_key.Column();
+  return 1ull << (2 * tile_key.Level()) | table[(row >> 24) & 0xFF] << 49 |
+         table[(row >> 16) & 0xFF] << 33 | table[(row >> 8) & 0xFF] << 17 |
+         table[row & 0xFF] << 1 | table[(column >> 24) & 0xFF] << 48 |
+         table[(column >> 16) & 0xFF] << 32 |
+         table[(column >> 8) & 0xFF] << 16 | table[column & 0xFF];
+}
+
+TileKey FromQuadKey64(std::uint64_t quad_key) {
+  std::uint32_t row = 0;
+  std::uint32_t column = 0;
+  std::uint32_t level = 0;
+  while (quad_key > 1) {
+    const std::uint32_t mask = 1u << level;
+    if (quad_key & 0x1) {
+      column |= mask;
+    }
+    if (quad_key & 0x2) {
+      row |= mask;
+    }
+    ++level;
+    quad_key >>= 2;
+  }
+  return TileKey::FromRowColumnLevel(row, column, level);
+}
+
+std::string ToHereTile(const TileKey& tile_key) {
+  std::ostringstream os;
+  os << std::dec << ToQuadKey64(tile_key);
+  return os.str();
+}
+
+TileKey FromHereTile(const std::string& key) {
+  char* ptr;
+  return FromQuadKey64(strtoull(key.data(), &ptr, 10));
+}
+
+}  // namespace legacy
+
+template <typename Function>
+double MeasureMilliseconds(Function function) {
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t done = 0; done < kTotalKeys; done += kChunkSize) {
+    function();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+class TileKeyBenchmark : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::mt19937 generator(42u);
+    std::uniform_int_distribution<std::uint32_t> coordinate(
+        0u, (1u << kLevel) - 1u);
+
+    tile_keys_.reserve(kChunkSize);
+    quad_keys_.reserve(kChunkSize);
+    here_tiles_.reserve(kChunkSize);
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      tile_keys_.push_back(TileKey::FromRowColumnLevel(
+          coordinate(generator), coordinate(generator), kLevel));
+      quad_keys_.push_back(tile_keys_.back().ToQuadKey64());
+      here_tiles_.push_back(tile_keys_.back().ToHereTile());
+    }
+  }
+
+  void Report(const char* name, double legacy_time, double single_time,
+              double batch_time) {
+    OLP_SDK_LOG_CRITICAL_INFO_F(
+        kLogTag,
+        "%s, keys=%zu, legacy=%.1f ms, single=%.1f ms (%.2fx), batch=%.1f ms "
+        "(%.2fx)",
+        name, kTotalKeys, legacy_time, single_time, legacy_time / single_time,
+        batch_time, legacy_time / batch_time);
+  }
+
+  std::vector<TileKey> tile_keys_;
+  std::vector<std::uint64_t> quad_keys_;
+  std::vector<std::string> here_tiles_;
+};
+
+TEST_F(TileKeyBenchmark, ToQuadKey64) {
+  std::vector<std::uint64_t> legacy(kChunkSize), single(kChunkSize),
+      batch(kChunkSize);
+
+  const auto legacy_time = MeasureMilliseconds([&] {
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      legacy[i] = legacy::ToQuadKey64(tile_keys_[i]);
+    }
+  });
+  const auto single_time = MeasureMilliseconds([&] {
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      single[i] = tile_keys_[i].ToQuadKey64();
+    }
+  });
+  const auto batch_time = MeasureMilliseconds([&] {
+    TileKey::ToQuadKeys64(tile_keys_.data(), kChunkSize, batch.data());
+  });
+
+  Report("ToQuadKey64", legacy_time, single_time, batch_time);
+  EXPECT_EQ(legacy, single);
+  EXPECT_EQ(legacy, batch);
+}
+
+TEST_F(TileKeyBenchmark, FromQuadKey64) {
+  std::vector<TileKey> legacy(kChunkSize), single(kChunkSize),
+      batch(kChunkSize);
+
+  const auto legacy_time = MeasureMilliseconds([&] {
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      legacy[i] = legacy::FromQuadKey64(quad_keys_[i]);
+    }
+  });
+  const auto single_time = MeasureMilliseconds([&] {
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      single[i] = TileKey::FromQuadKey64(quad_keys_[i]);
+    }
+  });
+  const auto batch_time = MeasureMilliseconds([&] {
+    TileKey::FromQuadKeys64(quad_keys_.data(), kChunkSize, batch.data());
+  });
+
+  Report("FromQuadKey64", legacy_time, single_time, batch_time);
+  EXPECT_EQ(legacy, single);
+  EXPECT_EQ(legacy, batch);
+}
+
+TEST_F(TileKeyBenchmark, ToHereTile) {
+  std::vector<std::string> legacy(kChunkSize), single(kChunkSize);
+  std::vector<char> buffer(kChunkSize * TileKey::HereTileMaxLength);
+  size_t length = 0;
+
+  const auto legacy_time = MeasureMilliseconds([&] {
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      legacy[i] = legacy::ToHereTile(tile_keys_[i]);
+    }
+  });
+  const auto single_time = MeasureMilliseconds([&] {
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      single[i] = tile_keys_[i].ToHereTile();
+    }
+  });
+
+  // Writes the strings one after another without allocations.
+  const auto batch_time = MeasureMilliseconds([&] {
+    char* first = buffer.data();
+    char* const last = first + buffer.size();
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      first = tile_keys_[i].ToHereTile(first, last);
+    }
+    length = first - buffer.data();
+  });
+
+  Report("ToHereTile", legacy_time, single_time, batch_time);
+  EXPECT_EQ(legacy, single);
+
+  std::string joined;
+  for (const auto& here_tile : legacy) {
+    joined += here_tile;
+  }
+  EXPECT_EQ(joined, std::string(buffer.data(), length));
+}
+
+TEST_F(TileKeyBenchmark, FromHereTile) {
+  std::vector<TileKey> legacy(kChunkSize), single(kChunkSize),
+      batch(kChunkSize);
+
+  const auto legacy_time = MeasureMilliseconds([&] {
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      legacy[i] = legacy::FromHereTile(here_tiles_[i]);
+    }
+  });
+  const auto single_time = MeasureMilliseconds([&] {
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      single[i] = TileKey::FromHereTile(here_tiles_[i]);
+    }
+  });
+  const auto batch_time = MeasureMilliseconds([&] {
+    for (size_t i = 0; i < kChunkSize; ++i) {
+      const auto& here_tile = here_tiles_[i];
+      batch[i] = TileKey::FromHereTile(here_tile.data(),
+                                       here_tile.data() + here_tile.size());
+    }
+  });
+
+  Report("FromHereTile", legacy_time, single_time, batch_time);
+  EXPECT_EQ(legacy, single);
+  EXPECT_EQ(legacy, batch);
+}
+
+}  // namespace